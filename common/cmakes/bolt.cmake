@@ -38,6 +38,28 @@ function (set_policy)
     endif()
 endfunction(set_policy)
 
+# Appends to srcs a copy of each x86 kernel source that is compiled with -D_USE_${isa}, so the
+# copy is built in namespace avx2, avx512 or avx512_vnni (see x86_avx512_expand.h).
+function (x86_isa_variant srcs isa)
+    string(TOLOWER ${isa} dir)
+    set(variant_srcs ${${srcs}})
+    foreach (src ${ARGN})
+        get_filename_component(name ${src} NAME)
+        set(variant ${CMAKE_CURRENT_BINARY_DIR}/${dir}/${name})
+        set(content "#include \"${src}\"\n")
+        set(old "")
+        if (EXISTS ${variant})
+            file(READ ${variant} old)
+        endif()
+        if (NOT "${old}" STREQUAL "${content}")
+            file(WRITE ${variant} "${content}")
+        endif()
+        set_source_files_properties(${variant} PROPERTIES COMPILE_FLAGS "-D_USE_${isa}")
+        list(APPEND variant_srcs ${variant})
+    endforeach()
+    set(${srcs} ${variant_srcs} PARENT_SCOPE)
+endfunction(x86_isa_variant)
+
 macro (set_c_cxx_flags)
     set(COMMON_FLAGS "-W -Wextra -O3 -fPIC")
     if (NOT WIN32)
@@ -95,13 +117,8 @@ macro (set_c_cxx_flags)
     endif(USE_GPU)
 
     if (USE_X86)
+        # AVX-512 kernels are built per function and picked at run time, see x86_isa_variant
         set(COMMON_FLAGS "${COMMON_FLAGS} -D_USE_X86 -mavx2 -mfma")
-        if (USE_INT8)
-            set(COMMON_FLAGS "${COMMON_FLAGS} -mavx512f")
-        endif (USE_INT8)
-	if (USE_AVX512_VNNI)
-            set(COMMON_FLAGS "${COMMON_FLAGS} -D_USE_AVX512_VNNI")
-	endif(USE_AVX512_VNNI)
     endif(USE_X86)
 
     if (USE_FP32)
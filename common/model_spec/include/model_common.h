@@ -27,7 +27,7 @@ OperatorSpec mt_create_operator(
 EE mt_insert_operator(ModelSpec *ms, int index, OperatorSpec newOperator);
 
 WeightSpec mt_create_weight(
-    const char *name, DataType dataType, U32 bytesOfWeight, U32 bytesOfVec, U32 numQuantScale);
+    const char *name, DataType dataType, U64 bytesOfWeight, U64 bytesOfVec, U32 numQuantScale);
 
 bool isDeprecatedOp(OperatorType opType);
 
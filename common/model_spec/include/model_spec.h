@@ -14,10 +14,16 @@
 #ifndef _H_MODEL_SPEC
 #define _H_MODEL_SPEC
 
+#include <memory>
 #include "parameter_spec.h"
 
-static const int sg_boltVersion = 20201120;
+// 20211201: 64-bit weight sizes, every weight and bias section starts on a sg_weightAlignment
+// boundary of the file
+static const int sg_boltVersion = 20211201;
+// 32-bit weight sizes without padding, still readable
+static const int sg_boltVersionU32 = 20201120;
 static const int sg_magicNumber = 1141119;
+static const int sg_weightAlignment = 64;
 
 #pragma pack(8)
 typedef struct {
@@ -36,9 +42,9 @@ typedef struct {
 typedef struct WeightSpec {
     I8 op_name[NAME_LEN];
     DataType mdt = DT_U8;
-    U32 bytes_of_weight = 0;
+    U64 bytes_of_weight = 0;
     U8 *weight;
-    U32 bytes_of_vec = 0;
+    U64 bytes_of_vec = 0;
     U8 *vec;
     // Merged FC may have multiple weight scales
     U32 num_quant_scale;
@@ -56,7 +62,7 @@ typedef struct {
 typedef struct {
     I32 fd;
     I8 *bytes;
-    U32 fileLength;
+    U64 fileLength;
     bool useFileStream;
 } ModelFileDescriptor;
 
@@ -95,6 +101,9 @@ EE mt_create_model(ModelSpec *md);
 EE serialize_model_to_file(const ModelSpec *spec, const char *fn);
 EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStream = false);
 EE mt_destroy_model(ModelSpec *md);
+// Take over the memory of a model read from file, weights that point into it stay valid after
+// mt_destroy_model until the returned pointer is released.
+std::shared_ptr<U8> mt_detach_model_file(ModelFileDescriptor *mfd);
 
 #include "model_print.h"
 #endif
@@ -61,7 +61,7 @@ EE mt_insert_operator(ModelSpec *ms, int index, OperatorSpec newOperator)
 }
 
 WeightSpec mt_create_weight(
-    const char *name, DataType dataType, U32 bytesOfWeight, U32 bytesOfVec, U32 numQuantScale)
+    const char *name, DataType dataType, U64 bytesOfWeight, U64 bytesOfVec, U32 numQuantScale)
 {
     WeightSpec newWeight;
     memset(&(newWeight), 0, sizeof(WeightSpec));
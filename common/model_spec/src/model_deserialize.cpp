@@ -181,7 +181,7 @@ void dequantize_int8_weight(int num, F32 scale, INT8 *q, T *d)
 }
 
 template <typename T>
-inline void deserialize_field(const char **buffer, U32 *position, T *element, int length = 1)
+inline void deserialize_field(const char **buffer, U64 *position, T *element, int length = 1)
 {
     int size = length * sizeof(T);
     memcpy(element, *buffer, size);
@@ -189,13 +189,13 @@ inline void deserialize_field(const char **buffer, U32 *position, T *element, in
     *position += size;
 }
 
-EE deserialize_header(const char *bytes, ModelSpec *spec, U32 *pos)
+EE deserialize_header(const char *bytes, ModelSpec *spec, U64 *pos)
 {
     const char *header_pointer = bytes + *pos;
     const char **pointer = &header_pointer;
 
     deserialize_field<I32>(pointer, pos, &spec->version);
-    if (spec->version != sg_boltVersion) {
+    if (spec->version != sg_boltVersion && spec->version != sg_boltVersionU32) {
         UNI_ERROR_LOG("X2bolt version is [%d], but your model version is : [%d].\n Please update "
                       "X2bolt to version[%d].\n",
             sg_boltVersion, spec->version, spec->version);
@@ -232,7 +232,7 @@ EE deserialize_header(const char *bytes, ModelSpec *spec, U32 *pos)
     return SUCCESS;
 }
 
-EE deserialize_operator(const char *bytes, ModelSpec *spec, U32 *pos)
+EE deserialize_operator(const char *bytes, ModelSpec *spec, U64 *pos)
 {
     const char *operator_pointer = bytes + *pos;
     const char **pointer = &operator_pointer;
@@ -279,7 +279,23 @@ EE deserialize_operator(const char *bytes, ModelSpec *spec, U32 *pos)
     return SUCCESS;
 }
 
-EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
+// read the size of a weight or bias section and move to its first byte
+inline void deserialize_section_size(
+    const ModelSpec *spec, const char **buffer, U64 *position, U64 *size)
+{
+    if (spec->version == sg_boltVersionU32) {
+        U32 size32;
+        deserialize_field<U32>(buffer, position, &size32);
+        *size = size32;
+    } else {
+        deserialize_field<U64>(buffer, position, size);
+        U64 padding = (sg_weightAlignment - *position % sg_weightAlignment) % sg_weightAlignment;
+        *buffer += padding;
+        *position += padding;
+    }
+}
+
+EE deserialize_weight(const char *bytes, ModelSpec *spec, U64 *pos)
 {
     const char *weight_pointer = bytes + *pos;
     const char **pointer = &weight_pointer;
@@ -288,8 +304,14 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
     spec->ws = (WeightSpec *)mt_new_storage(spec->num_weight_specs * sizeof(WeightSpec));
     WeightSpec *ptr = spec->ws;
     for (int i = 0; i < spec->num_weight_specs; i++) {
-        U32 length = 0, count = 0;
-        deserialize_field<U32>(pointer, pos, &length);
+        U64 length = 0, count = 0;
+        if (spec->version == sg_boltVersionU32) {
+            U32 length32;
+            deserialize_field<U32>(pointer, pos, &length32);
+            length = length32;
+        } else {
+            deserialize_field<U64>(pointer, pos, &length);
+        }
 
         deserialize_field<I8>(pointer, pos, ptr[i].op_name, NAME_LEN);
         deserialize_field<DataType>(pointer, pos, &ptr[i].mdt);
@@ -310,7 +332,7 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
             quantInt8 = true;
         }
 
-        deserialize_field<U32>(pointer, pos, &ptr[i].bytes_of_weight);
+        deserialize_section_size(spec, pointer, pos, &ptr[i].bytes_of_weight);
         U8 *serialWeight = (U8 *)(*pointer);
         if (ptr[i].bytes_of_weight == 0) {
             serialWeight = nullptr;
@@ -325,7 +347,7 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
             ptr[i].bytes_of_weight *= bytesOf(ptr[i].mdt);
         }
 
-        deserialize_field<U32>(pointer, pos, &ptr[i].bytes_of_vec);
+        deserialize_section_size(spec, pointer, pos, &ptr[i].bytes_of_vec);
         U8 *serialBias = (U8 *)(*pointer);
         if (ptr[i].bytes_of_vec == 0) {
             serialBias = nullptr;
@@ -388,7 +410,7 @@ EE deserialize_weight(const char *bytes, ModelSpec *spec, U32 *pos)
 
 EE deserialize_model(const char *bytes, ModelSpec *spec)
 {
-    U32 pos = 0;
+    U64 pos = 0;
     CHECK_STATUS(deserialize_header(bytes, spec, &pos));
     CHECK_STATUS(deserialize_operator(bytes, spec, &pos));
     CHECK_STATUS(deserialize_weight(bytes, spec, &pos));
@@ -448,7 +470,10 @@ EE deserialize_model_from_file(const char *fn, ModelSpec *spec, bool useFileStre
                 }
 
                 fileLength = ss.st_size;
-                bytes = (char *)mmap(nullptr, fileLength, PROT_READ, MAP_SHARED, fd, 0);
+                // weights are paged in when they are touched, the private writable mapping
+                // lets operators use them in place without ever writing back to the file
+                bytes = (char *)mmap(
+                    nullptr, fileLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
                 if (MAP_FAILED == bytes) {
                     UNI_ERROR_LOG("Mmap bolt model file %s failed.\n", fn);
                     return FILE_ERROR;
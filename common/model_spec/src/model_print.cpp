@@ -95,13 +95,15 @@ void print_weights(const ModelSpec ms)
     }
     for (int i = 0; i < number; i++) {
         if (isDeprecatedOpWeight(&ms, i)) {
-            printf("        %3d %32s | delete %16s %12u %10u\n", i, ms.ws[i].op_name,
-                DataTypeName()[ms.ws[i].mdt], ms.ws[i].bytes_of_weight, ms.ws[i].bytes_of_vec);
+            printf("        %3d %32s | delete %16s %12llu %10llu\n", i, ms.ws[i].op_name,
+                DataTypeName()[ms.ws[i].mdt], (unsigned long long)ms.ws[i].bytes_of_weight,
+                (unsigned long long)ms.ws[i].bytes_of_vec);
             continue;
         }
 
-        printf("        %3d %32s | retain %16s %12u %10u", i, ms.ws[i].op_name,
-            DataTypeName()[ms.ws[i].mdt], ms.ws[i].bytes_of_weight, ms.ws[i].bytes_of_vec);
+        printf("        %3d %32s | retain %16s %12llu %10llu", i, ms.ws[i].op_name,
+            DataTypeName()[ms.ws[i].mdt], (unsigned long long)ms.ws[i].bytes_of_weight,
+            (unsigned long long)ms.ws[i].bytes_of_vec);
         if (ms.ws[i].bytes_of_weight > 0 && ms.ws[i].weight != nullptr) {
             F32 value;
             transformToFloat(ms.ws[i].mdt, ms.ws[i].weight, &value, 1);
@@ -20,8 +20,9 @@ EE serialize_header(const ModelSpec *spec, std::string *tmp)
         sizeof(I32) + sizeof(I8) * NAME_LEN * spec->num_outputs;
     I8 *data = (I8 *)mt_new_storage(bufSize);
 
+    // the layout written here is always the current one
     I32 *pointer4version = (I32 *)data;
-    memcpy(pointer4version, &spec->version, sizeof(I32));
+    memcpy(pointer4version, &sg_boltVersion, sizeof(I32));
     pointer4version += 1;
 
     I32 *pointer4magicNumber = (I32 *)pointer4version;
@@ -174,19 +175,31 @@ EE serialize_operators(const ModelSpec *spec, std::string *tmp)
     return SUCCESS;
 }
 
-EE serialize_weights(const ModelSpec *spec, std::string *tmp)
+// zero bytes that move a section at offset to the next weight alignment boundary of the file
+inline U64 serialize_padding(U64 offset)
+{
+    return (sg_weightAlignment - offset % sg_weightAlignment) % sg_weightAlignment;
+}
+
+// offset is the position of the weight section in the file, weights and biases are aligned
+// relative to the beginning of the file so that a mapped model can use them in place
+EE serialize_weights(const ModelSpec *spec, U64 offset, std::string *tmp)
 {
     WeightSpec *tmpPointer = spec->ws;
-    U32 bufSize = sizeof(I32);
+    U64 bufSize = sizeof(I32);
     U32 weightCount = 0;
     for (int i = 0; i < spec->num_weight_specs; i++) {
         if (isDeprecatedOpWeight(spec, i)) {
             continue;
         }
 
-        // U32 x 5: length, mdt, bytes_of_weight, bytes_of_vec, num_quant_scale
-        bufSize += sizeof(I8) * NAME_LEN + sizeof(U32) * 5 + tmpPointer[i].bytes_of_weight +
-            tmpPointer[i].bytes_of_vec;
+        // U64 x 3: length, bytes_of_weight, bytes_of_vec
+        // U32 x 2: mdt, num_quant_scale
+        bufSize += sizeof(U64) + sizeof(I8) * NAME_LEN + sizeof(U32) + sizeof(U64);
+        bufSize += serialize_padding(offset + bufSize) + tmpPointer[i].bytes_of_weight;
+        bufSize += sizeof(U64);
+        bufSize += serialize_padding(offset + bufSize) + tmpPointer[i].bytes_of_vec;
+        bufSize += sizeof(U32);
         for (U32 j = 0; j < tmpPointer[i].num_quant_scale; j++) {
             bufSize += sizeof(int);  // num_scale
             bufSize += tmpPointer[i].weight_scale[j].num_scale * sizeof(F32);
@@ -194,7 +207,9 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
 
         weightCount++;
     }
-    char *data = (char *)mt_new_storage(bufSize);
+    // write in place, another copy of several GB of weights is not affordable
+    tmp->assign(bufSize, 0);
+    char *data = &(*tmp)[0];
 
     I32 *pointer4numWeightSpecs = (I32 *)data;
     *pointer4numWeightSpecs = weightCount;
@@ -207,32 +222,29 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
             continue;
         }
 
-        U32 *length = (U32 *)pointer4wsOpName;
-        U32 len;
-        len = wsPointer[i].bytes_of_weight + wsPointer[i].bytes_of_vec;
-        *length = len;
-        pointer4wsOpName += sizeof(U32);
+        U64 len = wsPointer[i].bytes_of_weight + wsPointer[i].bytes_of_vec;
+        memcpy(pointer4wsOpName, &len, sizeof(U64));
+        pointer4wsOpName += sizeof(U64);
 
         str_copy(pointer4wsOpName, wsPointer[i].op_name, NAME_LEN);
         pointer4wsOpName += NAME_LEN;
 
-        U32 *pointer4wsMdt = (U32 *)pointer4wsOpName;
-        *pointer4wsMdt = wsPointer[i].mdt;
-        pointer4wsMdt++;
+        U32 mdt = wsPointer[i].mdt;
+        memcpy(pointer4wsOpName, &mdt, sizeof(U32));
+        pointer4wsOpName += sizeof(U32);
 
-        U32 *pointer4wsBytesOfWeight = (U32 *)pointer4wsMdt;
-        *pointer4wsBytesOfWeight = wsPointer[i].bytes_of_weight;
-        pointer4wsBytesOfWeight++;
+        memcpy(pointer4wsOpName, &wsPointer[i].bytes_of_weight, sizeof(U64));
+        pointer4wsOpName += sizeof(U64);
+        pointer4wsOpName += serialize_padding(offset + (pointer4wsOpName - data));
 
-        U8 *pointer4wsWeight = (U8 *)pointer4wsBytesOfWeight;
-        memcpy(pointer4wsWeight, wsPointer[i].weight, wsPointer[i].bytes_of_weight);
-        pointer4wsWeight += wsPointer[i].bytes_of_weight;
+        memcpy(pointer4wsOpName, wsPointer[i].weight, wsPointer[i].bytes_of_weight);
+        pointer4wsOpName += wsPointer[i].bytes_of_weight;
 
-        U32 *pointer4wsBytesOfVec = (U32 *)pointer4wsWeight;
-        *pointer4wsBytesOfVec = wsPointer[i].bytes_of_vec;
-        pointer4wsBytesOfVec++;
+        memcpy(pointer4wsOpName, &wsPointer[i].bytes_of_vec, sizeof(U64));
+        pointer4wsOpName += sizeof(U64);
+        pointer4wsOpName += serialize_padding(offset + (pointer4wsOpName - data));
 
-        U8 *pointer4wsVec = (U8 *)pointer4wsBytesOfVec;
+        U8 *pointer4wsVec = (U8 *)pointer4wsOpName;
         memcpy(pointer4wsVec, wsPointer[i].vec, wsPointer[i].bytes_of_vec);
         pointer4wsVec += wsPointer[i].bytes_of_vec;
 
@@ -252,55 +264,47 @@ EE serialize_weights(const ModelSpec *spec, std::string *tmp)
         pointer4wsOpName = (char *)pointer4quant;
     }
 
-    tmp->clear();
-    CHECK_REQUIREMENT((U32)(pointer4wsOpName - data) == bufSize);
-    tmp->assign(data, data + bufSize);
-    delete data;
+    CHECK_REQUIREMENT((U64)(pointer4wsOpName - data) == bufSize);
     return SUCCESS;
 }
 
-EE serialize_model(const ModelSpec *spec, std::string *bytes)
+EE write_to_file(const std::string &bytes, FILE *file, const char *fn)
 {
-    bytes->clear();
-    std::string tmp;
-
-    CHECK_STATUS(serialize_header(spec, &tmp));
-    *bytes += tmp;
-
-    CHECK_STATUS(serialize_operators(spec, &tmp));
-    *bytes += tmp;
-
-    CHECK_STATUS(serialize_weights(spec, &tmp));
-    *bytes += tmp;
+    size_t size = fwrite(bytes.c_str(), sizeof(char), bytes.size(), file);
+    if (size != bytes.size()) {
+        UNI_ERROR_LOG("Write bolt model file %s failed.\n", fn);
+        return FILE_ERROR;
+    }
     return SUCCESS;
 }
 
-EE write_to_file(std::string *bytes, const char *fn)
+EE serialize_model_to_file(const ModelSpec *spec, const char *fn)
 {
+    UNI_DEBUG_LOG("Write bolt model to %s...\n", fn);
     FILE *file = fopen(fn, "wb");
     if (file == NULL) {
         UNI_ERROR_LOG("Cannot write bolt model to %s.\n", fn);
         return FILE_ERROR;
     }
-    U32 size = fwrite(bytes->c_str(), sizeof(char), bytes->size(), file);
-    if (size != bytes->size()) {
-        UNI_ERROR_LOG("Write bolt model file %s failed.\n", fn);
-        return FILE_ERROR;
-    }
+    // write each section once it is ready, the weights are not concatenated into another buffer
+    std::string tmp;
+    U64 offset = 0;
+    CHECK_STATUS(serialize_header(spec, &tmp));
+    CHECK_STATUS(write_to_file(tmp, file, fn));
+    offset += tmp.size();
+
+    CHECK_STATUS(serialize_operators(spec, &tmp));
+    CHECK_STATUS(write_to_file(tmp, file, fn));
+    offset += tmp.size();
+
+    CHECK_STATUS(serialize_weights(spec, offset, &tmp));
+    CHECK_STATUS(write_to_file(tmp, file, fn));
+
     int status = fclose(file);
     if (status != 0) {
         UNI_ERROR_LOG("Close bolt model file %s write handle failed.\n", fn);
         return FILE_ERROR;
     }
-    return SUCCESS;
-}
-
-EE serialize_model_to_file(const ModelSpec *spec, const char *fn)
-{
-    UNI_DEBUG_LOG("Write bolt model to %s...\n", fn);
-    std::string bytes = "";
-    CHECK_STATUS(serialize_model(spec, &bytes));
-    CHECK_STATUS(write_to_file(&bytes, fn));
     UNI_DEBUG_LOG("Write bolt model end.\n");
     return SUCCESS;
 }
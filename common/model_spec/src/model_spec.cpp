@@ -179,3 +179,28 @@ EE mt_destroy_model(ModelSpec *ms)
 
     return SUCCESS;
 }
+
+std::shared_ptr<U8> mt_detach_model_file(ModelFileDescriptor *mfd)
+{
+    std::shared_ptr<U8> file;
+    if (mfd == nullptr || mfd->useFileStream || mfd->bytes == nullptr) {
+        return file;
+    }
+#ifdef _WIN32
+    file = std::shared_ptr<U8>((U8 *)mfd->bytes, [](U8 *ptr) { free(ptr); });
+#else
+    U64 fileLength = mfd->fileLength;
+    I32 fd = mfd->fd;
+    file = std::shared_ptr<U8>((U8 *)mfd->bytes, [fileLength, fd](U8 *ptr) {
+        munmap(ptr, fileLength);
+        if (-1 != fd) {
+            close(fd);
+        }
+    });
+#endif
+    // from now on the memory is owned outside like a caller provided file stream, the range is
+    // kept for outOfFileMapRange
+    mfd->fd = -1;
+    mfd->useFileStream = true;
+    return file;
+}
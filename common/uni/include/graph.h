@@ -78,6 +78,7 @@ public:
                 tensor->resize(extractInputTensorDescFromNode(node));
                 CHECK_REQUIREMENT(nodeParameter.output_size() == 1);
                 this->tensors[nodeParameter.output(0)] = std::shared_ptr<DataTensor>(tensor);
+                this->inputs.insert(nodeParameter.output(0));
                 continue;
             }
 
@@ -87,14 +88,14 @@ public:
         UNI_DEBUG_LOG("load and build graph from %s end\n", graphPath.c_str());
     }
 
-    EE ready(DataType precision, AffinityPolicy affinityPolicy, int gpuId)
+    EE ready(DataType precision, AffinityPolicy affinityPolicy, int gpuId, int maxBatch = 1)
     {
         UNI_DEBUG_LOG("graph %s ready begin\n", this->name.c_str());
         CHECK_STATUS(managePrecision(precision));
         if (gpuId >= 0) {
             affinityPolicy = AFFINITY_GPU;
         }
-        CHECK_STATUS(initInference(affinityPolicy));
+        CHECK_STATUS(initInference(affinityPolicy, maxBatch));
         CHECK_STATUS(manageDataTensors());
         CHECK_STATUS(manageTmpBuffer());
         for (unsigned int i = 0; i < this->nodes.size(); i++) {
@@ -104,6 +105,87 @@ public:
         return SUCCESS;
     }
 
+    /**
+     * copy of the graph that only keeps the node at index for runNode, the node's inference
+     * shares the weights of this graph
+     */
+    Graph cloneNode(unsigned int index)
+    {
+        UNI_DEBUG_LOG("graph %s clone node %u begin\n", this->name.c_str(), index);
+        Graph graph;
+        graph.name = this->name;
+        graph.outputs = this->outputs;
+        graph.nodes.push_back(this->nodes[index].clone());
+        CHECK_STATUS(graph.manageTmpBuffer());
+        UNI_DEBUG_LOG("graph %s clone node end\n", this->name.c_str());
+        return graph;
+    }
+
+    /**
+     * ready only the node at index for runNode, the other nodes are dropped so that their models
+     * are not loaded
+     */
+    EE readyNode(unsigned int index, DataType precision, AffinityPolicy affinityPolicy, int gpuId)
+    {
+        UNI_DEBUG_LOG("graph %s ready node %u begin\n", this->name.c_str(), index);
+        ComputeNode node = this->nodes[index];
+        this->nodes.clear();
+        this->nodes.push_back(node);
+        this->tensors.clear();
+        CHECK_STATUS(managePrecision(precision));
+        if (gpuId >= 0) {
+            affinityPolicy = AFFINITY_GPU;
+        }
+        CHECK_STATUS(initInference(affinityPolicy, 1));
+        CHECK_STATUS(manageTmpBuffer());
+        this->nodes[0].ready();
+        UNI_DEBUG_LOG("graph %s ready node end\n", this->name.c_str());
+        return SUCCESS;
+    }
+
+    /**
+     * node indexes ordered so that every node comes after the nodes producing its inputs, nodes
+     * that are already in order keep their positions
+     */
+    EE getTopologicalOrder(std::vector<unsigned int> *order)
+    {
+        std::map<std::string, unsigned int> producers;
+        for (unsigned int i = 0; i < this->nodes.size(); i++) {
+            auto nodeParameter = this->nodes[i].getNodeParameter();
+            for (int j = 0; j < nodeParameter.output_size(); j++) {
+                producers[nodeParameter.output(j)] = i;
+            }
+        }
+        order->clear();
+        std::vector<bool> placed(this->nodes.size(), false);
+        while (order->size() < this->nodes.size()) {
+            unsigned int i = 0;
+            for (; i < this->nodes.size(); i++) {
+                if (placed[i]) {
+                    continue;
+                }
+                auto nodeParameter = this->nodes[i].getNodeParameter();
+                bool ready = true;
+                for (int j = 0; j < nodeParameter.input_size() && ready; j++) {
+                    auto producer = producers.find(nodeParameter.input(j));
+                    ready = (producer == producers.end() || producer->second == i ||
+                        placed[producer->second]);
+                }
+                if (ready) {
+                    break;
+                }
+            }
+            if (i == this->nodes.size()) {
+                UNI_WARNING_LOG(
+                    "graph %s has a cycle, nodes can not be ordered\n", this->name.c_str());
+                return NOT_MATCH;
+            }
+            placed[i] = true;
+            order->push_back(i);
+        }
+        return SUCCESS;
+    }
+
     EE setRuntime(int cpuId, Arch arch)
     {
         UNI_DEBUG_LOG(
@@ -126,11 +208,79 @@ public:
         return SUCCESS;
     }
 
+    /**
+     * run one node on the given tensors instead of the graph's own ones, the node outputs that
+     * are not in tensors are created and added to it so that the following nodes can consume them
+     */
+    EE runNode(unsigned int index, std::map<std::string, std::shared_ptr<DataTensor>> &tensors)
+    {
+        auto nodeParameter = this->nodes[index].getNodeParameter();
+        UNI_DEBUG_LOG(
+            "graph %s run node %s begin\n", this->name.c_str(), nodeParameter.name().c_str());
+        std::map<std::string, std::shared_ptr<DataTensor>> nodeInputs, nodeOutputs;
+        for (int j = 0; j < nodeParameter.input_size(); j++) {
+            std::string nodeInputName = nodeParameter.input(j);
+            if (tensors.find(nodeInputName) == tensors.end()) {
+                UNI_ERROR_LOG("graph %s can not find %s as input of node %s\n",
+                    this->name.c_str(), nodeInputName.c_str(), nodeParameter.name().c_str());
+            }
+            nodeInputs[nodeInputName] = tensors[nodeInputName];
+        }
+        for (int j = 0; j < nodeParameter.output_size(); j++) {
+            std::string nodeOutputName = nodeParameter.output(j);
+            if (tensors.find(nodeOutputName) == tensors.end()) {
+                tensors[nodeOutputName] = std::shared_ptr<DataTensor>(new DataTensor());
+            }
+            nodeOutputs[nodeOutputName] = tensors[nodeOutputName];
+        }
+        this->nodes[index].setInput(nodeInputs);
+        this->nodes[index].setOutput(nodeOutputs);
+        CHECK_STATUS(this->nodes[index].inferOutputSize());
+        for (auto tensor : nodeOutputs) {
+            tensor.second->alloc();
+        }
+        this->nodes[index].run();
+        UNI_DEBUG_LOG("graph %s run node end\n", this->name.c_str());
+        return SUCCESS;
+    }
+
+    unsigned int getNodeNum()
+    {
+        return this->nodes.size();
+    }
+
+    std::string getNodeName(unsigned int index)
+    {
+        return this->nodes[index].getNodeParameter().name();
+    }
+
+    std::set<std::string> getOutputNames()
+    {
+        return this->outputs;
+    }
+
+    /**
+     * descriptions of the graph inputs and outputs, the output ones are known after ready
+     */
+    std::map<std::string, TensorDesc> getInputOutputDescs()
+    {
+        std::map<std::string, TensorDesc> descs;
+        for (auto &names : {this->inputs, this->outputs}) {
+            for (auto &name : names) {
+                if (this->tensors.find(name) != this->tensors.end()) {
+                    descs[name] = this->tensors[name]->get_desc();
+                }
+            }
+        }
+        return descs;
+    }
+
 private:
     std::string name;
     std::vector<ComputeNode> nodes;
     std::map<std::string, std::shared_ptr<DataTensor>> tensors;
     std::shared_ptr<DataTensor> tmpDataTensor;
+    std::set<std::string> inputs;
     std::set<std::string> outputs;
 
     bool load(std::string graphPath, google::protobuf::Message *message)
@@ -238,11 +388,11 @@ private:
         return SUCCESS;
     }
 
-    EE initInference(AffinityPolicy affinityPolicy)
+    EE initInference(AffinityPolicy affinityPolicy, int maxBatch)
     {
         UNI_DEBUG_LOG("graph %s init inference(%d) begin\n", this->name.c_str(), affinityPolicy);
         for (unsigned int i = 0; i < this->nodes.size(); i++) {
-            this->nodes[i].initInference(affinityPolicy);
+            this->nodes[i].initInference(affinityPolicy, maxBatch);
         }
         UNI_DEBUG_LOG("graph %s init inference end\n", this->name.c_str());
         return SUCCESS;
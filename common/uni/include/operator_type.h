@@ -113,7 +113,9 @@ typedef enum {
     OT_GenerateProposals = 88,
     OT_RoIAlign = 89,
 
-    OT_GAT = 90
+    OT_GAT = 90,
+    OT_ScaledDotProductAttention = 91,
+    OT_TransformFormat = 92
 } OperatorType;
 
 inline const char *const *OperatorTypeName()
@@ -146,7 +148,7 @@ inline const char *const *OperatorTypeName()
         "OT_InstanceNorm", "OT_Expand", "OT_Scatter", "OT_Select", "OT_Not", "OT_Reciprocal",
         "OT_Log", "OT_GenerateProposals", "OT_RoIAlign",
 
-        "OT_GAT"};
+        "OT_GAT", "OT_ScaledDotProductAttention", "OT_TransformFormat"};
     return names;
 }
 #endif
@@ -76,6 +76,14 @@ typedef enum {
 
 typedef enum { BSliceApply_NULL, BSliceApply_CONV } BilateralSliceApplyMode;
 
+typedef enum {
+    SDPA_MASK_NONE,
+    // additive mask, broadcast to [batch, heads, from_sequence, to_sequence]
+    SDPA_MASK_ADD,
+    // [batch, to_sequence] 0/1 mask, expanded the same way as OT_Attention
+    SDPA_MASK_ATTENTION
+} SDPAMaskMode;
+
 typedef enum {
     Convolution_Pointwise,
     Convolution_Dilation,
@@ -567,6 +575,15 @@ typedef struct {
     ActivationParamSpec activation;
 } GATParamSpec;
 
+typedef struct {
+    // key is [..., to_sequence, dim] instead of [..., dim, to_sequence]
+    bool transpose_key;
+    // score = query * key * scale + mask * mask_scale
+    float scale;
+    float mask_scale;
+    SDPAMaskMode mask_mode;
+} ScaledDotProductAttentionParamSpec;
+
 typedef struct RoIAlignParamSpec {
     ROIAlignCoordinateTransformationMode coordinateTransformationMode;
     PoolingMode mode;
@@ -646,6 +663,7 @@ typedef union ParameterSpec {
     RoIAlignParamSpec roialign_spec;
     GenerateProposalsParamSpec generate_proposals_spec;
     GATParamSpec gat_spec;
+    ScaledDotProductAttentionParamSpec sdpa_spec;
 } ParameterSpec;
 
 typedef struct {
@@ -690,7 +708,8 @@ inline int get_operator_parameter_size(OperatorType operatorType)
         {OT_InstanceNorm, sizeof(InstanceNormParamSpec)}, {OT_Scatter, sizeof(ScatterParamSpec)},
         {OT_LogSoftmax, sizeof(SoftmaxParamSpec)}, {OT_Equal, sizeof(EqualParamSpec)},
         {OT_GenerateProposals, sizeof(GenerateProposalsParamSpec)},
-        {OT_RoIAlign, sizeof(RoIAlignParamSpec)}, {OT_GAT, sizeof(GATParamSpec)}};
+        {OT_RoIAlign, sizeof(RoIAlignParamSpec)}, {OT_GAT, sizeof(GATParamSpec)},
+        {OT_ScaledDotProductAttention, sizeof(ScaledDotProductAttentionParamSpec)}};
     int size;
     if (operatorParameterSizeMap.find(operatorType) == operatorParameterSizeMap.end()) {
         size = 0;
@@ -16,13 +16,26 @@
 
 #define _USE_WEIGHT_SHARE
 
-#include <queue>
+#include <deque>
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
+#include <errno.h>
+#include <time.h>
 
 #include "graph.h"
 #include "task.h"
+#include "profiling.h"
+
+typedef struct {
+    std::string name;        // node name
+    unsigned int tasks;      // the number of processed tasks
+    unsigned int maxDepth;   // the maximum length of the node's queue
+    double avgDepth;         // the average queue length seen by the arriving tasks
+    double avgWaitTime;      // the average time in ms that a task waits in the queue
+    double avgRunTime;       // the average time in ms of running the node once
+} StageStatistics;
 
 template <class GraphParameter, class ComputeNode, class DataTensor>
 class Schedule {
@@ -31,6 +44,8 @@ public:
     {
         pthread_mutex_init(&(this->taskQueueLock), NULL);
         pthread_cond_init(&(this->condition), NULL);
+        pthread_mutex_init(&(this->taskStatusLock), NULL);
+        pthread_cond_init(&(this->taskStatusCondition), NULL);
         this->threadNum = 0;
         this->stop = false;
     }
@@ -40,6 +55,15 @@ public:
         pthread_mutex_lock(&(this->taskQueueLock));
         pthread_mutex_destroy(&(this->taskQueueLock));
         pthread_cond_destroy(&(this->condition));
+        pthread_mutex_destroy(&(this->taskStatusLock));
+        pthread_cond_destroy(&(this->taskStatusCondition));
+        for (auto &iter : this->pipelines) {
+            for (auto &stage : iter.second.stages) {
+                pthread_mutex_destroy(&(stage.lock));
+                pthread_cond_destroy(&(stage.notEmpty));
+                pthread_cond_destroy(&(stage.notFull));
+            }
+        }
 #if !defined(__ANDROID_API__) && !defined(__APPLE__)
         pthread_barrier_destroy(&(this->barrier));
 #endif
@@ -70,11 +94,17 @@ public:
         this->precision = dataType;
         this->deviceInfo = get_cpu_info(affinityPolicy);
         this->graphPath = graphPath;
+        for (unsigned int i = 0; i < graphPath.size(); i++) {
+            if (this->getMaxBatch(graphPath[i]) > 1 && !this->canBatch(graphPath[i])) {
+                this->batchPolicy.erase(graphPath[i]);
+            }
+        }
 
 #ifdef _USE_WEIGHT_SHARE
         for (unsigned int i = 0; i < graphPath.size(); i++) {
             this->graph[graphPath[i]].init(graphPath[i]);
-            this->graph[graphPath[i]].ready(this->precision, this->deviceInfo.affinityPolicy, -1);
+            this->graph[graphPath[i]].ready(this->precision, this->deviceInfo.affinityPolicy, -1,
+                this->getMaxBatch(graphPath[i]));
         }
 #endif
 #ifndef _USE_OPENMP
@@ -87,6 +117,7 @@ public:
         set_thread_affinity(0, &cpuId, 1);
 #endif
         this->threadNum = threadNum;
+        this->useGPU = useGPU;
         this->threads = new pthread_t[threadNum];
         for (int i = 0; i < threadNum; i++) {
             if (pthread_create(this->threads + i, NULL, worker, reinterpret_cast<void *>(this)) !=
@@ -96,7 +127,11 @@ public:
                 return 1;
             }
         }
-        this->useGPU = useGPU;
+        if (this->initPipelines() != 0) {
+            this->end();
+            UNI_ERROR_LOG("schedule create pipeline threads fail\n");
+            return 1;
+        }
         UNI_DEBUG_LOG("schedule init end\n");
         return 0;
     }
@@ -120,6 +155,33 @@ public:
                 return 1;
             }
         }
+        for (auto &iter : this->pipelines) {
+            // stop the stages in order, so that the tasks in flight drain into the later stages
+            Pipeline &pipeline = iter.second;
+            unsigned int threadId = 0;
+            for (auto &stage : pipeline.stages) {
+                pthread_mutex_lock(&(stage.lock));
+                stage.stop = true;
+                pthread_cond_broadcast(&(stage.notEmpty));
+                pthread_cond_broadcast(&(stage.notFull));
+                pthread_mutex_unlock(&(stage.lock));
+                for (int i = 0; i < pipeline.stageThreads && threadId < pipeline.threads.size();
+                     i++, threadId++) {
+                    if (pthread_join(pipeline.threads[threadId], NULL) != 0) {
+                        return 1;
+                    }
+                }
+            }
+            pipeline.threads.clear();
+            std::vector<StageStatistics> statistics = this->getStageStatistics(iter.first);
+            for (unsigned int i = 0; i < statistics.size(); i++) {
+                UNI_INFO_LOG("graph %s stage %u(%s): tasks %u, queue depth avg %.2f max %u, wait "
+                             "%.3f ms, run %.3f ms\n",
+                    iter.first.c_str(), i, statistics[i].name.c_str(), statistics[i].tasks,
+                    statistics[i].avgDepth, statistics[i].maxDepth, statistics[i].avgWaitTime,
+                    statistics[i].avgRunTime);
+            }
+        }
         UNI_DEBUG_LOG("schedule exit end\n");
         return 0;
     }
@@ -132,6 +194,19 @@ public:
                             "deprecated\n");
             return 1;
         }
+        if (this->pipelines.find(task->graphPath) != this->pipelines.end()) {
+            PipelineItem item;
+            item.task = task;
+            for (auto iter : task->data) {
+                item.names.insert(iter.first);
+            }
+            if (!this->pushStage(this->pipelines[task->graphPath].stages[0], item)) {
+                UNI_WARNING_LOG("schedule enqueue task failed because schedule has end\n");
+                return 1;
+            }
+            UNI_DEBUG_LOG("schedule enqueue task end\n");
+            return 0;
+        }
         if (pthread_mutex_lock(&(this->taskQueueLock)) != 0) {
             UNI_WARNING_LOG("schedule enqueue task failed because of can not acquire task queue "
                             "lock\n");
@@ -141,7 +216,7 @@ public:
             UNI_WARNING_LOG("schedule enqueue task failed because schedule has end\n");
             return 1;
         }
-        this->taskQueue.push(task);
+        this->taskQueue.push_back(task);
         if (pthread_cond_signal(&(this->condition)) != 0) {
             UNI_WARNING_LOG("schedule enqueue task failed because can not find worker\n");
             return 1;
@@ -151,10 +226,169 @@ public:
         return 0;
     }
 
+    /**
+     * @brief coalesce queued tasks of one graph into a single inference, must be set before init
+     *        so that the graph is prepared for the largest batch. init turns batching off if a
+     *        graph input or output has no outermost dimension of 1 to stack the tasks along.
+     * @param  graphPath      predefined flow graph file path
+     * @param  maxBatch       the maximum number of tasks to run together, 1 disables batching
+     * @param  maxWaitUs      the maximum time to wait for more tasks after the first one arrives
+     *
+     * @return
+     */
+    int setBatchPolicy(std::string graphPath, int maxBatch, int maxWaitUs)
+    {
+        if (maxBatch <= 0 || maxWaitUs < 0) {
+            UNI_WARNING_LOG("schedule set batch policy failed because of invalid parameter "
+                            "(max batch %d, max wait %d us)\n",
+                maxBatch, maxWaitUs);
+            return 1;
+        }
+        if (this->threadNum > 0) {
+            UNI_WARNING_LOG("schedule set batch policy failed because schedule has been "
+                            "initialized\n");
+            return 1;
+        }
+        pthread_mutex_lock(&(this->taskQueueLock));
+        BatchPolicy policy = {maxBatch, maxWaitUs};
+        this->batchPolicy[graphPath] = policy;
+        pthread_mutex_unlock(&(this->taskQueueLock));
+        return 0;
+    }
+
+    /**
+     * @brief run each node of a graph on its own threads and pass the tasks from node to node
+     *        through bounded queues, so that different tasks occupy different nodes at the same
+     *        time, must be set before init
+     * @param  graphPath      predefined flow graph file path
+     * @param  queueDepth     the maximum number of tasks waiting in front of each node
+     * @param  stageThreads   the number of threads running each node
+     *
+     * @return
+     */
+    int setPipeline(std::string graphPath, int queueDepth, int stageThreads)
+    {
+        if (queueDepth <= 0 || stageThreads <= 0) {
+            UNI_WARNING_LOG("schedule set pipeline failed because of invalid parameter (queue "
+                            "depth %d, stage threads %d)\n",
+                queueDepth, stageThreads);
+            return 1;
+        }
+        if (this->threadNum > 0) {
+            UNI_WARNING_LOG("schedule set pipeline failed because schedule has been "
+                            "initialized\n");
+            return 1;
+        }
+        this->pipelines[graphPath].queueDepth = queueDepth;
+        this->pipelines[graphPath].stageThreads = stageThreads;
+        return 0;
+    }
+
+    /**
+     * @brief get the queue and latency statistics of a pipelined graph
+     * @param  graphPath      predefined flow graph file path
+     *
+     * @return statistics: one item per node in running order
+     */
+    std::vector<StageStatistics> getStageStatistics(std::string graphPath)
+    {
+        std::vector<StageStatistics> statistics;
+        if (this->pipelines.find(graphPath) == this->pipelines.end()) {
+            return statistics;
+        }
+        for (auto &stage : this->pipelines[graphPath].stages) {
+            StageStatistics item;
+            pthread_mutex_lock(&(stage.lock));
+            item.name = stage.name;
+            item.tasks = stage.tasks;
+            item.maxDepth = stage.maxDepth;
+            item.avgDepth = (stage.arrivals > 0) ? stage.depthSum / stage.arrivals : 0;
+            item.avgWaitTime = (stage.tasks > 0) ? stage.waitTime / stage.tasks : 0;
+            item.avgRunTime = (stage.tasks > 0) ? stage.runTime / stage.tasks : 0;
+            pthread_mutex_unlock(&(stage.lock));
+            statistics.push_back(item);
+        }
+        return statistics;
+    }
+
+    /**
+     * @brief wait until at least num of the enqueued tasks have been processed
+     * @param  tasks          enqueued tasks
+     * @param  num            the number of finished tasks to wait for, 0 only queries the status
+     *
+     * @return finished: whether each task has been processed
+     */
+    std::vector<bool> wait(std::vector<Task *> tasks, unsigned int num)
+    {
+        std::vector<bool> finished(tasks.size());
+        pthread_mutex_lock(&(this->taskStatusLock));
+        for (;;) {
+            unsigned int count = 0;
+            for (unsigned int i = 0; i < tasks.size(); i++) {
+                finished[i] = (tasks[i]->status == TASK_END);
+                count += finished[i];
+            }
+            if (count >= num) {
+                break;
+            }
+            pthread_cond_wait(&(this->taskStatusCondition), &(this->taskStatusLock));
+        }
+        pthread_mutex_unlock(&(this->taskStatusLock));
+        return finished;
+    }
+
 private:
+    struct BatchPolicy {
+        int maxBatch;
+        int maxWaitUs;
+    };
+
+    struct PipelineItem {
+        Task *task;
+        // tensors given by the user, the intermediate ones are dropped after the last node
+        std::set<std::string> names;
+        double time;
+    };
+
+    struct Stage {
+        std::string name;
+        int queueDepth;
+        std::deque<PipelineItem> queue;
+        pthread_mutex_t lock;
+        pthread_cond_t notEmpty;
+        pthread_cond_t notFull;
+        bool stop;
+        unsigned int tasks;
+        unsigned int arrivals;
+        unsigned int maxDepth;
+        double depthSum;
+        double waitTime;
+        double runTime;
+    };
+
+    struct Pipeline {
+        int queueDepth;
+        int stageThreads;
+        std::vector<Stage> stages;
+        // node index of each stage, in topological order
+        std::vector<unsigned int> nodes;
+        std::vector<pthread_t> threads;
+    };
+
+    struct StageWorkerParameter {
+        Schedule *schedule;
+        std::string graphPath;
+        unsigned int stage;
+        int threadId;
+    };
+
     int threadNum;
     pthread_mutex_t taskQueueLock;
-    std::queue<Task *> taskQueue;
+    std::deque<Task *> taskQueue;
+    std::map<std::string, BatchPolicy> batchPolicy;
+    std::map<std::string, Pipeline> pipelines;
+    pthread_mutex_t taskStatusLock;
+    pthread_cond_t taskStatusCondition;
     pthread_cond_t condition;
 #if !defined(__ANDROID_API__) && !defined(__APPLE__)
     pthread_barrier_t barrier;
@@ -169,6 +403,26 @@ private:
     DeviceInfo deviceInfo;
     DataType precision;
 
+    void finish(Task *task)
+    {
+        if (task->callback) {
+            task->callback(task);
+        }
+        pthread_mutex_lock(&(this->taskStatusLock));
+        task->status = TASK_END;
+        pthread_cond_broadcast(&(this->taskStatusCondition));
+        pthread_mutex_unlock(&(this->taskStatusLock));
+    }
+
+    int getMaxBatch(std::string graphPath)
+    {
+        int maxBatch = 1;
+        if (this->batchPolicy.find(graphPath) != this->batchPolicy.end()) {
+            maxBatch = this->batchPolicy[graphPath].maxBatch;
+        }
+        return maxBatch;
+    }
+
     int getThreadId(pthread_t tid)
     {
         for (int i = 0; i < this->threadNum; i++) {
@@ -179,6 +433,315 @@ private:
         return -1;
     }
 
+    // called with task queue lock held, moves queued tasks of the same graph into batch and waits
+    // for late ones until the graph's batch policy is satisfied or times out
+    void collectBatch(std::vector<Task *> &batch)
+    {
+        std::string graphPath = batch[0]->graphPath;
+        if (this->batchPolicy.find(graphPath) == this->batchPolicy.end()) {
+            return;
+        }
+        BatchPolicy policy = this->batchPolicy[graphPath];
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        long nsec = deadline.tv_nsec + (policy.maxWaitUs % 1000000) * 1000L;
+        deadline.tv_sec += policy.maxWaitUs / 1000000 + nsec / 1000000000;
+        deadline.tv_nsec = nsec % 1000000000;
+        bool timeout = false;
+        while ((int)batch.size() < policy.maxBatch) {
+            for (auto iter = this->taskQueue.begin();
+                 iter != this->taskQueue.end() && (int)batch.size() < policy.maxBatch;) {
+                if ((*iter)->graphPath == graphPath) {
+                    batch.push_back(*iter);
+                    iter = this->taskQueue.erase(iter);
+                } else {
+                    iter++;
+                }
+            }
+            if ((int)batch.size() >= policy.maxBatch || this->stop || timeout) {
+                break;
+            }
+            // tasks of other graphs are left to the idle workers
+            if (!(this->taskQueue.empty())) {
+                pthread_cond_signal(&(this->condition));
+            }
+            timeout = (pthread_cond_timedwait(&(this->condition), &(this->taskQueueLock),
+                           &deadline) == ETIMEDOUT);
+        }
+        if (!(this->taskQueue.empty())) {
+            pthread_cond_signal(&(this->condition));
+        }
+        UNI_DEBUG_LOG("schedule collect %d tasks of graph %s\n", (int)batch.size(),
+            graphPath.c_str());
+    }
+
+    // tasks are stacked along the outermost dimension, so every graph input and output needs one
+    // of size 1, checked on a copy of the graph prepared for a single task
+    bool canBatch(std::string graphPath)
+    {
+        Graph<GraphParameter, ComputeNode, DataTensor> graph;
+        graph.init(graphPath);
+        graph.ready(this->precision, this->deviceInfo.affinityPolicy, -1, 1);
+        for (auto iter : graph.getInputOutputDescs()) {
+            TensorDesc desc = iter.second;
+            if (desc.nDims < 2 || desc.dims[desc.nDims - 1] != 1) {
+                UNI_WARNING_LOG("schedule disables batching of graph %s because %s(%s) has no batch "
+                                "outer dimension\n",
+                    graphPath.c_str(), iter.first.c_str(), tensorDesc2Str(desc).c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void runOneByOne(
+        Graph<GraphParameter, ComputeNode, DataTensor> &graph, std::vector<Task *> &batch)
+    {
+        for (U32 i = 0; i < batch.size(); i++) {
+            graph.run(batch[i]->data);
+            this->finish(batch[i]);
+        }
+    }
+
+    static bool stackable(TensorDesc a, TensorDesc b)
+    {
+        if (a.dt != b.dt || a.df != b.df || a.nDims != b.nDims || a.nDims == 0) {
+            return false;
+        }
+        for (U32 i = 0; i < a.nDims; i++) {
+            if (a.dims[i] != b.dims[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // stacks the tasks' tensors along the outermost dimension, runs the graph once (the inference
+    // nodes reready to the new batch) and scatters the graph outputs back to each task
+    void runBatch(Graph<GraphParameter, ComputeNode, DataTensor> &graph, std::vector<Task *> &batch)
+    {
+        U32 num = batch.size();
+        bool batchable = true;
+        for (U32 i = 1; i < num && batchable; i++) {
+            batchable = (batch[i]->data.size() == batch[0]->data.size());
+            for (auto iter : batch[0]->data) {
+                auto other = batch[i]->data.find(iter.first);
+                if (other == batch[i]->data.end() ||
+                    !stackable(iter.second->get_desc(), other->second->get_desc())) {
+                    batchable = false;
+                    break;
+                }
+            }
+        }
+        if (!batchable) {
+            UNI_DEBUG_LOG("schedule run %d tasks one by one because of different shape\n", num);
+            this->runOneByOne(graph, batch);
+            return;
+        }
+
+        std::set<std::string> outputs = graph.getOutputNames();
+        std::map<std::string, std::shared_ptr<DataTensor>> data;
+        for (auto iter : batch[0]->data) {
+            TensorDesc desc = iter.second->get_desc();
+            U32 bytes = tensorNumBytes(desc);
+            desc.dims[desc.nDims - 1] *= num;
+            std::shared_ptr<DataTensor> tensor(new DataTensor());
+            tensor->resize(desc);
+            tensor->alloc();
+            if (outputs.find(iter.first) == outputs.end()) {
+                U8 *dst = (U8 *)((CpuMemory *)tensor->get_memory())->get_ptr();
+                for (U32 i = 0; i < num; i++) {
+                    memcpy(dst + i * bytes,
+                        ((CpuMemory *)batch[i]->data[iter.first]->get_memory())->get_ptr(), bytes);
+                }
+            }
+            data[iter.first] = tensor;
+        }
+        graph.run(data);
+        for (auto iter : data) {
+            TensorDesc desc = iter.second->get_desc();
+            if (outputs.find(iter.first) != outputs.end() &&
+                (desc.nDims == 0 || desc.dims[desc.nDims - 1] % num != 0)) {
+                UNI_WARNING_LOG("schedule can not split graph output %s(%s) into %d tasks, runs "
+                                "them one by one\n",
+                    iter.first.c_str(), tensorDesc2Str(desc).c_str(), num);
+                this->runOneByOne(graph, batch);
+                return;
+            }
+        }
+        for (auto iter : data) {
+            if (outputs.find(iter.first) == outputs.end()) {
+                continue;
+            }
+            TensorDesc desc = iter.second->get_desc();
+            desc.dims[desc.nDims - 1] /= num;
+            U32 bytes = tensorNumBytes(desc);
+            U8 *src = (U8 *)((CpuMemory *)iter.second->get_memory())->get_ptr();
+            for (U32 i = 0; i < num; i++) {
+                std::shared_ptr<DataTensor> tensor = batch[i]->data[iter.first];
+                tensor->resize(desc);
+                tensor->alloc();
+                memcpy(((CpuMemory *)tensor->get_memory())->get_ptr(), src + i * bytes, bytes);
+            }
+        }
+        for (U32 i = 0; i < num; i++) {
+            this->finish(batch[i]);
+        }
+    }
+
+    // creates one stage per node of each pipelined graph and starts the stage threads, the stage
+    // threads are placed on the cores after the worker pool's ones
+    int initPipelines()
+    {
+        int threadId = 0;
+        for (auto iter = this->pipelines.begin(); iter != this->pipelines.end();) {
+            std::string graphPath = iter->first;
+            Pipeline &pipeline = iter->second;
+            if (this->graph.find(graphPath) == this->graph.end()) {
+#ifdef _USE_WEIGHT_SHARE
+                UNI_WARNING_LOG("schedule can not pipeline %s because it is not in flow\n",
+                    graphPath.c_str());
+                iter = this->pipelines.erase(iter);
+                continue;
+#else
+                this->graph[graphPath].init(graphPath);
+#endif
+            }
+            if (this->graph[graphPath].getTopologicalOrder(&(pipeline.nodes)) != SUCCESS) {
+                UNI_WARNING_LOG("schedule can not pipeline %s, run it by worker pool\n",
+                    graphPath.c_str());
+                iter = this->pipelines.erase(iter);
+                continue;
+            }
+            if (this->batchPolicy.find(graphPath) != this->batchPolicy.end()) {
+                UNI_WARNING_LOG("schedule ignores batch policy of pipelined graph %s\n",
+                    graphPath.c_str());
+            }
+            pipeline.stages.resize(pipeline.nodes.size());
+            for (unsigned int i = 0; i < pipeline.stages.size(); i++) {
+                Stage &stage = pipeline.stages[i];
+                stage.name = this->graph[graphPath].getNodeName(pipeline.nodes[i]);
+                stage.queueDepth = pipeline.queueDepth;
+                pthread_mutex_init(&(stage.lock), NULL);
+                pthread_cond_init(&(stage.notEmpty), NULL);
+                pthread_cond_init(&(stage.notFull), NULL);
+                stage.stop = false;
+                stage.tasks = stage.arrivals = stage.maxDepth = 0;
+                stage.depthSum = stage.waitTime = stage.runTime = 0;
+            }
+            for (unsigned int i = 0; i < pipeline.stages.size(); i++) {
+                for (int j = 0; j < pipeline.stageThreads; j++, threadId++) {
+                    StageWorkerParameter *parameter =
+                        new StageWorkerParameter({this, graphPath, i, threadId});
+                    pthread_t thread;
+                    if (pthread_create(&thread, NULL, stageWorker, parameter) != 0) {
+                        delete parameter;
+                        return 1;
+                    }
+                    pipeline.threads.push_back(thread);
+                }
+            }
+            iter++;
+        }
+        return 0;
+    }
+
+    // blocks while the stage's queue is full, returns false once the schedule has end
+    bool pushStage(Stage &stage, PipelineItem &item)
+    {
+        pthread_mutex_lock(&(stage.lock));
+        while ((int)stage.queue.size() >= stage.queueDepth && !stage.stop) {
+            pthread_cond_wait(&(stage.notFull), &(stage.lock));
+        }
+        if (stage.stop) {
+            pthread_mutex_unlock(&(stage.lock));
+            return false;
+        }
+        item.time = ut_time_ms();
+        stage.queue.push_back(item);
+        stage.arrivals++;
+        stage.depthSum += stage.queue.size();
+        stage.maxDepth = UNI_MAX(stage.maxDepth, (unsigned int)stage.queue.size());
+        pthread_cond_signal(&(stage.notEmpty));
+        pthread_mutex_unlock(&(stage.lock));
+        return true;
+    }
+
+    // blocks while the stage's queue is empty, returns false once the schedule has end and the
+    // queue has been drained
+    bool popStage(Stage &stage, PipelineItem &item)
+    {
+        pthread_mutex_lock(&(stage.lock));
+        while (stage.queue.empty() && !stage.stop) {
+            pthread_cond_wait(&(stage.notEmpty), &(stage.lock));
+        }
+        if (stage.queue.empty()) {
+            pthread_mutex_unlock(&(stage.lock));
+            return false;
+        }
+        item = stage.queue.front();
+        stage.queue.pop_front();
+        stage.waitTime += ut_time_ms() - item.time;
+        pthread_cond_signal(&(stage.notFull));
+        pthread_mutex_unlock(&(stage.lock));
+        return true;
+    }
+
+    static void *stageWorker(void *_parameter)
+    {
+        StageWorkerParameter *parameter = reinterpret_cast<StageWorkerParameter *>(_parameter);
+        Schedule *schedule = parameter->schedule;
+        std::string graphPath = parameter->graphPath;
+        unsigned int stageId = parameter->stage;
+        int threadId = parameter->threadId;
+        delete parameter;
+        UNI_DEBUG_LOG(
+            "graph %s stage(%u) worker(%d) begin\n", graphPath.c_str(), stageId, threadId);
+        Pipeline &pipeline = schedule->pipelines[graphPath];
+        Stage &stage = pipeline.stages[stageId];
+        // the stage only builds its own node
+#ifdef _USE_WEIGHT_SHARE
+        Graph<GraphParameter, ComputeNode, DataTensor> graph =
+            schedule->graph[graphPath].cloneNode(pipeline.nodes[stageId]);
+#else
+        Graph<GraphParameter, ComputeNode, DataTensor> graph;
+        graph.init(graphPath);
+        graph.readyNode(
+            pipeline.nodes[stageId], schedule->precision, schedule->deviceInfo.affinityPolicy, -1);
+#endif
+#ifndef _USE_OPENMP
+        int cpuId = (schedule->threadNum + threadId) % schedule->deviceInfo.cpuNum;
+        if (schedule->deviceInfo.affinityPolicy == AFFINITY_CPU_HIGH_PERFORMANCE) {
+            cpuId = schedule->deviceInfo.cpuNum - 1 - cpuId;
+        }
+        graph.setRuntime(cpuId, schedule->deviceInfo.archs[cpuId]);
+#endif
+        PipelineItem item;
+        while (schedule->popStage(stage, item)) {
+            double start = ut_time_ms();
+            graph.runNode(0, item.task->data);
+            double time = ut_time_ms() - start;
+            pthread_mutex_lock(&(stage.lock));
+            stage.tasks++;
+            stage.runTime += time;
+            pthread_mutex_unlock(&(stage.lock));
+            if (stageId + 1 < pipeline.stages.size() &&
+                schedule->pushStage(pipeline.stages[stageId + 1], item)) {
+                continue;
+            }
+            for (auto iter = item.task->data.begin(); iter != item.task->data.end();) {
+                if (item.names.find(iter->first) == item.names.end()) {
+                    iter = item.task->data.erase(iter);
+                } else {
+                    iter++;
+                }
+            }
+            schedule->finish(item.task);
+        }
+        UNI_DEBUG_LOG("graph %s stage(%u) worker end\n", graphPath.c_str(), stageId);
+        return NULL;
+    }
+
     static void *worker(void *_schedule)
     {
         Schedule *schedule = reinterpret_cast<Schedule *>(_schedule);
@@ -191,8 +754,9 @@ private:
             gpuId = 0;
             for (unsigned int i = 0; i < schedule->graphPath.size(); i++) {
                 threadPrivateGraph[schedule->graphPath[i]].init(schedule->graphPath[i]);
-                threadPrivateGraph[schedule->graphPath[i]].ready(
-                    schedule->precision, schedule->deviceInfo.affinityPolicy, gpuId);
+                threadPrivateGraph[schedule->graphPath[i]].ready(schedule->precision,
+                    schedule->deviceInfo.affinityPolicy, gpuId,
+                    schedule->getMaxBatch(schedule->graphPath[i]));
             }
         }
         if (gpuId < 0) {
@@ -232,8 +796,9 @@ private:
 #else
         for (unsigned int i = 0; i < schedule->graphPath.size(); i++) {
             threadPrivateGraph[schedule->graphPath[i]].init(schedule->graphPath[i]);
-            threadPrivateGraph[schedule->graphPath[i]].ready(
-                schedule->precision, schedule->deviceInfo.affinityPolicy, -1);
+            threadPrivateGraph[schedule->graphPath[i]].ready(schedule->precision,
+                schedule->deviceInfo.affinityPolicy, -1,
+                schedule->getMaxBatch(schedule->graphPath[i]));
 #ifndef _USE_OPENMP
             threadPrivateGraph[schedule->graphPath[i]].setRuntime(6, ARM_A76);
 #endif
@@ -249,15 +814,18 @@ private:
                 break;
             }
 
-            Task *task = nullptr;
+            std::vector<Task *> batch;
             if (!(schedule->taskQueue.empty())) {
-                task = schedule->taskQueue.front();
-                schedule->taskQueue.pop();
+                batch.push_back(schedule->taskQueue.front());
+                schedule->taskQueue.pop_front();
+                schedule->collectBatch(batch);
             }
             pthread_mutex_unlock(&(schedule->taskQueueLock));
-            if (task != nullptr) {
-                threadPrivateGraph[task->graphPath].run(task->data);
-                task->status = TASK_END;
+            if (batch.size() > 1) {
+                schedule->runBatch(threadPrivateGraph[batch[0]->graphPath], batch);
+            } else if (batch.size() == 1) {
+                threadPrivateGraph[batch[0]->graphPath].run(batch[0]->data);
+                schedule->finish(batch[0]);
             }
         }
 
@@ -18,7 +18,8 @@
 #define _USE_CPU
 #endif
 #define IS_GENERAL(arch) (arch == CPU_GENERAL)
-#define IS_X86_AVX512(arch) (arch == X86_AVX512)
+#define IS_X86_AVX512_VNNI(arch) (arch == X86_AVX512_VNNI)
+#define IS_X86_AVX512(arch) ((arch == X86_AVX512) || IS_X86_AVX512_VNNI(arch))
 #define IS_X86_AVX2(arch) ((arch == X86_AVX2) || IS_X86_AVX512(arch))
 #define IS_X86(arch) (IS_X86_AVX2(arch) || IS_X86_AVX512(arch))
 #define IS_ARM_V7(arch) (arch == ARM_V7)
@@ -48,19 +49,23 @@ typedef enum {
     ARM_A76 = 6,
     QUALCOMM = 7,
     X86_AVX2 = 8,
-    X86_AVX512 = 9
+    X86_AVX512 = 9,
+    X86_AVX512_VNNI = 10
 } Arch;
 
 inline const char *const *ArchName()
 {
     static const char *const names[] = {"UNKNOWN", "SERIAL", "MALI", "ARM_V7", "ARM_V8",
-        "ARM_V8.2_LITTLE", "ARM_V8.2_BIG", "QUALCOMM", "X86_AVX2", "X86_AVX512"};
+        "ARM_V8.2_LITTLE", "ARM_V8.2_BIG", "QUALCOMM", "X86_AVX2", "X86_AVX512",
+        "X86_AVX512_VNNI"};
     return names;
 }
 
 typedef struct {
     Arch arch;
     void *archPara;
+    // parallel threads num of CPU kernels, 0 means the process-wide setting is used
+    int numThreads;
 } ArchInfo;
 typedef ArchInfo *ArchInfo_t;
 #ifdef __cplusplus
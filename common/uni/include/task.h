@@ -25,6 +25,7 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <functional>
 #include <iostream>
 #include <sstream>
 
@@ -85,6 +86,7 @@ public:
     Task(Task *task)
     {
         this->set(task->id, task->graphPath, task->data, task->status);
+        this->callback = task->callback;
     }
 
     /**
@@ -126,5 +128,7 @@ public:
     std::string graphPath;
     /** graph data */
     std::map<std::string, std::shared_ptr<Tensor>> data;
+    /** optional, invoked by the worker thread after processing and before the task is marked end */
+    std::function<void(Task *)> callback;
 };
 #endif  // UNI_INCLUDE_TASK_H_
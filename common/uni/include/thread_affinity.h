@@ -41,7 +41,42 @@ const int CPU_MAX_NUMBER = 128;
 #else
 #define OMP_MAX_NUM_THREADS 1
 #endif
-extern int OMP_NUM_THREADS;
+// process-wide parallel threads num, set by set_cpu_num_threads
+extern int OMP_GLOBAL_NUM_THREADS;
+// parallel threads num bound to the calling thread, 0 means OMP_GLOBAL_NUM_THREADS is used
+extern thread_local int OMP_LOCAL_NUM_THREADS;
+
+inline int &get_omp_num_threads()
+{
+    return (OMP_LOCAL_NUM_THREADS > 0) ? OMP_LOCAL_NUM_THREADS : OMP_GLOBAL_NUM_THREADS;
+}
+#define OMP_NUM_THREADS get_omp_num_threads()
+
+// Binds a parallel threads num to the calling thread while it is alive, so that kernels
+// called from this thread neither read nor modify the process-wide setting.
+class ThreadContextGuard {
+public:
+    explicit ThreadContextGuard(int numThreads)
+    {
+        this->previous = OMP_LOCAL_NUM_THREADS;
+        if (numThreads > 0) {
+            int maxThreads = OMP_MAX_NUM_THREADS;
+            OMP_LOCAL_NUM_THREADS = (numThreads > maxThreads) ? maxThreads : numThreads;
+        }
+    }
+
+    explicit ThreadContextGuard(const ArchInfo *archInfo)
+        : ThreadContextGuard((archInfo == nullptr) ? 0 : archInfo->numThreads)
+    {}
+
+    ~ThreadContextGuard()
+    {
+        OMP_LOCAL_NUM_THREADS = this->previous;
+    }
+
+private:
+    int previous;
+};
 
 typedef enum {
     AFFINITY_CPU_LOW_POWER = 0,
@@ -100,6 +135,40 @@ inline int get_cpus_num()
     return cpuNum;
 }
 
+#ifdef _USE_X86
+// best x86 kernel set of this process, an ISA is only used if the OS also saves its registers
+inline Arch get_x86_arch()
+{
+    static const Arch arch = []() {
+        U32 data[4] = {};
+        const U32 &ebx = data[1];
+        const U32 &ecx = data[2];
+        __cpuid(data, 0, 0);
+        U32 maxLeaf = data[0];
+        __cpuid(data, 1, 0);
+        if (maxLeaf < 7 || !(ecx & (1U << 27)) || !(ecx & (1U << 28)) || !(ecx & (1U << 12))) {
+            return CPU_GENERAL;
+        }
+        U32 xcr0, xcr0High;
+        __asm__ __volatile__("xgetbv\n" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+        // xmm/ymm state, then opmask/zmm state
+        bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+        bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+        __cpuid(data, 7, 0);
+        if (!ymmEnabled || !(ebx & (1U << 5))) {
+            return CPU_GENERAL;
+        }
+        // avx512f, avx512dq, avx512bw and avx512vl
+        const U32 avx512 = (1U << 16) | (1U << 17) | (1U << 30) | (1U << 31);
+        if (!zmmEnabled || (ebx & avx512) != avx512) {
+            return X86_AVX2;
+        }
+        return (ecx & (1U << 11)) ? X86_AVX512_VNNI : X86_AVX512;
+    }();
+    return arch;
+}
+#endif
+
 inline void get_cpus_arch(Arch *archs, int cpuNum)
 {
 #ifdef __APPLE__
@@ -113,47 +182,8 @@ inline void get_cpus_arch(Arch *archs, int cpuNum)
 #ifdef _USE_X86
     _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
     _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
-    U32 data[4] = {};
-    const U32 &ebx = data[1];
-    const U32 &ecx = data[2];
-
-    const U32 osxsave = 1U << 0;
-    const U32 avx = 1U << 1;
-    const U32 fma = 1U << 2;
-    const U32 avx2_fma = 1U << 3;
-    const U32 avx512f = 1U << 4;
-    const U32 avx512_vnni = 1U << 5;
-
-    U32 cpuArch = 0;
-    __cpuid(data, 0, 0);
-    __cpuid(data, 1, 0);
-    if (ecx & (1U << 27)) {
-        cpuArch |= osxsave;
-    }
-    if (cpuArch & osxsave) {
-        if (ecx & (1U << 28)) {
-            cpuArch |= avx;
-        }
-        if (ecx & (1U << 12)) {
-            cpuArch |= fma;
-        }
-        __cpuid(data, 7, 0);
-        if ((cpuArch & avx) && (ebx & (1U << 5))) {
-            cpuArch |= avx2_fma;
-        }
-        if (ebx & (1U << 16)) {
-            cpuArch |= avx512f;
-        }
-        if ((cpuArch & avx512f) && (ebx & (1U << 11))) {
-            cpuArch |= avx512_vnni;
-        }
-    }
-
-    if (cpuArch & avx512_vnni) {
-        archs[0] = X86_AVX512;
-    } else if (cpuArch & avx2_fma) {
-        archs[0] = X86_AVX2;
-    } else {
+    archs[0] = get_x86_arch();
+    if (archs[0] == CPU_GENERAL) {
         UNI_WARNING_LOG("The least arch AVX2-FMA is not available, use general implementation.\n");
     }
 #endif
@@ -561,6 +591,6 @@ inline void set_cpu_num_threads(int threadNum)
     if (threadNum > OMP_MAX_NUM_THREADS) {
         threadNum = OMP_MAX_NUM_THREADS;
     }
-    OMP_NUM_THREADS = threadNum;
+    OMP_GLOBAL_NUM_THREADS = threadNum;
 }
 #endif
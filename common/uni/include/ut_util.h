@@ -21,19 +21,20 @@
 #include "error.h"
 #include "data_type.h"
 #include "profiling.h"
+#include "thread_affinity.h"
 
 #if defined(_USE_NEON)
 const Arch UT_ARCH = ARM_A76;
 const Arch UT_CPU_ARCH = ARM_A76;
 #elif defined(_USE_X86)
-const Arch UT_ARCH = X86_AVX512;
-const Arch UT_CPU_ARCH = X86_AVX512;
+const Arch UT_ARCH = get_x86_arch();
+const Arch UT_CPU_ARCH = get_x86_arch();
 #else
 const Arch UT_ARCH = CPU_GENERAL;
 const Arch UT_CPU_ARCH = CPU_GENERAL;
 #endif
-static ArchInfo UT_CPU_ARCHINFO = {UT_ARCH, NULL};
-static ArchInfo UT_SERIAL_ARCHINFO = {CPU_GENERAL, NULL};
+static ArchInfo UT_CPU_ARCHINFO = {UT_ARCH, NULL, 0};
+static ArchInfo UT_SERIAL_ARCHINFO = {CPU_GENERAL, NULL, 0};
 
 // whether to check right
 const int UT_CHECK = 1;
@@ -172,4 +172,26 @@ inline I32 _mm256_hmax_epu32(__m256i x)
     max = _mm_max_epu32(low, high);
     return _mm_cvtsi128_si32(max);
 }
+
+// acc += 4-byte dot products of u8 a and s8 b, like vpdpbusd without saturation;
+// exact while every pair a0 * b0 + a1 * b1 stays inside int16
+inline __m256i _mm256_dpbusd_avx2_epi32(__m256i acc, __m256i a, __m256i b)
+{
+    __m256i s16 = _mm256_maddubs_epi16(a, b);
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(s16, _mm256_set1_epi16(1)));
+}
+
+// acc += 4-byte dot products of s8 a and s8 b
+inline __m256i _mm256_dpbssd_avx2_epi32(__m256i acc, __m256i a, __m256i b)
+{
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, _mm256_set1_epi8(-128))) == 0) {
+        return _mm256_dpbusd_avx2_epi32(acc, _mm256_abs_epi8(a), _mm256_sign_epi8(b, a));
+    }
+    // -128 in b can not be negated in s8, widen both operands to s16 instead
+    __m256i low = _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm256_castsi256_si128(a)),
+        _mm256_cvtepi8_epi16(_mm256_castsi256_si128(b)));
+    __m256i high = _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm256_extracti128_si256(a, 1)),
+        _mm256_cvtepi8_epi16(_mm256_extracti128_si256(b, 1)));
+    return _mm256_add_epi32(acc, _mm256_permute4x64_epi64(_mm256_hadd_epi32(low, high), 0xd8));
+}
 #endif  // _H_X86_AVX2_EXPAND
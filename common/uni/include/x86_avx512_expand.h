@@ -0,0 +1,116 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _H_X86_AVX512_EXPAND
+#define _H_X86_AVX512_EXPAND
+
+#include <immintrin.h>
+
+// x86 sources are compiled for AVX2-FMA, code between X86_AVX512_BEGIN and X86_AVX512_END is
+// built for AVX-512 and must only run if get_x86_arch found it. Put it after all includes, so
+// that inline functions and templates from other headers stay on the baseline ISA.
+#ifdef __clang__
+#define X86_AVX512_BEGIN \
+    _Pragma("clang attribute push(__attribute__((target(\"avx512f,avx512dq,avx512bw,avx512vl\"))), apply_to = function)")
+#define X86_AVX512_END _Pragma("clang attribute pop")
+#else
+#define X86_AVX512_BEGIN \
+    _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx512dq,avx512bw,avx512vl\")")
+#define X86_AVX512_END _Pragma("GCC pop_options")
+#endif
+
+// Kernel files listed with x86_isa_variant in CMakeLists.txt are compiled once more per ISA,
+// and that copy is put in namespace avx512 (-D_USE_AVX512), avx512_vnni (-D_USE_AVX512_VNNI)
+// or avx2 (-D_USE_AVX2, AVX2 fallback of the AVX-512 only int8 kernels).
+#if defined(_USE_AVX512_VNNI)
+#define X86_ISA_NAMESPACE_BEGIN namespace avx512_vnni {
+#define X86_ISA_NAMESPACE_END }
+#elif defined(_USE_AVX512)
+#define X86_ISA_NAMESPACE_BEGIN namespace avx512 {
+#define X86_ISA_NAMESPACE_END }
+#elif defined(_USE_AVX2)
+#define X86_ISA_NAMESPACE_BEGIN namespace avx2 {
+#define X86_ISA_NAMESPACE_END }
+#else
+#define X86_ISA_NAMESPACE_BEGIN
+#define X86_ISA_NAMESPACE_END
+#endif
+
+// AVX-512 copy of AVX2 kernels
+#ifdef _USE_AVX512
+#define X86_ISA_BEGIN X86_AVX512_BEGIN X86_ISA_NAMESPACE_BEGIN
+#define X86_ISA_END X86_ISA_NAMESPACE_END X86_AVX512_END
+#else
+#define X86_ISA_BEGIN
+#define X86_ISA_END
+#endif
+
+// int8 kernels are written for AVX-512, their AVX2 copy stays on the baseline ISA
+#ifdef _USE_AVX2
+#define X86_INT8_BEGIN
+#define X86_INT8_END
+#else
+#define X86_INT8_BEGIN X86_AVX512_BEGIN
+#define X86_INT8_END X86_AVX512_END
+#endif
+
+X86_AVX512_BEGIN
+
+// same polynomial as _mm256_exp_ps, 16 lanes
+inline __m512 _mm512_exp_ps(__m512 x)
+{
+    // the max and min x in exp(x) in 32-bit float range
+    __m512 max_upper_bound = _mm512_set1_ps(88.3762626647949f);
+    __m512 min_lower_bound = _mm512_set1_ps(-87.3365447504019f);
+
+    x = _mm512_min_ps(x, max_upper_bound);
+    x = _mm512_max_ps(x, min_lower_bound);
+
+    __m512 t, f, p, r;
+    __m512i i, j;
+
+    const __m512 l2e = _mm512_set1_ps(1.442695041f);    /* log2(e) */
+    const __m512 l2h = _mm512_set1_ps(-6.93145752e-1f); /* -log(2)_hi */
+    const __m512 l2l = _mm512_set1_ps(-1.42860677e-6f); /* -log(2)_lo */
+    const __m512 c0 = _mm512_set1_ps(0.008301110f);
+    const __m512 c1 = _mm512_set1_ps(0.041906696f);
+    const __m512 c2 = _mm512_set1_ps(0.166674897f);
+    const __m512 c3 = _mm512_set1_ps(0.499990642f);
+    const __m512 c4 = _mm512_set1_ps(0.999999762f);
+    const __m512 c5 = _mm512_set1_ps(1.000000000f);
+
+    /* exp(x) = 2^i * e^f; i = rint (log2(e) * x), f = x - log(2) * i */
+    t = _mm512_mul_ps(x, l2e); /* t = log2(e) * x */
+    r = _mm512_roundscale_ps(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); /* r = rint (t) */
+
+    f = _mm512_fmadd_ps(r, l2h, x); /* x - log(2)_hi * r */
+    f = _mm512_fmadd_ps(r, l2l, f); /* f = x - log(2)_hi * r - log(2)_lo * r */
+
+    i = _mm512_cvtps_epi32(r); /* i = (int)rint(t) */
+
+    /* p ~= exp (f), -log(2)/2 <= f <= log(2)/2 */
+    p = c0;
+    p = _mm512_fmadd_ps(p, f, c1);
+    p = _mm512_fmadd_ps(p, f, c2);
+    p = _mm512_fmadd_ps(p, f, c3);
+    p = _mm512_fmadd_ps(p, f, c4);
+    p = _mm512_fmadd_ps(p, f, c5);
+    /* exp(x) = 2^i * p */
+    j = _mm512_slli_epi32(i, 23);
+    r = _mm512_castsi512_ps(_mm512_add_epi32(j, _mm512_castps_si512(p)));
+
+    return r;
+}
+X86_AVX512_END
+#endif  // _H_X86_AVX512_EXPAND
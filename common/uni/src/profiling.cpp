@@ -20,7 +20,8 @@
 #include "error.h"
 #include "thread_affinity.h"
 
-int OMP_NUM_THREADS = OMP_MAX_NUM_THREADS;
+int OMP_GLOBAL_NUM_THREADS = OMP_MAX_NUM_THREADS;
+thread_local int OMP_LOCAL_NUM_THREADS = 0;
 
 #ifdef _THREAD_SAFE
 pthread_mutex_t uniThreadMutex = PTHREAD_MUTEX_INITIALIZER;
@@ -35,6 +35,29 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
     const F32 *scale,
     Arch arch);
 
+// C[b] = A[b] x B[b] + C[b] for b < batch, matrix b of A, B and C begins at b * stride elements,
+// and stride 0 shares that matrix by all products. Floating point data types only.
+EE matrix_matrix_multiply_batch_tmp_bytes(U32 batch,
+    TensorDesc matrixADesc,
+    TensorDesc matrixBDesc,
+    U32 strideB,
+    U32 *bytes,
+    Arch arch);
+
+EE matrix_matrix_multiply_batch(U32 batch,
+    TensorDesc matrixADesc,
+    const void *matrixA,
+    U32 strideA,
+    TensorDesc matrixBDesc,
+    const void *matrixB,
+    U32 strideB,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixC,
+    U32 strideC,
+    Arch arch);
+
 EE matrix_vector_multiply_tmp_bytes(TensorDesc matrixDesc, TensorDesc vectorDesc, U32 *bytes, Arch);
 
 EE matrix_vector_multiply(TensorDesc matrixDesc,
@@ -31,13 +31,18 @@ EE mvm_x86(U32 row,
     const void *vector,
     void *result,
     void *offsetCBias,
-    const F32 *scale);
+    const F32 *scale,
+    Arch arch);
 
 EE matrix_matrix_multiply_tmp_bytes_x86(
     U32 matrixA_M, U32 matrixA_K, U32 matrixB_K, U32 matrixB_N, DataType dt, U32 *bytes);
 
-EE matrix_matrix_multiply_transform_rhs_x86(
-    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst, void *offsetCBias);
+EE matrix_matrix_multiply_transform_rhs_x86(TensorDesc desc,
+    const void *src,
+    TensorDesc *descTran,
+    void *dst,
+    void *offsetCBias,
+    Arch arch);
 
 EE mmm_x86(U32 matrixC_N,
     U32 matrixC_M,
@@ -48,6 +53,34 @@ EE mmm_x86(U32 matrixC_N,
     const void *matrixBData,
     void *tmp,
     void *matrixCData,
-    const F32 *scale);
+    const F32 *scale,
+    Arch arch);
+
+// returns NOT_SUPPORTED if there is no batched kernel for dt on arch
+EE matrix_matrix_multiply_batch_tmp_bytes_x86(U32 batch,
+    U32 matrixA_M,
+    U32 matrixA_K,
+    U32 matrixB_N,
+    U32 batchB,
+    bool transformB,
+    DataType dt,
+    U32 *bytes,
+    Arch arch);
+
+EE mmm_batch_x86(U32 batch,
+    U32 matrixC_N,
+    U32 matrixC_M,
+    U32 matrixA_K,
+    DataType dt,
+    DataFormat matrixADataFormat,
+    const void *matrixAData,
+    U32 strideA,
+    TensorDesc matrixBDesc,
+    const void *matrixBData,
+    U32 strideB,
+    void *tmp,
+    void *matrixCData,
+    U32 strideC,
+    Arch arch);
 
 #endif
@@ -52,6 +52,18 @@ inline EE mvm_avx2_fp32(U32 row, U32 col, DataFormat df, F32 *matrix, F32 *vecto
     return ret;
 }
 
+void mvm_pack_avx512_fp32(U32 row, U32 col, F32 *matrix, F32 *vector, F32 *result);
+
+// DF_NKN16 matrix is packed the same way for AVX2 and AVX-512, other formats use AVX2 kernels
+inline EE mvm_avx512_fp32(U32 row, U32 col, DataFormat df, F32 *matrix, F32 *vector, F32 *result)
+{
+    if (df == DF_NKN16) {
+        mvm_pack_avx512_fp32(row, col, matrix, vector, result);
+        return SUCCESS;
+    }
+    return mvm_avx2_fp32(row, col, df, matrix, vector, result);
+}
+
 void matrix_matrix_multiply_tmp_bytes_fp32(
     U32 row1, U32 col1, U32 row2, U32 col2, DataType dt, U32 *bytes);
 
@@ -68,6 +80,37 @@ EE mmm_avx2_fp32(int M,
     F32 *tmp,
     F32 *result);
 
+// AVX-512 kernels read matrix B in 48 columns wide panels, so it is transformed by the functions
+// below when IS_X86_AVX512(arch)
+EE matrix_matrix_multiply_transform_rhsN_avx512_fp32(TensorDesc desc, F32 *src, F32 *dst);
+
+EE matrix_matrix_multiply_transform_rhsT_avx512_fp32(TensorDesc desc, F32 *src, F32 *dst);
+
+EE mmm_avx512_fp32(int M,
+    int N,
+    int K,
+    DataFormat matrixADataFormat,
+    F32 *matrix1,
+    F32 *matrix2,
+    F32 *tmp,
+    F32 *result);
+
+// C[b] += A[b] x B[b] for b < batch, A and C of product b begin at b * strideA and
+// b * strideC, and matrix2[b] is B of product b transformed for AVX-512
+EE mmm_batch_avx512_fp32(U32 batch,
+    int N,
+    int M,
+    int K,
+    DataFormat matrix1Df,
+    F32 *matrix1,
+    U32 strideA,
+    F32 *const *matrix2,
+    F32 *tmp,
+    F32 *result,
+    U32 strideC);
+
+U32 mmm_batch_avx512_fp32_tmp_bytes(U32 batch, U32 M, U32 K);
+
 inline void matrix1_trans(U32 size, U32 blockK, U32 K, F32 *src, F32 *dst)
 {
     U32 remain = size % 4;
@@ -82,14 +125,14 @@ inline void matrix1_trans(U32 size, U32 blockK, U32 K, F32 *src, F32 *dst)
                 _mm_prefetch(src + i + (j + 2) * K + 16, _MM_HINT_NTA);
                 _mm_prefetch(src + i + (j + 3) * K + 16, _MM_HINT_NTA);
             }
-            _mm_store_ps(dst, _mm_i32gather_ps(src + i + j * K, vindex, 4));
+            _mm_storeu_ps(dst, _mm_i32gather_ps(src + i + j * K, vindex, 4));
             dst += 4;
         }
-        for (; j < remain; ++j) {
+        for (j = 0; j < remain; ++j) {
             if (i % 16 == 0) {
                 _mm_prefetch(src + i + (j + size) * K + 16, _MM_HINT_NTA);
             }
-            *(dst++) = *(src + i + j * K);
+            *(dst++) = *(src + i + (j + size) * K);
         }
     }
 }
@@ -0,0 +1,303 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/fp32/blas_fp32.h"
+#include "x86_avx512_expand.h"
+
+#define UNROLL_N 48
+#define UNROLL_M 8
+#define BOLCK_M_DIM 768
+#define BOLCK_K_DIM 384
+#define align_addr(addr, unit) (((uintptr_t)addr + unit - 1) / unit * unit)
+
+X86_AVX512_BEGIN
+
+typedef void (*kernel_func)(
+    U32 bk, F32 *matrixA, F32 *matrixB, U32 ldb, __mmask16 mask, F32 *matrixC, U32 N);
+
+EE matrix_matrix_multiply_transform_rhsN_avx512_fp32(TensorDesc desc, F32 *src, F32 *dst)
+{
+    DataType dt;
+    DataFormat df;
+    U32 N, K, blockSizeK, unrollSizeN;
+    CHECK_STATUS(tensor2dGet(desc, &dt, &df, &K, &N));
+
+    // buffer addr algined to 32
+    F32 *packB = (F32 *)align_addr(dst, 32);
+    for (U32 bk = 0; bk < K; bk += blockSizeK) {
+        blockSizeK = UNI_MIN(BOLCK_K_DIM, K - bk);
+        for (U32 un = 0; un < N; un += unrollSizeN) {
+            unrollSizeN = UNI_MIN(UNROLL_N, N - un);
+            matrix2_trans(unrollSizeN, blockSizeK, N, src + un, packB);
+            packB += unrollSizeN * blockSizeK;
+        }
+        src += blockSizeK * N;
+    }
+    return SUCCESS;
+}
+
+EE matrix_matrix_multiply_transform_rhsT_avx512_fp32(TensorDesc desc, F32 *src, F32 *dst)
+{
+    DataType dt;
+    DataFormat df;
+    U32 N, K, blockSizeK, unrollSizeN;
+    CHECK_STATUS(tensor2dGet(desc, &dt, &df, &N, &K));
+
+    // buffer addr aligned to 32
+    F32 *packB = (F32 *)align_addr(dst, 32);
+    for (U32 bk = 0; bk < K; bk += blockSizeK) {
+        blockSizeK = UNI_MIN(BOLCK_K_DIM, K - bk);
+        for (U32 un = 0; un < N; un += unrollSizeN) {
+            unrollSizeN = UNI_MIN(UNROLL_N, N - un);
+            matrix1_trans(unrollSizeN, blockSizeK, K, src + un * K, packB);
+            packB += unrollSizeN * blockSizeK;
+        }
+        src += blockSizeK;
+    }
+    return SUCCESS;
+}
+
+// one row of the register block, c##i += A[i] * B
+#define MMM_AVX512_ROW_FMA(i)                            \
+    if (M > i) {                                         \
+        __m512 a = _mm512_set1_ps(matrixA[i]);           \
+        for (U32 j = 0; j < NREG; ++j) {                 \
+            c##i[j] = _mm512_fmadd_ps(a, b[j], c##i[j]); \
+        }                                                \
+    }
+
+#define MMM_AVX512_ROW_STORE(i)                                                        \
+    if (M > i) {                                                                       \
+        F32 *curC = matrixC + i * N;                                                   \
+        for (U32 j = 0; j < NREG - 1; ++j) {                                           \
+            __m512 sum = _mm512_add_ps(_mm512_loadu_ps(curC + j * 16), c##i[j]);       \
+            _mm512_storeu_ps(curC + j * 16, sum);                                      \
+        }                                                                              \
+        curC += (NREG - 1) * 16;                                                       \
+        __m512 sum = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, curC), c##i[NREG - 1]); \
+        _mm512_mask_storeu_ps(curC, mask, sum);                                        \
+    }
+
+// C[M x (16 * NREG)] += A * B, A is packed as K x M, B as K x ldb, and the last vector of each
+// row of B and C is masked by mask. Each row has its own accumulator array to keep it in zmm.
+template <U32 M, U32 NREG>
+void mmm_avx512_kernel(
+    U32 bk, F32 *matrixA, F32 *matrixB, U32 ldb, __mmask16 mask, F32 *matrixC, U32 N)
+{
+    __m512 c0[NREG], c1[NREG], c2[NREG], c3[NREG], c4[NREG], c5[NREG], c6[NREG], c7[NREG];
+    for (U32 j = 0; j < NREG; ++j) {
+        c0[j] = c1[j] = c2[j] = c3[j] = c4[j] = c5[j] = c6[j] = c7[j] = _mm512_setzero_ps();
+    }
+    for (U32 k = 0; k < bk; ++k) {
+        __m512 b[NREG];
+        for (U32 j = 0; j < NREG - 1; ++j) {
+            b[j] = _mm512_loadu_ps(matrixB + j * 16);
+        }
+        b[NREG - 1] = _mm512_maskz_loadu_ps(mask, matrixB + (NREG - 1) * 16);
+        MMM_AVX512_ROW_FMA(0);
+        MMM_AVX512_ROW_FMA(1);
+        MMM_AVX512_ROW_FMA(2);
+        MMM_AVX512_ROW_FMA(3);
+        MMM_AVX512_ROW_FMA(4);
+        MMM_AVX512_ROW_FMA(5);
+        MMM_AVX512_ROW_FMA(6);
+        MMM_AVX512_ROW_FMA(7);
+        matrixA += M;
+        matrixB += ldb;
+    }
+    MMM_AVX512_ROW_STORE(0);
+    MMM_AVX512_ROW_STORE(1);
+    MMM_AVX512_ROW_STORE(2);
+    MMM_AVX512_ROW_STORE(3);
+    MMM_AVX512_ROW_STORE(4);
+    MMM_AVX512_ROW_STORE(5);
+    MMM_AVX512_ROW_STORE(6);
+    MMM_AVX512_ROW_STORE(7);
+}
+
+// rows of a M tile are split into 8/4/2/1, which are also the sizes matrix1_trans supports
+inline U32 mmm_avx512_unroll_m(U32 size)
+{
+    return (size >= 8) ? 8 : ((size >= 4) ? 4 : ((size >= 2) ? 2 : 1));
+}
+
+EE mmm_avx512_fp32(
+    int N, int M, int K, DataFormat matrix1Df, F32 *matrix1, F32 *matrix2, F32 *tmp, F32 *result)
+{
+    // buffer addr algined to 32
+    F32 *packA = (F32 *)align_addr(tmp, 32);
+    F32 *packB = (F32 *)align_addr(matrix2, 32);
+    kernel_func kernel[4][3] = {
+        {mmm_avx512_kernel<1, 1>, mmm_avx512_kernel<1, 2>, mmm_avx512_kernel<1, 3>},
+        {mmm_avx512_kernel<2, 1>, mmm_avx512_kernel<2, 2>, mmm_avx512_kernel<2, 3>},
+        {mmm_avx512_kernel<4, 1>, mmm_avx512_kernel<4, 2>, mmm_avx512_kernel<4, 3>},
+        {mmm_avx512_kernel<8, 1>, mmm_avx512_kernel<8, 2>, mmm_avx512_kernel<8, 3>}};
+    U32 kernelMIdx[9] = {0, 0, 1, 1, 2, 2, 2, 2, 3};
+    I32 blockNNum = (N + UNROLL_N - 1) / UNROLL_N;
+
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+    {
+#endif
+        I32 blockSizeM = 0, blockSizeK = 0;
+        for (int k = 0; k < K; k += blockSizeK) {
+            blockSizeK = UNI_MIN(BOLCK_K_DIM, K - k);
+            for (int j = 0; j < M; j += blockSizeM) {
+                blockSizeM = UNI_MIN(BOLCK_M_DIM, M - j);
+                I32 blockMNum = (blockSizeM + UNROLL_M - 1) / UNROLL_M;
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (I32 mIdx = 0; mIdx < blockMNum; ++mIdx) {
+                    I32 mEnd = UNI_MIN(mIdx * UNROLL_M + UNROLL_M, blockSizeM);
+                    U32 unrollSizeM = 0;
+                    for (I32 m = mIdx * UNROLL_M; m < mEnd; m += unrollSizeM) {
+                        unrollSizeM = mmm_avx512_unroll_m(mEnd - m);
+                        F32 *curA = packA + m * blockSizeK;
+                        if (matrix1Df == DF_TRANSPOSE) {
+                            matrix2_trans(
+                                unrollSizeM, blockSizeK, M, matrix1 + (j + m) + k * M, curA);
+                        } else if (matrix1Df == DF_NORMAL) {
+                            matrix1_trans(
+                                unrollSizeM, blockSizeK, K, matrix1 + k + (j + m) * K, curA);
+                        } else if (matrix1Df == DF_NKN8) {
+                            matrix2_trans_c8(
+                                unrollSizeM, blockSizeK, M, matrix1 + (j + m) * 8 + k * M, curA);
+                        }
+                    }
+                }
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (I32 mnIdx = 0; mnIdx < blockNNum * blockMNum; ++mnIdx) {
+                    I32 n = mnIdx / blockMNum * UNROLL_N;
+                    I32 blockSizeN = UNI_MIN(UNROLL_N, N - n);
+                    U32 nreg = (blockSizeN + 15) / 16;
+                    __mmask16 mask = (blockSizeN % 16) ? (1 << (blockSizeN % 16)) - 1 : 0xFFFF;
+                    F32 *curB = packB + k * N + n * blockSizeK;
+
+                    I32 mIdx = mnIdx % blockMNum;
+                    I32 mEnd = UNI_MIN(mIdx * UNROLL_M + UNROLL_M, blockSizeM);
+                    U32 unrollSizeM = 0;
+                    for (I32 m = mIdx * UNROLL_M; m < mEnd; m += unrollSizeM) {
+                        unrollSizeM = mmm_avx512_unroll_m(mEnd - m);
+                        kernel[kernelMIdx[unrollSizeM]][nreg - 1](blockSizeK,
+                            packA + m * blockSizeK, curB, blockSizeN, mask,
+                            result + (m + j) * N + n, N);
+                    }
+                }
+            }
+        }
+#ifdef _USE_OPENMP
+    }
+#endif
+    return SUCCESS;
+}
+
+// All products share the K and M blocking, so one parallel region packs the A tiles of every
+// product for the current block and then spreads the (batch, N, M) tiles over all threads,
+// instead of forking once per product.
+EE mmm_batch_avx512_fp32(U32 batch,
+    int N,
+    int M,
+    int K,
+    DataFormat matrix1Df,
+    F32 *matrix1,
+    U32 strideA,
+    F32 *const *matrix2,
+    F32 *tmp,
+    F32 *result,
+    U32 strideC)
+{
+    F32 *packA = (F32 *)align_addr(tmp, 32);
+    kernel_func kernel[4][3] = {
+        {mmm_avx512_kernel<1, 1>, mmm_avx512_kernel<1, 2>, mmm_avx512_kernel<1, 3>},
+        {mmm_avx512_kernel<2, 1>, mmm_avx512_kernel<2, 2>, mmm_avx512_kernel<2, 3>},
+        {mmm_avx512_kernel<4, 1>, mmm_avx512_kernel<4, 2>, mmm_avx512_kernel<4, 3>},
+        {mmm_avx512_kernel<8, 1>, mmm_avx512_kernel<8, 2>, mmm_avx512_kernel<8, 3>}};
+    U32 kernelMIdx[9] = {0, 0, 1, 1, 2, 2, 2, 2, 3};
+    I32 blockNNum = (N + UNROLL_N - 1) / UNROLL_N;
+    I32 packStride = UNI_MIN(BOLCK_M_DIM, M) * UNI_MIN(BOLCK_K_DIM, K);
+
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+    {
+#endif
+        I32 blockSizeM = 0, blockSizeK = 0;
+        for (int k = 0; k < K; k += blockSizeK) {
+            blockSizeK = UNI_MIN(BOLCK_K_DIM, K - k);
+            for (int j = 0; j < M; j += blockSizeM) {
+                blockSizeM = UNI_MIN(BOLCK_M_DIM, M - j);
+                I32 blockMNum = (blockSizeM + UNROLL_M - 1) / UNROLL_M;
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (I32 bmIdx = 0; bmIdx < (I32)batch * blockMNum; ++bmIdx) {
+                    I32 b = bmIdx / blockMNum;
+                    I32 mIdx = bmIdx % blockMNum;
+                    F32 *curMatrix = matrix1 + b * strideA;
+                    I32 mEnd = UNI_MIN(mIdx * UNROLL_M + UNROLL_M, blockSizeM);
+                    U32 unrollSizeM = 0;
+                    for (I32 m = mIdx * UNROLL_M; m < mEnd; m += unrollSizeM) {
+                        unrollSizeM = mmm_avx512_unroll_m(mEnd - m);
+                        F32 *curA = packA + b * packStride + m * blockSizeK;
+                        if (matrix1Df == DF_TRANSPOSE) {
+                            matrix2_trans(
+                                unrollSizeM, blockSizeK, M, curMatrix + (j + m) + k * M, curA);
+                        } else if (matrix1Df == DF_NORMAL) {
+                            matrix1_trans(
+                                unrollSizeM, blockSizeK, K, curMatrix + k + (j + m) * K, curA);
+                        } else if (matrix1Df == DF_NKN8) {
+                            matrix2_trans_c8(
+                                unrollSizeM, blockSizeK, M, curMatrix + (j + m) * 8 + k * M, curA);
+                        }
+                    }
+                }
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+                for (I32 bmnIdx = 0; bmnIdx < (I32)batch * blockNNum * blockMNum; ++bmnIdx) {
+                    I32 b = bmnIdx / (blockNNum * blockMNum);
+                    I32 mnIdx = bmnIdx % (blockNNum * blockMNum);
+                    I32 n = mnIdx / blockMNum * UNROLL_N;
+                    I32 blockSizeN = UNI_MIN(UNROLL_N, N - n);
+                    U32 nreg = (blockSizeN + 15) / 16;
+                    __mmask16 mask = (blockSizeN % 16) ? (1 << (blockSizeN % 16)) - 1 : 0xFFFF;
+                    F32 *curB = (F32 *)align_addr(matrix2[b], 32) + k * N + n * blockSizeK;
+                    F32 *curC = result + b * strideC;
+
+                    I32 mIdx = mnIdx % blockMNum;
+                    I32 mEnd = UNI_MIN(mIdx * UNROLL_M + UNROLL_M, blockSizeM);
+                    U32 unrollSizeM = 0;
+                    for (I32 m = mIdx * UNROLL_M; m < mEnd; m += unrollSizeM) {
+                        unrollSizeM = mmm_avx512_unroll_m(mEnd - m);
+                        kernel[kernelMIdx[unrollSizeM]][nreg - 1](blockSizeK,
+                            packA + b * packStride + m * blockSizeK, curB, blockSizeN, mask,
+                            curC + (m + j) * N + n, N);
+                    }
+                }
+            }
+        }
+#ifdef _USE_OPENMP
+    }
+#endif
+    return SUCCESS;
+}
+
+// bytes of the packed A tiles used by mmm_batch_avx512_fp32
+U32 mmm_batch_avx512_fp32_tmp_bytes(U32 batch, U32 M, U32 K)
+{
+    return batch * UNI_MIN(BOLCK_M_DIM, M) * UNI_MIN(BOLCK_K_DIM, K) * bytesOf(DT_F32) + 32;
+}
+
+X86_AVX512_END
@@ -0,0 +1,129 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "cpu/x86/fp32/blas_fp32.h"
+#include "x86_avx512_expand.h"
+
+// same blocking as mvm_avx2_pack.cpp, so that both read the same packed matrix
+#define UNROLL_N 64
+#define BOLCK_K_DIM 1024
+
+X86_AVX512_BEGIN
+
+typedef void (*kernel_func)(
+    U32 bk, U32 ldb, __mmask16 mask, F32 *matrix, F32 *vector, F32 *result);
+
+// 16 columns of the matrix, the last vector is masked
+#define MVM_AVX512_LOAD(j, ptr) \
+    ((j == NREG - 1) ? _mm512_maskz_loadu_ps(mask, ptr + j * 16) : _mm512_loadu_ps(ptr + j * 16))
+
+#define MVM_AVX512_FMA(j)                                                         \
+    if (NREG > j) {                                                               \
+        c##j##0 = _mm512_fmadd_ps(a0, MVM_AVX512_LOAD(j, matrix), c##j##0);       \
+        c##j##1 = _mm512_fmadd_ps(a1, MVM_AVX512_LOAD(j, matrix + ldb), c##j##1); \
+    }
+
+#define MVM_AVX512_STORE(j)                                    \
+    if (NREG > j) {                                            \
+        __m512 sum = _mm512_add_ps(c##j##0, c##j##1);          \
+        sum = _mm512_add_ps(sum, MVM_AVX512_LOAD(j, result));  \
+        if (j == NREG - 1) {                                   \
+            _mm512_mask_storeu_ps(result + j * 16, mask, sum); \
+        } else {                                               \
+            _mm512_storeu_ps(result + j * 16, sum);            \
+        }                                                      \
+    }
+
+// result[16 * NREG] += vector * matrix, the matrix is packed as K x ldb. Even and odd k are
+// accumulated separately to hide the latency of FMA.
+template <U32 NREG>
+void mvm_avx512_kernel(U32 bk, U32 ldb, __mmask16 mask, F32 *matrix, F32 *vector, F32 *result)
+{
+    __m512 c00, c01, c10, c11, c20, c21, c30, c31;
+    c00 = c01 = c10 = c11 = c20 = c21 = c30 = c31 = _mm512_setzero_ps();
+    U32 k = 0;
+    for (; k + 1 < bk; k += 2) {
+        __m512 a0 = _mm512_set1_ps(vector[k]);
+        __m512 a1 = _mm512_set1_ps(vector[k + 1]);
+        MVM_AVX512_FMA(0);
+        MVM_AVX512_FMA(1);
+        MVM_AVX512_FMA(2);
+        MVM_AVX512_FMA(3);
+        matrix += ldb * 2;
+    }
+    if (k < bk) {
+        // odd bk, the last row is read twice and the second one is multiplied by 0
+        __m512 a0 = _mm512_set1_ps(vector[k]);
+        __m512 a1 = _mm512_setzero_ps();
+        ldb = 0;
+        MVM_AVX512_FMA(0);
+        MVM_AVX512_FMA(1);
+        MVM_AVX512_FMA(2);
+        MVM_AVX512_FMA(3);
+    }
+    MVM_AVX512_STORE(0);
+    MVM_AVX512_STORE(1);
+    MVM_AVX512_STORE(2);
+    MVM_AVX512_STORE(3);
+}
+
+void mvm_pack_avx512_fp32(U32 numRows, U32 numColumns, F32 *packB, F32 *vector, F32 *result)
+{
+    // Actual layout is NKN64, and vector is K
+    kernel_func kernel[4] = {mvm_avx512_kernel<1>, mvm_avx512_kernel<2>, mvm_avx512_kernel<3>,
+        mvm_avx512_kernel<4>};
+    U32 unrollSize[4] = {8, 16, 32, 64};
+    I32 resN = numRows % 64;
+    I32 blockNum = numRows / 64;
+    I32 edgeblockNSizeArray[6] = {0};
+    for (U32 i = 0; resN > 0; ++i) {
+        U32 value = UNI_MIN(unrollSize[UNI_MIN(resN >> 4, 2)], (U32)resN);
+        edgeblockNSizeArray[i] += value;
+        edgeblockNSizeArray[i + 1] = edgeblockNSizeArray[i];
+        resN -= value;
+        blockNum += 1;
+    }
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+    {
+#endif
+        U32 private_blockKSize = 0;
+        for (U32 bk = 0; bk < numColumns; bk += private_blockKSize) {
+            private_blockKSize = UNI_MIN(numColumns - bk, BOLCK_K_DIM);
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+            for (U32 bIdx = 0; bIdx < (U32)(blockNum); ++bIdx) {
+                U32 bn = bIdx * UNROLL_N;
+                if (bn >= numRows) {
+                    U32 idx = (bn - numRows) / UNROLL_N;
+                    CHECK_REQUIREMENT(idx <= 5);
+                    bn = numRows / UNROLL_N * UNROLL_N + edgeblockNSizeArray[idx];
+                }
+
+                U32 blockNSize = UNI_MIN(numRows - bn, UNROLL_N);
+                if (blockNSize >= 8) {
+                    blockNSize = unrollSize[blockNSize / 16 - (blockNSize >= 48)];
+                }
+                U32 nreg = (blockNSize + 15) / 16;
+                __mmask16 mask = (blockNSize % 16) ? (1 << (blockNSize % 16)) - 1 : 0xFFFF;
+                kernel[nreg - 1](private_blockKSize, blockNSize, mask,
+                    packB + bk * numRows + bn * private_blockKSize, vector + bk, result + bn);
+            }
+        }
+#ifdef _USE_OPENMP
+    }
+#endif
+}
+
+X86_AVX512_END
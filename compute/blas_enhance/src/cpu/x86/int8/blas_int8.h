@@ -19,6 +19,8 @@
 #include "tensor_desc.h"
 #include "thread_affinity.h"
 #include "uni.h"
+#include "x86_avx512_expand.h"
+#include "x86_avx2_expand.h"
 
 #define SIMDW 8
 #define align_size(size, unit) ((size + unit - 1) / unit * unit)
@@ -118,6 +120,29 @@ inline void matrix1_trans_r(int size, int blockK, int K, int alignSize, UINT8 *s
     }
 }
 
+// acc += the 128 * sum(B) that xor 0x80 takes away from u8 x s8 dot products on AVX2
+inline __m256i sum_128b_avx2(__m256i acc, __m256i b)
+{
+    return _mm256_dpbusd_avx2_epi32(acc, _mm256_set1_epi8(-128), b);
+}
+
+// store 8 int32 results like the AVX-512 kernels: as is, scaled F32 or scaled U8_Q
+inline void store_result_avx2(__m256i v, I32 *result, UINT8 *u8Result, const F32 *scale, U32 flags)
+{
+    if (scale == nullptr) {
+        _mm256_storeu_si256((__m256i *)result, v);
+        return;
+    }
+    __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(scale[0]));
+    if ((flags & 0x2) == 0) {
+        _mm256_storeu_ps((F32 *)result, f);
+        return;
+    }
+    v = _mm256_add_epi32(_mm256_cvtps_epi32(f), _mm256_set1_epi32(128));
+    __m128i u16 = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)u8Result, _mm_packus_epi16(u16, u16));
+}
+
 EE matrix_vector_multiply_transform_weight_int8(
     TensorDesc desc, INT8 *src, INT8 *packB, I32 *offsetCBias);
 
@@ -127,7 +152,67 @@ EE matrix_matrix_multiply_transform_rhsN_int8(
 EE matrix_matrix_multiply_transform_rhsT_int8(
     TensorDesc desc, INT8 *src, INT8 *dst, I32 *offsetCBias);
 
-EE mmm_avx512_vnni_int8(U32 M,
+// AVX-512 builds of the int8 kernels, picked at run time if the cpu has AVX-512 but no VNNI
+EE mmm_int8(U32 M,
+    U32 N,
+    U32 K,
+    DataFormat matrixADataFormat,
+    UINT8 *matrix1,
+    INT8 *matrix2,
+    UINT8 *tmp,
+    UINT8 *result,
+    const F32 *scale);
+
+EE mvm_int8(U32 numRows,
+    U32 numColumns,
+    INT8 *packB,
+    UINT8 *vector,
+    UINT8 *result,
+    I32 *offsetCBias,
+    const F32 *scale);
+
+EE mvm_int8_row_i8u8(U32 numRows,
+    U32 numColumns,
+    DataFormat df,
+    UINT8 *packB,
+    INT8 *vector,
+    UINT8 *result,
+    I32 *tmp,
+    const F32 *scale);
+
+// builds of the kernels above that use vpdpbusd, picked at run time if IS_X86_AVX512_VNNI(arch)
+namespace avx512_vnni {
+EE mmm_int8(U32 M,
+    U32 N,
+    U32 K,
+    DataFormat matrixADataFormat,
+    UINT8 *matrix1,
+    INT8 *matrix2,
+    UINT8 *tmp,
+    UINT8 *result,
+    const F32 *scale);
+
+EE mvm_int8(U32 numRows,
+    U32 numColumns,
+    INT8 *packB,
+    UINT8 *vector,
+    UINT8 *result,
+    I32 *offsetCBias,
+    const F32 *scale);
+
+EE mvm_int8_row_i8u8(U32 numRows,
+    U32 numColumns,
+    DataFormat df,
+    UINT8 *packB,
+    INT8 *vector,
+    UINT8 *result,
+    I32 *tmp,
+    const F32 *scale);
+}  // namespace avx512_vnni
+
+// AVX2 builds of the kernels above, picked at run time if the cpu has no AVX-512
+namespace avx2 {
+EE mmm_int8(U32 M,
     U32 N,
     U32 K,
     DataFormat matrixADataFormat,
@@ -137,7 +222,7 @@ EE mmm_avx512_vnni_int8(U32 M,
     UINT8 *result,
     const F32 *scale);
 
-EE mvm_avx512_int8(U32 numRows,
+EE mvm_int8(U32 numRows,
     U32 numColumns,
     INT8 *packB,
     UINT8 *vector,
@@ -145,7 +230,7 @@ EE mvm_avx512_int8(U32 numRows,
     I32 *offsetCBias,
     const F32 *scale);
 
-EE mvm_avx512_int8_row_i8u8(U32 numRows,
+EE mvm_int8_row_i8u8(U32 numRows,
     U32 numColumns,
     DataFormat df,
     UINT8 *packB,
@@ -153,5 +238,6 @@ EE mvm_avx512_int8_row_i8u8(U32 numRows,
     UINT8 *result,
     I32 *tmp,
     const F32 *scale);
+}  // namespace avx2
 
 #endif
@@ -14,6 +14,8 @@
 #include "cpu/x86/int8/blas_int8.h"
 #include "thread_affinity.h"
 
+X86_ISA_NAMESPACE_BEGIN
+
 #define UNROLL_N 48
 #define UNROLL_M 8
 #define BOLCK_M_DIM 384
@@ -129,6 +131,114 @@ EE matrix_matrix_multiply_transform_rhsT_int8(
     return SUCCESS;
 }
 
+X86_INT8_BEGIN
+#ifdef _USE_AVX2
+// AVX2 has no vpdpbusd and vpmaddubsw saturates u8 x s8 pairs, so A ^ 0x80 is used as s8 and
+// the 128 * sum(B) this removes is added back per column. The result is exact.
+template <U32 ROWS, U32 COLS>
+inline void mmm_avx2_block(U32 bk,
+    UINT8 *matrixA,
+    INT8 *matrixB,
+    U32 un,
+    const __m256i *sumB,
+    I32 *matrixC,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    U32 N,
+    U32 stepK,
+    const F32 *scale,
+    U32 flags)
+{
+    __m256i acc[ROWS][COLS];
+    for (U32 i = 0; i < ROWS; ++i) {
+        for (U32 j = 0; j < COLS; ++j) {
+            acc[i][j] = sumB[j];
+        }
+    }
+    __m256i flip = _mm256_set1_epi8(-128);
+    for (U32 k = 0; k < bk * 2; ++k) {
+        __m256i b[COLS];
+        for (U32 j = 0; j < COLS; ++j) {
+            b[j] = _mm256_loadu_si256((const __m256i *)(matrixB + k * un * 4 + j * 32));
+        }
+        for (U32 i = 0; i < ROWS; ++i) {
+            __m256i a = _mm256_set1_epi32(*(const I32 *)(matrixA + i * stepK + k * 4));
+            a = _mm256_xor_si256(a, flip);
+            for (U32 j = 0; j < COLS; ++j) {
+                acc[i][j] = _mm256_dpbssd_avx2_epi32(acc[i][j], a, b[j]);
+            }
+        }
+    }
+    for (U32 i = 0; i < ROWS; ++i) {
+        for (U32 j = 0; j < COLS; ++j) {
+            I32 *c = matrixC + i * N + j * 8;
+            __m256i v = _mm256_add_epi32(acc[i][j], _mm256_loadu_si256((const __m256i *)c));
+            if ((flags & 0x1) == 0) {
+                v = _mm256_add_epi32(v, _mm256_loadu_si256((const __m256i *)(offsetC + j * 8)));
+            }
+            store_result_avx2(v, c, u8Result + i * N + j * 8, scale, flags);
+        }
+    }
+}
+
+template <U32 COLS>
+inline void mmm_avx2_cols(U32 um,
+    U32 un,
+    U32 bk,
+    UINT8 *matrixA,
+    INT8 *matrixB,
+    I32 *matrixC,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    U32 N,
+    U32 stepK,
+    const F32 *scale,
+    U32 flags)
+{
+    __m256i sumB[COLS];
+    for (U32 j = 0; j < COLS; ++j) {
+        sumB[j] = _mm256_setzero_si256();
+        for (U32 k = 0; k < bk * 2; ++k) {
+            sumB[j] = sum_128b_avx2(
+                sumB[j], _mm256_loadu_si256((const __m256i *)(matrixB + k * un * 4 + j * 32)));
+        }
+    }
+    U32 m = 0;
+    for (; m + 3 <= um; m += 3) {
+        mmm_avx2_block<3, COLS>(bk, matrixA + m * stepK, matrixB, un, sumB, matrixC + m * N,
+            u8Result + m * N, offsetC, N, stepK, scale, flags);
+    }
+    for (; m < um; ++m) {
+        mmm_avx2_block<1, COLS>(bk, matrixA + m * stepK, matrixB, un, sumB, matrixC + m * N,
+            u8Result + m * N, offsetC, N, stepK, scale, flags);
+    }
+}
+
+// um x un block, un is a multiple of 8
+void mmm_avx2_kernel(U32 um,
+    U32 un,
+    U32 bk,
+    UINT8 *matrixA,
+    INT8 *matrixB,
+    I32 *matrixC,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    U32 N,
+    U32 stepK,
+    const F32 *scale,
+    U32 flags)
+{
+    U32 n = 0;
+    for (; n + 16 <= un; n += 16) {
+        mmm_avx2_cols<2>(um, un, bk, matrixA, matrixB + n * 4, matrixC + n, u8Result + n,
+            offsetC + n, N, stepK, scale, flags);
+    }
+    if (n < un) {
+        mmm_avx2_cols<1>(um, un, bk, matrixA, matrixB + n * 4, matrixC + n, u8Result + n,
+            offsetC + n, N, stepK, scale, flags);
+    }
+}
+#else
 #ifdef _USE_AVX512_VNNI
 #define mmmKernel8x48                                             \
     "movq %0, %%rax  \n\t"                                        \
@@ -4784,6 +4894,7 @@ inline void mmm_avx512_1x8_asm(U32 um,
         "%ymm18", "%ymm19", "%ymm20", "%ymm21", "%ymm22", "%ymm23", "%ymm24", "%ymm25", "%ymm26",
         "%ymm27", "%ymm28", "%ymm29", "%ymm30", "%ymm31", "memory", "cc");
 }
+#endif
 
 void mmm_avx512_n_mtail(U32 um,
     U32 un,
@@ -4825,7 +4936,7 @@ void mmm_avx512_n_mtail(U32 um,
 }
 
 //TODO: matrixC alloc
-EE mmm_avx512_vnni_int8(U32 N,
+EE mmm_int8(U32 N,
     U32 M,
     U32 K,
     DataFormat matrix1Df,
@@ -4836,12 +4947,19 @@ EE mmm_avx512_vnni_int8(U32 N,
     const F32 *scale)
 {
     UINT8 *packA = matrix1;
+#ifdef _USE_AVX2
+    kernel_func kernel[3][5] = {{mmm_avx512_n_mtail, mmm_avx2_kernel, mmm_avx2_kernel,
+                                    mmm_avx2_kernel, mmm_avx2_kernel},
+        {mmm_avx512_n_mtail, mmm_avx2_kernel, mmm_avx2_kernel, mmm_avx2_kernel, mmm_avx2_kernel},
+        {mmm_avx512_n_mtail, mmm_avx2_kernel, mmm_avx2_kernel, mmm_avx2_kernel, mmm_avx2_kernel}};
+#else
     kernel_func kernel[3][5] = {{mmm_avx512_n_mtail, mmm_avx512_1x8_asm, mmm_avx512_1x16_asm,
                                     mmm_avx512_1x32_asm, mmm_avx512_1x48_asm},
         {mmm_avx512_n_mtail, mmm_avx512_12x8_asm, mmm_avx512_12x16_asm, mmm_avx512_6x32_asm,
             mmm_avx512_4x48_asm},
         {mmm_avx512_n_mtail, mmm_avx512_24x8_asm, mmm_avx512_24x16_asm, mmm_avx512_12x32_asm,
             mmm_avx512_8x48_asm}};
+#endif
     U32 unrollNSizes[5] = {8, 8, 16, 32, 48};
     U32 unrollMSize[5] = {M, 24, 24, 12, 8};
     U32 alignedK = (K + 7) / 8 * 8;
@@ -5066,3 +5184,5 @@ EE mmm_avx512_vnni_int8(U32 N,
 
     return SUCCESS;
 }
+X86_INT8_END
+X86_ISA_NAMESPACE_END
@@ -12,6 +12,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "cpu/x86/int8/blas_int8.h"
+
+X86_ISA_NAMESPACE_BEGIN
+
 #define UNROLL_N 64
 #define BOLCK_K_DIM 2048
 
@@ -130,6 +133,64 @@ EE matrix_vector_multiply_transform_weight_int8(
     return ret;
 }
 
+X86_INT8_BEGIN
+#ifdef _USE_AVX2
+// same u8 ^ 0x80 trick as mmm_avx2_kernel, 128 * sum(B) is accumulated in the loop
+template <U32 COLS>
+inline void mvm_row_avx2_cols(U32 bn,
+    U32 bk,
+    INT8 *matrix,
+    UINT8 *vector,
+    I32 *result,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    const F32 *scale,
+    U32 flags)
+{
+    __m256i acc[COLS];
+    for (U32 j = 0; j < COLS; ++j) {
+        acc[j] = _mm256_setzero_si256();
+    }
+    __m256i flip = _mm256_set1_epi8(-128);
+    for (U32 k = 0; k < bk; k += 4) {
+        __m256i a = _mm256_xor_si256(_mm256_set1_epi32(*(const I32 *)(vector + k)), flip);
+        for (U32 j = 0; j < COLS; ++j) {
+            __m256i b = _mm256_loadu_si256((const __m256i *)(matrix + k * bn + j * 32));
+            acc[j] = _mm256_dpbssd_avx2_epi32(acc[j], a, b);
+            acc[j] = sum_128b_avx2(acc[j], b);
+        }
+    }
+    for (U32 j = 0; j < COLS; ++j) {
+        __m256i v = _mm256_add_epi32(acc[j], _mm256_loadu_si256((const __m256i *)(result + j * 8)));
+        if ((flags & 0x1) == 0) {
+            v = _mm256_add_epi32(v, _mm256_loadu_si256((const __m256i *)(offsetC + j * 8)));
+        }
+        store_result_avx2(v, result + j * 8, u8Result + j * 8, scale, flags);
+    }
+}
+
+// bn is a multiple of 8
+void mvm_row_avx2(U32 bn,
+    U32 bk,
+    INT8 *matrix,
+    UINT8 *vector,
+    I32 *result,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    const F32 *scale,
+    U32 flags)
+{
+    U32 n = 0;
+    for (; n + 32 <= bn; n += 32) {
+        mvm_row_avx2_cols<4>(bn, bk, matrix + n * 4, vector, result + n, u8Result + n,
+            offsetC + n, scale, flags);
+    }
+    for (; n < bn; n += 8) {
+        mvm_row_avx2_cols<1>(bn, bk, matrix + n * 4, vector, result + n, u8Result + n,
+            offsetC + n, scale, flags);
+    }
+}
+#else
 void mvm_row_avx512_64(U32 bn,
     U32 bk,
     INT8 *matrix,
@@ -664,6 +725,7 @@ void mvm_row_avx512_8(U32 bn,
                          "r"(scale), "r"(u8Result)
                          : "%eax", "%ymm0", "%ymm1", "%ymm2", "%ymm24", "%ymm31", "memory");
 }
+#endif
 
 void mvm_row_avx512_tail(U32 bn,
     U32 bk,
@@ -698,7 +760,7 @@ void mvm_row_avx512_tail(U32 bn,
     }
 }
 
-EE mvm_avx512_int8(U32 numRows,
+EE mvm_int8(U32 numRows,
     U32 numColumns,
     INT8 *packB,
     UINT8 *vector,
@@ -707,8 +769,13 @@ EE mvm_avx512_int8(U32 numRows,
     const F32 *scale)
 {
     // Actual layout is NKN64, and vector is K
+#ifdef _USE_AVX2
+    kernel_func kernel[6] = {mvm_row_avx512_tail, mvm_row_avx2, mvm_row_avx2, mvm_row_avx2,
+        mvm_row_avx2, mvm_row_avx2};
+#else
     kernel_func kernel[6] = {mvm_row_avx512_tail, mvm_row_avx512_8, mvm_row_avx512_16,
         mvm_row_avx512_32, mvm_row_avx512_32, mvm_row_avx512_64};
+#endif
     U32 unrollSize[5] = {8, 16, 32, 32, 64};
     U32 blockSizeK = 0, blockSizeN = 0;
     U32 flags = 0;
@@ -753,3 +820,5 @@ EE mvm_avx512_int8(U32 numRows,
 
     return SUCCESS;
 }
+X86_INT8_END
+X86_ISA_NAMESPACE_END
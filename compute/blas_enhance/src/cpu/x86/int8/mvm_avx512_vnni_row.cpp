@@ -13,6 +13,9 @@
 
 #include "cpu/x86/int8/blas_int8.h"
 
+X86_ISA_NAMESPACE_BEGIN
+X86_INT8_BEGIN
+
 #define UNROLL_N 16
 #define BOLCK_K_DIM 2048
 
@@ -27,6 +30,69 @@ typedef void (*kernel_func)(U32 K,
     const F32 *scale,
     U32 flags);
 
+#ifdef _USE_AVX2
+// matrix ^ 0x80 is used as s8, so the sums already hold the -128 * sum(vector) offset
+template <U32 ROWS>
+inline void mvm_avx2_rows(U32 K, UINT8 *matrix, INT8 *vector, I32 *sum)
+{
+    __m256i acc[ROWS];
+    for (U32 r = 0; r < ROWS; ++r) {
+        acc[r] = _mm256_setzero_si256();
+    }
+    __m256i flip = _mm256_set1_epi8(-128);
+    U32 k = 0;
+    for (; k + 32 <= K; k += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(vector + k));
+        for (U32 r = 0; r < ROWS; ++r) {
+            __m256i m = _mm256_loadu_si256((const __m256i *)(matrix + r * K + k));
+            acc[r] = _mm256_dpbssd_avx2_epi32(acc[r], _mm256_xor_si256(m, flip), v);
+        }
+    }
+    for (U32 r = 0; r < ROWS; ++r) {
+        sum[r] = _mm256_hadd_u32(acc[r]);
+        for (U32 kk = k; kk < K; ++kk) {
+            sum[r] += ((I32)matrix[r * K + kk] - 128) * (I32)vector[kk];
+        }
+    }
+}
+
+template <U32 ROWS>
+void mvm_avx2_row(U32 K,
+    U32 bk,
+    U64 kmask,
+    UINT8 *matrix,
+    INT8 *vector,
+    I32 *result,
+    UINT8 *u8Result,
+    I32 *offsetC,
+    const F32 *scale,
+    U32 flags)
+{
+    const U32 unroll = (ROWS < 4) ? ROWS : 4;
+    I32 sum[ROWS];
+    for (U32 r = 0; r < ROWS; r += unroll) {
+        mvm_avx2_rows<unroll>(K, matrix + r * K, vector, sum + r);
+    }
+    F32 *resultF32 = (F32 *)result;
+    for (U32 r = 0; r < ROWS; ++r) {
+        I32 tmp = sum[r];
+        if ((flags & 0x1) == 0) {
+            tmp += *offsetC;
+        }
+        if (scale != nullptr) {
+            F32 f = tmp * scale[0];
+            if (flags & 0x2) {
+                tmp = (I32)roundf(f) + 128;
+                u8Result[r] = UNI_MAX(0, UNI_MIN(255, tmp));
+            } else {
+                resultF32[r] = f;
+            }
+        } else {
+            result[r] = tmp;
+        }
+    }
+}
+#else
 // I8 U8
 void mvm_avx512_16_row(U32 K,
     U32 bk,
@@ -914,6 +980,7 @@ void mvm_avx512_1_row(U32 K,
                          "%zmm20", "%zmm21", "%zmm22", "%zmm23", "%zmm24", "%zmm25", "%zmm26",
                          "%zmm27", "%zmm28", "%zmm29", "%zmm30", "%zmm31", "memory");
 }
+#endif
 
 inline void transpose(UINT8 *matrix, UINT8 *transMatrix, U32 N, U32 K)
 {
@@ -928,7 +995,7 @@ inline void transpose(UINT8 *matrix, UINT8 *transMatrix, U32 N, U32 K)
     }
 }
 
-EE mvm_avx512_int8_row_i8u8(U32 numRows,
+EE mvm_int8_row_i8u8(U32 numRows,
     U32 numColumns,
     DataFormat df,
     UINT8 *packB,
@@ -940,6 +1007,7 @@ EE mvm_avx512_int8_row_i8u8(U32 numRows,
     I32 offsetC = 0;
     U32 num64 = numColumns / 16;
     U64 resMask = pow(2, numColumns % 16) - 1;
+#ifndef _USE_AVX2
     __asm__ __volatile__("vxorps %%zmm0, %%zmm0, %%zmm0            \n\t"
                          "mov %0, %%rdx \n\t"
                          "mov %2, %%ebx \n\t"
@@ -981,14 +1049,20 @@ EE mvm_avx512_int8_row_i8u8(U32 numRows,
                          : "r"(vector), "r"(&offsetC), "r"(num64), "a"(resMask)
                          : "%k2", "%ebx", "%rdx", "%zmm0", "%zmm1", "%zmm2", "memory", "cc");
     offsetC *= -128;
+#endif
     if (df == DF_TRANSPOSE) {
         transpose(packB, (UINT8 *)tmp, numRows, numColumns);
         packB = (UINT8 *)tmp;
     }
 
     U32 blockSizeK = 0, blockSizeN = 0, flags = 0;
+#ifdef _USE_AVX2
+    kernel_func kernel[5] = {mvm_avx2_row<1>, mvm_avx2_row<4>, mvm_avx2_row<8>, mvm_avx2_row<8>,
+        mvm_avx2_row<16>};
+#else
     kernel_func kernel[5] = {
         mvm_avx512_1_row, mvm_avx512_4_row, mvm_avx512_8_row, mvm_avx512_8_row, mvm_avx512_16_row};
+#endif
     U32 unrollSize[5] = {1, 4, 8, 8, 16};
     F32 *factorPtr = nullptr;
     F32 factor;
@@ -1026,3 +1100,5 @@ EE mvm_avx512_int8_row_i8u8(U32 numRows,
     }
     return SUCCESS;
 }
+X86_INT8_END
+X86_ISA_NAMESPACE_END
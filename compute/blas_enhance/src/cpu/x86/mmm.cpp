@@ -21,6 +21,7 @@
 #ifdef _USE_INT8
 #include "cpu/x86/int8/blas_int8.h"
 #endif
+#include <vector>
 
 EE matrix_matrix_multiply_tmp_bytes_x86(
     U32 matrixA_M, U32 matrixA_K, U32 matrixB_K, U32 matrixB_N, DataType dt, U32 *bytes)
@@ -50,14 +51,20 @@ EE matrix_matrix_multiply_tmp_bytes_x86(
     return ret;
 }
 
-static EE matrix_matrix_multiply_transform_rhsN(
-    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst, void *offsetCBias)
+static EE matrix_matrix_multiply_transform_rhsN(TensorDesc desc,
+    const void *src,
+    TensorDesc *descTran,
+    void *dst,
+    void *offsetCBias,
+    Arch arch)
 {
     EE ret = SUCCESS;
     switch (desc.dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = matrix_matrix_multiply_transform_rhsN_fp32(desc, (F32 *)src, (F32 *)dst);
+            auto func = IS_X86_AVX512(arch) ? matrix_matrix_multiply_transform_rhsN_avx512_fp32
+                                            : matrix_matrix_multiply_transform_rhsN_fp32;
+            ret = func(desc, (F32 *)src, (F32 *)dst);
             break;
         }
 #endif
@@ -77,14 +84,20 @@ static EE matrix_matrix_multiply_transform_rhsN(
     return ret;
 }
 
-static EE matrix_matrix_multiply_transform_rhsT(
-    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst, void *offsetCBias)
+static EE matrix_matrix_multiply_transform_rhsT(TensorDesc desc,
+    const void *src,
+    TensorDesc *descTran,
+    void *dst,
+    void *offsetCBias,
+    Arch arch)
 {
     EE ret = SUCCESS;
     switch (desc.dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = matrix_matrix_multiply_transform_rhsT_fp32(desc, (F32 *)src, (F32 *)dst);
+            auto func = IS_X86_AVX512(arch) ? matrix_matrix_multiply_transform_rhsT_avx512_fp32
+                                            : matrix_matrix_multiply_transform_rhsT_fp32;
+            ret = func(desc, (F32 *)src, (F32 *)dst);
             break;
         }
 #endif
@@ -105,8 +118,12 @@ static EE matrix_matrix_multiply_transform_rhsT(
     return ret;
 }
 
-EE matrix_matrix_multiply_transform_rhs_x86(
-    TensorDesc desc, const void *src, TensorDesc *descTran, void *dst, void *offsetCBias)
+EE matrix_matrix_multiply_transform_rhs_x86(TensorDesc desc,
+    const void *src,
+    TensorDesc *descTran,
+    void *dst,
+    void *offsetCBias,
+    Arch arch)
 {
     if (desc.df == targetFormat4MatrixB(desc.dt)) {
         return SUCCESS;
@@ -114,11 +131,13 @@ EE matrix_matrix_multiply_transform_rhs_x86(
     EE ret = SUCCESS;
     switch (desc.df) {
         case DF_NORMAL: {
-            ret = matrix_matrix_multiply_transform_rhsN(desc, src, descTran, dst, offsetCBias);
+            ret = matrix_matrix_multiply_transform_rhsN(
+                desc, src, descTran, dst, offsetCBias, arch);
             break;
         }
         case DF_TRANSPOSE: {
-            ret = matrix_matrix_multiply_transform_rhsT(desc, src, descTran, dst, offsetCBias);
+            ret = matrix_matrix_multiply_transform_rhsT(
+                desc, src, descTran, dst, offsetCBias, arch);
             break;
         }
         default:
@@ -137,22 +156,29 @@ EE mmm_x86(U32 matrixC_N,
     const void *matrixBData,
     void *tmp,
     void *matrixCData,
-    const F32 *scale)
+    const F32 *scale,
+    Arch arch)
 {
     EE ret = SUCCESS;
     switch (dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = mmm_avx2_fp32(matrixC_N, matrixC_M, matrixA_K, matrixADataFormat,
-                (F32 *)matrixAData, (F32 *)matrixBData, (F32 *)tmp, (F32 *)matrixCData);
+            auto func = IS_X86_AVX512(arch) ? mmm_avx512_fp32 : mmm_avx2_fp32;
+            ret = func(matrixC_N, matrixC_M, matrixA_K, matrixADataFormat, (F32 *)matrixAData,
+                (F32 *)matrixBData, (F32 *)tmp, (F32 *)matrixCData);
             break;
         }
 #endif
 #ifdef _USE_INT8
         case DT_I8: {
-            ret = mmm_avx512_vnni_int8(matrixC_N, matrixC_M, matrixA_K, matrixADataFormat,
-                (UINT8 *)matrixAData, (INT8 *)matrixBData, (UINT8 *)tmp, (UINT8 *)matrixCData,
-                scale);
+            auto func = avx2::mmm_int8;
+            if (IS_X86_AVX512_VNNI(arch)) {
+                func = avx512_vnni::mmm_int8;
+            } else if (IS_X86_AVX512(arch)) {
+                func = mmm_int8;
+            }
+            ret = func(matrixC_N, matrixC_M, matrixA_K, matrixADataFormat, (UINT8 *)matrixAData,
+                (INT8 *)matrixBData, (UINT8 *)tmp, (UINT8 *)matrixCData, scale);
             break;
         }
 #endif
@@ -162,3 +188,75 @@ EE mmm_x86(U32 matrixC_N,
     }
     return ret;
 }
+
+EE matrix_matrix_multiply_batch_tmp_bytes_x86(U32 batch,
+    U32 matrixA_M,
+    U32 matrixA_K,
+    U32 matrixB_N,
+    U32 batchB,
+    bool transformB,
+    DataType dt,
+    U32 *bytes,
+    Arch arch)
+{
+    EE ret = NOT_SUPPORTED;
+#ifdef _USE_FP32
+    if (dt == DT_F32 && IS_X86_AVX512(arch)) {
+        // packed A tiles of all products, followed by every distinct B in AVX-512 layout
+        *bytes = mmm_batch_avx512_fp32_tmp_bytes(batch, matrixA_M, matrixA_K);
+        if (transformB) {
+            *bytes += batchB * (matrixA_K * matrixB_N * bytesOf(dt) + 32);
+        }
+        ret = SUCCESS;
+    }
+#endif
+    return ret;
+}
+
+EE mmm_batch_x86(U32 batch,
+    U32 matrixC_N,
+    U32 matrixC_M,
+    U32 matrixA_K,
+    DataType dt,
+    DataFormat matrixADataFormat,
+    const void *matrixAData,
+    U32 strideA,
+    TensorDesc matrixBDesc,
+    const void *matrixBData,
+    U32 strideB,
+    void *tmp,
+    void *matrixCData,
+    U32 strideC,
+    Arch arch)
+{
+    EE ret = NOT_SUPPORTED;
+#ifdef _USE_FP32
+    if (dt == DT_F32 && IS_X86_AVX512(arch)) {
+        std::vector<F32 *> packB(batch);
+        if (matrixBDesc.df != targetFormat4MatrixB(dt)) {
+            U32 batchB = (strideB == 0) ? 1 : batch;
+            U32 packBBytes = matrixA_K * matrixC_N * bytesOf(dt) + 32;
+            U8 *dst = (U8 *)tmp + mmm_batch_avx512_fp32_tmp_bytes(batch, matrixC_M, matrixA_K);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+            for (I32 b = 0; b < (I32)batchB; b++) {
+                TensorDesc tranDescB;
+                CHECK_STATUS(matrix_matrix_multiply_transform_rhs_x86(matrixBDesc,
+                    (const F32 *)matrixBData + b * strideB, &tranDescB, dst + b * packBBytes,
+                    nullptr, arch));
+            }
+            for (U32 b = 0; b < batch; b++) {
+                packB[b] = (F32 *)(dst + ((strideB == 0) ? 0 : b) * packBBytes);
+            }
+        } else {
+            for (U32 b = 0; b < batch; b++) {
+                packB[b] = (F32 *)matrixBData + b * strideB;
+            }
+        }
+        ret = mmm_batch_avx512_fp32(batch, matrixC_N, matrixC_M, matrixA_K, matrixADataFormat,
+            (F32 *)matrixAData, strideA, packB.data(), (F32 *)tmp, (F32 *)matrixCData, strideC);
+    }
+#endif
+    return ret;
+}
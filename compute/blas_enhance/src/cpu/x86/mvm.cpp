@@ -88,27 +88,41 @@ EE mvm_x86(U32 row,
     const void *vector,
     void *result,
     void *offsetCBias,
-    const F32 *scale)
+    const F32 *scale,
+    Arch arch)
 {
     EE ret = SUCCESS;
     switch (dt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = mvm_avx2_fp32(row, col, df, (F32 *)matrix, (F32 *)vector, (F32 *)result);
+            auto func = IS_X86_AVX512(arch) ? mvm_avx512_fp32 : mvm_avx2_fp32;
+            ret = func(row, col, df, (F32 *)matrix, (F32 *)vector, (F32 *)result);
             break;
         }
 #endif
 #ifdef _USE_INT8
         case DT_I8: {
             CHECK_REQUIREMENT(offsetCBias != nullptr);
-            ret = mvm_avx512_int8(row, col, (INT8 *)matrix, (UINT8 *)vector, (UINT8 *)result,
+            auto func = avx2::mvm_int8;
+            if (IS_X86_AVX512_VNNI(arch)) {
+                func = avx512_vnni::mvm_int8;
+            } else if (IS_X86_AVX512(arch)) {
+                func = mvm_int8;
+            }
+            ret = func(row, col, (INT8 *)matrix, (UINT8 *)vector, (UINT8 *)result,
                 (I32 *)offsetCBias, scale);
             break;
         }
         case DT_U8_Q: {
             CHECK_REQUIREMENT(offsetCBias != nullptr);
-            ret = mvm_avx512_int8_row_i8u8(row, col, df, (UINT8 *)matrix, (INT8 *)vector,
-                (UINT8 *)result, (I32 *)offsetCBias, scale);
+            auto func = avx2::mvm_int8_row_i8u8;
+            if (IS_X86_AVX512_VNNI(arch)) {
+                func = avx512_vnni::mvm_int8_row_i8u8;
+            } else if (IS_X86_AVX512(arch)) {
+                func = mvm_int8_row_i8u8;
+            }
+            ret = func(row, col, df, (UINT8 *)matrix, (INT8 *)vector, (UINT8 *)result,
+                (I32 *)offsetCBias, scale);
             break;
         }
 #endif
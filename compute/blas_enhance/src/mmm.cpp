@@ -11,7 +11,10 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <vector>
 #include "blas_enhance.h"
+#include "thread_affinity.h"
+#include "uni.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/blas_general.h"
 #endif
@@ -73,7 +76,7 @@ EE matrix_matrix_multiply_transform_rhs(
 #endif
 #ifdef _USE_X86
     if (IS_X86(arch)) {
-        ret = matrix_matrix_multiply_transform_rhs_x86(desc, src, descTran, dst, nullptr);
+        ret = matrix_matrix_multiply_transform_rhs_x86(desc, src, descTran, dst, nullptr, arch);
     }
 #endif
     return ret;
@@ -152,10 +155,10 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
             }
             dataB += matrixA_M * alignedAK * bytesOf(matrixADataType);
             ret = matrix_matrix_multiply_transform_rhs_x86(
-                matrixBDesc, matrixBData, &tranDescB, dataB, offsetCBias);
+                matrixBDesc, matrixBData, &tranDescB, dataB, offsetCBias, arch);
         }
         ret = mmm_x86(matrixC_N, matrixC_M, matrixA_K, matrixBDataType, matrixADataFormat,
-            matrixAData, dataB, tmp, matrixCData, scale);
+            matrixAData, dataB, tmp, matrixCData, scale, arch);
 #endif
 #ifdef _USE_NEON
     } else {
@@ -176,3 +179,136 @@ EE matrix_matrix_multiply(TensorDesc matrixADesc,
     }
     return ret;
 }
+
+static EE mmm_batch_get_dims(TensorDesc matrixADesc,
+    TensorDesc matrixBDesc,
+    U32 *matrixA_M,
+    U32 *matrixA_K,
+    U32 *matrixB_N)
+{
+    DataType dt;
+    DataFormat df;
+    U32 matrixB_K;
+    CHECK_STATUS(tensor2dGet(matrixADesc, &dt, &df, matrixA_M, matrixA_K));
+    if (df == DF_TRANSPOSE || df == DF_NKN8) {
+        std::swap(*matrixA_M, *matrixA_K);
+    }
+    CHECK_STATUS(tensor2dGet(matrixBDesc, &dt, &df, &matrixB_K, matrixB_N));
+    if (df == DF_TRANSPOSE) {
+        std::swap(matrixB_K, *matrixB_N);
+    }
+    return (*matrixA_K == matrixB_K) ? SUCCESS : NOT_MATCH;
+}
+
+// products without a batched kernel are run one per thread, each with its own tmp
+static U32 mmm_batch_workers(U32 batch, U32 bytes, U32 singleBytes)
+{
+    U32 workers = UNI_MIN(batch, (U32)OMP_NUM_THREADS);
+    if (singleBytes > 0) {
+        workers = UNI_MIN(workers, bytes / singleBytes);
+    }
+    return UNI_MAX(workers, 1);
+}
+
+EE matrix_matrix_multiply_batch_tmp_bytes(U32 batch,
+    TensorDesc matrixADesc,
+    TensorDesc matrixBDesc,
+    U32 strideB,
+    U32 *bytes,
+    Arch arch)
+{
+    if (bytes == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+        return NULL_POINTER;
+    }
+    U32 matrixA_M, matrixA_K, matrixB_N;
+    CHECK_STATUS(mmm_batch_get_dims(matrixADesc, matrixBDesc, &matrixA_M, &matrixA_K, &matrixB_N));
+    EE ret = NOT_SUPPORTED;
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        U32 batchB = (strideB == 0) ? 1 : batch;
+        bool transformB = (matrixBDesc.df != targetFormat4MatrixB(matrixBDesc.dt));
+        ret = matrix_matrix_multiply_batch_tmp_bytes_x86(batch, matrixA_M, matrixA_K, matrixB_N,
+            batchB, transformB, matrixADesc.dt, bytes, arch);
+    }
+#endif
+    if (ret != SUCCESS) {
+        U32 singleBytes = 0;
+        ret = matrix_matrix_multiply_tmp_bytes(matrixADesc, matrixBDesc, &singleBytes, arch);
+        U32 workers = IS_GENERAL(arch) ? 1 : UNI_MIN(batch, (U32)OMP_NUM_THREADS);
+        *bytes = UNI_MAX(workers, 1) * singleBytes;
+    }
+    return ret;
+}
+
+EE matrix_matrix_multiply_batch(U32 batch,
+    TensorDesc matrixADesc,
+    const void *matrixA,
+    U32 strideA,
+    TensorDesc matrixBDesc,
+    const void *matrixB,
+    U32 strideB,
+    U32 bytes,
+    void *tmp,
+    TensorDesc matrixCDesc,
+    void *matrixC,
+    U32 strideC,
+    Arch arch)
+{
+    if (bytes != 0 && tmp == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+        return NULL_POINTER;
+    }
+    if (nullptr == matrixA || nullptr == matrixB || nullptr == matrixC) {
+        CHECK_STATUS(NULL_POINTER);
+        return NULL_POINTER;
+    }
+    if (batch == 0 || tensorNumElements(matrixCDesc) == 0) {
+        return SUCCESS;
+    }
+    U32 matrixA_M, matrixA_K, matrixB_N;
+    CHECK_STATUS(mmm_batch_get_dims(matrixADesc, matrixBDesc, &matrixA_M, &matrixA_K, &matrixB_N));
+    if (matrixCDesc.dims[1] != matrixA_M || matrixCDesc.dims[0] != matrixB_N) {
+        CHECK_STATUS(NOT_MATCH);
+        return NOT_MATCH;
+    }
+
+    EE ret = NOT_SUPPORTED;
+#ifdef _USE_X86
+    if (IS_X86(arch)) {
+        ret = mmm_batch_x86(batch, matrixB_N, matrixA_M, matrixA_K, matrixADesc.dt,
+            matrixADesc.df, matrixA, strideA, matrixBDesc, matrixB, strideB, tmp, matrixC,
+            strideC, arch);
+    }
+#endif
+    if (ret == SUCCESS) {
+        return ret;
+    }
+
+    U32 singleBytes = 0;
+    CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(matrixADesc, matrixBDesc, &singleBytes, arch));
+    U32 workers = IS_GENERAL(arch) ? 1 : mmm_batch_workers(batch, bytes, singleBytes);
+    U32 elementBytes = bytesOf(matrixADesc.dt);
+    std::vector<EE> status(batch, SUCCESS);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(workers)
+#endif
+    for (I32 b = 0; b < (I32)batch; b++) {
+#ifdef _USE_OPENMP
+        U8 *threadTmp = (U8 *)tmp + singleBytes * omp_get_thread_num();
+#else
+        U8 *threadTmp = (U8 *)tmp;
+#endif
+        ThreadContextGuard threadContext(1);
+        status[b] = matrix_matrix_multiply(matrixADesc,
+            (const U8 *)matrixA + (size_t)b * strideA * elementBytes, matrixBDesc,
+            (const U8 *)matrixB + (size_t)b * strideB * elementBytes, singleBytes, threadTmp,
+            matrixCDesc, (U8 *)matrixC + (size_t)b * strideC * bytesOf(matrixCDesc.dt), nullptr,
+            arch);
+    }
+    ret = SUCCESS;
+    for (U32 b = 0; b < batch && ret == SUCCESS; b++) {
+        ret = status[b];
+    }
+    return ret;
+}
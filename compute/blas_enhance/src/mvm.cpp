@@ -137,7 +137,7 @@ EE matrix_vector_multiply(TensorDesc matrixDesc,
         }
 #endif
         ret = mvm_x86(matrixRow, matrixColumn, matrixDataType, matrixDataFormat, dataB, vector,
-            result, tmp, scale);
+            result, tmp, scale, arch);
 #endif
 #ifdef _USE_NEON
     } else {
@@ -0,0 +1,104 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "blas_enhance.h"
+#include "ut_util.h"
+
+int mmmBatchTestKernel(U32 batch, U32 m, U32 k, U32 n, bool shareB, DataType dt)
+{
+    float threshold = 0.0001;
+    if (dt == DT_F16) {
+        threshold = 1;
+    }
+
+    TensorDesc A_desc = tensor2df(dt, DF_TRANSPOSE, k, m);
+    TensorDesc B_desc = tensor2df(dt, DF_NORMAL, k, n);
+    TensorDesc C_desc = tensor2df(dt, DF_NORMAL, m, n);
+    U32 strideA = m * k;
+    U32 strideB = shareB ? 0 : k * n;
+    U32 strideC = m * n;
+    U32 batchB = shareB ? 1 : batch;
+
+    U32 bytes = 0;
+    U8 *A = ut_input_v(batch * m * k, dt, UT_INIT_RANDOM);
+    U8 *B = ut_input_v(batchB * k * n, dt, UT_INIT_RANDOM);
+    U8 *C = ut_input_v(batch * m * n, dt, UT_INIT_ZERO);
+    U8 *C_ref = ut_input_v(batch * m * n, dt, UT_INIT_ZERO);
+    CHECK_STATUS(
+        matrix_matrix_multiply_batch_tmp_bytes(batch, A_desc, B_desc, strideB, &bytes, UT_ARCH));
+    U8 *tmp = ut_input_v(bytes / bytesOf(dt) + 1, dt, UT_INIT_ZERO);
+
+    if (UT_CHECK) {
+        CHECK_STATUS(matrix_matrix_multiply_batch(batch, A_desc, A, strideA, B_desc, B, strideB,
+            bytes, tmp, C_desc, C, strideC, UT_ARCH));
+
+        // naive implement
+        CHECK_STATUS(matrix_matrix_multiply_batch(batch, A_desc, A, strideA, B_desc, B, strideB,
+            0, nullptr, C_desc, C_ref, strideC, CPU_GENERAL));
+
+        // check
+        ut_check_v(C, C_ref, batch * m * n, dt, threshold, __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        matrix_matrix_multiply_batch(batch, A_desc, A, strideA, B_desc, B, strideB, bytes, tmp,
+            C_desc, C, strideC, UT_ARCH);
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    sprintf(params, "%u x (%u %u)+(%u %u)=(%u %u)%s", batch, m, k, k, n, m, n,
+        shareB ? " shared B" : "");
+    sprintf(buffer, "%20s, %80s", "MatrixMultiplyBatch", params);
+    double ops = batch * (2.0 * m * n * k + 1.0 * m * n);
+    ut_log(dt, buffer, ops, time);
+
+    free(A);
+    free(B);
+    free(C);
+    free(C_ref);
+    free(tmp);
+
+    return 0;
+}
+
+int mmmBatchTest(int argc, char **argv, DataType dt)
+{
+    CHECK_REQUIREMENT(argc == 5);
+    U32 batch = atoi(argv[1]);
+    U32 m = atoi(argv[2]);
+    U32 k = atoi(argv[3]);
+    U32 n = atoi(argv[4]);
+    int ret = mmmBatchTestKernel(batch, m, k, n, false, dt);
+    if (ret == 0) {
+        ret = mmmBatchTestKernel(batch, m, k, n, true, dt);
+    }
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+#ifdef _USE_FP16
+    mmmBatchTest(argc, argv, DT_F16);
+#endif
+#ifdef _USE_FP32
+    mmmBatchTest(argc, argv, DT_F32);
+#endif
+    return 0;
+}
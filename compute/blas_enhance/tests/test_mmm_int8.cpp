@@ -36,8 +36,15 @@ int main(int argc, char **argv)
     }
     INT8 *A = (INT8 *)ut_input_v(m * k, DT_I8, UT_INIT_RANDOM);
     INT8 *A_ref = (INT8 *)ut_input_v(m * k, DT_I8, UT_INIT_RANDOM);
-    memcpy(A_ref, A, m * k);
     INT8 *B = (INT8 *)ut_input_v(k * n, DT_I8, UT_INIT_RANDOM);
+    // -128 can not be negated in s8, the AVX2 kernel needs a separate path for it
+    for (U32 i = 0; i < m * k; i += 5) {
+        A[i] = -128;
+    }
+    for (U32 i = 0; i < k * n; i += 7) {
+        B[i] = -128;
+    }
+    memcpy(A_ref, A, m * k);
     INT8 *B_tran = (INT8 *)ut_input_v(k8 * n + 64 + n * 4, DT_I8, UT_INIT_ZERO);
     I32 *C = (I32 *)ut_input_v(m * n, DT_I32, UT_INIT_ZERO);
     I32 *C_ref = (I32 *)ut_input_v(m * n, DT_I32, UT_INIT_ZERO);
@@ -63,6 +70,15 @@ int main(int argc, char **argv)
 
         // check
         ut_check_v(C, C_ref, m * n, DT_I32, 1, __FILE__, __LINE__);
+
+#ifdef _USE_X86
+        // AVX2 fallback, only reached on hosts without AVX-512 otherwise
+        memcpy(tmp, B_tran, n * bytesOf(DT_I32));
+        memset(C, 0, m * n * bytesOf(DT_I32));
+        CHECK_STATUS(matrix_matrix_multiply(
+            A_desc, A, tranDescB, B_tran, bytes, tmp, C_desc, C, nullptr, X86_AVX2));
+        ut_check_v(C, C_ref, m * n, DT_I32, 1, __FILE__, __LINE__);
+#endif
     }
 
     // benchmark
@@ -47,6 +47,13 @@ int main(int argc, char **argv)
     INT8 *matTran = (INT8 *)ut_input_v(m * k4 + m * 4, DT_I8, UT_INIT_ZERO);
     INT8 *vec = (INT8 *)ut_input_v(vc, DT_I8, UT_INIT_RANDOM);
     INT8 *vec_ref = (INT8 *)ut_input_v(vc, DT_I8, UT_INIT_RANDOM);
+    // -128 can not be negated in s8, the AVX2 kernel needs a separate path for it
+    for (U32 i = 0; i < m * k; i += 7) {
+        mat[i] = -128;
+    }
+    for (U32 i = 0; i < vc; i += 5) {
+        vec[i] = -128;
+    }
     memcpy(vec_ref, vec, vc);
     I32 *res = (I32 *)ut_input_v(rc, DT_I32, UT_INIT_ZERO);
     I32 *res_ref = (I32 *)ut_input_v(rc, DT_I32, UT_INIT_ZERO);
@@ -75,6 +82,15 @@ int main(int argc, char **argv)
             mat_desc, mat, vec_desc, vec_ref, bytes, tmp, res_desc, res_ref, nullptr, CPU_GENERAL));
 
         ut_check_v(res, res_ref, rc, DT_I32, 1, __FILE__, __LINE__);
+
+#ifdef _USE_X86
+        // AVX2 fallback, only reached on hosts without AVX-512 otherwise
+        memcpy(tmp, matTran, rc * bytesOf(DT_I32));
+        memset(res, 0, rc * bytesOf(DT_I32));
+        CHECK_STATUS(matrix_vector_multiply(
+            tranDesc, matTran, vec_desc, vec, bytes, tmp, res_desc, res, nullptr, X86_AVX2));
+        ut_check_v(res, res_ref, rc, DT_I32, 1, __FILE__, __LINE__);
+#endif
     }
 
     // benchmark
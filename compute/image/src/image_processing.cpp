@@ -20,6 +20,7 @@ std::shared_ptr<Tensor> get_resize_image(
     ArchInfo archInfo;
     auto arch = CPU_GENERAL;
     archInfo.arch = arch;
+    archInfo.numThreads = 0;
     DataType rgbDt = DT_F16, imageDt = DT_F16;
     DataFormat rgbDf = DF_RGB, imageDf = DF_RGB;
     U32 rgbNum = 0, rgbChannel = 0, rgbHeight = 0, rgbWidth = 0;
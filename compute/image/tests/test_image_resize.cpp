@@ -29,8 +29,10 @@ int resizeTest(int argc, char *argv[], DataType dt)
     U32 ow = atoi(argv[8]);
     ArchInfo archInfo;
     archInfo.arch = UT_ARCH;
+    archInfo.numThreads = 0;
     ArchInfo archInfo_org;
     archInfo_org.arch = CPU_GENERAL;
+    archInfo_org.numThreads = 0;
 
     CHECK_REQUIREMENT(in == 1 && on == 1);
 
@@ -33,8 +33,10 @@ int resizeTest(int argc, char *argv[], DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     ArchInfo archInfo_org;
     archInfo_org.arch = CPU_GENERAL;
+    archInfo_org.numThreads = 0;
 
     TensorDesc inputDesc_cpu, inputDesc_gpu, outputDesc_cpu, outputDesc_gpu;
     inputDesc_cpu = tensor4df(dt, DF_NCHW, in, ic, ih, iw);
@@ -542,6 +542,19 @@ EE matmul(Tensor matrixATensor,
     Tensor matirxCTensor,
     ArchInfo_t archInfo);
 
+// matmul with the matrices of A and B placed matrixStrideA and matrixStrideB elements apart,
+// 0 if they are packed, strides are only supported for float data on CPU
+EE matmul_strided(Tensor matrixATensor,
+    bool transposeA,
+    U32 matrixStrideA,
+    Tensor matrixBTensor,
+    bool transposeB,
+    U32 matrixStrideB,
+    Tensor biasTensor,
+    std::vector<Tensor> tmpTensors,
+    Tensor matrixCTensor,
+    ArchInfo_t archInfo);
+
 EE reshape_infer_output_size(
     Tensor *inputTensor, ReshapeParamSpec p, Tensor *outputTensor, ArchInfo_t archInfo);
 
@@ -910,6 +923,35 @@ EE gat(Tensor nodeFeature0,
     Tensor outputTensor,
     ArchInfo_t archInfo);
 
+EE scaled_dot_product_attention_infer_output_size(Tensor *queryTensor,
+    Tensor *keyTensor,
+    Tensor *valueTensor,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor *outputTensor,
+    ArchInfo_t archInfo);
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes(Tensor queryTensor,
+    Tensor keyTensor,
+    Tensor valueTensor,
+    Tensor maskTensor,
+    ScaledDotProductAttentionParamSpec p,
+    U32 *bytes,
+    ArchInfo_t archInfo);
+
+// fused softmax(query * key * scale + mask * mask_scale) * value, maskTensor is unused when
+// p.mask_mode is SDPA_MASK_NONE, keyStride and valueStride are the distances in elements of
+// the matrices of every batch and head, 0 if they are packed
+EE scaled_dot_product_attention(Tensor queryTensor,
+    Tensor keyTensor,
+    U32 keyStride,
+    Tensor valueTensor,
+    U32 valueStride,
+    Tensor maskTensor,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo);
+
 EE generate_proposals_infer_output_size(Tensor *deltaTensor,
     Tensor *logitTensor,
     GenerateProposalsParamSpec generateProposalsParam,
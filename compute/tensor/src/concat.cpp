@@ -13,6 +13,7 @@
 
 #include <vector>
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_CPU
 #include "cpu/tensor_computing_cpu.h"
 #endif
@@ -155,6 +156,7 @@ EE concat(std::vector<Tensor> inputTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
     std::vector<F32> inputScale = get_scale_from_tensors(inputTensor);
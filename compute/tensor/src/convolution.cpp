@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
 #endif
@@ -103,7 +104,7 @@ EE convolution_infer_output_size(Tensor *inputTensor,
             CHECK_STATUS(NOT_SUPPORTED);
         }
 #ifdef _USE_INT8
-        if (IS_X86_AVX512(archInfo->arch) && (targetDataType == DT_U8_Q)) {
+        if (IS_X86(archInfo->arch) && (targetDataType == DT_U8_Q)) {
             outputDesc.df = DF_NCHWC16;
         }
 #endif
@@ -122,6 +123,7 @@ EE convolution_infer_forward_algorithm(Tensor inputTensor,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     TensorDesc inputDesc = inputTensor.get_desc();
     TensorDesc filterDesc = filterTensor.get_desc();
     TensorDesc outputDesc = outputTensor.get_desc();
@@ -134,8 +136,8 @@ EE convolution_infer_forward_algorithm(Tensor inputTensor,
 #endif
 #ifdef _USE_X86
     } else if (IS_X86(arch)) {
-        ret = convolution_infer_forward_algorithm_x86(
-            inputDesc, filterDesc, outputDesc, convParamSpec, policy, algorithm, targetDataType);
+        ret = convolution_infer_forward_algorithm_x86(inputDesc, filterDesc, outputDesc,
+            convParamSpec, policy, algorithm, targetDataType, arch);
 #endif
 #ifdef _USE_NEON
     } else if (IS_ARM(arch)) {
@@ -239,6 +241,7 @@ EE convolution_infer_forward_tmp_bytes(Tensor inputTensor,
     U32 *bytes,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     TensorDesc inputDesc = inputTensor.get_desc();
     TensorDesc filterDesc = filterTensor.get_desc();
     TensorDesc outputDesc = outputTensor.get_desc();
@@ -305,6 +308,7 @@ EE convolution(std::vector<Tensor> inputTensors,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensors[0].get_desc();
 
@@ -330,7 +334,9 @@ EE convolution(std::vector<Tensor> inputTensors,
         activationDesc.mode = ACTIVATION_NULL;
     }
 #if defined(_USE_GENERAL) || defined(_USE_X86)
-    if (tensorNumElements(eltwiseInputDesc) == tensorNumElements(outputDesc) &&
+    // x86 NCHW kernel has no fused-add epilogue
+    bool isEltwiseFusable = !(IS_X86(arch) && algorithm == CONVOLUTION_ALGORITHM_GEMM_ICNCHW);
+    if (isEltwiseFusable && tensorNumElements(eltwiseInputDesc) == tensorNumElements(outputDesc) &&
         eltwiseInputDesc.df == outputDesc.df) {
         isEltwiseSeperate = false;
         activationDesc = eltwiseActDesc;
@@ -13,84 +13,8 @@
 
 #include "error.h"
 #include "cpu/tensor_computing_cpu.h"
-
-inline EE qsort_descent(std::vector<BoxRect> &boxes, std::vector<F32> &scores, int left, int right)
-{
-    if (boxes.empty() || scores.empty()) {
-        return NOT_SUPPORTED;
-    }
-
-    int i = left;
-    int j = right;
-    F32 temp = scores[(left + right) / 2];
-
-    while (i <= j) {
-        while (scores[i] > temp) {
-            i++;
-        }
-        while (scores[j] < temp) {
-            j--;
-        }
-        if (i <= j) {
-            std::swap(boxes[i], boxes[j]);
-            std::swap(scores[i], scores[j]);
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j) {
-        qsort_descent(boxes, scores, left, j);
-    }
-    if (i < right) {
-        qsort_descent(boxes, scores, i, right);
-    }
-
-    return SUCCESS;
-}
-
-inline F32 intersectionarea(BoxRect a, BoxRect b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin) {
-        return 0.f;
-    }
-    F32 inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    F32 inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
-
-inline EE nms_pickedboxes(std::vector<BoxRect> boxes, std::vector<I64> &picked, F32 nms_threshold)
-{
-    I64 n = boxes.size();
-
-    std::vector<F32> areas(n);
-    for (I64 i = 0; i < n; i++) {
-        BoxRect box = boxes[i];
-
-        F32 width = box.xmax - box.xmin;
-        F32 height = box.ymax - box.ymin;
-
-        areas[i] = width * height;
-    }
-    for (I64 i = 0; i < n; i++) {
-        BoxRect a = boxes[i];
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++) {
-            BoxRect b = boxes[picked[j]];
-            F32 inter_area = intersectionarea(a, b);
-            F32 union_area = areas[i] + areas[picked[j]] - inter_area;
-
-            if (inter_area / union_area > nms_threshold) {
-                keep = 0;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-        }
-    }
-    return SUCCESS;
-}
+#include "cpu/nms_functions.h"
+#include "thread_affinity.h"
 
 template <typename T>
 EE detectionoutput_kernel(std::vector<void *> input,
@@ -109,8 +33,7 @@ EE detectionoutput_kernel(std::vector<void *> input,
     U32 num_total_priorbox = priorbox_width / 4;
     U32 numclass = num_class;
 
-    std::vector<std::vector<F32>> boxes;
-    boxes.resize(num_total_priorbox);
+    std::vector<BoxRect> boxes(num_total_priorbox);
     T *variance = priorbox + priorbox_width;
     // decode priorbox
     for (U32 i = 0; i < num_total_priorbox; i++) {
@@ -128,68 +51,61 @@ EE detectionoutput_kernel(std::vector<void *> input,
         F32 box_w = static_cast<F32>(exp(var[2] * loc[2]) * pb_w);
         F32 box_h = static_cast<F32>(exp(var[3] * loc[3]) * pb_h);
 
-        std::vector<F32> box;
-        box.resize(4);
-        box[0] = box_cx - box_w * 0.5f;
-        box[1] = box_cy - box_h * 0.5f;
-        box[2] = box_cx + box_w * 0.5f;
-        box[3] = box_cy + box_h * 0.5f;
-        // give box to boxes
-        boxes[i].assign(box.begin(), box.end());
+        boxes[i].xmin = box_cx - box_w * 0.5f;
+        boxes[i].ymin = box_cy - box_h * 0.5f;
+        boxes[i].xmax = box_cx + box_w * 0.5f;
+        boxes[i].ymax = box_cy + box_h * 0.5f;
     }
 
-    std::vector<std::vector<BoxRect>> allclass_boxrects;
-    std::vector<std::vector<F32>> allclass_boxscores;
-    allclass_boxrects.resize(numclass);
-    allclass_boxscores.resize(numclass);
-
-    for (U32 i = 1; i < numclass; i++) {
-        std::vector<BoxRect> class_boxrects;
-        std::vector<F32> class_boxscores;
+    std::vector<std::vector<BoxRect>> allclass_boxrects(numclass);
+    std::vector<std::vector<F32>> allclass_boxscores(numclass);
+    // class 0 is background, the others are independent and run in parallel
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (I32 i = 1; i < (I32)numclass; i++) {
+        std::vector<NMSCandidate> candidates;
         for (U32 j = 0; j < num_total_priorbox; j++) {
             F32 score = confidence[j * numclass + i];
-
             if (score > confidence_threshold) {
-                std::vector<F32> inbox;
-                inbox.assign(boxes[j].begin(), boxes[j].end());
-                BoxRect b = {inbox[0], inbox[1], inbox[2], inbox[3], i};
-                class_boxrects.push_back(b);
-                class_boxscores.push_back(score);
+                NMSCandidate c = {score, j};
+                candidates.push_back(c);
             }
         }
-        // sort the boxes with scores
-        qsort_descent(
-            class_boxrects, class_boxscores, 0, static_cast<int>(class_boxscores.size() - 1));
-
-        if (nms_top_k < (U32)class_boxrects.size()) {
-            class_boxrects.resize(nms_top_k);
-            class_boxscores.resize(nms_top_k);
+        // only the best nms_top_k boxes are sorted
+        nms_sort_candidates(candidates, nms_top_k);
+        std::vector<BoxRect> class_boxrects(candidates.size());
+        for (U32 j = 0; j < candidates.size(); j++) {
+            class_boxrects[j] = boxes[candidates[j].index];
+            class_boxrects[j].label = i;
         }
         // apply nms
-        std::vector<I64> picked;
-        nms_pickedboxes(class_boxrects, picked, nms_threshold);
+        std::vector<U32> picked;
+        nms_select(class_boxrects.data(), class_boxrects.size(), nms_threshold,
+            class_boxrects.size(), &picked);
 
-        for (I64 j = 0; j < (I64)picked.size(); j++) {
-            I64 picked_box = picked[j];
-            allclass_boxrects[i].push_back(class_boxrects[picked_box]);
-            allclass_boxscores[i].push_back(class_boxscores[picked_box]);
+        for (U32 j = 0; j < picked.size(); j++) {
+            allclass_boxrects[i].push_back(class_boxrects[picked[j]]);
+            allclass_boxscores[i].push_back(candidates[picked[j]].score);
         }
     }
 
-    std::vector<BoxRect> boxrects;
-    std::vector<F32> boxscores;
-
+    std::vector<BoxRect> allboxrects;
+    std::vector<NMSCandidate> allcandidates;
     for (U32 i = 1; i < numclass; i++) {
-        boxrects.insert(boxrects.end(), allclass_boxrects[i].begin(), allclass_boxrects[i].end());
-        boxscores.insert(
-            boxscores.end(), allclass_boxscores[i].begin(), allclass_boxscores[i].end());
+        for (U32 j = 0; j < allclass_boxrects[i].size(); j++) {
+            NMSCandidate c = {allclass_boxscores[i][j], (U32)allboxrects.size()};
+            allcandidates.push_back(c);
+            allboxrects.push_back(allclass_boxrects[i][j]);
+        }
     }
+    nms_sort_candidates(allcandidates, keep_top_k);
 
-    qsort_descent(boxrects, boxscores, 0, static_cast<int>(boxscores.size() - 1));
-
-    if (keep_top_k < (U32)boxrects.size()) {
-        boxrects.resize(keep_top_k);
-        boxscores.resize(keep_top_k);
+    std::vector<BoxRect> boxrects(allcandidates.size());
+    std::vector<F32> boxscores(allcandidates.size());
+    for (U32 i = 0; i < allcandidates.size(); i++) {
+        boxrects[i] = allboxrects[allcandidates[i].index];
+        boxscores[i] = allcandidates[i].score;
     }
 
     U32 num_detected = static_cast<U32>(boxrects.size());
@@ -0,0 +1,83 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _H_NMS_FUNCTIONS
+#define _H_NMS_FUNCTIONS
+
+#include <algorithm>
+#include <vector>
+#include "parameter_spec.h"
+#include "uni.h"
+
+// kept boxes are compared in blocks, so that a suppressed candidate stops early
+#define NMS_BLOCK 16
+
+typedef struct {
+    F32 score;
+    U32 index;
+} NMSCandidate;
+
+// descending score, equal scores keep the lower index
+inline bool nms_candidate_greater(const NMSCandidate &a, const NMSCandidate &b)
+{
+    return (a.score != b.score) ? (a.score > b.score) : (a.index < b.index);
+}
+
+// keep the best topk candidates in order, only those are sorted
+inline void nms_sort_candidates(std::vector<NMSCandidate> &candidates, U32 topk)
+{
+    if (topk < candidates.size()) {
+        std::nth_element(candidates.begin(), candidates.begin() + topk, candidates.end(),
+            nms_candidate_greater);
+        candidates.resize(topk);
+    }
+    std::sort(candidates.begin(), candidates.end(), nms_candidate_greater);
+}
+
+// Greedy NMS over boxes sorted by descending score, pushes the positions of at most maxOutput
+// kept boxes into picked. Kept boxes are stored as separate coordinate arrays, so that the IoU
+// of a candidate against them is a branch free loop the compiler vectorizes.
+inline void nms_select(
+    const BoxRect *boxes, U32 num, F32 iouThreshold, U32 maxOutput, std::vector<U32> *picked)
+{
+    U32 capacity = UNI_MIN(num, maxOutput);
+    std::vector<F32> xmin(capacity), ymin(capacity), xmax(capacity), ymax(capacity);
+    std::vector<F32> area(capacity);
+    U32 kept = 0;
+    for (U32 i = 0; i < num && kept < maxOutput; i++) {
+        BoxRect a = boxes[i];
+        F32 areaA = (a.xmax - a.xmin) * (a.ymax - a.ymin);
+        int suppress = 0;
+        for (U32 j = 0; j < kept && !suppress; j += NMS_BLOCK) {
+            U32 end = UNI_MIN(j + NMS_BLOCK, kept);
+            for (U32 k = j; k < end; k++) {
+                F32 w = std::min(a.xmax, xmax[k]) - std::max(a.xmin, xmin[k]);
+                F32 h = std::min(a.ymax, ymax[k]) - std::max(a.ymin, ymin[k]);
+                F32 inter = std::max(w, 0.f) * std::max(h, 0.f);
+                // inter / union > iouThreshold without a division
+                suppress |= (inter > iouThreshold * (areaA + area[k] - inter));
+            }
+        }
+        if (!suppress) {
+            xmin[kept] = a.xmin;
+            ymin[kept] = a.ymin;
+            xmax[kept] = a.xmax;
+            ymax[kept] = a.ymax;
+            area[kept] = areaA;
+            kept++;
+            picked->push_back(i);
+        }
+    }
+}
+#endif
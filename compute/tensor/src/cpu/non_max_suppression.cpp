@@ -12,89 +12,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "cpu/tensor_computing_cpu.h"
-
-inline EE qsort_descent(std::vector<BoxRect> &boxes,
-    std::vector<I64> &boxindex,
-    std::vector<F32> &scores,
-    int left,
-    int right)
-{
-    if (boxes.empty() || scores.empty()) {
-        return NOT_SUPPORTED;
-    }
-
-    int i = left;
-    int j = right;
-    F32 temp = scores[(left + right) / 2];
-
-    while (i <= j) {
-        while (scores[i] > temp) {
-            i++;
-        }
-        while (scores[j] < temp) {
-            j--;
-        }
-        if (i <= j) {
-            std::swap(boxes[i], boxes[j]);
-            std::swap(scores[i], scores[j]);
-            std::swap(boxindex[i], boxindex[j]);
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j) {
-        qsort_descent(boxes, boxindex, scores, left, j);
-    }
-    if (i < right) {
-        qsort_descent(boxes, boxindex, scores, i, right);
-    }
-
-    return SUCCESS;
-}
-
-inline F32 intersectionarea(BoxRect a, BoxRect b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin) {
-        return 0.f;
-    }
-    F32 inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    F32 inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
-
-inline EE nms_pickedboxes(std::vector<BoxRect> boxes, std::vector<I64> &picked, F32 nms_threshold)
-{
-    I64 n = boxes.size();
-
-    std::vector<F32> areas(n);
-    for (I64 i = 0; i < n; i++) {
-        BoxRect box = boxes[i];
-
-        F32 width = box.xmax - box.xmin;
-        F32 height = box.ymax - box.ymin;
-
-        areas[i] = width * height;
-    }
-    for (I64 i = 0; i < n; i++) {
-        BoxRect a = boxes[i];
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++) {
-            BoxRect b = boxes[picked[j]];
-            F32 inter_area = intersectionarea(a, b);
-            F32 union_area = areas[i] + areas[picked[j]] - inter_area;
-
-            if (inter_area / union_area > nms_threshold) {
-                keep = 0;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-        }
-    }
-    return SUCCESS;
-}
+#include "cpu/nms_functions.h"
+#include "thread_affinity.h"
 
 template <typename T>
 EE non_max_suppression_kernel(std::vector<void *> input,
@@ -108,55 +27,48 @@ EE non_max_suppression_kernel(std::vector<void *> input,
     T *box = (T *)input[0];
     T *score = (T *)input[1];
     // decode box
-    std::vector<std::vector<F32>> boxes;
-    boxes.resize(spatial_dim);
+    std::vector<BoxRect> boxes(spatial_dim);
     for (U32 i = 0; i < spatial_dim; i++) {
-        F32 ymin = std::min<T>(box[i * 4], box[i * 4 + 2]);
-        F32 xmin = std::min<T>(box[i * 4 + 1], box[i * 4 + 3]);
-        F32 ymax = std::max<T>(box[i * 4], box[i * 4 + 2]);
-        F32 xmax = std::max<T>(box[i * 4 + 1], box[i * 4 + 3]);
-        std::vector<F32> box_pixel;
-        box_pixel.resize(4);
-        box_pixel[0] = xmin;
-        box_pixel[1] = ymin;
-        box_pixel[2] = xmax;
-        box_pixel[3] = ymax;
-        boxes[i].assign(box_pixel.begin(), box_pixel.end());
+        boxes[i].xmin = std::min<T>(box[i * 4 + 1], box[i * 4 + 3]);
+        boxes[i].ymin = std::min<T>(box[i * 4], box[i * 4 + 2]);
+        boxes[i].xmax = std::max<T>(box[i * 4 + 1], box[i * 4 + 3]);
+        boxes[i].ymax = std::max<T>(box[i * 4], box[i * 4 + 2]);
+        boxes[i].label = 0;
     }
 
-    std::vector<BoxInfo> all_boxinfo;
-    for (U32 i = 0; i < num_class; i++) {
-        std::vector<BoxRect> class_boxrects;
-        std::vector<F32> class_boxscores;
-        std::vector<I64> class_boxindex;
+    // classes are independent, run them in parallel and concatenate in class order
+    std::vector<std::vector<U32>> class_boxindex(num_class);
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (I32 i = 0; i < (I32)num_class; i++) {
+        const T *class_score = score + i * spatial_dim;
+        std::vector<NMSCandidate> candidates;
         for (U32 j = 0; j < spatial_dim; j++) {
-            F32 score_pixel = score[i * spatial_dim + j];
-            if (score_pixel > score_threshold) {
-                std::vector<F32> inbox;
-                inbox.assign(boxes[j].begin(), boxes[j].end());
-                BoxRect b = {inbox[0], inbox[1], inbox[2], inbox[3], i};
-                class_boxrects.push_back(b);
-                class_boxindex.push_back(j);
-                class_boxscores.push_back(score_pixel);
+            if (class_score[j] > score_threshold) {
+                NMSCandidate c = {(F32)class_score[j], j};
+                candidates.push_back(c);
             }
         }
-        // sort boxes and box index
-        qsort_descent(class_boxrects, class_boxindex, class_boxscores, 0,
-            static_cast<int>(class_boxscores.size() - 1));
-        std::vector<I64> picked;
-        // apply nms
-        nms_pickedboxes(class_boxrects, picked, iou_threshold);
-        std::vector<I64> boxindex;
-        for (I64 p = 0; p < (I64)picked.size(); p++) {
-            I64 picked_box = picked[p];
-            boxindex.push_back(class_boxindex[picked_box]);
+        nms_sort_candidates(candidates, candidates.size());
+        std::vector<BoxRect> class_boxrects(candidates.size());
+        for (U32 j = 0; j < candidates.size(); j++) {
+            class_boxrects[j] = boxes[candidates[j].index];
         }
-        if (max_output_boxes_per_class < (U32)boxindex.size()) {
-            boxindex.resize(max_output_boxes_per_class);
+        // apply nms
+        std::vector<U32> picked;
+        nms_select(class_boxrects.data(), class_boxrects.size(), iou_threshold,
+            max_output_boxes_per_class, &picked);
+        for (U32 j = 0; j < picked.size(); j++) {
+            class_boxindex[i].push_back(candidates[picked[j]].index);
         }
-        for (I64 j = 0; j < (I64)boxindex.size(); j++) {
+    }
+
+    std::vector<BoxInfo> all_boxinfo;
+    for (U32 i = 0; i < num_class; i++) {
+        for (U32 j = 0; j < class_boxindex[i].size(); j++) {
             BoxInfo bi;
-            bi.box_index = boxindex[j];
+            bi.box_index = class_boxindex[i][j];
             bi.label = i;
             all_boxinfo.push_back(bi);
         }
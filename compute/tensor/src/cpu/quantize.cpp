@@ -112,8 +112,8 @@ EE quantize_cpu(
     }
 
 #if defined(_USE_X86) && defined(_USE_INT8)
-    if (IS_X86_AVX512(arch)) {
-        return quantize_x86(dDesc, data, qDesc, qData, scale);
+    if (IS_X86(arch)) {
+        return quantize_x86(dDesc, data, qDesc, qData, scale, arch);
     }
 #endif
 
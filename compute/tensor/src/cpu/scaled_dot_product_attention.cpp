@@ -0,0 +1,346 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <float.h>
+#include "cpu/tensor_computing_cpu.h"
+#if defined(_USE_X86) && defined(_USE_FP32)
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+#endif
+#include "thread_affinity.h"
+
+// query rows handled by one task
+#define SDPA_QUERY_TILE 32
+
+// view desc as [n, h, rows, cols]
+static EE sdpa_get_dims(TensorDesc desc, U32 *n, U32 *h, U32 *rows, U32 *cols)
+{
+    if (desc.nDims < 1 || desc.nDims > 4 || desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) {
+        return NOT_SUPPORTED;
+    }
+    *cols = desc.dims[0];
+    *rows = (desc.nDims > 1) ? desc.dims[1] : 1;
+    *h = (desc.nDims > 2) ? desc.dims[2] : 1;
+    *n = (desc.nDims > 3) ? desc.dims[3] : 1;
+    return SUCCESS;
+}
+
+static EE sdpa_broadcast(U32 *a, U32 b)
+{
+    if (*a == 1) {
+        *a = b;
+    } else if (b != 1 && b != *a) {
+        return NOT_MATCH;
+    }
+    return SUCCESS;
+}
+
+inline U32 sdpa_index(U32 i, U32 size)
+{
+    return (size == 1) ? 0 : i;
+}
+
+static bool sdpa_use_x86(Arch arch, DataType dt)
+{
+#if defined(_USE_X86) && defined(_USE_FP32)
+    return IS_X86(arch) && dt == DT_F32;
+#else
+    return false;
+#endif
+}
+
+static U32 sdpa_thread_bytes(Arch arch, DataType dt, U32 length, U32 dim, U32 vdim)
+{
+#if defined(_USE_X86) && defined(_USE_FP32)
+    if (sdpa_use_x86(arch, dt)) {
+        return scaled_dot_product_attention_fp32_tmp_bytes(SDPA_QUERY_TILE, dim, vdim);
+    }
+#endif
+    return (length + vdim) * bytesOf(DT_F32);
+}
+
+EE scaled_dot_product_attention_infer_output_size_cpu(TensorDesc queryDesc,
+    TensorDesc keyDesc,
+    TensorDesc valueDesc,
+    ScaledDotProductAttentionParamSpec p,
+    TensorDesc *outputDesc)
+{
+    U32 qn, qh, sq, dim, kn, kh, kr, kc, vn, vh, sk, vdim;
+    CHECK_STATUS(sdpa_get_dims(queryDesc, &qn, &qh, &sq, &dim));
+    CHECK_STATUS(sdpa_get_dims(keyDesc, &kn, &kh, &kr, &kc));
+    CHECK_STATUS(sdpa_get_dims(valueDesc, &vn, &vh, &sk, &vdim));
+    U32 length = p.transpose_key ? kr : kc;
+    U32 kdim = p.transpose_key ? kc : kr;
+    if (kdim != dim || length != sk) {
+        return NOT_MATCH;
+    }
+    U32 n = qn, h = qh;
+    CHECK_STATUS(sdpa_broadcast(&n, kn));
+    CHECK_STATUS(sdpa_broadcast(&n, vn));
+    CHECK_STATUS(sdpa_broadcast(&h, kh));
+    CHECK_STATUS(sdpa_broadcast(&h, vh));
+    *outputDesc = queryDesc;
+    outputDesc->nDims = UNI_MAX(queryDesc.nDims, UNI_MAX(keyDesc.nDims, valueDesc.nDims));
+    outputDesc->nDims = UNI_MAX(outputDesc->nDims, 2);
+    if (outputDesc->nDims != queryDesc.nDims) {
+        outputDesc->df = DF_NCHW;
+    }
+    outputDesc->dims[0] = vdim;
+    outputDesc->dims[1] = sq;
+    if (outputDesc->nDims > 2) {
+        outputDesc->dims[2] = h;
+    }
+    if (outputDesc->nDims > 3) {
+        outputDesc->dims[3] = n;
+    }
+    return SUCCESS;
+}
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_cpu(TensorDesc queryDesc,
+    TensorDesc keyDesc,
+    TensorDesc valueDesc,
+    TensorDesc maskDesc,
+    ScaledDotProductAttentionParamSpec p,
+    U32 *bytes,
+    Arch arch)
+{
+    U32 qn, qh, sq, dim, vn, vh, sk, vdim;
+    CHECK_STATUS(sdpa_get_dims(queryDesc, &qn, &qh, &sq, &dim));
+    CHECK_STATUS(sdpa_get_dims(valueDesc, &vn, &vh, &sk, &vdim));
+    *bytes = sdpa_thread_bytes(arch, queryDesc.dt, sk, dim, vdim) * OMP_NUM_THREADS;
+    if (p.mask_mode == SDPA_MASK_ATTENTION) {
+        *bytes += tensorNumElements(maskDesc) * bytesOf(queryDesc.dt);
+    }
+    return SUCCESS;
+}
+
+// expand a 0/1 sequence mask into additive values, same as attention_general
+template <typename T>
+static U32 sdpa_attention_bias(const T *input, U32 num, U32 length, T *bias)
+{
+    F32 count = 0;
+    for (U32 k = 0; k < length; k++) {
+        count += input[k];
+    }
+    for (U32 i = 0; i < num * length; i++) {
+        bias[i] = (1 - input[i]) * -10000.0;
+    }
+    return count;
+}
+
+// reference for one query tile, one score row at a time
+template <typename T>
+static void sdpa_rows(const T *query,
+    const T *key,
+    const T *value,
+    const T *mask,
+    I32 rows,
+    I32 length,
+    I32 dim,
+    I32 vdim,
+    I32 maskRowStride,
+    I32 maskColStride,
+    I32 validRows,
+    ScaledDotProductAttentionParamSpec p,
+    F32 *tmp,
+    T *output)
+{
+    F32 *score = tmp;
+    F32 *acc = tmp + length;
+    for (I32 i = 0; i < rows; i++) {
+        F32 max_s = -FLT_MAX;
+        for (I32 j = 0; j < length; j++) {
+            F32 s = 0;
+            for (I32 c = 0; c < dim; c++) {
+                F32 k = p.transpose_key ? key[j * dim + c] : key[c * length + j];
+                s += query[i * dim + c] * k;
+            }
+            s *= p.scale;
+            if (mask != nullptr) {
+                if (i < validRows) {
+                    s += mask[i * maskRowStride + j * maskColStride] * p.mask_scale;
+                } else {
+                    s += -10000.0 * p.mask_scale;
+                }
+            }
+            score[j] = s;
+            max_s = UNI_MAX(max_s, s);
+        }
+        F32 sum_s = 0;
+        for (I32 j = 0; j < length; j++) {
+            score[j] = exp(score[j] - max_s);
+            sum_s += score[j];
+        }
+        memset(acc, 0, vdim * sizeof(F32));
+        for (I32 j = 0; j < length; j++) {
+            for (I32 c = 0; c < vdim; c++) {
+                acc[c] += score[j] * value[j * vdim + c];
+            }
+        }
+        for (I32 c = 0; c < vdim; c++) {
+            output[i * vdim + c] = acc[c] / sum_s;
+        }
+    }
+}
+
+template <typename T>
+static EE sdpa(TensorDesc queryDesc,
+    const T *query,
+    TensorDesc keyDesc,
+    const T *key,
+    U32 keyStride,
+    TensorDesc valueDesc,
+    const T *value,
+    U32 valueStride,
+    TensorDesc maskDesc,
+    const T *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    U8 *tmp,
+    T *output,
+    Arch arch)
+{
+    U32 qn, qh, sq, dim, kn, kh, kr, kc, vn, vh, sk, vdim;
+    CHECK_STATUS(sdpa_get_dims(queryDesc, &qn, &qh, &sq, &dim));
+    CHECK_STATUS(sdpa_get_dims(keyDesc, &kn, &kh, &kr, &kc));
+    CHECK_STATUS(sdpa_get_dims(valueDesc, &vn, &vh, &sk, &vdim));
+    U32 n = qn, h = qh;
+    CHECK_STATUS(sdpa_broadcast(&n, kn));
+    CHECK_STATUS(sdpa_broadcast(&n, vn));
+    CHECK_STATUS(sdpa_broadcast(&h, kh));
+    CHECK_STATUS(sdpa_broadcast(&h, vh));
+
+    U32 mn = 1, mh = 1, mq = 1, mk = 1;
+    I32 validRows = sq;
+    if (p.mask_mode == SDPA_MASK_ATTENTION) {
+        mk = maskDesc.dims[0];
+        mn = tensorNumElements(maskDesc) / mk;
+        if (mk != sk || tmpBytes < mn * mk * sizeof(T)) {
+            return NOT_MATCH;
+        }
+        T *bias = (T *)tmp;
+        validRows = UNI_MIN(sdpa_attention_bias<T>(mask, mn, mk, bias), sq);
+        mask = bias;
+        tmp += mn * mk * sizeof(T);
+        tmpBytes -= mn * mk * sizeof(T);
+    } else if (p.mask_mode == SDPA_MASK_ADD) {
+        CHECK_STATUS(sdpa_get_dims(maskDesc, &mn, &mh, &mq, &mk));
+        U32 tn = n, th = h, tq = sq, tk = sk;
+        CHECK_STATUS(sdpa_broadcast(&tn, mn));
+        CHECK_STATUS(sdpa_broadcast(&th, mh));
+        CHECK_STATUS(sdpa_broadcast(&tq, mq));
+        CHECK_STATUS(sdpa_broadcast(&tk, mk));
+        if (tn != n || th != h || tq != sq || tk != sk) {
+            return NOT_MATCH;
+        }
+    } else {
+        mask = nullptr;
+    }
+    if (keyStride == 0) {
+        keyStride = sk * dim;
+    }
+    if (valueStride == 0) {
+        valueStride = sk * vdim;
+    }
+    I32 maskRowStride = (mq == 1) ? 0 : mk;
+    I32 maskColStride = (mk == 1) ? 0 : 1;
+
+    bool useX86 = sdpa_use_x86(arch, queryDesc.dt);
+#if defined(_USE_X86) && defined(_USE_FP32)
+    auto x86Func = IS_X86_AVX512(arch) ? avx512::scaled_dot_product_attention_fp32
+                                       : scaled_dot_product_attention_fp32;
+#endif
+    U32 threadBytes = sdpa_thread_bytes(arch, queryDesc.dt, sk, dim, vdim);
+    I32 threads = UNI_MIN((I32)(tmpBytes / threadBytes), OMP_NUM_THREADS);
+    if (threads < 1) {
+        return NOT_MATCH;
+    }
+    I32 tiles = (sq + SDPA_QUERY_TILE - 1) / SDPA_QUERY_TILE;
+    I32 tasks = n * h * tiles;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(threads)
+#endif
+    for (I32 t = 0; t < tasks; t++) {
+#ifdef _USE_OPENMP
+        F32 *threadTmp = (F32 *)(tmp + threadBytes * omp_get_thread_num());
+#else
+        F32 *threadTmp = (F32 *)tmp;
+#endif
+        U32 b = t / (h * tiles);
+        U32 head = t / tiles % h;
+        I32 i = t % tiles * SDPA_QUERY_TILE;
+        I32 rows = UNI_MIN(SDPA_QUERY_TILE, (I32)sq - i);
+        const T *q = query + ((sdpa_index(b, qn) * qh + sdpa_index(head, qh)) * sq + i) * dim;
+        const T *k = key + (sdpa_index(b, kn) * kh + sdpa_index(head, kh)) * keyStride;
+        const T *v = value + (sdpa_index(b, vn) * vh + sdpa_index(head, vh)) * valueStride;
+        const T *m = nullptr;
+        if (mask != nullptr) {
+            m = mask + (sdpa_index(b, mn) * mh + sdpa_index(head, mh)) * mq * mk +
+                i * maskRowStride;
+        }
+        T *o = output + ((b * h + head) * sq + i) * vdim;
+        I32 valid = UNI_MAX(validRows - i, 0);
+        if (useX86) {
+#if defined(_USE_X86) && defined(_USE_FP32)
+            x86Func((const F32 *)q, (const F32 *)k, (const F32 *)v, (const F32 *)m, rows, sk, dim,
+                vdim, maskRowStride, maskColStride, valid, p, threadTmp, (F32 *)o);
+#endif
+        } else {
+            sdpa_rows<T>(q, k, v, m, rows, sk, dim, vdim, maskRowStride, maskColStride, valid, p,
+                threadTmp, o);
+        }
+    }
+    return SUCCESS;
+}
+
+EE scaled_dot_product_attention_cpu(TensorDesc queryDesc,
+    void *query,
+    TensorDesc keyDesc,
+    void *key,
+    U32 keyStride,
+    TensorDesc valueDesc,
+    void *value,
+    U32 valueStride,
+    TensorDesc maskDesc,
+    void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
+{
+    EE ret = SUCCESS;
+    switch (outputDesc.dt) {
+#ifdef _USE_FP32
+        case DT_F32: {
+            ret = sdpa<F32>(queryDesc, (const F32 *)query, keyDesc, (const F32 *)key, keyStride,
+                valueDesc, (const F32 *)value, valueStride, maskDesc, (const F32 *)mask, p,
+                tmpBytes, (U8 *)tmp, (F32 *)output, arch);
+            break;
+        }
+#endif
+#ifdef _USE_FP16
+        case DT_F16: {
+            ret = sdpa<F16>(queryDesc, (const F16 *)query, keyDesc, (const F16 *)key, keyStride,
+                valueDesc, (const F16 *)value, valueStride, maskDesc, (const F16 *)mask, p,
+                tmpBytes, (U8 *)tmp, (F16 *)output, arch);
+            break;
+        }
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
+}
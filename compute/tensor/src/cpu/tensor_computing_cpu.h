@@ -323,9 +323,12 @@ EE instance_norm_cpu(TensorDesc inputDesc,
     void *output,
     Arch arch);
 
+EE topk_infer_forward_tmp_bytes_cpu(TensorDesc inputDesc, TopKParamSpec p, U32 *bytes);
+
 EE topk_cpu(TensorDesc inputDesc,
     void *input,
     TopKParamSpec p,
+    U32 tmpBytes,
     void *tmp,
     TensorDesc outputDesc,
     void *output,
@@ -350,4 +353,35 @@ EE gat_cpu(TensorDesc node_feature_desc,
     TensorDesc outputDesc,
     void *output,
     Arch arch);
+
+EE scaled_dot_product_attention_infer_output_size_cpu(TensorDesc queryDesc,
+    TensorDesc keyDesc,
+    TensorDesc valueDesc,
+    ScaledDotProductAttentionParamSpec p,
+    TensorDesc *outputDesc);
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes_cpu(TensorDesc queryDesc,
+    TensorDesc keyDesc,
+    TensorDesc valueDesc,
+    TensorDesc maskDesc,
+    ScaledDotProductAttentionParamSpec p,
+    U32 *bytes,
+    Arch arch);
+
+EE scaled_dot_product_attention_cpu(TensorDesc queryDesc,
+    void *query,
+    TensorDesc keyDesc,
+    void *key,
+    U32 keyStride,
+    TensorDesc valueDesc,
+    void *value,
+    U32 valueStride,
+    TensorDesc maskDesc,
+    void *mask,
+    ScaledDotProductAttentionParamSpec p,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch);
 #endif
@@ -12,73 +12,263 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "cpu/tensor_computing_cpu.h"
+#include "thread_affinity.h"
 #include <algorithm>
 
+// columns of a strided axis that are selected together, and block size of the contiguous filter
+#define TOPK_COLUMNS 16
+#define TOPK_BLOCK 16
+
+template <typename T>
+struct TopKItem {
+    T value;
+    int index;
+};
+
+// a is better than b, equal values keep the lower index
+template <typename T, bool increase>
+inline static bool topk_better(const TopKItem<T> &a, const TopKItem<T> &b)
+{
+    if (a.value != b.value) {
+        return increase ? (a.value < b.value) : (a.value > b.value);
+    }
+    return a.index < b.index;
+}
+
+// value enters a top k whose worst element is threshold, candidates come in index order, so an
+// equal value never does
+template <typename T, bool increase>
+inline static bool topk_pass(T value, T threshold)
+{
+    return increase ? (value < threshold) : (value > threshold);
+}
+
+template <typename T, bool increase>
+inline static void topk_replace(TopKItem<T> *heap, int num, T value, int index)
+{
+    std::pop_heap(heap, heap + num, topk_better<T, increase>);
+    heap[num - 1].value = value;
+    heap[num - 1].index = index;
+    std::push_heap(heap, heap + num, topk_better<T, increase>);
+}
+
 template <typename T, bool increase, bool order>
-inline static void topk_kernel(
-    const TensorDesc &inputDesc, T *input, const TopKParamSpec &p, int *tmp, T *output, int *index)
+inline static void topk_store(TopKItem<T> *heap, int num, int stride, T *output, int *index)
+{
+    if (order) {
+        std::sort_heap(heap, heap + num, topk_better<T, increase>);
+    } else {
+        std::sort(heap, heap + num,
+            [](const TopKItem<T> &a, const TopKItem<T> &b) { return a.index < b.index; });
+    }
+    for (int k = 0; k < num; k++) {
+        output[k * stride] = heap[k].value;
+        index[k * stride] = heap[k].index;
+    }
+}
+
+// contiguous axis, blocks without a candidate are skipped by a compare loop that vectorizes
+template <typename T, bool increase>
+static void topk_select_row(const T *input, int loops, int num, TopKItem<T> *heap)
+{
+    for (int k = 0; k < num; k++) {
+        heap[k].value = input[k];
+        heap[k].index = k;
+    }
+    std::make_heap(heap, heap + num, topk_better<T, increase>);
+    T threshold = heap[0].value;
+    int k = num;
+    for (; k + TOPK_BLOCK <= loops; k += TOPK_BLOCK) {
+        int hit = 0;
+        for (int l = 0; l < TOPK_BLOCK; l++) {
+            hit |= topk_pass<T, increase>(input[k + l], threshold);
+        }
+        if (!hit) {
+            continue;
+        }
+        for (int l = 0; l < TOPK_BLOCK; l++) {
+            if (topk_pass<T, increase>(input[k + l], threshold)) {
+                topk_replace<T, increase>(heap, num, input[k + l], k + l);
+                threshold = heap[0].value;
+            }
+        }
+    }
+    for (; k < loops; k++) {
+        if (topk_pass<T, increase>(input[k], threshold)) {
+            topk_replace<T, increase>(heap, num, input[k], k);
+            threshold = heap[0].value;
+        }
+    }
+}
+
+// strided axis, up to TOPK_COLUMNS neighbouring columns share every contiguous load
+template <typename T, bool increase>
+static void topk_select_columns(
+    const T *input, int loops, int loopInner, int columns, int num, TopKItem<T> *heaps)
+{
+    T threshold[TOPK_COLUMNS];
+    for (int c = 0; c < columns; c++) {
+        TopKItem<T> *heap = heaps + c * num;
+        for (int k = 0; k < num; k++) {
+            heap[k].value = input[k * loopInner + c];
+            heap[k].index = k;
+        }
+        std::make_heap(heap, heap + num, topk_better<T, increase>);
+        threshold[c] = heap[0].value;
+    }
+    for (int k = num; k < loops; k++) {
+        const T *row = input + k * loopInner;
+        int hit = 0;
+        for (int c = 0; c < columns; c++) {
+            hit |= topk_pass<T, increase>(row[c], threshold[c]);
+        }
+        if (!hit) {
+            continue;
+        }
+        for (int c = 0; c < columns; c++) {
+            if (topk_pass<T, increase>(row[c], threshold[c])) {
+                TopKItem<T> *heap = heaps + c * num;
+                topk_replace<T, increase>(heap, num, row[c], k);
+                threshold[c] = heap[0].value;
+            }
+        }
+    }
+}
+
+template <typename T>
+static int topk_thread_bytes(int loopInner, int num)
+{
+    return UNI_MIN(loopInner, TOPK_COLUMNS) * num * sizeof(TopKItem<T>);
+}
+
+static void topk_get_loops(
+    const TensorDesc &inputDesc, const TopKParamSpec &p, int *loopOuter, int *loops, int *loopInner)
 {
     int axis = inputDesc.nDims - 1 - (p.axis + inputDesc.nDims) % inputDesc.nDims;
-    int loopInner = 1, loops = inputDesc.dims[axis], loopOuter = 1;
+    *loopInner = 1;
+    *loops = inputDesc.dims[axis];
+    *loopOuter = 1;
     for (int i = 0; i < axis; i++) {
-        loopInner *= inputDesc.dims[i];
+        *loopInner *= inputDesc.dims[i];
     }
     for (U32 i = axis + 1; i < inputDesc.nDims; i++) {
-        loopOuter *= inputDesc.dims[i];
+        *loopOuter *= inputDesc.dims[i];
     }
+}
+
+// O(n log k) selection per row instead of sorting the whole axis, rows run in parallel
+template <typename T, bool increase, bool order>
+inline static EE topk_kernel(const TensorDesc &inputDesc,
+    T *input,
+    const TopKParamSpec &p,
+    U32 tmpBytes,
+    void *tmp,
+    T *output,
+    int *index)
+{
+    int loopOuter, loops, loopInner;
+    topk_get_loops(inputDesc, p, &loopOuter, &loops, &loopInner);
     int num = UNI_MIN(loops, p.topk);
-    int *tmpEnd = tmp + loops;
-    for (int i = 0; i < loopOuter; i++) {
-        int offset = i * loops * loopInner;
-        for (int j = 0; j < loopInner; j++, offset++) {
-            for (int k = 0; k < loops; k++) {
-                tmp[k] = k;
-            }
-            if (increase) {
-                std::sort(tmp, tmpEnd, [&input, &offset, &loopInner](int i1, int i2) {
-                    return input[offset + i1 * loopInner] < input[offset + i2 * loopInner];
-                });
-            } else {
-                std::sort(tmp, tmpEnd, [&input, &offset, &loopInner](int i1, int i2) {
-                    return input[offset + i1 * loopInner] > input[offset + i2 * loopInner];
-                });
-            }
-            if (!order) {
-                std::sort(tmp, tmp + num);
-            }
-            for (int k = 0; k < num; k++) {
-                int id = (i * p.topk + k) * loopInner + j;
-                index[id] = tmp[k];
-                output[id] = input[offset + tmp[k] * loopInner];
+    if (num <= 0) {
+        return SUCCESS;
+    }
+    int threadBytes = topk_thread_bytes<T>(loopInner, num);
+    int threads = UNI_MIN((int)(tmpBytes / threadBytes), OMP_NUM_THREADS);
+    if (threads < 1) {
+        return NOT_MATCH;
+    }
+    int blocks = (loopInner + TOPK_COLUMNS - 1) / TOPK_COLUMNS;
+    int tasks = loopOuter * blocks;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(threads)
+#endif
+    for (int t = 0; t < tasks; t++) {
+#ifdef _USE_OPENMP
+        TopKItem<T> *heaps = (TopKItem<T> *)((U8 *)tmp + threadBytes * omp_get_thread_num());
+#else
+        TopKItem<T> *heaps = (TopKItem<T> *)tmp;
+#endif
+        int i = t / blocks;
+        int j = t % blocks * TOPK_COLUMNS;
+        const T *in = input + i * loops * loopInner + j;
+        T *out = output + i * p.topk * loopInner + j;
+        int *id = index + i * p.topk * loopInner + j;
+        if (loopInner == 1) {
+            topk_select_row<T, increase>(in, loops, num, heaps);
+            topk_store<T, increase, order>(heaps, num, 1, out, id);
+        } else {
+            int columns = UNI_MIN(TOPK_COLUMNS, loopInner - j);
+            topk_select_columns<T, increase>(in, loops, loopInner, columns, num, heaps);
+            for (int c = 0; c < columns; c++) {
+                topk_store<T, increase, order>(heaps + c * num, num, loopInner, out + c, id + c);
             }
         }
     }
+    return SUCCESS;
 }
 
 template <typename T, bool increase>
-inline static void topk_wrapper0(
-    const TensorDesc &inputDesc, T *input, const TopKParamSpec &p, int *tmp, T *output, int *index)
+inline static EE topk_wrapper0(const TensorDesc &inputDesc,
+    T *input,
+    const TopKParamSpec &p,
+    U32 tmpBytes,
+    void *tmp,
+    T *output,
+    int *index)
 {
+    EE ret;
     if (p.sorted) {
-        topk_kernel<T, increase, true>(inputDesc, input, p, tmp, output, index);
+        ret = topk_kernel<T, increase, true>(inputDesc, input, p, tmpBytes, tmp, output, index);
     } else {
-        topk_kernel<T, increase, false>(inputDesc, input, p, tmp, output, index);
+        ret = topk_kernel<T, increase, false>(inputDesc, input, p, tmpBytes, tmp, output, index);
     }
+    return ret;
 }
+
 template <typename T>
-inline static void topk_wrapper1(
-    const TensorDesc &inputDesc, T *input, const TopKParamSpec &p, int *tmp, T *output, int *index)
+inline static EE topk_wrapper1(const TensorDesc &inputDesc,
+    T *input,
+    const TopKParamSpec &p,
+    U32 tmpBytes,
+    void *tmp,
+    T *output,
+    int *index)
 {
+    EE ret;
     if (p.largest) {
-        topk_wrapper0<T, false>(inputDesc, input, p, tmp, output, index);
+        ret = topk_wrapper0<T, false>(inputDesc, input, p, tmpBytes, tmp, output, index);
     } else {
-        topk_wrapper0<T, true>(inputDesc, input, p, tmp, output, index);
+        ret = topk_wrapper0<T, true>(inputDesc, input, p, tmpBytes, tmp, output, index);
     }
+    return ret;
+}
+
+EE topk_infer_forward_tmp_bytes_cpu(TensorDesc inputDesc, TopKParamSpec p, U32 *bytes)
+{
+    int loopOuter, loops, loopInner;
+    topk_get_loops(inputDesc, p, &loopOuter, &loops, &loopInner);
+    int num = UNI_MIN(loops, p.topk);
+    EE ret = SUCCESS;
+    switch (inputDesc.dt) {
+        case DT_F32:
+            *bytes = topk_thread_bytes<F32>(loopInner, num) * OMP_NUM_THREADS;
+            break;
+#ifdef _USE_FP16
+        case DT_F16:
+            *bytes = topk_thread_bytes<F16>(loopInner, num) * OMP_NUM_THREADS;
+            break;
+#endif
+        default:
+            ret = NOT_SUPPORTED;
+            break;
+    }
+    return ret;
 }
 
 EE topk_cpu(TensorDesc inputDesc,
     void *input,
     TopKParamSpec p,
+    U32 tmpBytes,
     void *tmp,
     TensorDesc outputDesc,
     void *output,
@@ -91,13 +281,13 @@ EE topk_cpu(TensorDesc inputDesc,
     EE ret;
     switch (inputDesc.dt) {
         case DT_F32:
-            topk_wrapper1<F32>(inputDesc, (F32 *)input, p, (I32 *)tmp, (F32 *)output, (I32 *)index);
-            ret = SUCCESS;
+            ret = topk_wrapper1<F32>(
+                inputDesc, (F32 *)input, p, tmpBytes, tmp, (F32 *)output, (I32 *)index);
             break;
 #ifdef _USE_FP16
         case DT_F16:
-            topk_wrapper1<F16>(inputDesc, (F16 *)input, p, (I32 *)tmp, (F16 *)output, (I32 *)index);
-            ret = SUCCESS;
+            ret = topk_wrapper1<F16>(
+                inputDesc, (F16 *)input, p, tmpBytes, tmp, (F16 *)output, (I32 *)index);
             break;
 #endif
         default:
@@ -20,6 +20,73 @@
 #include "cpu/x86/int8/tensor_computing_int8.h"
 #endif
 #include "tensor_transpose.h"
+#include "profiling.h"
+
+static ConvolutionForwardAlgorithm convolution_tune_algorithm_x86(TensorDesc inputDesc,
+    TensorDesc filterDesc,
+    TensorDesc outputDesc,
+    ConvolutionParamSpec convParamSpec,
+    std::vector<ConvolutionForwardAlgorithm> convolutionAlgorithms,
+    Arch arch)
+{
+    U32 filterBytes = 0;
+    U32 tmpBytes = 0;
+    for (U32 i = 0; i < convolutionAlgorithms.size(); i++) {
+        U32 bytes = 0;
+        CHECK_STATUS(convolution_transform_filter_bytes_x86(
+            filterDesc, convParamSpec, convolutionAlgorithms[i], &bytes));
+        filterBytes = (bytes > filterBytes) ? bytes : filterBytes;
+        CHECK_STATUS(convolution_infer_forward_tmp_bytes_x86(
+            inputDesc, filterDesc, outputDesc, convParamSpec, convolutionAlgorithms[i], &bytes));
+        tmpBytes = (bytes > tmpBytes) ? bytes : tmpBytes;
+    }
+    TensorDesc biasDesc = tensor1d(filterDesc.dt, outputDesc.dims[outputDesc.nDims - 2]);
+    TensorDesc scaleDesc = tensor1d(DT_F32, 0);
+    U8 *input = (U8 *)malloc(tensorNumBytes(inputDesc));
+    U8 *filter = (U8 *)malloc(tensorNumBytes(filterDesc));
+    U8 *filterTransformed = (U8 *)malloc(filterBytes);
+    U8 *bias = (U8 *)malloc(tensorNumBytes(biasDesc));
+    U8 *tmp = (U8 *)malloc(tmpBytes);
+    U8 *output = (U8 *)malloc(tensorNumBytes(outputDesc));
+    UNI_INIT(tensorNumElements(inputDesc), inputDesc.dt, 0.5, input);
+    UNI_INIT(tensorNumElements(filterDesc), filterDesc.dt, 0.5, filter);
+    UNI_INIT(tensorNumElements(biasDesc), biasDesc.dt, 0.5, bias);
+    ActivationParamSpec activationDesc;
+    activationDesc.mode = ACTIVATION_NULL;
+
+    // one warm-up run, then keep the best of several timed runs for each algorithm
+    const U32 loops = 3;
+    U32 algorithmIndex = 0;
+    double timeMin = -1;
+    for (U32 i = 0; i < convolutionAlgorithms.size(); i++) {
+        TensorDesc ftmDesc;
+        CHECK_STATUS(convolution_transform_filter_x86(
+            filterDesc, filter, convParamSpec, convolutionAlgorithms[i], &ftmDesc, filterTransformed));
+        double time = -1;
+        for (U32 j = 0; j <= loops; j++) {
+            double timeStart = ut_time_ms();
+            CHECK_STATUS(convolution_x86(inputDesc, input, nullptr, ftmDesc, filterTransformed,
+                convParamSpec, convolutionAlgorithms[i], scaleDesc, nullptr, biasDesc, bias,
+                tmpBytes, tmp, outputDesc, output, activationDesc, arch));
+            double timeEnd = ut_time_ms();
+            if (j > 0 && (time < 0 || timeEnd - timeStart < time)) {
+                time = timeEnd - timeStart;
+            }
+        }
+        UNI_DEBUG_LOG("convolution algorithm %d takes %f ms\n", convolutionAlgorithms[i], time);
+        if (timeMin < 0 || time < timeMin) {
+            timeMin = time;
+            algorithmIndex = i;
+        }
+    }
+    free(input);
+    free(filter);
+    free(filterTransformed);
+    free(bias);
+    free(tmp);
+    free(output);
+    return convolutionAlgorithms[algorithmIndex];
+}
 
 EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     TensorDesc filterDesc,
@@ -27,13 +94,9 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     ConvolutionParamSpec convParamSpec,
     ConvolutionPolicy policy,
     ConvolutionForwardAlgorithm *algorithm,
-    DataType targetDataType)
+    DataType targetDataType,
+    Arch arch)
 {
-    UNUSED(filterDesc);
-    UNUSED(outputDesc);
-    UNUSED(convParamSpec);
-    UNUSED(policy);
-    UNUSED(targetDataType);
     if (nullptr == algorithm) {
         CHECK_STATUS(NULL_POINTER);
     }
@@ -57,18 +120,29 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     U32 paddingL = convParamSpec.padding_left;
     U32 paddingR = convParamSpec.padding_right;
 
-    if ((targetDataType != DT_I8) && (targetDataType != DT_U8_Q) &&
-        ((idf != DF_NCHWC8) || (ic / group % 8 != 0))) {
+    bool alignedInput = (idf == DF_NCHWC8) && (ic / group % 8 == 0);
+    if ((targetDataType != DT_I8) && (targetDataType != DT_U8_Q) && !alignedInput) {
         *algorithm = CONVOLUTION_ALGORITHM_GEMM_ICNCHW;
-        return SUCCESS;
-    }
-
-    if ((fh == 1) && (fw == 1)) {
+    } else if ((fh == 1) && (fw == 1)) {
         *algorithm = CONVOLUTION_ALGORITHM_POINTWISE;
-        return SUCCESS;
+    } else {
+        *algorithm = CONVOLUTION_ALGORITHM_DIRECT;
     }
 
-    *algorithm = CONVOLUTION_ALGORITHM_DIRECT;
+    // time every float kernel that can consume this input layout on the real shape
+    if (policy == CONVOLUTION_TUNNING && alignedInput && idt == DT_F32 && fdt == DT_F32 &&
+        targetDataType == DT_F32) {
+        std::vector<ConvolutionForwardAlgorithm> convolutionAlgorithms;
+        convolutionAlgorithms.push_back(CONVOLUTION_ALGORITHM_DIRECT);
+        if ((fh == 1) && (fw == 1)) {
+            convolutionAlgorithms.push_back(CONVOLUTION_ALGORITHM_POINTWISE);
+        }
+        if (group == 1) {
+            convolutionAlgorithms.push_back(CONVOLUTION_ALGORITHM_GEMM_ICNCHW);
+        }
+        *algorithm = convolution_tune_algorithm_x86(
+            inputDesc, filterDesc, outputDesc, convParamSpec, convolutionAlgorithms, arch);
+    }
     return SUCCESS;
 }
 
@@ -205,7 +279,8 @@ EE convolution_x86(TensorDesc inputDesc,
     U32 icGroupSize = inputDesc.dims[dataChannelAxis] / group;
 
     void *inputTransform;
-    if ((inputDesc.df == DF_NCHWC8 && icGroupSize % 8 != 0) ||
+    if ((inputDesc.df == DF_NCHWC8 &&
+            (icGroupSize % 8 != 0 || algorithm == CONVOLUTION_ALGORITHM_GEMM_ICNCHW)) ||
         (inputDesc.df == DF_NCHWC16 && icGroupSize % 16 != 0)) {
         TensorDesc tmpInputDesc = inputDesc;
         tmpInputDesc.df = DF_NCHW;
@@ -22,14 +22,16 @@ EE dequantize_x86(TensorDesc qDesc,
     TensorDesc bDesc,
     void *bData,
     TensorDesc dDesc,
-    void *dData)
+    void *dData,
+    Arch arch)
 {
     EE ret = SUCCESS;
     if (dDesc.dt == DT_F32) {
         switch (qDesc.dt) {
 #ifdef _USE_INT8
             case DT_I32: {
-                ret = dequantizeI32ToF32(qDesc, (I32 *)qData, scale, dDesc, (F32 *)dData);
+                auto func = IS_X86_AVX512(arch) ? dequantizeI32ToF32 : avx2::dequantizeI32ToF32;
+                ret = func(qDesc, (I32 *)qData, scale, dDesc, (F32 *)dData);
                 break;
             }
 #endif
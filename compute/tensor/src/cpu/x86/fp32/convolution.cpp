@@ -69,9 +69,11 @@ EE convolution_infer_forward_tmp_bytes_fp32(TensorDesc inputDesc,
             break;
     }
 
-    // pre data processing space for not complete NCHWC8 group convolution input
+    // pre data processing space for not complete NCHWC8 group convolution input,
+    // or for NCHWC8 input consumed by the NCHW kernel
     U32 icGroupSize = ic / convParamSpec.group;
-    if (idf == DF_NCHWC8 && icGroupSize % 8 != 0) {
+    if (idf == DF_NCHWC8 &&
+        (icGroupSize % 8 != 0 || algorithm == CONVOLUTION_ALGORITHM_GEMM_ICNCHW)) {
         *bytes += tensorNumBytes(inputDesc);
     }
 
@@ -96,7 +98,6 @@ EE convolution_fp32(TensorDesc inputDesc,
     ActivationParamSpec activationDesc,
     Arch arch)
 {
-    UNUSED(arch);
     if (nullptr == input || nullptr == filter || nullptr == output || nullptr == bias ||
         nullptr == tmp) {
         CHECK_STATUS(NULL_POINTER);
@@ -122,14 +123,19 @@ EE convolution_fp32(TensorDesc inputDesc,
 
     EE ret = SUCCESS;
     switch (algorithm) {
-        case CONVOLUTION_ALGORITHM_DIRECT:
-            ret = convolution_direct(inputDesc, input, eltwiseInput, filterDesc, filter,
-                convParamSpec, biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc);
+        case CONVOLUTION_ALGORITHM_DIRECT: {
+            auto func = IS_X86_AVX512(arch) ? avx512::convolution_direct : convolution_direct;
+            ret = func(inputDesc, input, eltwiseInput, filterDesc, filter, convParamSpec, biasDesc,
+                bias, tmpBytes, tmp, outputDesc, output, activationDesc);
             break;
-        case CONVOLUTION_ALGORITHM_POINTWISE:
-            ret = convolution_1x1_direct(inputDesc, input, eltwiseInput, filterDesc, filter,
-                convParamSpec, bias, tmpBytes, tmp, outputDesc, output, activationDesc);
+        }
+        case CONVOLUTION_ALGORITHM_POINTWISE: {
+            auto func = IS_X86_AVX512(arch) ? avx512::convolution_1x1_direct
+                                            : convolution_1x1_direct;
+            ret = func(inputDesc, input, eltwiseInput, filterDesc, filter, convParamSpec, bias,
+                tmpBytes, tmp, outputDesc, output, activationDesc);
             break;
+        }
         case CONVOLUTION_ALGORITHM_GEMM_ICNCHW:
             ret = convolution_direct_nchw(inputDesc, input, filterDesc, filter, convParamSpec,
                 biasDesc, bias, tmpBytes, tmp, outputDesc, output, activationDesc);
@@ -17,6 +17,8 @@
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #include "cpu/x86/fp32/convolution_functions.h"
 
+X86_ISA_BEGIN
+
 #define BLOCK_IC_DIM 128
 #define BLOCK_OC_DIM 128
 #define BLOCK_HW_DIM 768
@@ -31,6 +33,40 @@ typedef void (*kernelFunc)(F32 *curI,
     U32 ic,
     U32 fStep);
 
+#ifdef _USE_AVX512
+#define CONV_AVX512_INPUT(p) curI[p * 8 + cc]
+
+// P pixels x OC output channels, P is 12 or 1, OC is 8, 16, 24 or 32
+template <U32 P, U32 OC>
+void Avx512PointwiseKernel(F32 *curI,
+    const F32 *curW,
+    F32 *curO,
+    const F32 *curB,
+    F32 *curE,
+    U32 oStep,
+    U32 flags,
+    U32 ic,
+    U32 fStep)
+{
+    const U32 NZ = (OC + 15) / 16;
+    const __mmask16 mask = (OC % 16) ? 0xFF : 0xFFFF;
+    oStep /= sizeof(F32);
+    fStep /= sizeof(F32);
+    __m512 bias0, bias1, w0, w1;
+    CONV_AVX512_LOAD_OC(bias, curB);
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_DECLARE);
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_INIT);
+    for (U32 icb = 0; icb < ic; icb += 8) {
+        for (U32 cc = 0; cc < 8; ++cc) {
+            CONV_AVX512_LOAD_OC(w, curW);
+            CONV_AVX512_UNROLL_HW(CONV_AVX512_FMA);
+            curW += OC;
+        }
+        curI += fStep;
+    }
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_STORE);
+}
+#else
 inline void Avx2PointwiseKernel3x32(F32 *curI,
     const F32 *curW,
     F32 *curO,
@@ -1729,6 +1765,8 @@ inline void Avx2PointwiseKernel1x8(F32 *curI,
                          "%ymm14", "%ymm15", "memory", "cc");
 }
 
+#endif
+
 EE convolution_1x1_direct(TensorDesc inputDesc,
     F32 *inArray,
     F32 *eltwiseInput,
@@ -1757,12 +1795,20 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     }
 
     // get kernels
+#ifdef _USE_AVX512
+    kernelFunc kernel[2][4] = {{Avx512PointwiseKernel<1, 8>, Avx512PointwiseKernel<1, 16>,
+                                   Avx512PointwiseKernel<1, 24>, Avx512PointwiseKernel<1, 32>},
+        {Avx512PointwiseKernel<12, 8>, Avx512PointwiseKernel<12, 16>,
+            Avx512PointwiseKernel<12, 24>, Avx512PointwiseKernel<12, 32>}};
+    I32 unrollHwArray[4] = {12, 12, 12, 12};
+#else
     kernelFunc kernel[2][4] = {{Avx2PointwiseKernel1x8, Avx2PointwiseKernel1x16,
                                    Avx2PointwiseKernel1x24, Avx2PointwiseKernel1x32},
         {Avx2PointwiseKernel12x8, Avx2PointwiseKernel6x16, Avx2PointwiseKernel4x24,
             Avx2PointwiseKernel3x32}};
-    I32 unrollOcArray[4] = {8, 16, 24, 32};
     I32 unrollHwArray[4] = {12, 6, 4, 3};
+#endif
+    I32 unrollOcArray[4] = {8, 16, 24, 32};
 
     // get computing params
     U32 paddingT = convParamSpec.padding_top;
@@ -1958,3 +2004,5 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
 #endif
     return SUCCESS;
 }
+
+X86_ISA_END
@@ -18,6 +18,8 @@
 #include "cpu/x86/fp32/transform_functions_fp32.h"
 #include "cpu/x86/fp32/convolution_functions.h"
 
+X86_ISA_BEGIN
+
 #define BLOCK_IC_DIM 16
 #define BLOCK_HW_DIM 1024
 // #define BLOCK_OC_DIM 32
@@ -36,6 +38,53 @@ typedef void (*kernelFunc)(F32 **curI,
     I32 ic,
     I32 fStep);
 
+#ifdef _USE_AVX512
+#define CONV_AVX512_INPUT(p) curI[p][off + cc]
+
+// P pixels x OC output channels, P is 12 or 1, OC is 8, 16, 24 or 32
+template <U32 P, U32 OC>
+void Avx512ConvKernel(F32 **curI,
+    const F32 *curW,
+    F32 *curO,
+    F32 *curE,
+    U32 fw,
+    U32 fh,
+    I32 oStep,
+    I32 iStep,
+    I32 flags,
+    const F32 *curB,
+    I32 dw,
+    I32 ic,
+    I32 fStep)
+{
+    const U32 NZ = (OC + 15) / 16;
+    const __mmask16 mask = (OC % 16) ? 0xFF : 0xFFFF;
+    oStep /= sizeof(F32);
+    iStep /= sizeof(F32);
+    fStep /= sizeof(F32);
+    dw /= sizeof(F32);
+    __m512 bias0, bias1, w0, w1;
+    CONV_AVX512_LOAD_OC(bias, curB);
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_DECLARE);
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_INIT);
+    I32 off = 0;
+    for (I32 icb = 0; icb < ic; icb += 8) {
+        for (U32 h = 0; h < fh; ++h) {
+            for (U32 j = 0; j < fw; ++j) {
+                for (U32 cc = 0; cc < 8; ++cc) {
+                    CONV_AVX512_LOAD_OC(w, curW);
+                    CONV_AVX512_UNROLL_HW(CONV_AVX512_FMA);
+                    curW += OC;
+                }
+                off += dw;
+            }
+            off += iStep;
+        }
+        off += fStep;
+    }
+    CONV_AVX512_UNROLL_HW(CONV_AVX512_STORE);
+}
+#else
 void Avx2ConvKernel3x32(F32 **curI,
     const F32 *curW,
     F32 *curO,
@@ -1910,6 +1959,8 @@ void Avx2ConvKernel1x8(F32 **curI,
                          : "%ebx", "%ecx", "%ymm0", "%ymm12", "%ymm15", "memory", "cc");
 }
 
+#endif
+
 EE convolution_direct(TensorDesc inputDesc,
     F32 *inArray,
     F32 *eltwiseInput,
@@ -1941,11 +1992,19 @@ EE convolution_direct(TensorDesc inputDesc,
     }
 
     // get kernels
+#ifdef _USE_AVX512
+    const kernelFunc kernel[4][2] = {{Avx512ConvKernel<1, 8>, Avx512ConvKernel<12, 8>},
+        {Avx512ConvKernel<1, 16>, Avx512ConvKernel<12, 16>},
+        {Avx512ConvKernel<1, 24>, Avx512ConvKernel<12, 24>},
+        {Avx512ConvKernel<1, 32>, Avx512ConvKernel<12, 32>}};
+    const I32 unrollHwArray[4] = {12, 12, 12, 12};
+#else
     const kernelFunc kernel[4][2] = {{Avx2ConvKernel1x8, Avx2ConvKernel8x8},
         {Avx2ConvKernel1x16, Avx2ConvKernel6x16}, {Avx2ConvKernel1x24, Avx2ConvKernel4x24},
         {Avx2ConvKernel1x32, Avx2ConvKernel3x32}};
-    const I32 unrollOcArray[4] = {8, 16, 24, 32};
     const I32 unrollHwArray[4] = {8, 6, 4, 3};
+#endif
+    const I32 unrollOcArray[4] = {8, 16, 24, 32};
 
     // get computing params
     I32 strideH = convParamSpec.stride_h;
@@ -2025,7 +2084,7 @@ EE convolution_direct(TensorDesc inputDesc,
                     const F32 *curB = biasArray + ocb;
                     const F32 *calW = filterArray + ocb * ic * fh * fw + ocSize * icbb * fh * fw;
                     F32 *curI = tmpInput + icbb * ih_pad * iw_pad;
-                    F32 *in_i[8] = {nullptr};
+                    F32 *in_i[12] = {nullptr};
                     I32 wSize = 0;
                     for (I32 ihw = hw; ihw < (I32)(hw + hwSize); ihw += wSize) {
                         wSize = UNI_MIN(hw + hwSize - ihw, unrollHw);
@@ -2056,3 +2115,5 @@ EE convolution_direct(TensorDesc inputDesc,
 
     return SUCCESS;
 }
+
+X86_ISA_END
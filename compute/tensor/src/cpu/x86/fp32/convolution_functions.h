@@ -178,16 +178,91 @@ T gcd(T u, T v)
 #if defined(_WIN32) && defined(_USE_OPENMP)
 struct OpenMPController {
     I32 ompThread;
+    // only change the threads num bound to the calling thread
     void checkAndSetOpenMP(I32 ohow, I32 threshold, I32 blockNums)
     {
-        ompThread = OMP_NUM_THREADS;
+        ompThread = OMP_LOCAL_NUM_THREADS;
         if (ohow < threshold && blockNums < OMP_NUM_THREADS) {
-            OMP_NUM_THREADS = 1;
+            OMP_LOCAL_NUM_THREADS = 1;
         }
     }
     void resetOpenMP()
     {
-        OMP_NUM_THREADS = ompThread;
+        OMP_LOCAL_NUM_THREADS = ompThread;
     }
 };
+#endif
+
+#ifdef _USE_AVX512
+// Register blocks of the AVX-512 convolution kernels. Output stays NCHWC8: c<p>_<z> holds output
+// channels [16z, 16z + 16) of pixel p, which are the same pixel of two C8 blocks oStep floats
+// apart. If OC % 16 == 8, the upper half of the last vector is not used. Named variables instead
+// of arrays keep the accumulators in zmm. The kernels define CONV_AVX512_INPUT(p) as input
+// channel cc of pixel p.
+#define CONV_AVX512_UNROLL_HW(func)                                 \
+    func(0) func(1) func(2) func(3) func(4) func(5) func(6) func(7) \
+        func(8) func(9) func(10) func(11)
+
+#define CONV_AVX512_LOAD_C8X2(ptr, z)                                                         \
+    ((2 * z + 1 < OC / 8) ? _mm512_insertf32x8(                                               \
+                                _mm512_castps256_ps512(_mm256_loadu_ps(ptr + 2 * z * oStep)), \
+                                _mm256_loadu_ps(ptr + (2 * z + 1) * oStep), 1)                \
+                          : _mm512_castps256_ps512(_mm256_loadu_ps(ptr + 2 * z * oStep)))
+
+#define CONV_AVX512_DECLARE(p) __m512 c##p##_0, c##p##_1;
+
+#define CONV_AVX512_INIT_Z(p, z)                                                     \
+    if (flags & 0x1) {                                                               \
+        c##p##_##z = CONV_AVX512_LOAD_C8X2(curO + p * 8, z);                         \
+    } else if (flags & 0x2) {                                                        \
+        c##p##_##z = _mm512_add_ps(bias##z, CONV_AVX512_LOAD_C8X2(curE + p * 8, z)); \
+    } else {                                                                         \
+        c##p##_##z = bias##z;                                                        \
+    }
+
+#define CONV_AVX512_INIT(p)           \
+    if (P > p) {                      \
+        CONV_AVX512_INIT_Z(p, 0);     \
+        if (NZ > 1) {                 \
+            CONV_AVX512_INIT_Z(p, 1); \
+        }                             \
+    }
+
+#define CONV_AVX512_FMA(p)                                \
+    if (P > p) {                                          \
+        __m512 in = _mm512_set1_ps(CONV_AVX512_INPUT(p)); \
+        c##p##_0 = _mm512_fmadd_ps(w0, in, c##p##_0);     \
+        if (NZ > 1) {                                     \
+            c##p##_1 = _mm512_fmadd_ps(w1, in, c##p##_1); \
+        }                                                 \
+    }
+
+// relu if flags & 0xC, relu6 if flags & 0x8
+#define CONV_AVX512_STORE_Z(p, z)                                                       \
+    if (flags & 0xC) {                                                                  \
+        c##p##_##z = _mm512_max_ps(c##p##_##z, _mm512_setzero_ps());                    \
+    }                                                                                   \
+    if (flags & 0x8) {                                                                  \
+        c##p##_##z = _mm512_min_ps(c##p##_##z, _mm512_set1_ps(6.0f));                   \
+    }                                                                                   \
+    _mm256_storeu_ps(curO + p * 8 + 2 * z * oStep, _mm512_castps512_ps256(c##p##_##z)); \
+    if (2 * z + 1 < OC / 8) {                                                           \
+        _mm256_storeu_ps(                                                               \
+            curO + p * 8 + (2 * z + 1) * oStep, _mm512_extractf32x8_ps(c##p##_##z, 1)); \
+    }
+
+#define CONV_AVX512_STORE(p)           \
+    if (P > p) {                       \
+        CONV_AVX512_STORE_Z(p, 0);     \
+        if (NZ > 1) {                  \
+            CONV_AVX512_STORE_Z(p, 1); \
+        }                              \
+    }
+
+// bias or weights of OC output channels
+#define CONV_AVX512_LOAD_OC(v, ptr)                               \
+    v##0 = _mm512_maskz_loadu_ps((NZ == 1) ? mask : 0xFFFF, ptr); \
+    if (NZ > 1) {                                                 \
+        v##1 = _mm512_maskz_loadu_ps(mask, ptr + 16);             \
+    }
 #endif
\ No newline at end of file
@@ -14,27 +14,79 @@
 #include <math.h>
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 
+X86_ISA_BEGIN
+
+// Single pass mean and variance. Values are shifted by the first element before accumulating
+// so that sum(x^2) - sum(x)^2 / n does not cancel badly when the mean is large.
+inline void array_mean_var_fp32(const F32 *input, I32 len, F32 *mean, F32 *var)
+{
+    F32 shift = input[0];
+    F32 sum_s = 0;
+    F32 sqr_s = 0;
+    I32 i = 0;
+#ifdef _USE_AVX512
+    __m512 shift_x = _mm512_set1_ps(shift);
+    __m512 sum_x = _mm512_setzero_ps();
+    __m512 sqr_x = _mm512_setzero_ps();
+    for (; i < len - 15; i += 16) {
+        __m512 in = _mm512_sub_ps(_mm512_loadu_ps(input + i), shift_x);
+        sum_x = _mm512_add_ps(sum_x, in);
+        sqr_x = _mm512_fmadd_ps(in, in, sqr_x);
+    }
+    sum_s += _mm512_reduce_add_ps(sum_x);
+    sqr_s += _mm512_reduce_add_ps(sqr_x);
+#endif
+    __m256 shift_v = _mm256_set1_ps(shift);
+    __m256 sum_v = _mm256_setzero_ps();
+    __m256 sqr_v = _mm256_setzero_ps();
+    for (; i < len - 7; i += 8) {
+        __m256 in = _mm256_sub_ps(_mm256_loadu_ps(input + i), shift_v);
+        sum_v = _mm256_add_ps(sum_v, in);
+        sqr_v = _mm256_fmadd_ps(in, in, sqr_v);
+    }
+    sum_s += _mm256_sum_ps(sum_v);
+    sqr_s += _mm256_sum_ps(sqr_v);
+    for (; i < len; i++) {
+        F32 in = input[i] - shift;
+        sum_s += in;
+        sqr_s += in * in;
+    }
+    F32 mean_s = sum_s / len;
+    *mean = mean_s + shift;
+    *var = UNI_MAX(sqr_s / len - mean_s * mean_s, 0);
+}
+
 inline void array_norm_scale_fp32(
     F32 *input, F32 *output, I32 len, F32 mean, F32 var, F32 *alpha, F32 *beta)
 {
     F32 eps = 1e-6;
     F32 std_value = sqrt(var + eps);
-    __m256 mean_v = _mm256_set1_ps(mean);
-    __m256 std_v = _mm256_set1_ps(std_value);
+    F32 scale = 1 / std_value;
 
     I32 i = 0;
-    for (i = 0; i < len - 7; i += 8) {
+#ifdef _USE_AVX512
+    __m512 mean_x = _mm512_set1_ps(mean);
+    __m512 scale_x = _mm512_set1_ps(scale);
+    for (; i < len - 15; i += 16) {
+        __m512 tmp_x = _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(input + i), mean_x), scale_x);
+        tmp_x = _mm512_fmadd_ps(_mm512_loadu_ps(alpha + i), tmp_x, _mm512_loadu_ps(beta + i));
+        _mm512_storeu_ps(output + i, tmp_x);
+    }
+#endif
+    __m256 mean_v = _mm256_set1_ps(mean);
+    __m256 scale_v = _mm256_set1_ps(scale);
+    for (; i < len - 7; i += 8) {
         __m256 in = _mm256_loadu_ps(input + i);
         __m256 alpha_v = _mm256_loadu_ps(alpha + i);
         __m256 beta_v = _mm256_loadu_ps(beta + i);
 
         __m256 tmp_v = _mm256_sub_ps(in, mean_v);
-        tmp_v = _mm256_div_ps(tmp_v, std_v);
+        tmp_v = _mm256_mul_ps(tmp_v, scale_v);
         tmp_v = _mm256_fmadd_ps(alpha_v, tmp_v, beta_v);
         _mm256_storeu_ps(output + i, tmp_v);
     }
     for (; i < len; i++) {
-        output[i] = alpha[i] * (input[i] - mean) / std_value + beta[i];
+        output[i] = alpha[i] * (input[i] - mean) * scale + beta[i];
     }
 }
 
@@ -49,14 +101,18 @@ EE layer_normalization_fp32(
     U32 size = tensorNumElements(inputDesc);
     I32 size_inner = inputDesc.dims[0];
     I32 size_outer = size / size_inner;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
     for (I32 i = 0; i < size_outer; i++) {
         F32 *current_input = input + i * size_inner;
         F32 *current_output = output + i * size_inner;
-        F32 mean = array_mean_f32(current_input, size_inner);
-        F32 var = array_var_f32(current_input, size_inner, mean);
+        F32 mean, var;
+        array_mean_var_fp32(current_input, size_inner, &mean, &var);
 
         array_norm_scale_fp32(current_input, current_output, size_inner, mean, var, alpha, beta);
     }
 
     return SUCCESS;
 }
+X86_ISA_END
@@ -13,6 +13,8 @@
 
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 
+X86_AVX512_BEGIN
+
 #define UNROLL_W 4
 
 typedef void (*pooling_max_func)(const F32 *curI, F32 *curO, U32 kw, U32 kh, U32 iStep, U32 stride);
@@ -361,3 +363,4 @@ EE pooling_c16_fp32(TensorDesc inputDesc,
     }
     return SUCCESS;
 }
+X86_AVX512_END
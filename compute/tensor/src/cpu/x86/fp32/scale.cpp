@@ -14,6 +14,7 @@
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 
 #ifdef _USE_INT8
+X86_AVX512_BEGIN
 EE scale_nchwc16_fp32(
     F32 *input, F32 *alpha, F32 *beta, I32 in, I32 ic, I32 elements_per_channel, F32 *output)
 {
@@ -35,6 +36,7 @@ EE scale_nchwc16_fp32(
     }
     return SUCCESS;
 }
+X86_AVX512_END
 #endif
 
 EE scale_nchwc8_fp32(
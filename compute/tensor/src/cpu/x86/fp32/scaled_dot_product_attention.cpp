@@ -0,0 +1,264 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <float.h>
+#include "cpu/x86/fp32/tensor_computing_fp32.h"
+
+X86_ISA_BEGIN
+
+// keys handled by one step of the online softmax
+#define SDPA_KEY_TILE 64
+
+// score[j] = sum_c query[c] * key[c * ldk + j], 0 <= j < len
+inline void sdpa_dot_fp32(const F32 *query, const F32 *key, I32 ldk, I32 dim, I32 len, F32 *score)
+{
+    I32 j = 0;
+#ifdef _USE_AVX512
+    for (; j < len - 63; j += 64) {
+        __m512 s0 = _mm512_setzero_ps();
+        __m512 s1 = _mm512_setzero_ps();
+        __m512 s2 = _mm512_setzero_ps();
+        __m512 s3 = _mm512_setzero_ps();
+        for (I32 c = 0; c < dim; c++) {
+            __m512 q = _mm512_set1_ps(query[c]);
+            const F32 *k = key + c * ldk + j;
+            s0 = _mm512_fmadd_ps(q, _mm512_loadu_ps(k), s0);
+            s1 = _mm512_fmadd_ps(q, _mm512_loadu_ps(k + 16), s1);
+            s2 = _mm512_fmadd_ps(q, _mm512_loadu_ps(k + 32), s2);
+            s3 = _mm512_fmadd_ps(q, _mm512_loadu_ps(k + 48), s3);
+        }
+        _mm512_storeu_ps(score + j, s0);
+        _mm512_storeu_ps(score + j + 16, s1);
+        _mm512_storeu_ps(score + j + 32, s2);
+        _mm512_storeu_ps(score + j + 48, s3);
+    }
+    for (; j < len - 15; j += 16) {
+        __m512 s0 = _mm512_setzero_ps();
+        for (I32 c = 0; c < dim; c++) {
+            s0 = _mm512_fmadd_ps(
+                _mm512_set1_ps(query[c]), _mm512_loadu_ps(key + c * ldk + j), s0);
+        }
+        _mm512_storeu_ps(score + j, s0);
+    }
+#endif
+    for (; j < len - 31; j += 32) {
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        __m256 s2 = _mm256_setzero_ps();
+        __m256 s3 = _mm256_setzero_ps();
+        for (I32 c = 0; c < dim; c++) {
+            __m256 q = _mm256_set1_ps(query[c]);
+            const F32 *k = key + c * ldk + j;
+            s0 = _mm256_fmadd_ps(q, _mm256_loadu_ps(k), s0);
+            s1 = _mm256_fmadd_ps(q, _mm256_loadu_ps(k + 8), s1);
+            s2 = _mm256_fmadd_ps(q, _mm256_loadu_ps(k + 16), s2);
+            s3 = _mm256_fmadd_ps(q, _mm256_loadu_ps(k + 24), s3);
+        }
+        _mm256_storeu_ps(score + j, s0);
+        _mm256_storeu_ps(score + j + 8, s1);
+        _mm256_storeu_ps(score + j + 16, s2);
+        _mm256_storeu_ps(score + j + 24, s3);
+    }
+    for (; j < len - 7; j += 8) {
+        __m256 s0 = _mm256_setzero_ps();
+        for (I32 c = 0; c < dim; c++) {
+            s0 = _mm256_fmadd_ps(
+                _mm256_set1_ps(query[c]), _mm256_loadu_ps(key + c * ldk + j), s0);
+        }
+        _mm256_storeu_ps(score + j, s0);
+    }
+    for (; j < len; j++) {
+        F32 s = 0;
+        for (I32 c = 0; c < dim; c++) {
+            s += query[c] * key[c * ldk + j];
+        }
+        score[j] = s;
+    }
+}
+
+// score[j] = score[j] * scale + mask[j] * maskScale + shift, mask may be nullptr
+inline void sdpa_bias_fp32(
+    F32 *score, I32 len, F32 scale, const F32 *mask, F32 maskScale, F32 shift)
+{
+    I32 j = 0;
+    if (mask == nullptr) {
+        array_scale_f32(score, score, len, scale, shift);
+        return;
+    }
+#ifdef _USE_AVX512
+    __m512 scale_x = _mm512_set1_ps(scale);
+    __m512 mask_scale_x = _mm512_set1_ps(maskScale);
+    __m512 shift_x = _mm512_set1_ps(shift);
+    for (; j < len - 15; j += 16) {
+        __m512 m = _mm512_fmadd_ps(_mm512_loadu_ps(mask + j), mask_scale_x, shift_x);
+        _mm512_storeu_ps(score + j, _mm512_fmadd_ps(_mm512_loadu_ps(score + j), scale_x, m));
+    }
+#endif
+    __m256 scale_v = _mm256_set1_ps(scale);
+    __m256 mask_scale_v = _mm256_set1_ps(maskScale);
+    __m256 shift_v = _mm256_set1_ps(shift);
+    for (; j < len - 7; j += 8) {
+        __m256 m = _mm256_fmadd_ps(_mm256_loadu_ps(mask + j), mask_scale_v, shift_v);
+        _mm256_storeu_ps(score + j, _mm256_fmadd_ps(_mm256_loadu_ps(score + j), scale_v, m));
+    }
+    for (; j < len; j++) {
+        score[j] = score[j] * scale + mask[j] * maskScale + shift;
+    }
+}
+
+// output[c] = output[c] * alpha + sum_j prob[j] * value[j * ldv + c], 0 <= c < dim
+inline void sdpa_accumulate_fp32(
+    const F32 *prob, I32 len, const F32 *value, I32 ldv, I32 dim, F32 alpha, F32 *output)
+{
+    I32 c = 0;
+#ifdef _USE_AVX512
+    __m512 alpha_x = _mm512_set1_ps(alpha);
+    for (; c < dim - 63; c += 64) {
+        __m512 o0 = _mm512_mul_ps(_mm512_loadu_ps(output + c), alpha_x);
+        __m512 o1 = _mm512_mul_ps(_mm512_loadu_ps(output + c + 16), alpha_x);
+        __m512 o2 = _mm512_mul_ps(_mm512_loadu_ps(output + c + 32), alpha_x);
+        __m512 o3 = _mm512_mul_ps(_mm512_loadu_ps(output + c + 48), alpha_x);
+        for (I32 j = 0; j < len; j++) {
+            __m512 p = _mm512_set1_ps(prob[j]);
+            const F32 *v = value + j * ldv + c;
+            o0 = _mm512_fmadd_ps(p, _mm512_loadu_ps(v), o0);
+            o1 = _mm512_fmadd_ps(p, _mm512_loadu_ps(v + 16), o1);
+            o2 = _mm512_fmadd_ps(p, _mm512_loadu_ps(v + 32), o2);
+            o3 = _mm512_fmadd_ps(p, _mm512_loadu_ps(v + 48), o3);
+        }
+        _mm512_storeu_ps(output + c, o0);
+        _mm512_storeu_ps(output + c + 16, o1);
+        _mm512_storeu_ps(output + c + 32, o2);
+        _mm512_storeu_ps(output + c + 48, o3);
+    }
+    for (; c < dim - 15; c += 16) {
+        __m512 o0 = _mm512_mul_ps(_mm512_loadu_ps(output + c), alpha_x);
+        for (I32 j = 0; j < len; j++) {
+            o0 = _mm512_fmadd_ps(
+                _mm512_set1_ps(prob[j]), _mm512_loadu_ps(value + j * ldv + c), o0);
+        }
+        _mm512_storeu_ps(output + c, o0);
+    }
+#endif
+    __m256 alpha_v = _mm256_set1_ps(alpha);
+    for (; c < dim - 31; c += 32) {
+        __m256 o0 = _mm256_mul_ps(_mm256_loadu_ps(output + c), alpha_v);
+        __m256 o1 = _mm256_mul_ps(_mm256_loadu_ps(output + c + 8), alpha_v);
+        __m256 o2 = _mm256_mul_ps(_mm256_loadu_ps(output + c + 16), alpha_v);
+        __m256 o3 = _mm256_mul_ps(_mm256_loadu_ps(output + c + 24), alpha_v);
+        for (I32 j = 0; j < len; j++) {
+            __m256 p = _mm256_set1_ps(prob[j]);
+            const F32 *v = value + j * ldv + c;
+            o0 = _mm256_fmadd_ps(p, _mm256_loadu_ps(v), o0);
+            o1 = _mm256_fmadd_ps(p, _mm256_loadu_ps(v + 8), o1);
+            o2 = _mm256_fmadd_ps(p, _mm256_loadu_ps(v + 16), o2);
+            o3 = _mm256_fmadd_ps(p, _mm256_loadu_ps(v + 24), o3);
+        }
+        _mm256_storeu_ps(output + c, o0);
+        _mm256_storeu_ps(output + c + 8, o1);
+        _mm256_storeu_ps(output + c + 16, o2);
+        _mm256_storeu_ps(output + c + 24, o3);
+    }
+    for (; c < dim - 7; c += 8) {
+        __m256 o0 = _mm256_mul_ps(_mm256_loadu_ps(output + c), alpha_v);
+        for (I32 j = 0; j < len; j++) {
+            o0 = _mm256_fmadd_ps(
+                _mm256_set1_ps(prob[j]), _mm256_loadu_ps(value + j * ldv + c), o0);
+        }
+        _mm256_storeu_ps(output + c, o0);
+    }
+    for (; c < dim; c++) {
+        F32 o = output[c] * alpha;
+        for (I32 j = 0; j < len; j++) {
+            o += prob[j] * value[j * ldv + c];
+        }
+        output[c] = o;
+    }
+}
+
+U32 scaled_dot_product_attention_fp32_tmp_bytes(I32 rows, I32 dim, I32 vdim)
+{
+    return (rows * (vdim + 2) + SDPA_KEY_TILE * (dim + 1)) * bytesOf(DT_F32);
+}
+
+// Attention of one query tile against all keys of a head. The score row of a key tile lives in
+// a small buffer and is folded into the output with an online softmax, so the
+// [rows, length] score matrix is never written out.
+EE scaled_dot_product_attention_fp32(const F32 *query,
+    const F32 *key,
+    const F32 *value,
+    const F32 *mask,
+    I32 rows,
+    I32 length,
+    I32 dim,
+    I32 vdim,
+    I32 maskRowStride,
+    I32 maskColStride,
+    I32 validRows,
+    ScaledDotProductAttentionParamSpec p,
+    F32 *tmp,
+    F32 *output)
+{
+    F32 *acc = tmp;
+    F32 *maxBuffer = acc + rows * vdim;
+    F32 *sumBuffer = maxBuffer + rows;
+    F32 *score = sumBuffer + rows;
+    F32 *keyPack = score + SDPA_KEY_TILE;
+    memset(acc, 0, rows * vdim * sizeof(F32));
+    for (I32 i = 0; i < rows; i++) {
+        maxBuffer[i] = -FLT_MAX;
+        sumBuffer[i] = 0;
+    }
+    F32 minValue = -10000.0 * p.mask_scale;
+    for (I32 j = 0; j < length; j += SDPA_KEY_TILE) {
+        I32 len = UNI_MIN(SDPA_KEY_TILE, length - j);
+        const F32 *keyPtr = key + j;
+        I32 ldk = length;
+        if (p.transpose_key) {
+            for (I32 k = 0; k < len; k++) {
+                for (I32 c = 0; c < dim; c++) {
+                    keyPack[c * SDPA_KEY_TILE + k] = key[(j + k) * dim + c];
+                }
+            }
+            keyPtr = keyPack;
+            ldk = SDPA_KEY_TILE;
+        }
+        for (I32 i = 0; i < rows; i++) {
+            sdpa_dot_fp32(query + i * dim, keyPtr, ldk, dim, len, score);
+            if (mask == nullptr) {
+                sdpa_bias_fp32(score, len, p.scale, nullptr, 0, 0);
+            } else if (i >= validRows) {
+                sdpa_bias_fp32(score, len, p.scale, nullptr, 0, minValue);
+            } else if (maskColStride == 0) {
+                sdpa_bias_fp32(
+                    score, len, p.scale, nullptr, 0, mask[i * maskRowStride] * p.mask_scale);
+            } else {
+                sdpa_bias_fp32(score, len, p.scale, mask + i * maskRowStride + j, p.mask_scale, 0);
+            }
+            F32 max_s;
+            array_minmax_value_f32(score, len, 2, &max_s);
+            max_s = UNI_MAX(max_s, maxBuffer[i]);
+            F32 alpha = exp(maxBuffer[i] - max_s);
+            F32 sum_s = array_exp_sum_f32(score, score, len, max_s);
+            maxBuffer[i] = max_s;
+            sumBuffer[i] = sumBuffer[i] * alpha + sum_s;
+            sdpa_accumulate_fp32(score, len, value + j * vdim, vdim, vdim, alpha, acc + i * vdim);
+        }
+    }
+    for (I32 i = 0; i < rows; i++) {
+        array_scale_f32(acc + i * vdim, output + i * vdim, vdim, 1 / sumBuffer[i], 0);
+    }
+    return SUCCESS;
+}
+X86_ISA_END
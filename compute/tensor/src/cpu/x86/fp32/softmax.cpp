@@ -14,65 +14,177 @@
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #include "tensor_transpose.h"
 
-void softmax_lastAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, F32 *output)
+X86_ISA_BEGIN
+
+// elements of a row handled by one task, small enough to stay in L1 between passes
+#define SOFTMAX_BLOCK 1024
+// columns handled by one task when softmax is not on the last axis
+#define SOFTMAX_TILE 64
+
+inline F32 softmax_block_max(const F32 *input, I32 len)
 {
-    for (I32 i = 0; i < loopOuter; i++) {
-        const F32 *inputPtr = input + i * loops;
-        F32 *outputPtr = output + i * loops;
+    I32 i = 0;
+    F32 max_s = input[0];
+#ifdef _USE_AVX512
+    if (len > 15) {
+        __m512 max_v = _mm512_loadu_ps(input);
+        for (i = 16; i < len - 15; i += 16) {
+            max_v = _mm512_max_ps(max_v, _mm512_loadu_ps(input + i));
+        }
+        max_s = _mm512_reduce_max_ps(max_v);
+    }
+#endif
+    if (len - i > 7) {
+        __m256 max_v = _mm256_loadu_ps(input + i);
+        for (i += 8; i < len - 7; i += 8) {
+            max_v = _mm256_max_ps(max_v, _mm256_loadu_ps(input + i));
+        }
+        max_s = UNI_MAX(max_s, _mm256_hmax_ps(max_v));
+    }
+    for (; i < len; i++) {
+        max_s = UNI_MAX(max_s, input[i]);
+    }
+    return max_s;
+}
 
-        __m256 max_v, sub_v, sum_v, tmp_v;
-        F32 max_s, tmp_s;
-        array_minmax_value_f32(inputPtr, loops, 2, &max_s);
-        max_v = _mm256_set1_ps(max_s);
-        sum_v = _mm256_set1_ps(0.f);
+inline void softmax_block_scale(F32 *data, I32 len, F32 scale)
+{
+    I32 i = 0;
+#ifdef _USE_AVX512
+    __m512 scale_x = _mm512_set1_ps(scale);
+    for (; i < len - 15; i += 16) {
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), scale_x));
+    }
+#endif
+    __m256 scale_v = _mm256_set1_ps(scale);
+    for (; i < len - 7; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), scale_v));
+    }
+    for (; i < len; i++) {
+        data[i] *= scale;
+    }
+}
 
-        I32 j = 0;
-        F32 sum_s = 0;
-        for (j = 0; j < loops - 7; j += 8) {
-            __m256 in = _mm256_loadu_ps(inputPtr + j);
-            sub_v = _mm256_sub_ps(in, max_v);
-            tmp_v = _mm256_exp_ps(sub_v);
-            sum_v = _mm256_add_ps(sum_v, tmp_v);
-            _mm256_storeu_ps(outputPtr + j, tmp_v);
+// Each block keeps its own (max, sum) pair. The pairs of a row are merged afterwards, so the
+// input is read once and max/exp/sum share a single pass, and blocks of one long row can run on
+// different threads.
+void softmax_lastAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, F32 *output)
+{
+    I32 blocks = (loops + SOFTMAX_BLOCK - 1) / SOFTMAX_BLOCK;
+    I32 tasks = loopOuter * blocks;
+    std::vector<F32> buffer(tasks * 2);
+    F32 *maxBuffer = &buffer[0];
+    F32 *sumBuffer = &buffer[tasks];
+#ifdef _USE_OPENMP
+#pragma omp parallel num_threads(OMP_NUM_THREADS)
+#endif
+    {
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+        for (I32 t = 0; t < tasks; t++) {
+            I32 i = t / blocks;
+            I32 j = (t % blocks) * SOFTMAX_BLOCK;
+            I32 len = UNI_MIN(SOFTMAX_BLOCK, loops - j);
+            const F32 *inputPtr = input + i * loops + j;
+            maxBuffer[t] = softmax_block_max(inputPtr, len);
+            sumBuffer[t] = array_exp_sum_f32(inputPtr, output + i * loops + j, len, maxBuffer[t]);
         }
-        sum_s += _mm256_sum_ps(sum_v);
-        for (; j < loops; j++) {
-            tmp_s = exp(inputPtr[j] - max_s);
-            outputPtr[j] = tmp_s;
-            sum_s += tmp_s;
+        if (blocks > 1) {
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+            for (I32 i = 0; i < loopOuter; i++) {
+                F32 *maxPtr = maxBuffer + i * blocks;
+                F32 *sumPtr = sumBuffer + i * blocks;
+                F32 max_s = maxPtr[0];
+                for (I32 b = 1; b < blocks; b++) {
+                    max_s = UNI_MAX(max_s, maxPtr[b]);
+                }
+                F32 sum_s = 0;
+                for (I32 b = 0; b < blocks; b++) {
+                    maxPtr[b] = exp(maxPtr[b] - max_s);
+                    sum_s += sumPtr[b] * maxPtr[b];
+                }
+                for (I32 b = 0; b < blocks; b++) {
+                    sumPtr[b] = maxPtr[b] / sum_s;
+                }
+            }
+        } else {
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+            for (I32 t = 0; t < tasks; t++) {
+                sumBuffer[t] = 1 / sumBuffer[t];
+            }
+        }
+#ifdef _USE_OPENMP
+#pragma omp for
+#endif
+        for (I32 t = 0; t < tasks; t++) {
+            I32 i = t / blocks;
+            I32 j = (t % blocks) * SOFTMAX_BLOCK;
+            I32 len = UNI_MIN(SOFTMAX_BLOCK, loops - j);
+            softmax_block_scale(output + i * loops + j, len, sumBuffer[t]);
         }
-        array_scale_f32(outputPtr, outputPtr, loops, 1.0 / sum_s, 0);
     }
 }
 
+// Columns are split into tiles of SOFTMAX_TILE, so a (loops x tile) slab stays in cache across the
+// max, exp and normalize passes and tiles run in parallel.
 void softmax_anyAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, I32 loopInner, F32 *output)
 {
-    std::vector<F32> buffer(loopInner * 2);
-    F32 *maxBuffer = &buffer[0];
-    F32 *sumBuffer = &buffer[loopInner];
-    I32 k = 0;
-    for (I32 i = 0; i < loopOuter; i++) {
-        const F32 *inputPtrBase = input + i * loops * loopInner;
-        F32 *outputPtrBase = output + i * loops * loopInner;
+    I32 tiles = (loopInner + SOFTMAX_TILE - 1) / SOFTMAX_TILE;
+#ifdef _USE_OPENMP
+#pragma omp parallel for num_threads(OMP_NUM_THREADS)
+#endif
+    for (I32 t = 0; t < loopOuter * tiles; t++) {
+        F32 maxBuffer[SOFTMAX_TILE];
+        F32 sumBuffer[SOFTMAX_TILE];
+        I32 i = t / tiles;
+        I32 kk = (t % tiles) * SOFTMAX_TILE;
+        I32 tile = UNI_MIN(SOFTMAX_TILE, loopInner - kk);
+        const F32 *inputPtrBase = input + i * loops * loopInner + kk;
+        F32 *outputPtrBase = output + i * loops * loopInner + kk;
+        I32 k = 0;
 
-        memcpy(maxBuffer, inputPtrBase, loopInner * sizeof(F32));
-        memset(sumBuffer, 0, loopInner * sizeof(F32));
+        memcpy(maxBuffer, inputPtrBase, tile * sizeof(F32));
+        memset(sumBuffer, 0, tile * sizeof(F32));
         for (I32 j = 1; j < loops; j++) {
             const F32 *inputPtr = inputPtrBase + j * loopInner;
-            for (k = 0; k < loopInner - 7; k += 8) {
+            k = 0;
+#ifdef _USE_AVX512
+            for (; k < tile - 15; k += 16) {
+                __m512 max_x = _mm512_max_ps(
+                    _mm512_loadu_ps(inputPtr + k), _mm512_loadu_ps(maxBuffer + k));
+                _mm512_storeu_ps(maxBuffer + k, max_x);
+            }
+#endif
+            for (; k < tile - 7; k += 8) {
                 __m256 in_v = _mm256_loadu_ps(inputPtr + k);
                 __m256 out_v = _mm256_loadu_ps(maxBuffer + k);
                 __m256 max_v = _mm256_max_ps(in_v, out_v);
                 _mm256_storeu_ps(maxBuffer + k, max_v);
             }
-            for (; k < loopInner; k++) {
+            for (; k < tile; k++) {
                 maxBuffer[k] = UNI_MAX(maxBuffer[k], inputPtr[k]);
             }
         }
         for (I32 j = 0; j < loops; j++) {
             const F32 *inputPtr = inputPtrBase + j * loopInner;
             F32 *outputPtr = outputPtrBase + j * loopInner;
-            for (k = 0; k < loopInner - 7; k += 8) {
+            k = 0;
+#ifdef _USE_AVX512
+            for (; k < tile - 15; k += 16) {
+                __m512 sub_x = _mm512_sub_ps(
+                    _mm512_loadu_ps(inputPtr + k), _mm512_loadu_ps(maxBuffer + k));
+                __m512 exp_x = _mm512_exp_ps(sub_x);
+                __m512 sum_x = _mm512_add_ps(_mm512_loadu_ps(sumBuffer + k), exp_x);
+                _mm512_storeu_ps(sumBuffer + k, sum_x);
+                _mm512_storeu_ps(outputPtr + k, exp_x);
+            }
+#endif
+            for (; k < tile - 7; k += 8) {
                 __m256 in_v = _mm256_loadu_ps(inputPtr + k);
                 __m256 max_v = _mm256_loadu_ps(maxBuffer + k);
                 __m256 sub_v = _mm256_sub_ps(in_v, max_v);
@@ -82,21 +194,32 @@ void softmax_anyAxis_fp32(const F32 *input, I32 loopOuter, I32 loops, I32 loopIn
                 _mm256_storeu_ps(sumBuffer + k, sum_v);
                 _mm256_storeu_ps(outputPtr + k, exp_v);
             }
-            for (; k < loopInner; k++) {
+            for (; k < tile; k++) {
                 outputPtr[k] = exp(inputPtr[k] - maxBuffer[k]);
                 sumBuffer[k] += outputPtr[k];
             }
         }
+        for (k = 0; k < tile; k++) {
+            sumBuffer[k] = 1 / sumBuffer[k];
+        }
         for (I32 j = 0; j < loops; j++) {
             F32 *outputPtr = outputPtrBase + j * loopInner;
-            for (k = 0; k < loopInner - 7; k += 8) {
+            k = 0;
+#ifdef _USE_AVX512
+            for (; k < tile - 15; k += 16) {
+                __m512 out_x = _mm512_mul_ps(
+                    _mm512_loadu_ps(outputPtr + k), _mm512_loadu_ps(sumBuffer + k));
+                _mm512_storeu_ps(outputPtr + k, out_x);
+            }
+#endif
+            for (; k < tile - 7; k += 8) {
                 __m256 out_v = _mm256_loadu_ps(outputPtr + k);
                 __m256 sum_v = _mm256_loadu_ps(sumBuffer + k);
-                out_v = _mm256_div_ps(out_v, sum_v);
+                out_v = _mm256_mul_ps(out_v, sum_v);
                 _mm256_storeu_ps(outputPtr + k, out_v);
             }
-            for (; k < loopInner; k++) {
-                outputPtr[k] /= sumBuffer[k];
+            for (; k < tile; k++) {
+                outputPtr[k] *= sumBuffer[k];
             }
         }
     }
@@ -145,10 +268,11 @@ EE softmax_fp32(TensorDesc inputDesc, const F32 *input, int axis, TensorDesc out
         loop_inner *= inputDesc.dims[i];
     }
     U32 loop_outer = size / loops / loop_inner;
-    if (axis == 0) {
+    if (axis == 0 || loop_inner == 1) {
         softmax_lastAxis_fp32(input, loop_outer, loops, output);
     } else {
         softmax_anyAxis_fp32(input, loop_outer, loops, loop_inner, output);
     }
     return SUCCESS;
 }
+X86_ISA_END
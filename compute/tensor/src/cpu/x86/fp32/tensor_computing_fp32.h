@@ -34,6 +34,23 @@ EE attention_mask_fp32(TensorDesc inputDesc,
     TensorDesc outputDesc,
     F32 *output);
 
+U32 scaled_dot_product_attention_fp32_tmp_bytes(I32 rows, I32 dim, I32 vdim);
+
+EE scaled_dot_product_attention_fp32(const F32 *query,
+    const F32 *key,
+    const F32 *value,
+    const F32 *mask,
+    I32 rows,
+    I32 length,
+    I32 dim,
+    I32 vdim,
+    I32 maskRowStride,
+    I32 maskColStride,
+    I32 validRows,
+    ScaledDotProductAttentionParamSpec p,
+    F32 *tmp,
+    F32 *output);
+
 EE convolution_transform_filter_fp32(TensorDesc filterDesc,
     const F32 *filter,
     ConvolutionParamSpec convParamSpec,
@@ -326,4 +343,55 @@ EE instance_norm_fp32(TensorDesc inputDesc,
     InstanceNormParamSpec p,
     F32 *output);
 
+// AVX-512 builds of the kernels above, picked at run time if IS_X86_AVX512(arch)
+namespace avx512 {
+EE convolution_direct(TensorDesc inputDesc,
+    F32 *inArray,
+    F32 *eltwiseInput,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec activationDesc);
+
+EE convolution_1x1_direct(TensorDesc inputDesc,
+    F32 *inArray,
+    F32 *eltwiseInput,
+    TensorDesc filterDesc,
+    const F32 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    const F32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    F32 *outArray,
+    ActivationParamSpec activationDesc);
+
+EE scaled_dot_product_attention_fp32(const F32 *query,
+    const F32 *key,
+    const F32 *value,
+    const F32 *mask,
+    I32 rows,
+    I32 length,
+    I32 dim,
+    I32 vdim,
+    I32 maskRowStride,
+    I32 maskColStride,
+    I32 validRows,
+    ScaledDotProductAttentionParamSpec p,
+    F32 *tmp,
+    F32 *output);
+
+EE layer_normalization_fp32(
+    TensorDesc inputDesc, F32 *input, F32 *alpha, F32 *beta, TensorDesc outputDesc, F32 *output);
+
+EE softmax_fp32(
+    TensorDesc inputDesc, const F32 *input, int axis, TensorDesc outputDesc, F32 *output);
+}  // namespace avx512
+
 #endif  //CHEETAH_TENSOR_COMPUTING_FP32_H
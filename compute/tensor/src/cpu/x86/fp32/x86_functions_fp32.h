@@ -15,6 +15,7 @@
 #define CHEETAH_X86_FUNCTIONS_FP32_H
 #include <math.h>
 #include "x86_avx2_expand.h"
+#include "x86_avx512_expand.h"
 #include "parameter_spec.h"
 #include "uni.h"
 #include "thread_affinity.h"
@@ -506,6 +507,44 @@ inline F32 array_sum_f32(const F32 *data, I32 len)
     return sum_s;
 }
 
+// output = exp(input - shift), return sum of output
+inline F32 array_exp_sum_f32(const F32 *input, F32 *output, I32 len, F32 shift)
+{
+    I32 i = 0;
+    F32 sum_s = 0;
+    __m256 shift_v = _mm256_set1_ps(shift);
+    __m256 sum_v = _mm256_setzero_ps();
+    for (; i < len - 7; i += 8) {
+        __m256 exp_v = _mm256_exp_ps(_mm256_sub_ps(_mm256_loadu_ps(input + i), shift_v));
+        sum_v = _mm256_add_ps(sum_v, exp_v);
+        _mm256_storeu_ps(output + i, exp_v);
+    }
+    sum_s += _mm256_sum_ps(sum_v);
+    for (; i < len; i++) {
+        output[i] = exp(input[i] - shift);
+        sum_s += output[i];
+    }
+    return sum_s;
+}
+
+X86_AVX512_BEGIN
+namespace avx512 {
+// hides array_exp_sum_f32 in the AVX-512 copy of the kernels
+inline F32 array_exp_sum_f32(const F32 *input, F32 *output, I32 len, F32 shift)
+{
+    I32 i = 0;
+    __m512 shift_x = _mm512_set1_ps(shift);
+    __m512 sum_x = _mm512_setzero_ps();
+    for (; i < len - 15; i += 16) {
+        __m512 exp_x = _mm512_exp_ps(_mm512_sub_ps(_mm512_loadu_ps(input + i), shift_x));
+        sum_x = _mm512_add_ps(sum_x, exp_x);
+        _mm512_storeu_ps(output + i, exp_x);
+    }
+    return _mm512_reduce_add_ps(sum_x) + ::array_exp_sum_f32(input + i, output + i, len - i, shift);
+}
+}  // namespace avx512
+X86_AVX512_END
+
 // array mean
 inline F32 array_mean_f32(const F32 *data, I32 len)
 {
@@ -131,14 +131,28 @@ EE convolution_int8(TensorDesc inputDesc,
 
     EE ret = SUCCESS;
     switch (algorithm) {
-        case CONVOLUTION_ALGORITHM_DIRECT:
-            ret = convolution_direct(inputDesc, input, filterDesc, filter, convParamSpec, biasDesc,
-                bias, tmpBytes, tmp, outputDesc, output, scale, activationDesc);
+        case CONVOLUTION_ALGORITHM_DIRECT: {
+            auto func = avx2::convolution_direct;
+            if (IS_X86_AVX512_VNNI(arch)) {
+                func = avx512_vnni::convolution_direct;
+            } else if (IS_X86_AVX512(arch)) {
+                func = convolution_direct;
+            }
+            ret = func(inputDesc, input, filterDesc, filter, convParamSpec, biasDesc, bias,
+                tmpBytes, tmp, outputDesc, output, scale, activationDesc, arch);
             break;
-        case CONVOLUTION_ALGORITHM_POINTWISE:
-            ret = convolution_1x1_direct(inputDesc, input, filterDesc, filter, convParamSpec,
-                biasDesc, bias, tmpBytes, tmp, outputDesc, output, scale, activationDesc);
+        }
+        case CONVOLUTION_ALGORITHM_POINTWISE: {
+            auto func = avx2::convolution_1x1_direct;
+            if (IS_X86_AVX512_VNNI(arch)) {
+                func = avx512_vnni::convolution_1x1_direct;
+            } else if (IS_X86_AVX512(arch)) {
+                func = convolution_1x1_direct;
+            }
+            ret = func(inputDesc, input, filterDesc, filter, convParamSpec, biasDesc, bias,
+                tmpBytes, tmp, outputDesc, output, scale, activationDesc, arch);
             break;
+        }
         default:
             ret = NOT_SUPPORTED;
             break;
@@ -19,6 +19,9 @@
 #include "cpu/x86/int8/tensor_computing_int8.h"
 #include "cpu/x86/tensor_computing_x86.h"
 
+X86_ISA_NAMESPACE_BEGIN
+X86_INT8_BEGIN
+
 #define SIMDW 16
 #define BLOCK_IC_DIM 256
 #define BLOCK_HW_DIM 768
@@ -45,6 +48,101 @@ struct ConvController {
 
 typedef void (*kernelFunc)(ConvController &c);
 
+#ifdef _USE_AVX2
+// P pixels x Q chunks of 8 output channels. u8 input is flipped to s8 by xor 0x80, the driver
+// has already folded the -128 * sum(w) correction out of the bias.
+template <U32 P, U32 Q>
+inline void Avx2ConvC4(__m256i (&acc)[P][Q],
+    const UINT8 *input,
+    I64 pixStep,
+    const INT8 *filter,
+    U32 groups,
+    U32 oc)
+{
+    __m256i flip = _mm256_set1_epi8(-128);
+    for (U32 g = 0; g < groups; ++g) {
+        __m256i w[Q];
+        for (U32 q = 0; q < Q; ++q) {
+            w[q] = _mm256_loadu_si256((const __m256i *)(filter + g * oc * 4 + q * 32));
+        }
+        for (U32 p = 0; p < P; ++p) {
+            __m256i a = _mm256_xor_si256(
+                _mm256_set1_epi32(*(const I32 *)(input + p * pixStep + g * 4)), flip);
+            for (U32 q = 0; q < Q; ++q) {
+                acc[p][q] = _mm256_dpbssd_avx2_epi32(acc[p][q], a, w[q]);
+            }
+        }
+    }
+}
+
+template <U32 P, U32 Q>
+inline void Avx2ConvStore(__m256i (&acc)[P][Q], ConvController &c, U32 p0, U32 ocb, U32 oc)
+{
+    U32 simdOc = UNI_MIN(SIMDW, oc);
+    for (U32 p = 0; p < P; ++p) {
+        for (U32 q = 0; q < Q; ++q) {
+            U32 o = ocb + q * 8;
+            I32 *out = (I32 *)((UINT8 *)c.output + (o / 16) * c.ostepC16) + (o % 16) +
+                (p0 + p) * simdOc;
+            __m256i v = acc[p][q];
+            if (c.flags & 1) {
+                v = _mm256_add_epi32(v, _mm256_loadu_si256((const __m256i *)out));
+            }
+            if (c.flags & 0xC) {
+                v = _mm256_max_epi32(v, _mm256_setzero_si256());
+            }
+            if (c.scale != nullptr) {
+                __m256 s = _mm256_set1_ps(*(F32 *)c.scale);
+                _mm256_storeu_ps((F32 *)out, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+            } else {
+                _mm256_storeu_si256((__m256i *)out, v);
+            }
+        }
+    }
+}
+
+template <U32 P, U32 Q>
+inline void Avx2Conv1x1Block(ConvController &c, U32 p0, U32 ocb, U32 oc)
+{
+    __m256i acc[P][Q];
+    for (U32 q = 0; q < Q; ++q) {
+        __m256i b = (c.flags & 1) ? _mm256_setzero_si256()
+                                  : _mm256_loadu_si256((const __m256i *)(c.bias + ocb + q * 8));
+        for (U32 p = 0; p < P; ++p) {
+            acc[p][q] = b;
+        }
+    }
+    const UINT8 *input = c.input;
+    const INT8 *filter = c.filter + ocb * 4;
+    I64 ic = (c.ic + 3) / 4 * 4;
+    while (ic > 0) {
+        U32 cx = (ic >= 16) ? 16 : ((ic >= 8) ? 8 : 4);
+        Avx2ConvC4<P, Q>(acc, input + p0 * cx, cx, filter, cx / 4, oc);
+        filter += oc * cx;
+        ic -= cx;
+        if (ic > 0) {
+            input += (cx == 8) ? c.f4Step : ((ic >= 16) ? c.fStep : c.f8Step);
+        }
+    }
+    Avx2ConvStore<P, Q>(acc, c, p0, ocb, oc);
+}
+
+template <U32 W, U32 OC>
+void Avx2Conv1x1Kernel(ConvController &c)
+{
+    const U32 Q = (OC == 8) ? 1 : 2;
+    const U32 P = (Q == 1) ? 6 : 3;
+    for (U32 ocb = 0; ocb < OC; ocb += Q * 8) {
+        U32 p = 0;
+        for (; p + P <= W; p += P) {
+            Avx2Conv1x1Block<P, Q>(c, p, ocb, OC);
+        }
+        for (; p < W; ++p) {
+            Avx2Conv1x1Block<1, Q>(c, p, ocb, OC);
+        }
+    }
+}
+#else
 // clang-format off
 #define clear1Regs(rtype) \
     "vxorps "#rtype"0, "#rtype"0, "#rtype"0                     \n\t"
@@ -1923,6 +2021,8 @@ void Avx512Conv1x1Kernel1x8(ConvController &c) {
 }
 
 // clang-format on
+#endif
+
 EE convolution_1x1_direct(TensorDesc inputDesc,
     UINT8 *inArray,
     TensorDesc filterDesc,
@@ -1935,7 +2035,8 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     TensorDesc outputDesc,
     void *outArray,
     F32 *scale,
-    ActivationParamSpec activationDesc)
+    ActivationParamSpec activationDesc,
+    Arch arch)
 {
     DataType idt, fdt, odt;
     DataFormat idf, fdf, odf;
@@ -1958,11 +2059,19 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     U32 icSizeArray[3] = {4, 8, 16};
     U32 ocSizeArray[4] = {8, 16, 32, 48};
     U32 wSizeArray[4] = {24, 24, 12, 8};
+#ifdef _USE_AVX2
+    const kernelFunc kernel[4][3] = {
+        {Avx2Conv1x1Kernel<1, 8>, Avx2Conv1x1Kernel<12, 8>, Avx2Conv1x1Kernel<24, 8>},
+        {Avx2Conv1x1Kernel<1, 16>, Avx2Conv1x1Kernel<12, 16>, Avx2Conv1x1Kernel<24, 16>},
+        {Avx2Conv1x1Kernel<1, 32>, Avx2Conv1x1Kernel<6, 32>, Avx2Conv1x1Kernel<12, 32>},
+        {Avx2Conv1x1Kernel<1, 48>, Avx2Conv1x1Kernel<4, 48>, Avx2Conv1x1Kernel<8, 48>}};
+#else
     const kernelFunc kernel[4][3] = {
         {Avx512Conv1x1Kernel1x8, Avx512Conv1x1Kernel12x8, Avx512Conv1x1Kernel24x8},
         {Avx512Conv1x1Kernel1x16, Avx512Conv1x1Kernel12x16, Avx512Conv1x1Kernel24x16},
         {Avx512Conv1x1Kernel1x32, Avx512Conv1x1Kernel6x32, Avx512Conv1x1Kernel12x32},
         {Avx512Conv1x1Kernel1x48, Avx512Conv1x1Kernel4x48, Avx512Conv1x1Kernel8x48}};
+#endif
 
     // get computing params
     U32 strideH = convParamSpec.stride_h;
@@ -2006,7 +2115,7 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
         //quantize to U8_Q
         TensorDesc qDesc = inputDesc;
         qDesc.dt = DT_U8_Q;
-        CHECK_STATUS(quantize_x86(inputDesc, (void *)inArray, &qDesc, tmp, scaleI));
+        CHECK_STATUS(quantize_x86(inputDesc, (void *)inArray, &qDesc, tmp, scaleI, arch));
         inArray = (UINT8 *)tmp;
         tmp = (void *)((U8 *)tmp + tensorNumBytes(qDesc));
     }
@@ -2027,6 +2136,12 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     tmp = (void *)((U8 *)tmp + oc * bytesOf(DT_I32));
     CHECK_STATUS(quantize_bias_offsetC((const void *)biasArray, biasDesc, DT_I32,
         (const void *)filterArray, filterDesc, scaleO, offsetC));
+#ifdef _USE_AVX2
+    // the AVX2 kernels flip the input to s8 themselves, drop the u8 offset folded into the header
+    for (U32 i = 0; i < oc; ++i) {
+        offsetC[i] -= ((const I32 *)filterArray)[i];
+    }
+#endif
     filterArray += oc * 4;
 
     U32 oBytes = bytesOf(outputDesc.dt);
@@ -2075,7 +2190,7 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
             U32 simdC = SIMDW;
             U32 simdOc = SIMDW;
             if (icSize < SIMDW) {
-                simdC = icSizeArray[icSize >> 3];
+                simdC = icSizeArray[((icSize + 3) / 4 * 4) >> 3];
             }
             U32 hwSize = 0;
             for (U32 hw = 0; hw < ohow; hw += hwSize) {
@@ -2099,7 +2214,7 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
                         convCtl.output = output + ((n * oc + ocb) * ohow + ihw * simdOc) * oBytes;
                         convCtl.filter = filterArray + ocb * ic * fh * fw + ocSize * icbb * fh * fw;
                         if ((ic % 16 != 0) && (icbb == (int)ic - icSize)) {
-                            U32 cx = (ic % 8 == 0) ? 8 : 4;
+                            U32 cx = ((ic + 3) / 4 * 4 % 16 >= 8) ? 8 : 4;
                             convCtl.f8Step =
                                 convCtl.fStep - (in_h * iw_stride + in_w) * (SIMDW - cx);
                             convCtl.f4Step = convCtl.fStep / 2 - (in_h * iw_stride + in_w) * (8 - 4);
@@ -2117,9 +2232,11 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
         F32 scales[2] = {-1, scaleO[0]};
         TensorDesc qDesc = outputDesc;
         qDesc.dt = DT_U8_Q;
-        CHECK_STATUS(quantize_x86(outputDesc, (void *)output, &qDesc, (void *)outArray, scales));
+        CHECK_STATUS(quantize_x86(outputDesc, (void *)output, &qDesc, (void *)outArray, scales, arch));
         *scaleO = scales[0];
     }
 
     return SUCCESS;
 }
+X86_INT8_END
+X86_ISA_NAMESPACE_END
@@ -15,12 +15,26 @@
 
 #include "cpu/x86/int8/tensor_computing_int8.h"
 
+X86_ISA_NAMESPACE_BEGIN
+X86_INT8_BEGIN
+
 EE dequantizeI32ToF32(TensorDesc qDesc, I32 *qData, const F32 *scale, TensorDesc dDesc, F32 *data)
 {
     U32 dataNum = tensorNumElements(dDesc);
     U32 num16 = dataNum / 16;
     U32 resMask = pow(2, dataNum % 16) - 1;
     F32 factor = 1 / *scale;
+#ifdef _USE_AVX2
+    __m256 f = _mm256_set1_ps(factor);
+    U32 i = 0;
+    for (; i + 8 <= dataNum; i += 8) {
+        __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(qData + i)));
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(v, f));
+    }
+    for (; i < dataNum; ++i) {
+        data[i] = qData[i] * factor;
+    }
+#else
     __asm__ __volatile__("vbroadcastss (%2), %%zmm2              \n\t"
                          ".align 16                              \n\t"
                          "0:                                     \n\t"
@@ -46,5 +60,8 @@ EE dequantizeI32ToF32(TensorDesc qDesc, I32 *qData, const F32 *scale, TensorDesc
                          : "+r"(qData), "+r"(data)
                          : "r"(&factor), "b"(num16), "a"(resMask)
                          : "%k1", "%zmm0", "%zmm1", "%zmm2", "memory", "cc");
+#endif
     return SUCCESS;
 }
+X86_INT8_END
+X86_ISA_NAMESPACE_END
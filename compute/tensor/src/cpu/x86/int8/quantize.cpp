@@ -18,6 +18,200 @@
 #include "blas_enhance.h"
 #include "cpu/x86/int8/tensor_computing_int8.h"
 
+X86_ISA_NAMESPACE_BEGIN
+
+#ifndef _USE_AVX2
+EE quantizeBiasOffsetCI32(F32 *bias,
+    TensorDesc biasDesc,
+    INT8 *filter,
+    TensorDesc filterDesc,
+    const F32 *scale,
+    I32 *offsetCBias)
+{
+    U32 N = tensorNumElements(biasDesc);
+    std::set<DataFormat> nativeFormat = {DF_NCHW, DF_NHWC, DF_MTK, DF_NORMAL, DF_TRANSPOSE};
+    I32 *offsetC = (I32 *)filter;
+    if (bias == nullptr || N == 0) {
+        N = UNI_MAX(filterDesc.dims[0], filterDesc.dims[1]);
+        if (nativeFormat.count(filterDesc.df)) {
+            memset(offsetCBias, 0, N * bytesOf(DT_I32));
+        } else {
+            memcpy(offsetCBias, offsetC, N * bytesOf(DT_I32));
+        }
+        return SUCCESS;
+    }
+
+    if (nativeFormat.count(filterDesc.df)) {
+        for (U32 i = 0; i < N; ++i) {
+            offsetCBias[i] = round(bias[i] * scale[0]);
+        }
+    } else {
+        for (U32 i = 0; i < N; ++i) {
+            offsetCBias[i] = round(bias[i] * scale[0]) + offsetC[i];
+        }
+    }
+    return SUCCESS;
+}
+#endif
+
+X86_INT8_BEGIN
+#ifdef _USE_AVX2
+inline void getSymmetricQuantizeScale(U32 len, const F32 *data, F32 *scale)
+{
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 maxV = _mm256_setzero_ps();
+    U32 i = 0;
+    for (; i + 8 <= len; i += 8) {
+        maxV = _mm256_max_ps(maxV, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+    }
+    F32 maxS = _mm256_hmax_ps(maxV);
+    for (; i < len; ++i) {
+        maxS = UNI_MAX(maxS, UNI_ABS(data[i]));
+    }
+    *scale = 127.0f / maxS;
+}
+
+inline void getSymmetricQuantizeScaleI32(U32 len, const I32 *data, F32 *scale)
+{
+    __m256i maxV = _mm256_setzero_si256();
+    U32 i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        maxV = _mm256_max_epi32(maxV, _mm256_abs_epi32(v));
+    }
+    I32 maxS = _mm256_hmax_epu32(maxV);
+    for (; i < len; ++i) {
+        maxS = UNI_MAX(maxS, UNI_ABS(data[i]));
+    }
+    *scale = 127.0f / maxS;
+}
+
+// 8 int32 to 8 bytes with unsigned or signed saturation
+inline void storeU8x8(__m256i v, UINT8 *dst)
+{
+    __m128i u16 = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(u16, u16));
+}
+
+inline void storeI8x8(__m256i v, INT8 *dst)
+{
+    __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packs_epi16(i16, i16));
+}
+
+EE quantizeF32ToU8(TensorDesc dDesc, const F32 *data, TensorDesc *qDesc, UINT8 *qData, F32 *scale)
+{
+    U32 dataNum = tensorNumElements(dDesc);
+    F32 minScale = 0;
+    if (*scale > 0) {
+        minScale = *scale;
+    }
+
+    getSymmetricQuantizeScale(dataNum, data, scale);
+    *scale = UNI_MAX(minScale, *scale);
+
+    __m256 s = _mm256_set1_ps(*scale);
+    __m256 offset = _mm256_set1_ps(128);
+    __m256i lower = _mm256_set1_epi32(1);
+    __m256i upper = _mm256_set1_epi32(255);
+    U32 i = 0;
+    for (; i + 8 <= dataNum; i += 8) {
+        __m256 f = _mm256_fmadd_ps(_mm256_loadu_ps(data + i), s, offset);
+        __m256i q = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvtps_epi32(f), lower), upper);
+        storeU8x8(q, qData + i);
+    }
+    for (; i < dataNum; ++i) {
+        I32 q = round(data[i] * scale[0] + 128);
+        qData[i] = UNI_MIN(UNI_MAX(q, 1), 255);
+    }
+    return SUCCESS;
+}
+
+EE quantizeF32ToI8(TensorDesc dDesc, const F32 *data, TensorDesc *qDesc, INT8 *qData, F32 *scale)
+{
+    U32 dataNum = tensorNumElements(dDesc);
+    F32 minScale = 0;
+    if (*scale > 0) {
+        minScale = *scale;
+    }
+
+    getSymmetricQuantizeScale(dataNum, data, scale);
+    *scale = UNI_MAX(minScale, *scale);
+
+    __m256 s = _mm256_set1_ps(*scale);
+    __m256i lower = _mm256_set1_epi32(-127);
+    __m256i upper = _mm256_set1_epi32(127);
+    U32 i = 0;
+    for (; i + 8 <= dataNum; i += 8) {
+        __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(data + i), s));
+        storeI8x8(_mm256_min_epi32(_mm256_max_epi32(q, lower), upper), qData + i);
+    }
+    for (; i < dataNum; ++i) {
+        I32 q = round(data[i] * scale[0]);
+        qData[i] = UNI_MIN(UNI_MAX(q, -127), 127);
+    }
+    return SUCCESS;
+}
+
+EE transformU8ToI8(TensorDesc dDesc, const UINT8 *data, TensorDesc *qDesc, INT8 *qData)
+{
+    U32 dataNum = tensorNumElements(dDesc);
+    __m256i offset = _mm256_set1_epi8(-128);
+    U32 i = 0;
+    for (; i + 32 <= dataNum; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        _mm256_storeu_si256((__m256i *)(qData + i), _mm256_add_epi8(v, offset));
+    }
+    for (; i < dataNum; ++i) {
+        qData[i] = (INT8)(data[i] + 128);
+    }
+    return SUCCESS;
+}
+
+EE quantizeI32ToI8(TensorDesc dDesc, const I32 *data, TensorDesc *qDesc, INT8 *qData, F32 *scale)
+{
+    U32 dataNum = tensorNumElements(dDesc);
+    F32 scaleRaw = 0;
+    getSymmetricQuantizeScaleI32(dataNum, data, &scaleRaw);
+
+    __m256 s = _mm256_set1_ps(scaleRaw);
+    U32 i = 0;
+    for (; i + 8 <= dataNum; i += 8) {
+        __m256 f = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(data + i)));
+        storeI8x8(_mm256_cvtps_epi32(_mm256_mul_ps(f, s)), qData + i);
+    }
+    for (; i < dataNum; ++i) {
+        I32 q = round(data[i] * scaleRaw);
+        qData[i] = UNI_MIN(UNI_MAX(q, -128), 127);
+    }
+    return SUCCESS;
+}
+
+EE quantizeI32ToU8(TensorDesc dDesc, const I32 *data, TensorDesc *qDesc, UINT8 *qData, F32 *scale)
+{
+    U32 dataNum = tensorNumElements(dDesc);
+    F32 scaleRaw = 0;
+    if (*scale < 0 && scale[1] > 0) {
+        getSymmetricQuantizeScaleI32(dataNum, data, &scaleRaw);
+        scale[0] = scale[1] * scaleRaw;
+    } else if (scale[0] > 0 && scale[1] > 0) {
+        scaleRaw = scale[0] / scale[1];
+    }
+
+    __m256 s = _mm256_set1_ps(scaleRaw);
+    __m256 offset = _mm256_set1_ps(128);
+    U32 i = 0;
+    for (; i + 8 <= dataNum; i += 8) {
+        __m256 f = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(data + i)));
+        storeU8x8(_mm256_cvtps_epi32(_mm256_fmadd_ps(f, s, offset)), qData + i);
+    }
+    for (; i < dataNum; ++i) {
+        I32 q = round(data[i] * scaleRaw + 128);
+        qData[i] = UNI_MIN(UNI_MAX(q, 0), 255);
+    }
+    return SUCCESS;
+}
+#else
 inline void getSymmetricQuantizeScale(U32 num16, U32 resMask, const F32 *data, F32 *scale)
 {
     __asm__ __volatile__("vxorps %%zmm0, %%zmm0, %%zmm0            \n\t"
@@ -223,38 +417,6 @@ EE quantizeF32ToI8(TensorDesc dDesc, const F32 *data, TensorDesc *qDesc, INT8 *q
     return SUCCESS;
 }
 
-EE quantizeBiasOffsetCI32(F32 *bias,
-    TensorDesc biasDesc,
-    INT8 *filter,
-    TensorDesc filterDesc,
-    const F32 *scale,
-    I32 *offsetCBias)
-{
-    U32 N = tensorNumElements(biasDesc);
-    std::set<DataFormat> nativeFormat = {DF_NCHW, DF_NHWC, DF_MTK, DF_NORMAL, DF_TRANSPOSE};
-    I32 *offsetC = (I32 *)filter;
-    if (bias == nullptr || N == 0) {
-        N = UNI_MAX(filterDesc.dims[0], filterDesc.dims[1]);
-        if (nativeFormat.count(filterDesc.df)) {
-            memset(offsetCBias, 0, N * bytesOf(DT_I32));
-        } else {
-            memcpy(offsetCBias, offsetC, N * bytesOf(DT_I32));
-        }
-        return SUCCESS;
-    }
-
-    if (nativeFormat.count(filterDesc.df)) {
-        for (U32 i = 0; i < N; ++i) {
-            offsetCBias[i] = round(bias[i] * scale[0]);
-        }
-    } else {
-        for (U32 i = 0; i < N; ++i) {
-            offsetCBias[i] = round(bias[i] * scale[0]) + offsetC[i];
-        }
-    }
-    return SUCCESS;
-}
-
 EE transformU8ToI8(TensorDesc dDesc, const UINT8 *data, TensorDesc *qDesc, INT8 *qData)
 {
     U32 dataNum = tensorNumElements(dDesc);
@@ -390,3 +552,6 @@ EE quantizeI32ToU8(TensorDesc dDesc, const I32 *data, TensorDesc *qDesc, UINT8 *
 
     return SUCCESS;
 }
+#endif
+X86_INT8_END
+X86_ISA_NAMESPACE_END
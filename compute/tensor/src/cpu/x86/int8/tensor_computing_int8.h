@@ -18,6 +18,8 @@
 #include "error.h"
 #include "data_type.h"
 #include "parameter_spec.h"
+#include "x86_avx512_expand.h"
+#include "x86_avx2_expand.h"
 
 EE dequantizeI32ToF32(TensorDesc qDesc, I32 *qData, const F32 *scale, TensorDesc dDesc, F32 *data);
 
@@ -66,7 +68,8 @@ EE convolution_direct(TensorDesc inputDesc,
     TensorDesc outputDesc,
     void *outArray,
     F32 *scale,
-    ActivationParamSpec activationDesc);
+    ActivationParamSpec activationDesc,
+    Arch arch);
 
 EE convolution_transform_filter_int8(TensorDesc filterDesc,
     const INT8 *filter,
@@ -94,6 +97,85 @@ EE convolution_1x1_direct(TensorDesc inputDesc,
     TensorDesc outputDesc,
     void *outArray,
     F32 *scale,
-    ActivationParamSpec activationDesc);
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
+// builds of the kernels above that use vpdpbusd, picked at run time if IS_X86_AVX512_VNNI(arch)
+namespace avx512_vnni {
+EE convolution_direct(TensorDesc inputDesc,
+    UINT8 *inArray,
+    TensorDesc filterDesc,
+    const INT8 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const I32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *outArray,
+    F32 *scale,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
+EE convolution_1x1_direct(TensorDesc inputDesc,
+    UINT8 *inArray,
+    TensorDesc filterDesc,
+    const INT8 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const I32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *outArray,
+    F32 *scale,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+}  // namespace avx512_vnni
+
+// AVX2 builds of the kernels above, picked at run time if the cpu has no AVX-512
+namespace avx2 {
+EE dequantizeI32ToF32(TensorDesc qDesc, I32 *qData, const F32 *scale, TensorDesc dDesc, F32 *data);
+
+EE quantizeF32ToI8(TensorDesc dDesc, const F32 *data, TensorDesc *qDesc, INT8 *qData, F32 *scale);
+
+EE quantizeF32ToU8(TensorDesc dDesc, const F32 *data, TensorDesc *qDesc, UINT8 *qData, F32 *scale);
+
+EE transformU8ToI8(TensorDesc dDesc, const UINT8 *data, TensorDesc *qDesc, INT8 *qData);
+
+EE quantizeI32ToU8(TensorDesc dDesc, const I32 *data, TensorDesc *qDesc, UINT8 *qData, F32 *scale);
+
+EE quantizeI32ToI8(TensorDesc dDesc, const I32 *data, TensorDesc *qDesc, INT8 *qData, F32 *scale);
+
+EE convolution_direct(TensorDesc inputDesc,
+    UINT8 *inArray,
+    TensorDesc filterDesc,
+    const INT8 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const I32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *outArray,
+    F32 *scale,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+
+EE convolution_1x1_direct(TensorDesc inputDesc,
+    UINT8 *inArray,
+    TensorDesc filterDesc,
+    const INT8 *filterArray,
+    ConvolutionParamSpec convParamSpec,
+    TensorDesc biasDesc,
+    const I32 *biasArray,
+    U32 tmpBytes,
+    void *tmp,
+    TensorDesc outputDesc,
+    void *outArray,
+    F32 *scale,
+    ActivationParamSpec activationDesc,
+    Arch arch);
+}  // namespace avx2
 
 #endif  //CHEETAH_TENSOR_COMPUTING_INT8_H
\ No newline at end of file
@@ -18,12 +18,12 @@
 #include "parameter_spec.h"
 #include "uni.h"
 #include "thread_affinity.h"
+#include "x86_avx512_expand.h"
 
 inline EE activation_offset_int8(
     UINT8 *input, U32 len, ActivationParamSpec activationDesc, UINT8 *output)
 {
     U32 num32 = len / 32;
-    U32 resMask = pow(2, len % 32) - 1;
 
     EE ret = SUCCESS;
 
@@ -49,17 +49,12 @@ inline EE activation_offset_int8(
 
                                  ".align 16                             \n\t"
                                  "1:                                    \n\t"
-                                 "cmp $0x0, %%eax                       \n\t"
-                                 "je 2f                                 \n\t"
-                                 "kmovw %%eax, %%k1                     \n\t"
-                                 "vmovdqu8 (%0), %%ymm1 %{%%k1%}              \n\t"
-                                 "vpmaxub %%ymm1, %%ymm2, %%ymm0 %{%%k1%}              \n\t"
-                                 "vmovdqu8 %%ymm0, (%1) %{%%k1%}              \n\t"
-                                 ".align 16                             \n\t"
-                                 "2:                                    \n\t"
                                  : "+r"(input), "+r"(output)
-                                 : "r"(num32), "a"(resMask)
-                                 : "%k1", "%ebx", "%zmm0", "%zmm1", "%zmm2", "memory", "cc");
+                                 : "r"(num32)
+                                 : "%ebx", "%ymm0", "%ymm1", "%ymm2", "memory", "cc");
+            for (U32 i = 0; i < len % 32; ++i) {
+                output[i] = UNI_MAX(input[i], 128);
+            }
             break;
         }
         default:
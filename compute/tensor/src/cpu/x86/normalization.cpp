@@ -16,15 +16,22 @@
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #endif
 
-EE layer_normalization_x86(
-    TensorDesc inputDesc, void *input, void *alpha, void *beta, TensorDesc outputDesc, void *output)
+EE layer_normalization_x86(TensorDesc inputDesc,
+    void *input,
+    void *alpha,
+    void *beta,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
 {
     DataType idt = inputDesc.dt;
     EE ret = SUCCESS;
     switch (idt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = layer_normalization_fp32(
+            auto func = IS_X86_AVX512(arch) ? avx512::layer_normalization_fp32
+                                            : layer_normalization_fp32;
+            ret = func(
                 inputDesc, (F32 *)input, (F32 *)alpha, (F32 *)beta, outputDesc, (F32 *)output);
             break;
         }
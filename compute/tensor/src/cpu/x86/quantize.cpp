@@ -16,18 +16,22 @@
 #include "cpu/x86/int8/tensor_computing_int8.h"
 #endif
 
-EE quantize_x86(TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale)
+EE quantize_x86(
+    TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale, Arch arch)
 {
     EE ret = SUCCESS;
+    bool avx512 = IS_X86_AVX512(arch);
     if (dDesc.dt == DT_F32 || dDesc.dt == DT_F32_8Q) {
         switch (qDesc->dt) {
 #ifdef _USE_INT8
             case DT_I8: {
-                ret = quantizeF32ToI8(dDesc, (const F32 *)data, qDesc, (INT8 *)qData, scale);
+                auto func = avx512 ? quantizeF32ToI8 : avx2::quantizeF32ToI8;
+                ret = func(dDesc, (const F32 *)data, qDesc, (INT8 *)qData, scale);
                 break;
             }
             case DT_U8_Q: {
-                ret = quantizeF32ToU8(dDesc, (const F32 *)data, qDesc, (UINT8 *)qData, scale);
+                auto func = avx512 ? quantizeF32ToU8 : avx2::quantizeF32ToU8;
+                ret = func(dDesc, (const F32 *)data, qDesc, (UINT8 *)qData, scale);
                 break;
             }
 #endif
@@ -37,17 +41,20 @@ EE quantize_x86(TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qDa
         }
 #ifdef _USE_INT8
     } else if (dDesc.dt == DT_U8_Q && qDesc->dt == DT_I8) {
-        ret = transformU8ToI8(dDesc, (const UINT8 *)data, qDesc, (INT8 *)qData);
+        auto func = avx512 ? transformU8ToI8 : avx2::transformU8ToI8;
+        ret = func(dDesc, (const UINT8 *)data, qDesc, (INT8 *)qData);
 #endif
     } else if (dDesc.dt == DT_I32) {
         switch (qDesc->dt) {
 #ifdef _USE_INT8
             case DT_I8: {
-                ret = quantizeI32ToI8(dDesc, (const I32 *)data, qDesc, (INT8 *)qData, scale);
+                auto func = avx512 ? quantizeI32ToI8 : avx2::quantizeI32ToI8;
+                ret = func(dDesc, (const I32 *)data, qDesc, (INT8 *)qData, scale);
                 break;
             }
             case DT_U8_Q: {
-                ret = quantizeI32ToU8(dDesc, (const I32 *)data, qDesc, (UINT8 *)qData, scale);
+                auto func = avx512 ? quantizeI32ToU8 : avx2::quantizeI32ToU8;
+                ret = func(dDesc, (const I32 *)data, qDesc, (UINT8 *)qData, scale);
                 break;
             }
 #endif
@@ -16,15 +16,20 @@
 #include "cpu/x86/fp32/tensor_computing_fp32.h"
 #endif
 
-EE softmax_x86(
-    TensorDesc inputDesc, const void *input, SoftmaxParamSpec p, TensorDesc outputDesc, void *output)
+EE softmax_x86(TensorDesc inputDesc,
+    const void *input,
+    SoftmaxParamSpec p,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch)
 {
     DataType idt = inputDesc.dt;
     EE ret = SUCCESS;
     switch (idt) {
 #ifdef _USE_FP32
         case DT_F32: {
-            ret = softmax_fp32(inputDesc, (const F32 *)input, p.axis, outputDesc, (F32 *)output);
+            auto func = IS_X86_AVX512(arch) ? avx512::softmax_fp32 : softmax_fp32;
+            ret = func(inputDesc, (const F32 *)input, p.axis, outputDesc, (F32 *)output);
             break;
         }
 #endif
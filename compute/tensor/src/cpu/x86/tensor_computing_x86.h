@@ -44,7 +44,8 @@ EE convolution_infer_forward_algorithm_x86(TensorDesc inputDesc,
     ConvolutionParamSpec convParamSpec,
     ConvolutionPolicy policy,
     ConvolutionForwardAlgorithm *algorithm,
-    DataType targetDataType);
+    DataType targetDataType,
+    Arch arch);
 
 EE convolution_transform_filter_bytes_x86(TensorDesc filterDesc,
     ConvolutionParamSpec convParamSpec,
@@ -152,8 +153,13 @@ EE eltwise_x86(DataType dataType,
     void *output,
     EltwiseMode eltwiseMode);
 
-EE layer_normalization_x86(
-    TensorDesc inputDesc, void *input, void *alpha, void *beta, TensorDesc outputDesc, void *output);
+EE layer_normalization_x86(TensorDesc inputDesc,
+    void *input,
+    void *alpha,
+    void *beta,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch);
 
 EE rnncell_x86(TensorDesc xDesc,
     const void *currentX,
@@ -194,8 +200,12 @@ EE pooling_bp_x86(TensorDesc inputDesc,
 
 EE reshape_x86(TensorDesc inputDesc, void *input, TensorDesc outputDesc, void *output);
 
-EE softmax_x86(
-    TensorDesc inputDesc, const void *input, SoftmaxParamSpec p, TensorDesc outputDesc, void *output);
+EE softmax_x86(TensorDesc inputDesc,
+    const void *input,
+    SoftmaxParamSpec p,
+    TensorDesc outputDesc,
+    void *output,
+    Arch arch);
 
 EE deconvolution_transform_filter_x86(TensorDesc filterDesc,
     const void *filter,
@@ -249,7 +259,8 @@ EE quantize_bias_offsetC(const void *bias,
     const F32 *scale,
     void *qBias);
 
-EE quantize_x86(TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale);
+EE quantize_x86(
+    TensorDesc dDesc, const void *data, TensorDesc *qDesc, void *qData, F32 *scale, Arch arch);
 
 EE dequantize_x86(TensorDesc qDesc,
     void *qData,
@@ -257,6 +268,7 @@ EE dequantize_x86(TensorDesc qDesc,
     TensorDesc bDesc,
     void *bData,
     TensorDesc dDesc,
-    void *dData);
+    void *dData,
+    Arch arch);
 
 #endif  //CHEETAH_TENSOR_COMPUTING_X86_H
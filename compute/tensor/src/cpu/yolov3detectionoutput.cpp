@@ -12,86 +12,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "cpu/tensor_computing_cpu.h"
+#include "cpu/nms_functions.h"
 #include "tensor_transpose.h"
 
-inline EE qsort_descent(std::vector<BoxRect> &boxes, std::vector<F32> &scores, int left, int right)
-{
-    if (boxes.empty() || scores.empty()) {
-        return NOT_SUPPORTED;
-    }
-
-    int i = left;
-    int j = right;
-    F32 temp = scores[(left + right) / 2];
-
-    while (i <= j) {
-        while (scores[i] > temp) {
-            i++;
-        }
-        while (scores[j] < temp) {
-            j--;
-        }
-        if (i <= j) {
-            std::swap(boxes[i], boxes[j]);
-            std::swap(scores[i], scores[j]);
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j) {
-        qsort_descent(boxes, scores, left, j);
-    }
-    if (i < right) {
-        qsort_descent(boxes, scores, i, right);
-    }
-
-    return SUCCESS;
-}
-
-inline F32 intersectionarea(BoxRect a, BoxRect b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin) {
-        return 0.f;
-    }
-    F32 inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    F32 inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
-
-inline EE nms_pickedboxes(std::vector<BoxRect> boxes, std::vector<I64> &picked, F32 nms_threshold)
-{
-    I64 n = boxes.size();
-
-    std::vector<F32> areas(n);
-    for (I64 i = 0; i < n; i++) {
-        BoxRect box = boxes[i];
-
-        F32 width = box.xmax - box.xmin;
-        F32 height = box.ymax - box.ymin;
-
-        areas[i] = width * height;
-    }
-    for (I64 i = 0; i < n; i++) {
-        BoxRect a = boxes[i];
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++) {
-            BoxRect b = boxes[picked[j]];
-            F32 inter_area = intersectionarea(a, b);
-            F32 union_area = areas[i] + areas[picked[j]] - inter_area;
-
-            if (inter_area / union_area > nms_threshold) {
-                keep = 0;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-        }
-    }
-    return SUCCESS;
-}
-
 template <typename T>
 EE yolov3detectionoutput(std::vector<void *> input,
     T *output,
@@ -207,17 +130,26 @@ EE yolov3detectionoutput(std::vector<void *> input,
         }
     }
     // sort boxes
-    qsort_descent(all_boxrects, all_boxscores, 0, static_cast<int>(all_boxscores.size() - 1));
+    std::vector<NMSCandidate> candidates(all_boxscores.size());
+    for (U32 i = 0; i < candidates.size(); i++) {
+        candidates[i].score = all_boxscores[i];
+        candidates[i].index = i;
+    }
+    nms_sort_candidates(candidates, candidates.size());
+    std::vector<BoxRect> sorted_boxrects(candidates.size());
+    for (U32 i = 0; i < candidates.size(); i++) {
+        sorted_boxrects[i] = all_boxrects[candidates[i].index];
+    }
     // apply nms
-    std::vector<I64> picked;
-    nms_pickedboxes(all_boxrects, picked, nms_threshold);
+    std::vector<U32> picked;
+    nms_select(sorted_boxrects.data(), sorted_boxrects.size(), nms_threshold,
+        sorted_boxrects.size(), &picked);
 
     std::vector<BoxRect> boxrects;
     std::vector<F32> boxscores;
-    for (I64 p = 0; p < (I64)picked.size(); p++) {
-        I64 picked_box = picked[p];
-        boxrects.push_back(all_boxrects[picked_box]);
-        boxscores.push_back(all_boxscores[picked_box]);
+    for (U32 p = 0; p < picked.size(); p++) {
+        boxrects.push_back(sorted_boxrects[picked[p]]);
+        boxscores.push_back(candidates[picked[p]].score);
     }
 
     U32 num_detected = static_cast<U32>(boxrects.size());
@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
 #endif
@@ -207,6 +208,7 @@ EE deconvolution_infer_forward_tmp_bytes(Tensor inputTensor,
     U32 *bytes,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     TensorDesc inputDesc = inputTensor.get_desc();
     TensorDesc filterDesc = filterTensor.get_desc();
     TensorDesc outputDesc = outputTensor.get_desc();
@@ -242,6 +244,7 @@ EE deconvolution(Tensor inputTensor,
     ActivationParamSpec activationDesc,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensor.get_desc();
     void *input = get_ptr_from_tensor(inputTensor, arch);
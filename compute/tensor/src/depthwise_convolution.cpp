@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #include "cpu/tensor_computing_cpu.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
@@ -269,6 +270,7 @@ EE depthwise_convolution(Tensor inputTensor,
     ActivationParamSpec depthwiseActivationParamSpec,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensor.get_desc();
     void *input = get_ptr_from_tensor(inputTensor, arch);
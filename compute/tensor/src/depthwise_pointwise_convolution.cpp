@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
 #endif
@@ -311,6 +312,7 @@ EE depthwise_pointwise_convolution(std::vector<Tensor> inputTensors,
     ActivationParamSpec pointwiseActivationParamSpec,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensors[0].get_desc();
     void *input = get_ptr_from_tensor(inputTensors[0], arch);
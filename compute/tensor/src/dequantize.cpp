@@ -42,7 +42,7 @@ EE dequantize(Tensor input, const F32 *scale, Tensor bias, Tensor output, ArchIn
 #endif
 #ifdef _USE_X86
     } else if (IS_X86(arch)) {
-        ret = dequantize_x86(qDesc, qData, scale, bDesc, bData, dDesc, data);
+        ret = dequantize_x86(qDesc, qData, scale, bDesc, bData, dDesc, data, arch);
 #endif
     }
     return ret;
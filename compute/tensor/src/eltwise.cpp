@@ -13,6 +13,7 @@
 
 #include <set>
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #if defined(_USE_CPU)
 #include "cpu/tensor_computing_cpu.h"
 #endif
@@ -160,6 +161,7 @@ EE eltwise(std::vector<Tensor> inputTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     std::vector<TensorDesc> inputDesc = get_desc_from_tensors(inputTensor);
     std::vector<void *> input = get_data_from_tensors<void *>(inputTensor, arch);
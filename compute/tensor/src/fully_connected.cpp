@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #include "blas_enhance.h"
 #ifdef _USE_GPU
 #include "gpu/mali/tensor_computing_mali.h"
@@ -133,7 +134,8 @@ EE fully_connected_infer_forward_tmp_bytes(
         CHECK_REQUIREMENT(tensorIs2d(filterDesc));
         U32 fh = tensorNumElements(filterDesc) / fw;
         U32 M = tensorNumElements(inputDesc) / fh;
-        if (M != 1) {
+        // weight transformed for mmm also runs batch 1 as mmm
+        if (M != 1 || filterDesc.df == targetFormat4MatrixB(filterDesc.dt)) {
             // call gemm
             TensorDesc in_desc = tensor2df(inputDesc.dt, DF_NORMAL, M, fh);
             ret = matrix_matrix_multiply_tmp_bytes(in_desc, filterDesc, bytes, archInfo->arch);
@@ -310,6 +312,7 @@ EE fully_connected(Tensor inputTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = inputTensor.get_desc();
     void *input = get_ptr_from_tensor(inputTensor, arch);
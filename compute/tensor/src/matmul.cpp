@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #include "blas_enhance.h"
 #include <string.h>
 #ifdef _USE_GPU
@@ -37,6 +38,43 @@ static void align_input_desc(TensorDesc *matrixADesc, TensorDesc *matrixBDesc)
     }
 }
 
+// Matrix products of a MatMul run as one matrix_matrix_multiply_batch call when neither side
+// is a vector and A and B are either shared or indexed like C, so that they have fixed strides.
+// matrixStrideA and matrixStrideB are the distances of the matrices, 0 if they are packed.
+static bool matmul_batch_strides(TensorDesc matrixADesc,
+    bool transposeA,
+    U32 matrixStrideA,
+    TensorDesc matrixBDesc,
+    bool transposeB,
+    U32 matrixStrideB,
+    TensorDesc matrixCDesc,
+    U32 *batch,
+    U32 *strideA,
+    U32 *strideB,
+    U32 *strideC)
+{
+    if (matrixADesc.nDims < 2 || matrixBDesc.nDims < 2 || matrixCDesc.nDims < 2) {
+        return false;
+    }
+    if (matrixADesc.dims[transposeA ? 0 : 1] == 1 || matrixBDesc.dims[transposeB ? 1 : 0] == 1) {
+        return false;
+    }
+    U32 sizeA = matrixADesc.dims[1] * matrixADesc.dims[0];
+    U32 sizeB = matrixBDesc.dims[1] * matrixBDesc.dims[0];
+    U32 sizeC = matrixCDesc.dims[1] * matrixCDesc.dims[0];
+    U32 loopsA = tensorNumElements(matrixADesc) / sizeA;
+    U32 loopsB = tensorNumElements(matrixBDesc) / sizeB;
+    U32 loopsC = tensorNumElements(matrixCDesc) / sizeC;
+    if (loopsC <= 1 || (loopsA != loopsC && loopsA != 1) || (loopsB != loopsC && loopsB != 1)) {
+        return false;
+    }
+    *batch = loopsC;
+    *strideA = (loopsA == 1) ? 0 : ((matrixStrideA > 0) ? matrixStrideA : sizeA);
+    *strideB = (loopsB == 1) ? 0 : ((matrixStrideB > 0) ? matrixStrideB : sizeB);
+    *strideC = sizeC;
+    return true;
+}
+
 EE matmul_infer_output_size_cpu(TensorDesc matrixADesc,
     bool transposeA,
     TensorDesc matrixBDesc,
@@ -265,6 +303,16 @@ EE matmul_infer_forward_tmp_bytes(Tensor matrixATensor,
         TensorDesc matrixB2Ddesc =
             tensor2df(matrixBDesc.dt, dataFormatB, matrixBDesc.dims[1], matrixBDesc.dims[0]);
         ret = matrix_matrix_multiply_tmp_bytes(matrixA2DDesc, matrixB2Ddesc, bytes, archInfo->arch);
+        U32 batch, strideA, strideB, strideC;
+        if (!useINT8Type(matrixADesc.dt, matrixBDesc.dt, matrixCDesc.dt,
+                matrixCTensor.get_scale()) &&
+            matmul_batch_strides(matrixADesc, transposeA, 0, matrixBDesc, transposeB, 0,
+                matrixCDesc, &batch, &strideA, &strideB, &strideC)) {
+            U32 batchBytes = 0;
+            ret = matrix_matrix_multiply_batch_tmp_bytes(
+                batch, matrixA2DDesc, matrixB2Ddesc, strideB, &batchBytes, archInfo->arch);
+            *bytes = UNI_MAX(*bytes, batchBytes);
+        }
     }
 
     if (quantA) {
@@ -289,6 +337,22 @@ EE matmul(Tensor matrixATensor,
     Tensor matrixCTensor,
     ArchInfo_t archInfo)
 {
+    return matmul_strided(matrixATensor, transposeA, 0, matrixBTensor, transposeB, 0, biasTensor,
+        tmpTensors, matrixCTensor, archInfo);
+}
+
+EE matmul_strided(Tensor matrixATensor,
+    bool transposeA,
+    U32 matrixStrideA,
+    Tensor matrixBTensor,
+    bool transposeB,
+    U32 matrixStrideB,
+    Tensor biasTensor,
+    std::vector<Tensor> tmpTensors,
+    Tensor matrixCTensor,
+    ArchInfo_t archInfo)
+{
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     U32 tmpBytes = tmpTensors[0].bytes();
     void *tmp = get_ptr_from_tensor(tmpTensors[0], arch);
@@ -304,7 +368,13 @@ EE matmul(Tensor matrixATensor,
     if (matrixA == nullptr || matrixB == nullptr || matrixC == nullptr) {
         CHECK_STATUS(NULL_POINTER);
     }
+    if (useINT8 && (matrixStrideA > 0 || matrixStrideB > 0)) {
+        return NOT_SUPPORTED;
+    }
     if (IS_GPU(arch)) {
+        if (matrixStrideA > 0 || matrixStrideB > 0) {
+            return NOT_SUPPORTED;
+        }
 #ifdef _USE_GPU
         void *bias = get_ptr_from_tensor(biasTensor, arch);
         TensorDesc biasDesc;
@@ -407,8 +477,14 @@ EE matmul(Tensor matrixATensor,
         kDimB = 1;
     }
 
-    U32 matrixA2DBytes = (matrixADesc.dims[1] * matrixADesc.dims[0]) * bytesOf(matrixADesc.dt);
-    U32 matrixB2DBytes = (matrixBDesc.dims[1] * matrixBDesc.dims[0]) * bytesOf(matrixBDesc.dt);
+    if (matrixStrideA == 0) {
+        matrixStrideA = matrixADesc.dims[1] * matrixADesc.dims[0];
+    }
+    if (matrixStrideB == 0) {
+        matrixStrideB = matrixBDesc.dims[1] * matrixBDesc.dims[0];
+    }
+    U32 matrixA2DBytes = matrixStrideA * bytesOf(matrixADesc.dt);
+    U32 matrixB2DBytes = matrixStrideB * bytesOf(matrixBDesc.dt);
     U32 matrixC2DBytes = (matrixCDesc.dims[1] * matrixCDesc.dims[0]) * bytesOf(matrixCDesc.dt);
     if (biasTensor.bytes() > 0) {
         U8 *bias = (U8 *)get_ptr_from_tensor(biasTensor, arch);
@@ -418,6 +494,19 @@ EE matmul(Tensor matrixATensor,
     } else {
         memset(matrixC, 0, tensorNumBytes(matrixCDesc));
     }
+    U32 batch, strideA, strideB, strideC;
+    if (!useINT8 &&
+        matmul_batch_strides(matrixADesc, transposeA, matrixStrideA, matrixBDesc, transposeB,
+            matrixStrideB, matrixCDesc, &batch, &strideA, &strideB, &strideC)) {
+        TensorDesc matrixA2DDesc = tensor2df(matrixADesc.dt,
+            transposeA ? DF_TRANSPOSE : DF_NORMAL, matrixADesc.dims[1], matrixADesc.dims[0]);
+        TensorDesc matrixB2DDesc = tensor2df(matrixBDesc.dt,
+            transposeB ? DF_TRANSPOSE : DF_NORMAL, matrixBDesc.dims[1], matrixBDesc.dims[0]);
+        TensorDesc matrixC2DDesc =
+            tensor2df(matrixCDesc.dt, DF_NORMAL, matrixCDesc.dims[1], matrixCDesc.dims[0]);
+        return matrix_matrix_multiply_batch(batch, matrixA2DDesc, matrixA, strideA, matrixB2DDesc,
+            matrixB, strideB, tmpBytes, tmp, matrixC2DDesc, matrixC, strideC, archInfo->arch);
+    }
     std::vector<U32> ADims, BDims, CDims;
     U32 loopsA = tensorNumElements(matrixADesc) / (matrixADesc.dims[1] * matrixADesc.dims[0]);
     U32 loopsB = tensorNumElements(matrixBDesc) / (matrixBDesc.dims[1] * matrixBDesc.dims[0]);
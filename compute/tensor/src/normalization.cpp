@@ -58,7 +58,7 @@ EE layer_normalization(Tensor inputTensor,
 #endif
 #ifdef _USE_X86
     } else if (IS_X86(arch)) {
-        ret = layer_normalization_x86(inputDesc, input, alpha, beta, outputDesc, output);
+        ret = layer_normalization_x86(inputDesc, input, alpha, beta, outputDesc, output, arch);
 #endif
 #ifdef _USE_NEON
     } else if (IS_ARM(arch)) {
@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_GENERAL
 #include "cpu/general/tensor_computing_general.h"
 #endif
@@ -138,6 +139,7 @@ EE pooling(Tensor inputTensor,
     Tensor outputTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc inputDesc = transformDescTo4d(inputTensor.get_desc());
     void *input = get_ptr_from_tensor(inputTensor, arch);
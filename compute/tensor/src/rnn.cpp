@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_X86
 #include "cpu/x86/tensor_computing_x86.h"
 #endif
@@ -190,6 +191,7 @@ EE rnn(std::vector<Tensor> inputTensors,
     std::vector<Tensor> outputTensors,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     std::vector<TensorDesc> inputDescs = get_desc_from_tensors(inputTensors);
     std::vector<void *> inputs = get_data_from_tensors<void *>(inputTensors, arch);
@@ -389,6 +391,7 @@ EE rnncell(Tensor xTensor,
     Tensor hTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     TensorDesc xDesc = xTensor.get_desc();
     void *currentX = get_ptr_from_tensor(xTensor, arch);
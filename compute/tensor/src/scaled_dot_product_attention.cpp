@@ -0,0 +1,106 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "tensor_computing.h"
+#ifdef _USE_CPU
+#include "cpu/tensor_computing_cpu.h"
+#endif
+
+EE scaled_dot_product_attention_infer_output_size(Tensor *queryTensor,
+    Tensor *keyTensor,
+    Tensor *valueTensor,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor *outputTensor,
+    ArchInfo_t archInfo)
+{
+    if (queryTensor == nullptr || keyTensor == nullptr || valueTensor == nullptr ||
+        outputTensor == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    TensorDesc queryDesc = queryTensor->get_desc();
+    TensorDesc keyDesc = keyTensor->get_desc();
+    TensorDesc valueDesc = valueTensor->get_desc();
+    TensorDesc outputDesc = outputTensor->get_desc();
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(archInfo->arch)) {
+#ifdef _USE_CPU
+        ret = scaled_dot_product_attention_infer_output_size_cpu(
+            queryDesc, keyDesc, valueDesc, p, &outputDesc);
+#endif
+    }
+    outputTensor->resize(outputDesc);
+    return ret;
+}
+
+EE scaled_dot_product_attention_infer_forward_tmp_bytes(Tensor queryTensor,
+    Tensor keyTensor,
+    Tensor valueTensor,
+    Tensor maskTensor,
+    ScaledDotProductAttentionParamSpec p,
+    U32 *bytes,
+    ArchInfo_t archInfo)
+{
+    if (bytes == nullptr) {
+        CHECK_STATUS(NULL_POINTER);
+    }
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(archInfo->arch)) {
+#ifdef _USE_CPU
+        ret = scaled_dot_product_attention_infer_forward_tmp_bytes_cpu(queryTensor.get_desc(),
+            keyTensor.get_desc(), valueTensor.get_desc(), maskTensor.get_desc(), p, bytes,
+            archInfo->arch);
+#endif
+    }
+    return ret;
+}
+
+EE scaled_dot_product_attention(Tensor queryTensor,
+    Tensor keyTensor,
+    U32 keyStride,
+    Tensor valueTensor,
+    U32 valueStride,
+    Tensor maskTensor,
+    ScaledDotProductAttentionParamSpec p,
+    Tensor tmpTensor,
+    Tensor outputTensor,
+    ArchInfo_t archInfo)
+{
+    auto arch = archInfo->arch;
+    TensorDesc queryDesc = queryTensor.get_desc();
+    void *query = get_ptr_from_tensor(queryTensor, arch);
+    TensorDesc keyDesc = keyTensor.get_desc();
+    void *key = get_ptr_from_tensor(keyTensor, arch);
+    TensorDesc valueDesc = valueTensor.get_desc();
+    void *value = get_ptr_from_tensor(valueTensor, arch);
+    TensorDesc maskDesc;
+    void *mask = nullptr;
+    if (p.mask_mode != SDPA_MASK_NONE) {
+        maskDesc = maskTensor.get_desc();
+        mask = get_ptr_from_tensor(maskTensor, arch);
+    }
+    U32 tmpBytes = tmpTensor.bytes();
+    void *tmp = get_ptr_from_tensor(tmpTensor, arch);
+    TensorDesc outputDesc = outputTensor.get_desc();
+    void *output = get_ptr_from_tensor(outputTensor, arch);
+
+    EE ret = NOT_SUPPORTED;
+    if (IS_CPU(arch)) {
+#ifdef _USE_CPU
+        ret = scaled_dot_product_attention_cpu(queryDesc, query, keyDesc, key, keyStride,
+            valueDesc, value, valueStride, maskDesc, mask, p, tmpBytes, tmp, outputDesc, output,
+            arch);
+#endif
+    }
+    return ret;
+}
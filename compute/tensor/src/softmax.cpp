@@ -40,7 +40,7 @@ EE softmax(
 #endif
 #ifdef _USE_X86
     } else if (IS_X86(arch)) {
-        ret = softmax_x86(inputDesc, input, p, outputDesc, output);
+        ret = softmax_x86(inputDesc, input, p, outputDesc, output, arch);
 #endif
 #ifdef _USE_NEON
     } else if (IS_ARM(arch)) {
@@ -12,6 +12,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "tensor_computing.h"
+#include "thread_affinity.h"
 #ifdef _USE_CPU
 #include "cpu/tensor_computing_cpu.h"
 #endif
@@ -26,6 +27,7 @@ EE topk(Tensor inputTensor,
     Tensor outputIndicesTensor,
     ArchInfo_t archInfo)
 {
+    ThreadContextGuard threadContext(archInfo);
     auto arch = archInfo->arch;
     EE ret = NOT_SUPPORTED;
     TensorDesc inputDesc = inputTensor.get_desc();
@@ -41,8 +43,8 @@ EE topk(Tensor inputTensor,
             (GCLMem_t)tmp, outputDesc, (GCLMem_t)output, outputIndicesDesc, (GCLMem_t)outputIndices);
 #endif
     } else {
-        ret = topk_cpu(
-            inputDesc, input, p, tmp, outputDesc, output, outputIndicesDesc, outputIndices);
+        ret = topk_cpu(inputDesc, input, p, tmpTensor.bytes(), tmp, outputDesc, output,
+            outputIndicesDesc, outputIndices);
     }
     return ret;
 }
@@ -58,9 +60,7 @@ EE topk_infer_forward_tmp_bytes(
         ret = topk_infer_forward_tmp_bytes_mali(inputDesc, p, outputDesc, bytes);
 #endif
     } else {
-        int axis = inputDesc.nDims - 1 - (p.axis + inputDesc.nDims) % inputDesc.nDims;
-        *bytes = inputDesc.dims[axis] * sizeof(int);
-        ret = SUCCESS;
+        ret = topk_infer_forward_tmp_bytes_cpu(inputDesc, p, bytes);
     }
     return ret;
 }
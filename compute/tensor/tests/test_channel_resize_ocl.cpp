@@ -70,6 +70,7 @@ int channelresizeTest(int argc, char *argv[], DataType dt)
     maliPara.handle = handle;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     archInfo.archPara = &maliPara;
 
     CHECK_STATUS(channel_resize_infer_output_size(&inputTensor, p, &outputTensor, &archInfo));
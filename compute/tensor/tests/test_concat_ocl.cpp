@@ -46,6 +46,7 @@ int concatTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     std::vector<Tensor *> inputTensorCpuPtr;
     std::vector<Tensor *> inputTensorPtr;
@@ -19,6 +19,7 @@ int convolutionTest(int argc, char *argv[], DataType dt)
     U32 biasNum;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
     }
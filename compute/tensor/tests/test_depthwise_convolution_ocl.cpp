@@ -23,6 +23,7 @@ int depthwiseConvolutionTest(int argc, char *argv[], DataFormat filterDataFormat
     U32 biasNum;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
@@ -24,6 +24,7 @@ int depthwisePointwiseConvolutionTest(
     U32 biasNum;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
@@ -21,6 +21,7 @@ int eltwiseTest(int argc, char *argv[], DataType dt)
     U32 bn, bc, bh, bw;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     num = 2;
     in = 1;
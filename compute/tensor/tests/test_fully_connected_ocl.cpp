@@ -22,6 +22,7 @@ int fullyConnectedTest(int argc, char *argv[], DataType dt)
     U32 biasNum;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
     }
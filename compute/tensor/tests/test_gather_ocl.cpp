@@ -52,6 +52,7 @@ int gatherTest(int argc, char **argv, DataType dt)
     I32 axis = atoi(argv[11]);
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     GatherParamSpec p;
     p.axis = axis;
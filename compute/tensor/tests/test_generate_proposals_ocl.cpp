@@ -260,6 +260,7 @@ void generateProposals(I32 argc, char *argv[], DataType dt)
     /***************************GPU**************************/
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;  //off qualcomm
     }
@@ -22,6 +22,7 @@ int matmulTest(int argc, char *argv[], DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
     }
@@ -287,6 +287,7 @@ int matmulF32Test(int argc, char *argv[], DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     ac = 4;
     ah = 4;
@@ -32,6 +32,7 @@ int paddingTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     PadParamSpec padParamSpec;
 
@@ -40,6 +40,7 @@ int powerTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     U32 len = in * ic * ih * iw;
 
@@ -27,6 +27,7 @@ int preluTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     TensorDesc inputDescGPU, outputDescGPU, weightDescGPU;
     inputDescGPU = tensor4df(dt, DF_NCHWC4, in, ic, ih, iw);
@@ -34,6 +34,7 @@ int reductionTest(int argc, char **argv, DataType dt)
     maskDesc.nDims = 0;
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     DataFormat df = DF_NCHW;
     TensorDesc inputDesc = tensor4df(dt, df, in, ic, ih, iw);
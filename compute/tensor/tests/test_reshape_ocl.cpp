@@ -31,6 +31,7 @@ int reshapeTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     U32 len = tensorNumElements(inputDesc);
     U8 *input_cpu = ut_input_v(len, dt, UT_INIT_RANDOM);
@@ -25,6 +25,7 @@ int rnnTest(int argc, char **argv, DataType dt, RNNMode mode)
     biDir = atoi(argv[6]);
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
     if (gcl_check_device_qualcomm(OCLContext::getInstance().handle.get())) {
         archInfo.arch = QUALCOMM;
     }
@@ -26,6 +26,7 @@ int rnncellTest(int argc, char **argv, DataType dt, RNNMode mode)
     }
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     RNNParamSpec rnnParamSpec;
     rnnParamSpec.mode = RNN_LSTM;
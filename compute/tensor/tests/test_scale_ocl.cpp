@@ -34,6 +34,7 @@ int scaleTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     ScaleParamSpec p;
     p.axis = axis;
@@ -0,0 +1,142 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "tensor_computing.h"
+#include "ut_util.h"
+
+int scaledDotProductAttentionTestKernel(U32 n,
+    U32 h,
+    U32 sq,
+    U32 sk,
+    U32 dim,
+    U32 vdim,
+    bool transposeKey,
+    SDPAMaskMode maskMode,
+    DataType dt)
+{
+    ScaledDotProductAttentionParamSpec p;
+    p.transpose_key = transposeKey;
+    p.scale = 1.0 / sqrt(dim);
+    p.mask_scale = 1;
+    p.mask_mode = maskMode;
+
+    TensorDesc queryDesc = tensor4df(dt, DF_NCHW, n, h, sq, dim);
+    TensorDesc keyDesc = transposeKey ? tensor4df(dt, DF_NCHW, n, h, sk, dim)
+                                      : tensor4df(dt, DF_NCHW, n, h, dim, sk);
+    TensorDesc valueDesc = tensor4df(dt, DF_NCHW, n, h, sk, vdim);
+    TensorDesc maskDesc = tensor4df(dt, DF_NCHW, n, 1, sq, sk);
+    if (maskMode == SDPA_MASK_ATTENTION) {
+        maskDesc = tensor2df(dt, DF_NORMAL, n, sk);
+    }
+    TensorDesc descs[4] = {queryDesc, keyDesc, valueDesc, maskDesc};
+    Tensor tensors[4];
+    for (U32 i = 0; i < 4; i++) {
+        U8 *data = ut_input_v(tensorNumElements(descs[i]), dt, UT_INIT_RANDOM);
+        tensors[i] = Tensor::alloc_sized<CPUMem>(descs[i]);
+        memcpy(get_ptr_from_tensor(tensors[i], CPU_GENERAL), data, tensorNumBytes(descs[i]));
+        free(data);
+    }
+    if (maskMode == SDPA_MASK_ATTENTION) {
+        // 0/1 mask of padded sequences, the i-th batch has i padded positions
+        for (U32 i = 0; i < n; i++) {
+            for (U32 j = 0; j < sk; j++) {
+                F32 value = (j + i < sk) ? 1 : 0;
+                transformFromFloat(dt, &value,
+                    (U8 *)get_ptr_from_tensor(tensors[3], CPU_GENERAL) + (i * sk + j) * bytesOf(dt),
+                    1);
+            }
+        }
+    }
+
+    Tensor outputTensor;
+    CHECK_STATUS(scaled_dot_product_attention_infer_output_size(
+        &tensors[0], &tensors[1], &tensors[2], p, &outputTensor, &UT_CPU_ARCHINFO));
+    outputTensor.alloc();
+    Tensor outputTensorRef = Tensor::alloc_sized<CPUMem>(outputTensor.get_desc());
+
+    U32 tmpBytes = 0;
+    CHECK_STATUS(scaled_dot_product_attention_infer_forward_tmp_bytes(
+        tensors[0], tensors[1], tensors[2], tensors[3], p, &tmpBytes, &UT_CPU_ARCHINFO));
+    Tensor tmpTensor = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, tmpBytes));
+    U32 tmpBytesRef = 0;
+    CHECK_STATUS(scaled_dot_product_attention_infer_forward_tmp_bytes(
+        tensors[0], tensors[1], tensors[2], tensors[3], p, &tmpBytesRef, &UT_SERIAL_ARCHINFO));
+    Tensor tmpTensorRef = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, tmpBytesRef));
+
+    if (UT_CHECK) {
+        CHECK_STATUS(scaled_dot_product_attention(tensors[0], tensors[1], 0, tensors[2], 0,
+            tensors[3], p, tmpTensor, outputTensor, &UT_CPU_ARCHINFO));
+
+        // naive implement
+        CHECK_STATUS(scaled_dot_product_attention(tensors[0], tensors[1], 0, tensors[2], 0,
+            tensors[3], p, tmpTensorRef, outputTensorRef, &UT_SERIAL_ARCHINFO));
+
+        // check
+        ut_check_v(get_ptr_from_tensor(outputTensor, CPU_GENERAL),
+            get_ptr_from_tensor(outputTensorRef, CPU_GENERAL), outputTensor.length(), dt, 0.1,
+            __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(scaled_dot_product_attention(tensors[0], tensors[1], 0, tensors[2], 0,
+            tensors[3], p, tmpTensor, outputTensor, &UT_CPU_ARCHINFO));
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    const char *maskNames[3] = {"", " mask add", " mask attention"};
+    char buffer[150];
+    char params[120];
+    sprintf(params, "(%u %u %u %u %u %u)=(%u %u %u %u)%s%s", n, h, sq, sk, dim, vdim, n, h, sq,
+        vdim, transposeKey ? "" : " key KN", maskNames[maskMode]);
+    sprintf(buffer, "%20s, %80s", "ScaledDotProductAttention", params);
+    double ops = 2.0 * n * h * sq * sk * (dim + vdim) + 4.0 * n * h * sq * sk;
+    ut_log(dt, buffer, ops, time);
+
+    return 0;
+}
+
+int scaledDotProductAttentionTest(int argc, char **argv, DataType dt)
+{
+    CHECK_REQUIREMENT(argc == 7);
+    U32 n = atoi(argv[1]);
+    U32 h = atoi(argv[2]);
+    U32 sq = atoi(argv[3]);
+    U32 sk = atoi(argv[4]);
+    U32 dim = atoi(argv[5]);
+    U32 vdim = atoi(argv[6]);
+    SDPAMaskMode maskModes[3] = {SDPA_MASK_NONE, SDPA_MASK_ADD, SDPA_MASK_ATTENTION};
+    int ret = 0;
+    for (U32 i = 0; i < 2 && ret == 0; i++) {
+        for (U32 j = 0; j < 3 && ret == 0; j++) {
+            ret = scaledDotProductAttentionTestKernel(
+                n, h, sq, sk, dim, vdim, i == 0, maskModes[j], dt);
+        }
+    }
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+#ifdef _USE_FP16
+    scaledDotProductAttentionTest(argc, argv, DT_F16);
+#endif
+#ifdef _USE_FP32
+    scaledDotProductAttentionTest(argc, argv, DT_F32);
+#endif
+    return 0;
+}
@@ -33,6 +33,7 @@ int sliceTest(int argc, char **argv, DataType dt)
     }
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     DataFormat df = DF_NCHW;
     TensorDesc inDesc = tensor4df(dt, df, in, ic, ih, iw);
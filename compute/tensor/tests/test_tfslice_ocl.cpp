@@ -40,6 +40,7 @@ int tfsliceTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     DataFormat df = DF_NCHW;
     TensorDesc inputDesc = tensor4df(dt, df, in, ic, ih, iw);
@@ -0,0 +1,144 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <algorithm>
+#include "tensor_computing.h"
+#include "ut_util.h"
+
+// sort every row of the axis, ties keep the lower index
+template <typename T>
+static void topk_naive(TensorDesc desc, T *input, TopKParamSpec p, T *output, I32 *index)
+{
+    int axis = desc.nDims - 1 - (p.axis + desc.nDims) % desc.nDims;
+    int loopInner = 1, loops = desc.dims[axis], loopOuter = 1;
+    for (int i = 0; i < axis; i++) {
+        loopInner *= desc.dims[i];
+    }
+    for (U32 i = axis + 1; i < desc.nDims; i++) {
+        loopOuter *= desc.dims[i];
+    }
+    int num = UNI_MIN(loops, p.topk);
+    std::vector<int> id(loops);
+    for (int i = 0; i < loopOuter; i++) {
+        for (int j = 0; j < loopInner; j++) {
+            T *in = input + i * loops * loopInner + j;
+            for (int k = 0; k < loops; k++) {
+                id[k] = k;
+            }
+            std::stable_sort(id.begin(), id.end(), [&](int a, int b) {
+                return p.largest ? in[a * loopInner] > in[b * loopInner]
+                                 : in[a * loopInner] < in[b * loopInner];
+            });
+            if (!p.sorted) {
+                std::sort(id.begin(), id.begin() + num);
+            }
+            for (int k = 0; k < num; k++) {
+                int o = (i * p.topk + k) * loopInner + j;
+                output[o] = in[id[k] * loopInner];
+                index[o] = id[k];
+            }
+        }
+    }
+}
+
+int topkTest(int argc, char **argv, DataType dt)
+{
+    CHECK_REQUIREMENT(argc == 9);
+    TopKParamSpec p;
+    U32 in = atoi(argv[1]);
+    U32 ic = atoi(argv[2]);
+    U32 ih = atoi(argv[3]);
+    U32 iw = atoi(argv[4]);
+    p.axis = atoi(argv[5]);
+    p.topk = atoi(argv[6]);
+    p.largest = atoi(argv[7]);
+    p.sorted = atoi(argv[8]);
+
+    DataFormat df = DF_NCHW;
+    TensorDesc inDesc = tensor4df(dt, df, in, ic, ih, iw);
+    U8 *input = ut_input_v(tensorNumElements(inDesc), dt, UT_INIT_RANDOM);
+    Tensor inputTensor;
+    inputTensor.resize(inDesc);
+    inputTensor.alloc();
+    memcpy(get_ptr_from_tensor(inputTensor, CPU_GENERAL), input, tensorNumBytes(inDesc));
+
+    Tensor outputTensor, indexTensor;
+    CHECK_STATUS(
+        topk_infer_output_size(&inputTensor, p, &outputTensor, &indexTensor, &UT_CPU_ARCHINFO));
+    outputTensor.alloc();
+    indexTensor.alloc();
+    U32 outputLength = outputTensor.length();
+    U8 *outputRef = ut_input_v(outputLength, dt, UT_INIT_ZERO);
+    U8 *indexRef = ut_input_v(outputLength, DT_I32, UT_INIT_ZERO);
+
+    U32 tmpBytes = 0;
+    CHECK_STATUS(topk_infer_forward_tmp_bytes(
+        inputTensor, p, outputTensor, &tmpBytes, &UT_CPU_ARCHINFO));
+    Tensor tmpTensor;
+    tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+    tmpTensor.alloc();
+
+    if (UT_CHECK) {
+        CHECK_STATUS(topk(inputTensor, p, tmpTensor, outputTensor, indexTensor, &UT_CPU_ARCHINFO));
+
+        // naive implement
+        if (dt == DT_F32) {
+            topk_naive<F32>(inDesc, (F32 *)input, p, (F32 *)outputRef, (I32 *)indexRef);
+        }
+#ifdef _USE_FP16
+        if (dt == DT_F16) {
+            topk_naive<F16>(inDesc, (F16 *)input, p, (F16 *)outputRef, (I32 *)indexRef);
+        }
+#endif
+
+        // check
+        ut_check_v(get_ptr_from_tensor(outputTensor, CPU_GENERAL), outputRef, outputLength, dt,
+            0, __FILE__, __LINE__);
+        ut_check_v(get_ptr_from_tensor(indexTensor, CPU_GENERAL), indexRef, outputLength, DT_I32,
+            0, __FILE__, __LINE__);
+    }
+
+    // benchmark
+    double time_start = ut_time_ms();
+    for (int iter = 0; iter < UT_LOOPS; iter++) {
+        CHECK_STATUS(topk(inputTensor, p, tmpTensor, outputTensor, indexTensor, &UT_CPU_ARCHINFO));
+    }
+    double time_end = ut_time_ms();
+    double time = (time_end - time_start) / UT_LOOPS;
+
+    // log performance data
+    char buffer[150];
+    char params[120];
+    sprintf(params, "(%u %u %u %u) axis=%d k=%d largest=%d sorted=%d", in, ic, ih, iw, p.axis,
+        p.topk, p.largest, p.sorted);
+    sprintf(buffer, "%20s, %80s", "TopK", params);
+    double ops = 1.0 * in * ic * ih * iw;
+    ut_log(dt, buffer, ops, time);
+
+    free(input);
+    free(outputRef);
+    free(indexRef);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+#ifdef _USE_FP16
+    topkTest(argc, argv, DT_F16);
+#endif
+#ifdef _USE_FP32
+    topkTest(argc, argv, DT_F32);
+#endif
+    return 0;
+}
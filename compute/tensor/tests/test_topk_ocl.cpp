@@ -90,6 +90,7 @@ int topkTest(int argc, char **argv, DataType dt)
 
     ArchInfo archInfo;
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     U32 len = in * ic * ih * iw;
 
@@ -44,6 +44,7 @@ int transposeTest(int argc, char **argv, DataType dt)
     ArchInfo archInfo;
 
     archInfo.arch = MALI;
+    archInfo.numThreads = 0;
 
     TensorDesc outputDesc;
     U32 len = tensorNumElements(inputDesc_cpu);
@@ -31,6 +31,9 @@ typedef void *ModelHandle;
 /** result data memory handle */
 typedef void *ResultHandle;
 
+/** asynchronous inference handle */
+typedef void *RunHandle;
+
 /** CPU affinity policy */
 typedef enum {
     CPU_HIGH_PERFORMANCE = 0,  ///< performance is high priority(use big core)
@@ -395,10 +398,178 @@ void SetRuntimeDeviceDynamic(ModelHandle ih);
  *
  * @note
  * This can only be used before RunModel. If you use it before PrepareModel, this will affect tmp buffer allocation. Then you are limited that next setting can not greater than before one.
- * This setting is global to each inference threads.
+ * This setting is global to each inference threads. Use SetModelNumThreads to give a model its own threads num.
  * @return
  */
 void SetNumThreads(int threads);
+
+/**
+ * @brief set parallel threads num of one model
+ * @param  ih            inference pipeline handle
+ * @param  threads       number of threads, 0 means to use the global setting of SetNumThreads
+ *
+ * @note
+ * The setting is bound to the calling thread only while PrepareModel/ResizeModelInput/RunModel of this model is running, so models running on different threads can use their own non-overlapping threads budget.
+ * It should be set before PrepareModel, because tmp buffer allocation may depend on it.
+ * @return
+ */
+void SetModelNumThreads(ModelHandle ih, int threads);
+
+/**
+ * @brief run independent operators(branches) of model concurrently
+ * @param  ih            inference pipeline handle
+ * @param  enable        1 to enable, 0 to run operators one by one(default)
+ *
+ * @note
+ * This only works on CPU. The threads set by SetNumThreads are shared by concurrent operators according to their size, and each concurrent worker uses its own tmp buffer.
+ * @return
+ */
+void SetParallelOperators(ModelHandle ih, int enable);
+
+/**
+ * @brief keep past states(e.g. attention key/value) of an autoregressive decoder inside model
+ * @param  ih            inference pipeline handle
+ * @param  capacity      number of steps(tokens) that the cache is preallocated for
+ *
+ * @note
+ * A model input that is concatenated with the current step and then exported as a model output is kept in a buffer preallocated for capacity steps. RunModel only appends the current step to it, and the data of these inputs given to RunModel is ignored.
+ * The cache grows when a sequence exceeds capacity, which reallocates the tensors once.
+ * When every operator reading a kept state supports it, the rows of the state, its dimensions outside the concatenation axis, are placed capacity steps apart instead of packed, so that a step moves no history. The output of such a state is in this layout too.
+ * This only works on CPU, and should be called after PrepareModel. The cache is empty after this call. CloneModel copies the cache, which can be used to fork a sequence.
+ * @return
+ */
+void SetKVCache(ModelHandle ih, int capacity);
+
+/**
+ * @brief drop all steps kept in the cache set by SetKVCache
+ * @param  ih            inference pipeline handle
+ *
+ * @return
+ */
+void ResetKVCache(ModelHandle ih);
+
+/**
+ * @brief keep only the first length steps in the cache set by SetKVCache
+ * @param  ih            inference pipeline handle
+ * @param  length        number of steps to keep
+ *
+ * @return
+ */
+void TruncateKVCache(ModelHandle ih, int length);
+
+/**
+ * @brief get the number of steps kept in the cache set by SetKVCache
+ * @param  ih            inference pipeline handle
+ *
+ * @return number of steps
+ */
+int GetKVCacheLength(ModelHandle ih);
+
+/**
+ * @brief keep the hidden/cell states of RNN/LSTM/GRU operators inside model between RunModel calls
+ * @param  ih            inference pipeline handle
+ * @param  enable        1 to continue each RunModel from the states left by the previous one, 0 to start from zero states or the h/c inputs of model(default)
+ *
+ * @note
+ * A long stream can be fed chunk by chunk, and each RunModel only computes the new frames. The h/c inputs of RNN operators are ignored in this mode. Bi-direction RNN can not be continued and keeps running chunk by chunk independently.
+ * This only works on CPU, and should be called after PrepareModel. The states are zero after this call. CloneModel copies the states, so that each stream can use its own clone.
+ * The batch of a stream must not change, a RunModel with another batch restarts from zero states with a warning.
+ * @return
+ */
+void SetStreaming(ModelHandle ih, int enable);
+
+/**
+ * @brief set the states kept by SetStreaming to zero, used when a new stream begins
+ * @param  ih            inference pipeline handle
+ *
+ * @return
+ */
+void ResetStreamingState(ModelHandle ih);
+
+/**
+ * @brief get the bytes of the states kept by SetStreaming
+ * @param  ih            inference pipeline handle
+ *
+ * @return bytes of the buffer used by SaveStreamingState and LoadStreamingState
+ */
+int GetStreamingStateSize(ModelHandle ih);
+
+/**
+ * @brief copy the states kept by SetStreaming to state
+ * @param  ih            inference pipeline handle
+ * @param  state         buffer of GetStreamingStateSize bytes
+ *
+ * @note
+ * Together with LoadStreamingState, this lets several streams share one model by switching their states between RunModel calls.
+ * @return
+ */
+void SaveStreamingState(ModelHandle ih, void *state);
+
+/**
+ * @brief restore the states kept by SetStreaming from a buffer filled by SaveStreamingState
+ * @param  ih            inference pipeline handle
+ * @param  state         buffer of GetStreamingStateSize bytes
+ *
+ * @return
+ */
+void LoadStreamingState(ModelHandle ih, const void *state);
+
+/**
+ * @brief bind caller buffers to model inputs and outputs
+ * @param  ih            inference pipeline handle
+ * @param  num_inputs    the number of input buffers
+ * @param  input_names   the array of bound input data's name
+ * @param  input_data    the array of input buffers
+ * @param  num_outputs   the number of output buffers
+ * @param  output_names  the array of bound output data's name
+ * @param  output_data   the array of output buffers
+ *
+ * @note
+ * The operators read bound inputs and write bound outputs in place, so RunModel with num_inputs 0 needs no input copy,
+ * and the output data pointers of ResultHandle point to the caller buffers instead of memory reused by the next RunModel.
+ * Each buffer must hold the bytes of its data reported by GetInputDataInfoFromModel or GetOutputDataInfoFromResultHandle, and stay valid until the binding is replaced.
+ * A binding is dropped when a later resize needs more bytes than its data had at binding time.
+ * Calling it again replaces all bindings, num_inputs and num_outputs 0 remove them. Only supported on CPU.
+ * @code
+ *     BindModelInputOutput(handle, 1, inputNames, inputData, 1, outputNames, outputData);
+ *     // write inputData[0]
+ *     RunModel(handle, result, 0, NULL, NULL);
+ *     // read outputData[0]
+ * @endcode
+ * @return
+ */
+void BindModelInputOutput(ModelHandle ih,
+    int num_inputs,
+    const char **input_names,
+    void **input_data,
+    int num_outputs,
+    const char **output_names,
+    void **output_data);
+
+/**
+ * @brief queue RunModel on the background thread of the model
+ * @param  ih            inference pipeline handle
+ * @param  ir            result data memory handle
+ * @param  num_inputs    the number of input data
+ * @param  name          the array of all input data's name
+ * @param  data          the array of all input data
+ *
+ * @return asynchronous inference handle, must be passed to WaitRunModel
+ * @note
+ * Input names are copied, input data must stay valid until WaitRunModel.
+ * Runs on one model handle are executed one by one in the order they are started, use CloneModel for concurrent inference.
+ * The result handle and the other APIs of the model must not be used before WaitRunModel of the run returns.
+ */
+RunHandle RunModelAsync(
+    ModelHandle ih, ResultHandle ir, int num_inputs, const char **name, void **data);
+
+/**
+ * @brief wait for an inference started by RunModelAsync, and free its handle
+ * @param  rh            asynchronous inference handle
+ *
+ * @return
+ */
+void WaitRunModel(RunHandle rh);
 #ifdef __cplusplus
 }
 #endif
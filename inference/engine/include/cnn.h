@@ -17,6 +17,11 @@
 #include <string>
 #include "model.hpp"
 #include "memory_tracker.hpp"
+#include "operator_scheduler.hpp"
+#include "kv_cache.hpp"
+#include "weight_cache.hpp"
+#include "weight_prefetcher.hpp"
+#include "operator_profiler.hpp"
 #include "model_spec.h"
 #ifdef _USE_GPU
 #include "image_container.hpp"
@@ -25,11 +30,17 @@
 class CNN : public Model {
 public:
     CNN()
-    {}
+    {
+        this->parallelOperators = false;
+        this->formatAssignment = true;
+    }
 
     explicit CNN(AffinityPolicy affinityPolicy, DataType dt, std::string name)
         : Model(affinityPolicy, dt, name)
-    {}
+    {
+        this->parallelOperators = false;
+        this->formatAssignment = true;
+    }
 
     virtual ~CNN() = default;
 
@@ -51,8 +62,59 @@ public:
 
     void set_input_by_copy(std::map<std::string, U8 *> modelTensorsInput);
 
+    // read inputs from and write outputs to caller buffers, the binding is kept when tensors
+    // are reassigned after input resize, only supported on CPU
+    void bind_input_output(std::map<std::string, std::shared_ptr<U8>> modelTensorsInput,
+        std::map<std::string, std::shared_ptr<U8>> modelTensorsOutput);
+
     void run() override;
 
+    // run independent operators concurrently, only supported on CPU
+    void set_parallel_operators(bool parallel);
+
+    // keep past states of an autoregressive decoder in preallocated buffers of capacity steps,
+    // only supported on CPU
+    void set_kv_cache(U32 capacity);
+
+    void reset_kv_cache();
+
+    void truncate_kv_cache(U32 length);
+
+    U32 get_kv_cache_length();
+
+    // RNN operators keep their final state and start the next run from it instead of zero or their
+    // h/c inputs, so that a sequence can be fed chunk by chunk, only supported on CPU
+    void set_streaming(bool streaming);
+
+    void reset_streaming_state();
+
+    // bytes of the states of all streaming RNN operators, in operator order
+    U32 get_streaming_state_bytes();
+
+    void save_streaming_state(U8 *state);
+
+    void load_streaming_state(const U8 *state);
+
+    // data formats of tensors are assigned to cut the transforms inside operators, on by default,
+    // a change takes effect at the next ready or reready
+    void set_format_assignment(bool enable);
+
+    // keep weights transformed by ready() in a file under directory and map it on later loads,
+    // only supported on CPU
+    void set_weight_cache(std::string directory, const ModelSpec *ms);
+
+    // time every operator run with its FLOPs and bytes, can be switched between runs
+    void set_profiling(bool enable);
+
+    // peak GFLOP/s and GB/s of the machine, used to show roofline efficiency of operators
+    void set_profiling_roofline(double peakGFlops, double peakGBs);
+
+    // write the profiled runs as Chrome trace JSON
+    EE save_profiling_trace(std::string path);
+
+    // print time, GFLOP/s and GB/s of each operator type
+    void print_profiling_statistics();
+
     std::map<std::string, TensorDesc> get_output_desc();
 
     std::map<std::string, std::shared_ptr<Tensor>> get_output();
@@ -80,6 +142,23 @@ private:
 
     void infer_layout_desc();
 
+    void assign_data_formats();
+
+    void remove_format_transforms();
+
+    bool push_output_formats();
+
+    bool insert_format_transforms();
+
+    bool get_format_users(std::map<std::string, std::set<U32>> *writers,
+        std::map<std::string, std::vector<std::pair<U32, U32>>> *readers);
+
+    bool is_format_candidate(std::string name,
+        std::map<std::string, std::set<U32>> &writers,
+        std::map<std::string, std::vector<std::pair<U32, U32>>> &readers);
+
+    std::vector<Tensor *> get_op_tensors(U32 opIndex, U32 kind);
+
     void update_op_tensors();
 
     void set_input_desc(std::map<std::string, TensorDesc> inputDescMap);
@@ -90,6 +169,8 @@ private:
 
     Tensor *get_reuse_memory(U32 slot, Tensor *tensor);
 
+    Tensor get_arena_memory(std::string tensorName);
+
     void check_memory_reuse_ratio();
 
     EE infer_output_tensors_size(std::map<std::string, TensorDesc> inputDescMap) override;
@@ -98,6 +179,28 @@ private:
 
     void clean_tensorMap_desc();
 
+    void apply_bound_buffers();
+
+    U32 run_parallel_operators(U32 start);
+
+    void update_kv_cache();
+
+    void extend_kv_cache();
+
+    void update_kv_cache_shapes();
+
+    void plan_kv_cache_memory();
+
+    void grow_kv_cache(U32 length);
+
+    void find_kv_cache_ops();
+
+    void set_kv_cache_row_strides();
+
+    void build_weight_prefetcher();
+
+    void transform_filter();
+
 private:
     std::map<std::string, std::shared_ptr<Tensor>> tensorMap;
     std::map<std::string, std::shared_ptr<Operator>> operatorMap;
@@ -106,6 +209,10 @@ private:
     std::set<std::string> weightOpOutputNames;
     std::map<std::string, std::shared_ptr<Tensor>> inputTensors;
     std::map<std::string, std::shared_ptr<Tensor>> outputTensors;
+    // caller buffers bound by bind_input_output, their sizes, and the memory they replaced
+    std::map<std::string, std::shared_ptr<U8>> boundBuffers;
+    std::map<std::string, U32> boundBytes;
+    std::map<std::string, std::shared_ptr<U8>> ownBuffers;
     std::vector<std::shared_ptr<Tensor>> storageMemory;
     Tensor tmpTensor;
     std::map<I32, std::vector<std::shared_ptr<Tensor>>> storageImage;
@@ -113,6 +220,25 @@ private:
     std::vector<std::string> sortedOps;
 
     MemoryTracker memoryTracker;
+
+    bool parallelOperators;
+    // data format transforms (output name to input name) and producers writing another format,
+    // assigned again at every shape inference
+    bool formatAssignment;
+    std::map<std::string, std::string> formatTransforms;
+    std::vector<std::string> formatProducers;
+    std::string formatPlan;
+    // operator graph of each straight-line operator range, indexed by range start
+    std::map<U32, OperatorScheduler> operatorSchedulers;
+    std::vector<Tensor> workerTmpTensors;
+
+    KVCache kvCache;
+    std::vector<std::string> kvCacheOps;
+    WeightCache weightCache;
+    // mapped model file taken over from the model spec, weights used in place point into it
+    std::shared_ptr<U8> modelFile;
+    WeightPrefetcher weightPrefetcher;
+    OperatorProfiler operatorProfiler;
 #ifdef _USE_GPU
     ImageContainer tmpImages;
 #endif
@@ -21,6 +21,7 @@ public:
     Concat(ConcatParamSpec p)
     {
         this->p = p;
+        this->appendInPlace = false;
     }
 
     OperatorType get_type() override
@@ -28,8 +29,27 @@ public:
         return OT_Concat;
     }
 
+    // concatenation dimension in TensorDesc order, the output can extend the first input in
+    // place unless the data is blocked by channel
+    bool get_append_axis(TensorDesc desc, U32 *axis)
+    {
+        if (desc.nDims == 0 || desc.df == DF_NCHWC8) {
+            return false;
+        }
+        int dim = desc.nDims;
+        *axis = dim - 1 - (this->p.axis + dim) % dim;
+        return true;
+    }
+
+    // output shares memory with the first input, only the other inputs need to be written
+    void set_append_in_place(bool appendInPlace)
+    {
+        this->appendInPlace = appendInPlace;
+    }
+
 protected:
     ConcatParamSpec p;
+    bool appendInPlace;
 };
 
 #endif  // _CONCAT_H
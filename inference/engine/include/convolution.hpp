@@ -37,6 +37,42 @@ public:
         return OT_Conv;
     }
 
+    double get_flops() override
+    {
+        if (this->inputTensors.size() == 0 || this->outputTensors.size() == 0) {
+            return 0;
+        }
+        U32 ic, oc;
+        TensorDesc outputDesc = this->outputTensors[0].get_desc();
+        tensorSelectGet(this->inputTensors[0].get_desc(), NULL, NULL, NULL, &ic, NULL, NULL);
+        tensorSelectGet(outputDesc, NULL, NULL, NULL, &oc, NULL, NULL);
+        double points = 1.0 * tensorNumElements(outputDesc) / UNI_MAX(1, oc);
+        double kernel =
+            1.0 * UNI_MAX(1, this->p.kernel_t) * this->p.kernel_h * this->p.kernel_w;
+        switch (this->p.convolution_type) {
+            case Convolution_Depthwise:
+                return 2 * points * ic * kernel;
+            case Convolution_Depthwise_Pointwise:
+                return 2 * points * ic * (kernel + oc);
+            default:
+                return 2 * points * oc * ic / UNI_MAX(1, this->p.group) * kernel;
+        }
+    }
+
+    std::string get_algorithm() override
+    {
+        const char *pwNames[] = {"POINTWISE", "DIRECT", "IM2COL_GEMM", "GEMM", "GEMM_ICNCHW",
+            "WINOGRAD", "BNN", "DIRECT_SPE_CK", "GROUP_DECONV", ""};
+        const char *dwNames[] = {"DEPTHWISE_DIRECT", "DEPTHWISE_POINTWISE_DIRECT",
+            "DEPTHWISE_POINTWISE_DIRECT_NO_PADDING", "DEPTHWISE_POINTWISE_3X3S1P1",
+            "DEPTHWISE_POINTWISE_GEMM", ""};
+        if (this->p.convolution_type == Convolution_Depthwise ||
+            this->p.convolution_type == Convolution_Depthwise_Pointwise) {
+            return dwNames[this->dwAlg];
+        }
+        return pwNames[this->pwAlg];
+    }
+
 public:
     ConvolutionParamSpec p;
     ActivationParamSpec dwActivationParamSpec;
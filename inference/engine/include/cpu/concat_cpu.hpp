@@ -19,7 +19,11 @@
 class ConcatCPU : public Concat {
 public:
     ConcatCPU(ConcatParamSpec p) : Concat(p)
-    {}
+    {
+        this->outputFormatSet = false;
+        this->outputFormat = DF_NCHW;
+        this->rowStride = 0;
+    }
 
     std::shared_ptr<Operator> clone() override
     {
@@ -30,23 +34,121 @@ public:
 
     void run() override
     {
-        CHECK_STATUS(
-            concat(this->inputTensors, this->p, this->temp, outputTensors[0], &this->archInfo));
+        if (this->appendInPlace) {
+            U32 axis;
+            TensorDesc desc = this->outputTensors[0].get_desc();
+            if (!this->get_append_axis(desc, &axis)) {
+                UNI_ERROR_LOG("concat %s can not append to input in place.\n", this->name.c_str());
+            }
+            U32 outer = 1;
+            for (U32 i = axis + 1; i < desc.nDims; i++) {
+                outer *= desc.dims[i];
+            }
+            U8 *output = (U8 *)((CpuMemory *)(this->outputTensors[0].get_memory()))->get_ptr();
+            U32 outputStride = this->outputTensors[0].bytes() / outer;
+            U32 pastStride = this->inputTensors[0].bytes() / outer;
+            if (this->rowStride > 0) {
+                // rows already have room for the new steps
+                outputStride = this->rowStride * bytesOf(desc.dt);
+            } else {
+                // spread the rows of the first input from the last one, so that no row is
+                // overwritten before it is moved
+                for (I32 o = outer - 1; o > 0; o--) {
+                    memmove(output + o * outputStride, output + o * pastStride, pastStride);
+                }
+            }
+            for (U32 o = 0; o < outer; o++) {
+                U32 offset = o * outputStride + pastStride;
+                for (U32 i = 1; i < this->inputTensors.size(); i++) {
+                    U32 bytes = this->inputTensors[i].bytes() / outer;
+                    U8 *input =
+                        (U8 *)((CpuMemory *)(this->inputTensors[i].get_memory()))->get_ptr();
+                    UNI_MEMCPY(output + offset, input + o * bytes, bytes);
+                    offset += bytes;
+                }
+            }
+        } else {
+            CHECK_STATUS(
+                concat(this->inputTensors, this->p, this->temp, outputTensors[0], &this->archInfo));
+        }
     }
 
     EE infer_output_tensors_size(
         std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
     {
         CHECK_STATUS(concat_infer_output_size(inTensors, this->p, outTensors[0], &this->archInfo));
+        if (this->outputFormatSet) {
+            TensorDesc desc = outTensors[0]->get_desc();
+            desc.df = this->outputFormat;
+            outTensors[0]->resize(desc);
+        }
         return SUCCESS;
     }
 
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc desc = inTensors[index]->get_desc();
+        bool outputC8 = (outTensors[0]->get_desc().df == DF_NCHWC8);
+        // inputs are transformed to the format of the output, except 4-D ones of 1x1 spatial
+        // size, whose NCHW and NCHWC8 layouts are the same
+        if (this->appendInPlace || (desc.nDims == 4 && desc.dims[0] == 1 && desc.dims[1] == 1) ||
+            (desc.df == DF_NCHWC8) == outputC8) {
+            return desc.df;
+        }
+        return outputC8 ? DF_NCHWC8 : DF_NCHW;
+    }
+
+    bool support_output_format(
+        DataFormat df, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        if (this->appendInPlace || outTensors[0]->get_desc().nDims != 4 ||
+            (df != DF_NCHW && df != DF_NCHWC8)) {
+            return false;
+        }
+        // every input can be blocked by 8 channels
+        for (U32 i = 0; i < inTensors.size() && df == DF_NCHWC8; i++) {
+            TensorDesc desc = inTensors[i]->get_desc();
+            if (desc.nDims != 4 || desc.dims[2] % 8 != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void set_output_format(DataFormat df) override
+    {
+        this->outputFormatSet = true;
+        this->outputFormat = df;
+    }
+
+    void clear_output_format() override
+    {
+        this->outputFormatSet = false;
+    }
+
+    // the first input extended in place along axis and the output keep their rows at the stride
+    bool set_input_row_stride(U32 index, U32 axis, U32 stride) override
+    {
+        UNUSED(axis);
+        if (!this->appendInPlace || index != 0) {
+            return false;
+        }
+        this->rowStride = stride;
+        return true;
+    }
+
     U32 infer_tmp_memory_size() override
     {
         U32 bytes = 0;
         CHECK_STATUS(concat_infer_forward_tmp_bytes(this->inputTensors, &bytes, &this->archInfo));
         return bytes;
     }
+
+protected:
+    bool outputFormatSet;
+    DataFormat outputFormat;
+    U32 rowStride;
 };
 
 #endif  // _CONCAT_CPU_H
@@ -217,6 +217,11 @@ public:
         TensorDesc filterDesc = filterTensor.get_desc();
 
         ConvolutionPolicy policy = CONVOLUTION_FASTEST;
+        char *tuningSetting = getenv("BOLT_CPU_ALGORITHM_TUNING");
+        if (IS_X86(this->archInfo.arch) && tuningSetting != NULL &&
+            std::string(tuningSetting) == std::string("ON")) {
+            policy = CONVOLUTION_TUNNING;
+        }
         DataType targetType = filterDesc.dt;
         I32 algo;
         switch (this->p.convolution_type) {
@@ -583,6 +588,61 @@ public:
         this->weightTensors[0] = *this->get_wtm();
         return SUCCESS;
     }
+
+    bool is_weight_cacheable() override
+    {
+        return true;
+    }
+
+    std::string get_weight_cache_key() override
+    {
+        return WeightOperator::get_weight_cache_key() + " alg:" + std::to_string(this->pwAlg) +
+            "," + std::to_string(this->dwAlg);
+    }
+
+    std::vector<Tensor> get_transformed_weights() override
+    {
+        std::vector<Tensor> tensors = WeightOperator::get_transformed_weights();
+        U32 num = this->get_num_scales();
+        if (num > 0) {
+            Tensor scaleTensor;
+            scaleTensor.resize(tensor1d(DT_F32, num));
+            ((CpuMemory *)scaleTensor.get_memory())
+                ->set_shared_ptr(std::shared_ptr<U8>(this->scales, (U8 *)this->scales.get()));
+            tensors.push_back(scaleTensor);
+        }
+        return tensors;
+    }
+
+    EE set_transformed_weights(std::vector<Tensor> tensors) override
+    {
+        U32 num = this->get_num_scales();
+        if (num > 0) {
+            if (tensors.empty() || tensors.back().length() != num) {
+                return NOT_MATCH;
+            }
+            // scales are also written during inference, keep a private copy
+            this->scales = std::shared_ptr<F32>((F32 *)operator new(num * bytesOf(DT_F32)));
+            memcpy(this->scales.get(), ((CpuMemory *)tensors.back().get_memory())->get_ptr(),
+                num * bytesOf(DT_F32));
+            tensors.pop_back();
+        }
+        return WeightOperator::set_transformed_weights(tensors);
+    }
+
+private:
+    // number of quantization scales that transform_filter() produces for int8 convolution
+    U32 get_num_scales()
+    {
+        U32 num = 0;
+#if defined(_USE_INT8)
+        if ((DT_F16_8Q == this->dt || DT_F32_8Q == this->dt) &&
+            Convolution_Pointwise == this->p.convolution_type) {
+            num = (CONVOLUTION_ALGORITHM_WINOGRAD == this->pwAlg) ? 38 : 3;
+        }
+#endif
+        return num;
+    }
 };
 
 #endif  // _CONVELTWISEPOOLING_H
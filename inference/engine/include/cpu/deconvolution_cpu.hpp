@@ -172,6 +172,16 @@ public:
         this->weightTensors[0] = wtm;
         return SUCCESS;
     }
+
+    bool is_weight_cacheable() override
+    {
+        return true;
+    }
+
+    std::string get_weight_cache_key() override
+    {
+        return WeightOperator::get_weight_cache_key() + " alg:" + std::to_string(this->alg);
+    }
 };
 
 #endif  // _DECONVOLUTION_CPU_H
@@ -84,6 +84,24 @@ public:
         }
         return SUCCESS;
     }
+
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        std::vector<TensorDesc> inputDesc;
+        for (auto p : inTensors) {
+            inputDesc.push_back(p->get_desc());
+        }
+        TensorDesc desc = inputDesc[index];
+        TensorDesc outputDesc = outTensors[0]->get_desc();
+        // an input of the same size is transformed to the blocked format of the output
+        if (!this->use_scale(inputDesc) && desc.nDims > 2 && desc.df != outputDesc.df &&
+            (outputDesc.df == DF_NCHWC8 || outputDesc.df == DF_NCHWC16) &&
+            tensorNumElements(desc) == tensorNumElements(outputDesc)) {
+            return outputDesc.df;
+        }
+        return desc.df;
+    }
 };
 
 #endif  // _ELTWISE_CPU_H
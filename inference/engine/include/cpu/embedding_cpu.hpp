@@ -91,8 +91,8 @@ public:
         modelWeightTensor->resize(weightDesc);
 
         bool set_ptr = false;
-        modelWeightTensor->alloc();
         if (modelPtr != nullptr) {
+            modelWeightTensor->alloc();
             memcpy(
                 ((CpuMemory *)(modelWeightTensor->get_memory()))->get_ptr(), modelPtr, weightBytes);
             *modelPtrShared = std::shared_ptr<U8>(*modelPtrShared, modelPtr + weightBytes);
@@ -100,8 +100,15 @@ public:
         } else {
             auto curOpWs = this->get_weightspec();
             if (curOpWs.weight != nullptr) {
-                memcpy(((CpuMemory *)(modelWeightTensor->get_memory()))->get_ptr(), curOpWs.weight,
-                    weightBytes);
+                // large vocabularies are only paged in for the rows that are looked up
+                auto mapped = this->get_model_file_memory(curOpWs.weight);
+                if (mapped != nullptr) {
+                    ((CpuMemory *)(modelWeightTensor->get_memory()))->set_shared_ptr(mapped);
+                } else {
+                    modelWeightTensor->alloc();
+                    memcpy(((CpuMemory *)(modelWeightTensor->get_memory()))->get_ptr(),
+                        curOpWs.weight, weightBytes);
+                }
                 set_ptr = true;
             }
         }
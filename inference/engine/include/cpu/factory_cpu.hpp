@@ -74,6 +74,8 @@
 #include "cpu/select_cpu.hpp"
 #include "cpu/topk_cpu.hpp"
 #include "cpu/gat_cpu.hpp"
+#include "cpu/scaled_dot_product_attention_cpu.hpp"
+#include "cpu/roialign_cpu.hpp"
 
 class FactoryCPU : public Factory {
 public:
@@ -452,7 +454,7 @@ public:
 
     std::shared_ptr<Operator> createRoIAlign(RoIAlignParamSpec p) override
     {
-        OP_UNSUP(1, p);
+        auto cep = new RoIAlignCPU(p);
         return std::shared_ptr<Operator>(cep);
     }
 
@@ -468,5 +470,12 @@ public:
         auto cep = new GATCPU(dt, p);
         return std::shared_ptr<Operator>(cep);
     }
+
+    std::shared_ptr<Operator> createScaledDotProductAttention(
+        DataType dt, ScaledDotProductAttentionParamSpec p) override
+    {
+        auto cep = new ScaledDotProductAttentionCPU(dt, p);
+        return std::shared_ptr<Operator>(cep);
+    }
 };
 #endif  // _FACTORY_CPU_H
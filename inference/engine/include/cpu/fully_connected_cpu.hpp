@@ -121,6 +121,18 @@ public:
             inputTensor, weightTensor, biasTensor, tmpTensor, outputTensor, &this->archInfo));
     }
 
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc desc = inTensors[index]->get_desc();
+        // a blocked input with spatial dims is flattened from a NCHW copy
+        if (index == 0 && desc.df == DF_NCHWC8 &&
+            tensorNumElements(desc) != desc.dims[desc.nDims - 1] * desc.dims[desc.nDims - 2]) {
+            return DF_NCHW;
+        }
+        return desc.df;
+    }
+
     EE infer_output_tensors_size(
         std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
     {
@@ -269,6 +281,11 @@ public:
         return SUCCESS;
     }
 
+    bool is_weight_cacheable() override
+    {
+        return true;
+    }
+
     bool mvm;
 };
 
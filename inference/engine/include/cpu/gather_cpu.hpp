@@ -46,6 +46,17 @@ public:
         return SUCCESS;
     }
 
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        DataFormat df = inTensors[index]->get_desc().df;
+        // blocked data is gathered from a NCHW copy
+        if (index == 0 && this->p.data_desc.nDims == 0 && df == DF_NCHWC8) {
+            df = DF_NCHW;
+        }
+        return df;
+    }
+
     EE infer_weight_desc() override
     {
         Tensor dataTensor, indexTensor;
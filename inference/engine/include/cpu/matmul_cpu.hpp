@@ -19,7 +19,10 @@
 class MatMulCPU : public MatMul {
 public:
     MatMulCPU(DataType dt, MatMulParamSpec p) : MatMul(dt, p)
-    {}
+    {
+        this->matrixStrides[0] = 0;
+        this->matrixStrides[1] = 0;
+    }
 
     std::shared_ptr<Operator> clone() override
     {
@@ -54,8 +57,9 @@ public:
             outputTensor.set_scale((featureScale.back())[0]);
         }
         std::vector<Tensor> tmpTensor(1, this->temp);
-        CHECK_STATUS(matmul(inputTensors[0], this->p.transpose_a, inputTensors[1],
-            this->p.transpose_b, inputTensorC, tmpTensor, outputTensors[0], &this->archInfo));
+        CHECK_STATUS(matmul_strided(inputTensors[0], this->p.transpose_a, this->matrixStrides[0],
+            inputTensors[1], this->p.transpose_b, this->matrixStrides[1], inputTensorC, tmpTensor,
+            outputTensors[0], &this->archInfo));
     }
 
     EE infer_output_tensors_size(
@@ -86,6 +90,19 @@ public:
             inputTensors[1], this->p.transpose_b, outputTensors[0], &bytes, &this->archInfo));
         return bytes;
     }
+
+    // a row above the matrix dimensions is a whole matrix
+    bool set_input_row_stride(U32 index, U32 axis, U32 stride) override
+    {
+        if (index > 1 || axis != 1 || DT_F16_8Q == this->dt || DT_F32_8Q == this->dt) {
+            return false;
+        }
+        this->matrixStrides[index] = stride;
+        return true;
+    }
+
+private:
+    U32 matrixStrides[2];
 };
 
 #endif  // _MATMUL_CPU_H
@@ -77,6 +77,24 @@ public:
         return SUCCESS;
     }
 
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc inputDesc = inTensors[index]->get_desc();
+        TensorDesc outputDesc = outTensors[0]->get_desc();
+        bool sameDim = (inputDesc.nDims == outputDesc.nDims);
+        for (U32 i = 0; sameDim && i < inputDesc.nDims; i++) {
+            sameDim = (inputDesc.dims[i] == outputDesc.dims[i]);
+        }
+        // a blocked input is rearranged to NCHW when its shape changes
+        if (index == 0 && this->p.axis != 8 && !sameDim &&
+            (inputDesc.df == DF_NCHWC8 || inputDesc.df == DF_NCHWC16) &&
+            tensorNumElements(inputDesc) == tensorNumElements(outputDesc)) {
+            return DF_NCHW;
+        }
+        return inputDesc.df;
+    }
+
     U32 infer_tmp_memory_size() override
     {
         U32 bytes = 0;
@@ -19,15 +19,76 @@
 class RNNCPU : public RNNCellCPU {
 public:
     RNNCPU(DataType dt, RNNParamSpec p) : RNNCellCPU(dt, p)
-    {}
+    {
+        this->streaming = false;
+        this->continued = false;
+    }
 
     std::shared_ptr<Operator> clone() override
     {
         std::shared_ptr<RNNCPU> mem = std::shared_ptr<RNNCPU>(new RNNCPU(this->dt, this->p));
         *mem = *this;
+        // the clone continues the stream on its own copy of the state
+        if (this->state.bytes() > 0) {
+            mem->state = this->state.clone();
+            mem->state.copy_from(&this->state);
+        }
         return mem;
     }
 
+    // only the forward direction can be continued by the next chunk
+    EE set_streaming(bool streaming) override
+    {
+        if (streaming && this->p.biDirection) {
+            return NOT_SUPPORTED;
+        }
+        this->streaming = streaming;
+        this->reset_state();
+        return SUCCESS;
+    }
+
+    void reset_state() override
+    {
+        U32 bytes = this->get_state_bytes();
+        if (this->state.bytes() != bytes) {
+            this->state = Tensor();
+            if (bytes > 0) {
+                this->state.resize(tensor1d(DT_U8, bytes));
+                this->state.alloc();
+            }
+        }
+        if (bytes > 0) {
+            memset(get_ptr_from_tensor(this->state, this->archInfo.arch), 0, bytes);
+        }
+        this->continued = false;
+    }
+
+    // the state of each batch is c followed by h
+    U32 get_state_bytes() override
+    {
+        if (!this->streaming || this->inputTensors.size() == 0) {
+            return 0;
+        }
+        TensorDesc desc = this->inputTensors[0].get_desc();
+        U32 column = this->p.numProjection > 0 ? this->p.numProjection : this->p.numOutput;
+        return desc.dims[desc.nDims - 1] * (this->p.numOutput + column) * bytesOf(desc.dt);
+    }
+
+    void save_state(U8 *state) override
+    {
+        this->fit_state();
+        memcpy(state, get_ptr_from_tensor(this->state, this->archInfo.arch), this->state.bytes());
+    }
+
+    void load_state(const U8 *state) override
+    {
+        if (this->state.bytes() != this->get_state_bytes()) {
+            this->reset_state();
+        }
+        memcpy(get_ptr_from_tensor(this->state, this->archInfo.arch), state, this->state.bytes());
+        this->continued = true;
+    }
+
     void run() override
     {
         Tensor inputTensor = this->inputTensors[0];
@@ -39,7 +100,13 @@ public:
         I32 num = p.biDirection ? 2 : 1;
         I32 column = this->p.numProjection > 0 ? this->p.numProjection : this->p.numOutput;
         U32 ch_size = (this->p.numOutput + column) * bytesOf(desc.dt);
-        if (this->inputTensors.size() == 1) {
+        U8 *streamState = nullptr;
+        if (this->streaming) {
+            // h and c inputs are replaced by the state of the previous run
+            this->fit_state();
+            streamState = (U8 *)get_ptr_from_tensor(this->state, this->archInfo.arch);
+            memcpy(state, streamState, batch * ch_size);
+        } else if (this->inputTensors.size() == 1) {
             // bi-direction rnn has forward-states and backward-states
             memset(state, 0, batch * num * ch_size);
         } else if (this->inputTensors.size() == 2) {
@@ -67,6 +134,10 @@ public:
         std::vector<Tensor> tmpTensor(1, this->temp);
         CHECK_STATUS(rnn(this->inputTensors, this->weightTensors, this->biasTensors, this->p,
             tmpTensor, this->outputTensors, &this->archInfo));
+        if (streamState != nullptr) {
+            memcpy(streamState, state, batch * ch_size);
+            this->continued = true;
+        }
 
         if (this->outputTensors.size() == 2) {
             memcpy(get_ptr_from_tensor(this->outputTensors[1], this->archInfo.arch), state,
@@ -108,6 +179,26 @@ public:
             this->outputTensors[0], this->p, &bytes, &this->archInfo));
         return bytes;
     }
+
+private:
+    // the state of another batch can not be continued, a stream that changes its batch restarts
+    void fit_state()
+    {
+        if (this->state.bytes() == this->get_state_bytes()) {
+            return;
+        }
+        if (this->continued) {
+            UNI_WARNING_LOG("RNN operator %s changes its batch in streaming mode, the state of the "
+                            "stream is reset.\n",
+                this->get_name().c_str());
+        }
+        this->reset_state();
+    }
+
+    bool streaming;
+    // state holds the history of a stream
+    bool continued;
+    Tensor state;
 };
 
 #endif  // _RNN_CPU_H
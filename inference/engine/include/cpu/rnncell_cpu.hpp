@@ -94,6 +94,11 @@ public:
         return SUCCESS;
     }
 
+    bool is_weight_cacheable() override
+    {
+        return true;
+    }
+
     EE infer_weight_desc() override
     {
         int directions = (this->p.biDirection) ? 2 : 1;
@@ -0,0 +1,79 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _ROIALIGN_CPU_H
+#define _ROIALIGN_CPU_H
+
+#include "roialign.hpp"
+
+class RoIAlignCPU : public RoIAlign {
+public:
+    RoIAlignCPU(RoIAlignParamSpec p) : RoIAlign(p)
+    {}
+
+    std::shared_ptr<Operator> clone() override
+    {
+        std::shared_ptr<RoIAlignCPU> mem = std::shared_ptr<RoIAlignCPU>(new RoIAlignCPU(this->p));
+        *mem = *this;
+        return mem;
+    }
+
+    void run() override
+    {
+        std::vector<Tensor> inputTensors = this->inputTensors;
+        TensorDesc inputDesc = inputTensors[0].get_desc();
+        // a blocked feature map is read from a NCHW copy, the input itself is left unchanged
+        if (inputDesc.df != DF_NCHW) {
+            TensorDesc tmpInputDesc = inputDesc;
+            tmpInputDesc.df = DF_NCHW;
+            CHECK_STATUS(transformToNCHW(inputDesc,
+                ((CpuMemory *)(inputTensors[0].get_memory()))->get_ptr(), tmpInputDesc,
+                ((CpuMemory *)(this->temp.get_memory()))->get_ptr()));
+            inputTensors[0] = this->temp;
+            inputTensors[0].resize(tmpInputDesc);
+        }
+        CHECK_STATUS(
+            roialign(inputTensors, this->p, this->temp, this->outputTensors[0], &this->archInfo));
+    }
+
+    EE infer_output_tensors_size(
+        std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        CHECK_STATUS(
+            roialign_infer_output_size(inTensors, this->p, outTensors[0], &this->archInfo));
+        return SUCCESS;
+    }
+
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc desc = inTensors[index]->get_desc();
+        // the feature map is sampled in NCHW
+        if (index == 0 && (desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16)) {
+            return DF_NCHW;
+        }
+        return desc.df;
+    }
+
+    U32 infer_tmp_memory_size() override
+    {
+        TensorDesc inputDesc = this->inputTensors[0].get_desc();
+        U32 bytes = 0;
+        if (inputDesc.df != DF_NCHW) {
+            bytes = tensorNumBytes(inputDesc);
+        }
+        return bytes;
+    }
+};
+
+#endif  // _ROIALIGN_CPU_H
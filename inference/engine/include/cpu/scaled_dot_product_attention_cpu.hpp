@@ -0,0 +1,99 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _SCALED_DOT_PRODUCT_ATTENTION_CPU_H
+#define _SCALED_DOT_PRODUCT_ATTENTION_CPU_H
+
+#include "scaled_dot_product_attention.hpp"
+
+class ScaledDotProductAttentionCPU : public ScaledDotProductAttention {
+public:
+    ScaledDotProductAttentionCPU(DataType dt, ScaledDotProductAttentionParamSpec p)
+        : ScaledDotProductAttention(dt, p)
+    {
+        this->keyStride = 0;
+        this->valueStride = 0;
+    }
+
+    std::shared_ptr<Operator> clone() override
+    {
+        std::shared_ptr<ScaledDotProductAttentionCPU> mem =
+            std::shared_ptr<ScaledDotProductAttentionCPU>(
+                new ScaledDotProductAttentionCPU(this->dt, this->p));
+        *mem = *this;
+        return mem;
+    }
+
+    void run() override
+    {
+        CHECK_STATUS(scaled_dot_product_attention(inputTensors[0], inputTensors[1],
+            this->keyStride, inputTensors[2], this->valueStride,
+            get_mask_tensor(this->inputTensors), this->p, this->temp, outputTensors[0],
+            &this->archInfo));
+    }
+
+    EE infer_output_tensors_size(
+        std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        CHECK_STATUS(scaled_dot_product_attention_infer_output_size(
+            inTensors[0], inTensors[1], inTensors[2], this->p, outTensors[0], &this->archInfo));
+        return SUCCESS;
+    }
+
+    U32 infer_tmp_memory_size() override
+    {
+        U32 size = 0;
+        CHECK_STATUS(scaled_dot_product_attention_infer_forward_tmp_bytes(inputTensors[0],
+            inputTensors[1], inputTensors[2], get_mask_tensor(this->inputTensors), this->p, &size,
+            &this->archInfo));
+        return size;
+    }
+
+    // a row above the matrix dimensions of the keys and values is the matrix of a batch and head
+    bool set_input_row_stride(U32 index, U32 axis, U32 stride) override
+    {
+        if (axis != 1) {
+            return false;
+        }
+        if (index == 1) {
+            this->keyStride = stride;
+        } else if (index == 2) {
+            this->valueStride = stride;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // the raw sequence mask is read in the model data type, same as Attention
+    Tensor get_mask_tensor(std::vector<Tensor> inTensors)
+    {
+        Tensor maskTensor;
+        if (this->p.mask_mode != SDPA_MASK_NONE && inTensors.size() > 3) {
+            maskTensor = inTensors[3];
+            if (this->p.mask_mode == SDPA_MASK_ATTENTION) {
+                TensorDesc maskDesc = maskTensor.get_desc();
+                maskDesc.dt = this->dt;
+                maskTensor.resize(maskDesc);
+            }
+        }
+        return maskTensor;
+    }
+
+    U32 keyStride;
+    U32 valueStride;
+};
+
+#endif  // _SCALED_DOT_PRODUCT_ATTENTION_CPU_H
@@ -102,6 +102,20 @@ public:
         return SUCCESS;
     }
 
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        DataFormat df = inTensors[index]->get_desc().df;
+        U32 updateIndex = (this->p.data_desc.nDims == 0) + (this->p.index_desc.nDims == 0);
+        bool isData = (this->p.data_desc.nDims == 0 && index == 0);
+        bool isUpdate = (this->p.update_desc.nDims == 0 && index == updateIndex);
+        // blocked data and updates are scattered through NCHW copies
+        if ((isData || isUpdate) && df == DF_NCHWC8) {
+            df = DF_NCHW;
+        }
+        return df;
+    }
+
     EE infer_weight_desc() override
     {
         Tensor dataTensor, indexTensor, updateTensor;
@@ -59,15 +59,21 @@ public:
         Tensor modelWeightTensor;
         modelWeightTensor.resize(weightDesc);
         U32 weightBytes = modelWeightTensor.bytes();
-        modelWeightTensor.alloc();
         if (modelPtr != nullptr) {
+            modelWeightTensor.alloc();
             memcpy(
                 ((CpuMemory *)(modelWeightTensor.get_memory()))->get_ptr(), modelPtr, weightBytes);
             *modelPtrShared = std::shared_ptr<U8>(*modelPtrShared, modelPtr + weightBytes);
         } else {
             auto curOpWs = this->get_weightspec();
-            memcpy(((CpuMemory *)(modelWeightTensor.get_memory()))->get_ptr(), curOpWs.weight,
-                weightBytes);
+            auto mapped = this->get_model_file_memory(curOpWs.weight);
+            if (mapped != nullptr) {
+                ((CpuMemory *)(modelWeightTensor.get_memory()))->set_shared_ptr(mapped);
+            } else {
+                modelWeightTensor.alloc();
+                memcpy(((CpuMemory *)(modelWeightTensor.get_memory()))->get_ptr(), curOpWs.weight,
+                    weightBytes);
+            }
         }
         this->weightTensors.push_back(modelWeightTensor);
         (*this->tensorMapPtr)[this->outputTensorName]->reuse(&(this->weightTensors[0]));
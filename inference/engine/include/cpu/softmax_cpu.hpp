@@ -42,6 +42,19 @@ public:
             softmax_infer_output_size(inTensors[0], this->p, outTensors[0], &this->archInfo));
         return SUCCESS;
     }
+
+    DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc desc = inTensors[index]->get_desc();
+        int axis = (this->p.axis + desc.nDims) % desc.nDims;
+        // the channel softmax of a blocked tensor with spatial dims runs on a NCHW copy
+        if ((desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) && axis == 1 &&
+            tensorNumElements(desc) != desc.dims[desc.nDims - 1] * desc.dims[desc.nDims - 2]) {
+            return DF_NCHW;
+        }
+        return desc.df;
+    }
 };
 
 #endif  // SOFTMAX_CPU_H
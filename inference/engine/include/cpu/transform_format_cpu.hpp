@@ -0,0 +1,76 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _TRANSFORM_FORMAT_CPU_H
+#define _TRANSFORM_FORMAT_CPU_H
+
+#include "operator.hpp"
+
+// Explicit data format transform inserted by the engine, so that several readers of a tensor
+// share one transformed copy instead of each transforming it inside their kernels.
+class TransformFormatCPU : public Operator {
+public:
+    TransformFormatCPU(DataType dt, DataFormat df)
+    {
+        this->dt = dt;
+        this->df = df;
+    }
+
+    OperatorType get_type() override
+    {
+        return OT_TransformFormat;
+    }
+
+    std::shared_ptr<Operator> clone() override
+    {
+        std::shared_ptr<TransformFormatCPU> mem =
+            std::shared_ptr<TransformFormatCPU>(new TransformFormatCPU(this->dt, this->df));
+        *mem = *this;
+        return mem;
+    }
+
+    void run() override
+    {
+        Tensor inputTensor = this->inputTensors[0];
+        Tensor outputTensor = this->outputTensors[0];
+        TensorDesc inputDesc = inputTensor.get_desc();
+        TensorDesc outputDesc = outputTensor.get_desc();
+        void *input = ((CpuMemory *)(inputTensor.get_memory()))->get_ptr();
+        void *output = ((CpuMemory *)(outputTensor.get_memory()))->get_ptr();
+        if (inputDesc.df == outputDesc.df) {
+            memcpy(output, input, tensorNumBytes(inputDesc));
+        } else {
+            CHECK_STATUS(transformFormat(inputDesc, input, outputDesc, output));
+        }
+        outputTensor.set_scale(inputTensor.get_scale());
+    }
+
+    EE infer_output_tensors_size(
+        std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors) override
+    {
+        TensorDesc desc = inTensors[0]->get_desc();
+        // an input that can not be transformed any more after a resize is copied
+        if (desc.nDims >= 4 &&
+            (desc.df == DF_NCHW || desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16)) {
+            desc.df = this->df;
+        }
+        outTensors[0]->resize(desc);
+        return SUCCESS;
+    }
+
+protected:
+    DataFormat df;
+};
+
+#endif  // _TRANSFORM_FORMAT_CPU_H
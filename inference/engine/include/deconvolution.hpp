@@ -32,6 +32,26 @@ public:
         return OT_Deconvolution;
     }
 
+    // every input point is scattered to a kernel window of each output channel in its group
+    double get_flops() override
+    {
+        if (this->inputTensors.size() == 0 || this->outputTensors.size() == 0) {
+            return 0;
+        }
+        U32 oc;
+        tensorSelectGet(this->outputTensors[0].get_desc(), NULL, NULL, NULL, &oc, NULL, NULL);
+        double kernel = 1.0 * this->p.kernel_h * this->p.kernel_w;
+        return 2 * kernel * tensorNumElements(this->inputTensors[0].get_desc()) * oc /
+            UNI_MAX(1, this->p.group);
+    }
+
+    std::string get_algorithm() override
+    {
+        const char *names[] = {"POINTWISE", "DIRECT", "IM2COL_GEMM", "GEMM", "GEMM_ICNCHW",
+            "WINOGRAD", "BNN", "DIRECT_SPE_CK", "GROUP_DECONV", ""};
+        return names[this->alg];
+    }
+
 public:
     U32 numInputs;
 
@@ -28,6 +28,15 @@ public:
         return OT_Eltwise;
     }
 
+    double get_flops() override
+    {
+        if (this->inputTensors.size() < 2 || this->outputTensors.size() == 0) {
+            return 0;
+        }
+        return 1.0 * (this->inputTensors.size() - 1) *
+            tensorNumElements(this->outputTensors[0].get_desc());
+    }
+
     U32 infer_tmp_memory_size() override
     {
         U32 bytes = 0;
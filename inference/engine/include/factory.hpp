@@ -205,6 +205,9 @@ public:
 
     virtual std::shared_ptr<Operator> createGAT(DataType dt, GATParamSpec p) = 0;
 
+    virtual std::shared_ptr<Operator> createScaledDotProductAttention(
+        DataType dt, ScaledDotProductAttentionParamSpec p) = 0;
+
     DataType get_float_precision(DataType dt)
     {
         DataType ret = dt;
@@ -239,7 +242,7 @@ public:
         if (dt == DT_F32_8Q || dt == DT_F16_8Q) {
 #ifndef _USE_INT8
             UNI_ERROR_LOG("this library not support to inference int8, please recompile with "
-                          "--int8=on. Only Armv7+ and x86 AVX512-VNNI cpu support.\n");
+                          "--int8=on. Only Armv7+ and x86 AVX2+ cpu support.\n");
 #endif
         }
         OperatorType opType = curOps.type;
@@ -613,6 +616,10 @@ public:
                 op = createGAT(dt, curPs.gat_spec);
                 break;
             }
+            case OT_ScaledDotProductAttention: {
+                op = createScaledDotProductAttention(dt, curPs.sdpa_spec);
+                break;
+            }
             case OT_RoIAlign: {
                 op = createRoIAlign(curPs.roialign_spec);
                 break;
@@ -31,6 +31,22 @@ public:
         return OT_FC;
     }
 
+    double get_flops() override
+    {
+        if (this->inputTensors.size() == 0) {
+            return 0;
+        }
+        double outputs = 0;
+        for (auto &tensor : this->outputTensors) {
+            outputs += tensorNumElements(tensor.get_desc());
+        }
+        double rows = outputs / UNI_MAX(1, this->p.num_outputs);
+        if (rows == 0) {
+            return 0;
+        }
+        return 2 * outputs * tensorNumElements(this->inputTensors[0].get_desc()) / rows;
+    }
+
 public:
     U32 numInput;
 
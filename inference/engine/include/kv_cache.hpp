@@ -0,0 +1,153 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _KV_CACHE_H
+#define _KV_CACHE_H
+
+#include "tensor.hpp"
+
+// Past states (e.g. attention keys/values) of an autoregressive decoder. Each entry is a
+// model input that a concat operator extends with the current step and exports as a model
+// output. Both tensors share one buffer that is preallocated for the whole capacity, so a
+// decoding step only writes the new step instead of copying the history. The rows of the
+// states, the dimensions outside the concatenation axis, are placed at a fixed stride sized for
+// the capacity when every operator reading them supports it, otherwise they are packed and the
+// history is moved inside the buffer.
+class KVCache {
+public:
+    struct Entry {
+        std::string presentName;
+        // concatenation dimension in TensorDesc order
+        U32 axis;
+        // distance of the rows, 0 if they are packed
+        U32 rowBytes;
+        std::shared_ptr<Tensor> buffer;
+    };
+
+    KVCache()
+    {
+        this->capacity = 0;
+        this->changed = false;
+        this->extended = false;
+    }
+
+    void set_capacity(U32 capacity)
+    {
+        this->capacity = capacity;
+    }
+
+    U32 get_capacity()
+    {
+        return this->capacity;
+    }
+
+    void add(std::string pastName, std::string presentName, U32 axis, U32 stepBytes)
+    {
+        Entry entry;
+        entry.presentName = presentName;
+        entry.axis = axis;
+        entry.rowBytes = 0;
+        entry.buffer = std::shared_ptr<Tensor>(new Tensor());
+        entry.buffer->resize(tensor1d(DT_U8, stepBytes * this->capacity));
+        entry.buffer->alloc();
+        this->entries[pastName] = entry;
+    }
+
+    bool empty()
+    {
+        return this->entries.empty();
+    }
+
+    std::map<std::string, Entry> &get_entries()
+    {
+        return this->entries;
+    }
+
+    // reallocate the buffers for a larger capacity, the states are kept
+    void reserve(U32 capacity)
+    {
+        for (auto &iter : this->entries) {
+            Tensor *old = iter.second.buffer.get();
+            U32 bytes = old->bytes();
+            std::shared_ptr<Tensor> buffer = std::shared_ptr<Tensor>(new Tensor());
+            buffer->resize(tensor1d(DT_U8, bytes / this->capacity * capacity));
+            buffer->alloc();
+            U8 *dst = (U8 *)((CpuMemory *)(buffer->get_memory()))->get_ptr();
+            U8 *src = (U8 *)((CpuMemory *)(old->get_memory()))->get_ptr();
+            U32 rowBytes = iter.second.rowBytes;
+            if (rowBytes == 0) {
+                UNI_MEMCPY(dst, src, bytes);
+            } else {
+                // rows are spread to the stride of the new capacity
+                U32 newRowBytes = rowBytes / this->capacity * capacity;
+                for (U32 o = 0; o < bytes / rowBytes; o++) {
+                    UNI_MEMCPY(dst + o * newRowBytes, src + o * rowBytes, rowBytes);
+                }
+                iter.second.rowBytes = newRowBytes;
+            }
+            iter.second.buffer = buffer;
+        }
+        this->capacity = capacity;
+    }
+
+    // buffer that backs a past or present tensor, nullptr for other tensors
+    Tensor *get_buffer(std::string name)
+    {
+        for (auto &iter : this->entries) {
+            if (iter.first == name || iter.second.presentName == name) {
+                return iter.second.buffer.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // give this cache its own copy of the states, used when a model is cloned
+    void clone_buffers()
+    {
+        for (auto &iter : this->entries) {
+            std::shared_ptr<Tensor> buffer = std::shared_ptr<Tensor>(new Tensor());
+            *buffer = iter.second.buffer->clone();
+            buffer->copy_from(iter.second.buffer.get());
+            iter.second.buffer = buffer;
+        }
+    }
+
+    // the length of the states is changed, so tensor shapes need to be inferred again
+    void set_changed(bool changed)
+    {
+        this->changed = changed;
+    }
+
+    bool is_changed()
+    {
+        return this->changed;
+    }
+
+    // the states are extended by a step, shapes of the operators reading them are stale
+    void set_extended(bool extended)
+    {
+        this->extended = extended;
+    }
+
+    bool is_extended()
+    {
+        return this->extended;
+    }
+
+private:
+    U32 capacity;
+    bool changed;
+    bool extended;
+    std::map<std::string, Entry> entries;
+};
+#endif
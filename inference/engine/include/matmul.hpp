@@ -29,6 +29,16 @@ public:
         return OT_MatMul;
     }
 
+    double get_flops() override
+    {
+        if (this->inputTensors.size() == 0 || this->outputTensors.size() == 0) {
+            return 0;
+        }
+        TensorDesc desc = this->inputTensors[0].get_desc();
+        U32 k = (this->p.transpose_a && desc.nDims > 1) ? desc.dims[1] : desc.dims[0];
+        return 2.0 * k * tensorNumElements(this->outputTensors[0].get_desc());
+    }
+
 protected:
     MatMulParamSpec p;
 };
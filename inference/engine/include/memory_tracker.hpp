@@ -14,6 +14,7 @@
 #ifndef _MEMORY_TRACKER_H
 #define _MEMORY_TRACKER_H
 
+#include <algorithm>
 #include "tensor_desc.h"
 #ifdef _USE_GPU
 #include "image_manager.hpp"
@@ -25,10 +26,14 @@ public:
     {
         this->storageSize.clear();
         this->tensorStoragePosition.clear();
+        this->tensorLifetime.clear();
+        this->tensorOffset.clear();
+        this->plannedSize = 0;
         this->memoryNeedAssign = true;
     }
 
-    void trackOpTensorSizes(std::shared_ptr<Operator> op, std::vector<std::string> tensorNames)
+    void trackOpTensorSizes(
+        std::shared_ptr<Operator> op, std::vector<std::string> tensorNames, U32 opIndex)
     {
         I32 *pos = op->get_tensor_positions().data();
         auto inputTensors = op->get_input_tensors();
@@ -39,22 +44,116 @@ public:
             I32 slot = pos[i];
             this->tensorStoragePosition[tensorNames[i]] = slot;
             if (slot < 0) {
+                this->tensorLifetime.erase(tensorNames[i]);
                 this->trackSingleTensor(inputTensors[i]);
                 continue;
             }
             this->trackSlotSize(slot, inputTensors[i]);
+            this->trackTensorLifetime(tensorNames[i], opIndex, inputTensors[i]);
         }
         for (size_t i = 0; i < numOutput; i++) {
             I32 slot = pos[numInput + i];
             this->tensorStoragePosition[tensorNames[numInput + i]] = slot;
             if (slot < 0) {
+                this->tensorLifetime.erase(tensorNames[numInput + i]);
                 this->trackSingleTensor(outputTensors[i]);
                 continue;
             }
             this->trackSlotSize(slot, outputTensors[i]);
+            this->trackTensorLifetime(tensorNames[numInput + i], opIndex, outputTensors[i]);
         }
     }
 
+    // model inputs are written before the first operator runs and model outputs are read
+    // after the last one, so their lifetime must be extended to the whole run.
+    void extendTensorLifetime(std::string name, U32 start, U32 end)
+    {
+        auto iter = this->tensorLifetime.find(name);
+        if (iter != this->tensorLifetime.end()) {
+            iter->second.start = UNI_MIN(iter->second.start, start);
+            iter->second.end = UNI_MAX(iter->second.end, end);
+        }
+    }
+
+    // the operators using a tensor changed, its lifetime is tracked again and offsets replanned
+    void eraseTensor(std::string name)
+    {
+        this->tensorLifetime.erase(name);
+        this->tensorOffset.erase(name);
+        this->memoryNeedAssign = true;
+    }
+
+    // Place every slot-managed buffer tensor at an offset inside one arena. Tensors are
+    // visited from the biggest to the smallest one, and each tensor takes the smallest
+    // gap that does not overlap with an already placed tensor whose lifetime intersects.
+    // Returns the arena size.
+    U32 planTensorOffsets()
+    {
+        std::vector<std::pair<std::string, TensorLifetime>> tensors(
+            this->tensorLifetime.begin(), this->tensorLifetime.end());
+        std::stable_sort(tensors.begin(), tensors.end(),
+            [](const std::pair<std::string, TensorLifetime> &a,
+                const std::pair<std::string, TensorLifetime> &b) {
+                if (a.second.bytes != b.second.bytes) {
+                    return a.second.bytes > b.second.bytes;
+                }
+                return a.second.start < b.second.start;
+            });
+        // placed tensors, sorted by offset
+        std::vector<std::pair<U32, TensorLifetime>> placed;
+        this->tensorOffset.clear();
+        this->plannedSize = 0;
+        for (auto &tensor : tensors) {
+            TensorLifetime &cur = tensor.second;
+            cur.bytes = alignSize(cur.bytes);
+            U32 prevEnd = 0;
+            U32 bestOffset = 0;
+            U32 bestGap = 0;
+            bool found = false;
+            for (auto &p : placed) {
+                if (p.second.end < cur.start || cur.end < p.second.start) {
+                    continue;
+                }
+                if (p.first >= prevEnd) {
+                    U32 gap = p.first - prevEnd;
+                    if (gap >= cur.bytes && (!found || gap < bestGap)) {
+                        bestOffset = prevEnd;
+                        bestGap = gap;
+                        found = true;
+                    }
+                }
+                prevEnd = UNI_MAX(prevEnd, p.first + p.second.bytes);
+            }
+            if (!found) {
+                bestOffset = prevEnd;
+            }
+            auto iter = std::upper_bound(placed.begin(), placed.end(), bestOffset,
+                [](U32 offset, const std::pair<U32, TensorLifetime> &p) {
+                    return offset < p.first;
+                });
+            placed.insert(iter, std::make_pair(bestOffset, cur));
+            this->tensorOffset[tensor.first] = std::make_pair(bestOffset, cur.bytes);
+            this->plannedSize = UNI_MAX(this->plannedSize, bestOffset + cur.bytes);
+        }
+        return this->plannedSize;
+    }
+
+    bool getTensorOffset(std::string name, U32 *offset, U32 *size)
+    {
+        auto iter = this->tensorOffset.find(name);
+        if (iter == this->tensorOffset.end()) {
+            return false;
+        }
+        *offset = iter->second.first;
+        *size = iter->second.second;
+        return true;
+    }
+
+    U32 getPlannedSize()
+    {
+        return this->plannedSize;
+    }
+
     I32 getSlotByTensorName(std::string name)
     {
         return tensorStoragePosition[name];
@@ -113,6 +212,40 @@ public:
     }
 
 protected:
+    struct TensorLifetime {
+        U32 start;
+        U32 end;
+        U32 bytes;
+    };
+
+    U32 alignSize(U32 size)
+    {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    void trackTensorLifetime(std::string name, U32 opIndex, Tensor tensor)
+    {
+        Memory *mem = tensor.get_memory();
+        if (mem->get_mem_type() != OCLMem && mem->get_mem_type() != CPUMem) {
+            return;
+        }
+        U32 size = mem->bytes();
+        auto iter = this->tensorLifetime.find(name);
+        if (iter == this->tensorLifetime.end()) {
+            TensorLifetime lifetime = {opIndex, opIndex, size};
+            this->tensorLifetime[name] = lifetime;
+        } else {
+            iter->second.start = UNI_MIN(iter->second.start, opIndex);
+            iter->second.end = UNI_MAX(iter->second.end, opIndex);
+            // keep the biggest size seen, so that shrinking shapes never trigger a new plan
+            iter->second.bytes = UNI_MAX(iter->second.bytes, size);
+        }
+        auto planned = this->tensorOffset.find(name);
+        if (planned == this->tensorOffset.end() || size > planned->second.second) {
+            this->memoryNeedAssign = true;
+        }
+    }
+
     void trackSingleTensor(Tensor tensor)
     {
         if (!memoryNeedAssign) {
@@ -187,7 +320,12 @@ protected:
 
     std::vector<U32> storageSize;
     std::map<std::string, I32> tensorStoragePosition;
+    std::map<std::string, TensorLifetime> tensorLifetime;
+    // tensor name -> (offset, reserved bytes) inside the activation arena
+    std::map<std::string, std::pair<U32, U32>> tensorOffset;
+    U32 plannedSize;
     bool memoryNeedAssign;
+    static const U32 ALIGNMENT = 64;
 #ifdef _USE_GPU
     ImageManager imageManager;
 #endif
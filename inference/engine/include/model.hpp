@@ -14,6 +14,7 @@
 #ifndef _MODEL_H
 #define _MODEL_H
 
+#include <functional>
 #include "operator.hpp"
 #include "tensor_desc.h"
 #include "algorithm_map.h"
@@ -25,10 +26,13 @@
 class Model {
 public:
     Model()
-    {}
+    {
+        this->numThreads = 0;
+    }
 
     Model(AffinityPolicy affinityPolicy, DataType dt, std::string name)
     {
+        this->numThreads = 0;
         this->set_device_info(affinityPolicy);
         this->dt = dt;
         this->name = name;
@@ -75,8 +79,29 @@ public:
         return this->deviceInfo.schedule;
     }
 
+    // set the parallel threads num of this model only, 0 means the process-wide setting
+    void set_num_threads(int threadNum)
+    {
+        if (threadNum < 0) {
+            threadNum = 0;
+        }
+        if (threadNum > OMP_MAX_NUM_THREADS) {
+            threadNum = OMP_MAX_NUM_THREADS;
+        }
+        this->numThreads = threadNum;
+        for (auto op : ops) {
+            op->set_num_threads(this->numThreads);
+        }
+    }
+
+    int get_num_threads()
+    {
+        return this->numThreads;
+    }
+
     virtual void ready(std::map<std::string, TensorDesc> inputDescMap)
     {
+        ThreadContextGuard threadContext(this->numThreads);
         infer_output_tensors_size(inputDescMap);
         assign_output_tensor();
 
@@ -123,6 +148,7 @@ public:
     virtual void run_till_breakpoint(U32 opIdx)
     {
         CHECK_REQUIREMENT(IS_CPU(this->deviceInfo.schedule));
+        ThreadContextGuard threadContext(this->numThreads);
         for (U32 i = 0; i < this->ops.size();) {
             auto op = this->ops[i];
             if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
@@ -139,6 +165,24 @@ public:
             }
         }
     }
+
+    // runs all the operators on CPU and calls observer with the index of each one that has run,
+    // before the following operators reuse the memory of its tensors
+    virtual void run_with_observer(std::function<void(U32)> observer)
+    {
+        CHECK_REQUIREMENT(IS_CPU(this->deviceInfo.schedule));
+        ThreadContextGuard threadContext(this->numThreads);
+        for (U32 i = 0; i < this->ops.size();) {
+            auto op = this->ops[i];
+            if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
+                i = op->get_next_operator_index();
+            } else {
+                op->run();
+                observer(i);
+                i++;
+            }
+        }
+    }
 #endif
 
     std::string get_name()
@@ -175,6 +219,7 @@ protected:
     DeviceInfo deviceInfo;
     DataType dt;
     std::shared_ptr<AlgorithmMap> algorithmMap;
+    int numThreads;
 
     virtual EE infer_output_tensors_size(std::map<std::string, TensorDesc>) = 0;
     virtual void assign_output_tensor() = 0;
@@ -18,11 +18,16 @@
 #include "model_spec.h"
 
 #ifdef _USE_INT8
+// threadNum > 0 records all the calibrated tensors in one forward pass per sample, spreading the
+// samples over threadNum cloned models, otherwise the operators are calibrated one by one.
+// useMinMax takes the maximum absolute value as the clipping threshold instead of KL-divergence.
 void calibrate_model_with_dataset(std::string dataPath,
     ImageFormat imageFormat,
     DataType inferType,
     F32 scaleValue,
     std::string modelPath,
-    ModelSpec *resultMs);
+    ModelSpec *resultMs,
+    U32 threadNum = 0,
+    bool useMinMax = false);
 #endif
 #endif
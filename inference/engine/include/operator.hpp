@@ -33,6 +33,7 @@ public:
         this->name = "";
         this->lenOfTemp = 0;
         this->archInfo.archPara = nullptr;
+        this->archInfo.numThreads = 0;
 #ifdef _USE_GPU
         this->tempImages = nullptr;
 #endif
@@ -95,6 +96,44 @@ public:
         return false;
     }
 
+    // data format in which the CPU operator reads input index without transforming it first,
+    // an input in another format is transformed inside the kernel on every run
+    virtual DataFormat get_input_format(
+        U32 index, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors)
+    {
+        UNUSED(outTensors);
+        return inTensors[index]->get_desc().df;
+    }
+
+    // whether the CPU operator can write its output in data format df instead of the format it
+    // picks itself, set_output_format makes it do so until clear_output_format
+    virtual bool support_output_format(
+        DataFormat df, std::vector<Tensor *> inTensors, std::vector<Tensor *> outTensors)
+    {
+        UNUSED(df);
+        UNUSED(inTensors);
+        UNUSED(outTensors);
+        return false;
+    }
+
+    virtual void set_output_format(DataFormat df)
+    {
+        UNUSED(df);
+    }
+
+    virtual void clear_output_format()
+    {}
+
+    // make the CPU operator read input index with its rows, the dimensions above axis in
+    // TensorDesc order, placed stride elements apart, 0 for packed rows, false if not supported
+    virtual bool set_input_row_stride(U32 index, U32 axis, U32 stride)
+    {
+        UNUSED(index);
+        UNUSED(axis);
+        UNUSED(stride);
+        return false;
+    }
+
     virtual bool is_weight()
     {
         return false;
@@ -125,6 +164,11 @@ public:
         this->archInfo.arch = opSchedule;
     }
 
+    virtual void set_num_threads(int numThreads)
+    {
+        this->archInfo.numThreads = numThreads;
+    }
+
     virtual void set_tensor_positions(std::vector<I32> tensorPos)
     {
         this->tensorPos = tensorPos;
@@ -221,6 +265,31 @@ public:
 
     virtual OperatorType get_type() = 0;
 
+    // floating point operations of one run with the current shapes, 0 if not counted
+    virtual double get_flops()
+    {
+        return 0;
+    }
+
+    // bytes of the tensors that one run reads and writes
+    virtual double get_bytes()
+    {
+        double bytes = 0;
+        for (auto &tensor : this->inputTensors) {
+            bytes += tensor.bytes();
+        }
+        for (auto &tensor : this->outputTensors) {
+            bytes += tensor.bytes();
+        }
+        return bytes;
+    }
+
+    // chosen algorithm, empty if the operator has only one
+    virtual std::string get_algorithm()
+    {
+        return "";
+    }
+
     virtual EE infer_forward_algorithm(std::shared_ptr<AlgorithmMap> algorithmMap)
     {
         UNUSED(algorithmMap);
@@ -0,0 +1,202 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _OPERATOR_PROFILER_H
+#define _OPERATOR_PROFILER_H
+
+#include <mutex>
+#include <fstream>
+#include <algorithm>
+#include "profiling.h"
+#include "operator.hpp"
+
+// Times every operator run when enabled, and attributes the FLOPs and bytes the operator reports
+// for its current shapes to it. Results are a Chrome trace (chrome://tracing, ui.perfetto.dev)
+// and a table per operator type with achieved GFLOP/s and GB/s. If the peak compute and memory
+// bandwidth of the machine are given, the table also shows how close each type comes to the
+// roofline bound min(peak GFLOP/s, FLOP/byte * peak GB/s).
+class OperatorProfiler {
+public:
+    OperatorProfiler()
+    {
+        this->enabled = false;
+        this->peakGFlops = 0;
+        this->peakGBs = 0;
+    }
+
+    // clones share the settings but not the records
+    OperatorProfiler(const OperatorProfiler &other)
+    {
+        this->enabled = other.enabled;
+        this->peakGFlops = other.peakGFlops;
+        this->peakGBs = other.peakGBs;
+    }
+
+    OperatorProfiler &operator=(const OperatorProfiler &other)
+    {
+        if (this != &other) {
+            this->enabled = other.enabled;
+            this->peakGFlops = other.peakGFlops;
+            this->peakGBs = other.peakGBs;
+            this->clear();
+        }
+        return *this;
+    }
+
+    void set_enabled(bool enabled)
+    {
+        this->enabled = enabled;
+    }
+
+    bool is_enabled()
+    {
+        return this->enabled;
+    }
+
+    // peak of the machine, 0 leaves the efficiency out
+    void set_roofline(double peakGFlops, double peakGBs)
+    {
+        this->peakGFlops = peakGFlops;
+        this->peakGBs = peakGBs;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->records.clear();
+    }
+
+    // may be called by several threads at the same time
+    void run(Operator *op)
+    {
+        if (!this->enabled) {
+            op->run();
+            return;
+        }
+        double start = ut_time_ms();
+        op->run();
+        double end = ut_time_ms();
+        UNI_THREADID
+        Record record = {op->get_name(), op->get_type(), op->get_algorithm(), (int)tid, start,
+            end - start, op->get_flops(), op->get_bytes()};
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->records.push_back(record);
+    }
+
+    EE save_trace(std::string path)
+    {
+        std::ofstream file(path.c_str());
+        if (!file.is_open()) {
+            UNI_WARNING_LOG("can not write profiling trace to %s.\n", path.c_str());
+            return FILE_ERROR;
+        }
+        std::lock_guard<std::mutex> lock(this->mutex);
+        file << "{\"traceEvents\": [";
+        for (U32 i = 0; i < this->records.size(); i++) {
+            const Record &r = this->records[i];
+            file << (i == 0 ? "\n" : ",\n") << "{\"name\": \"" << r.name << "\", \"cat\": \""
+                 << OperatorTypeName()[r.type] << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+                 << r.tid << ", \"ts\": " << std::fixed << r.start * 1000
+                 << ", \"dur\": " << r.duration * 1000 << ", \"args\": {\"flops\": " << r.flops
+                 << ", \"bytes\": " << r.bytes;
+            if (r.algorithm != "") {
+                file << ", \"algorithm\": \"" << r.algorithm << "\"";
+            }
+            file << "}}";
+        }
+        file << "\n], \"displayTimeUnit\": \"ms\"}\n";
+        return SUCCESS;
+    }
+
+    void print_statistics()
+    {
+        struct Statistics {
+            U32 count;
+            double time;
+            double flops;
+            double bytes;
+        };
+        std::map<OperatorType, Statistics> types;
+        double totalTime = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            for (auto &r : this->records) {
+                if (types.find(r.type) == types.end()) {
+                    types[r.type] = {0, 0, 0, 0};
+                }
+                Statistics &s = types[r.type];
+                s.count++;
+                s.time += r.duration;
+                s.flops += r.flops;
+                s.bytes += r.bytes;
+                totalTime += r.duration;
+            }
+        }
+        std::vector<std::pair<OperatorType, Statistics>> vec(types.begin(), types.end());
+        std::sort(vec.begin(), vec.end(),
+            [&](const std::pair<OperatorType, Statistics> &a,
+                const std::pair<OperatorType, Statistics> &b) {
+                return (a.second.time > b.second.time);
+            });
+        printf("\nOperator Statistics:\n");
+        printf("%24s %8s %12s %8s %12s %12s %10s %10s\n", "type", "count", "time(ms)", "ratio",
+            "GFLOP/s", "GB/s", "FLOP/byte", "roofline");
+        for (auto &iter : vec) {
+            Statistics &s = iter.second;
+            double seconds = UNI_MAX(s.time, 1e-6) / 1000;
+            double gflops = s.flops / seconds / 1e9;
+            double gbs = s.bytes / seconds / 1e9;
+            double intensity = (s.bytes > 0) ? s.flops / s.bytes : 0;
+            // compute bound operators are measured against the roofline, the others against the
+            // memory bandwidth
+            double bound = 0, achieved = 0;
+            if (s.flops > 0 && this->peakGFlops > 0) {
+                bound = this->peakGFlops;
+                if (this->peakGBs > 0) {
+                    bound = UNI_MIN(bound, intensity * this->peakGBs);
+                }
+                achieved = gflops;
+            } else if (s.flops == 0 && this->peakGBs > 0) {
+                bound = this->peakGBs;
+                achieved = gbs;
+            }
+            char efficiency[16] = "-";
+            if (bound > 0) {
+                snprintf(efficiency, sizeof(efficiency), "%.1f%%", 100 * achieved / bound);
+            }
+            printf("%24s %8u %12.4lf %7.1lf%% %12.4lf %12.4lf %10.4lf %10s\n",
+                OperatorTypeName()[iter.first], s.count, s.time,
+                100 * s.time / UNI_MAX(totalTime, 1e-6), gflops, gbs, intensity, efficiency);
+        }
+        printf("\n");
+    }
+
+private:
+    struct Record {
+        std::string name;
+        OperatorType type;
+        std::string algorithm;
+        int tid;
+        double start;
+        double duration;
+        double flops;
+        double bytes;
+    };
+
+    bool enabled;
+    double peakGFlops;
+    double peakGBs;
+    std::vector<Record> records;
+    std::mutex mutex;
+};
+#endif  // _OPERATOR_PROFILER_H
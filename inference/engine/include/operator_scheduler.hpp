@@ -0,0 +1,273 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _OPERATOR_SCHEDULER_H
+#define _OPERATOR_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "thread_affinity.h"
+#include "operator_profiler.hpp"
+
+// Runs a straight-line range of operators (no Repeat/Jump inside) as a dependency graph.
+// Two operators depend on each other when they touch overlapping memory and at least one
+// of them writes it, so producer/consumer order and the memory reuse decided by
+// MemoryTracker are both kept. Ready operators are executed by a work-stealing pool, and
+// the thread budget is split between operators of the same graph level by their cost.
+class OperatorScheduler {
+public:
+    OperatorScheduler()
+    {
+        this->start = 0;
+        this->end = 0;
+        this->numWorkers = 1;
+        this->threadNum = 1;
+    }
+
+    void build(std::vector<std::shared_ptr<Operator>> &ops, U32 start, U32 end, int threadNum)
+    {
+        this->start = start;
+        this->end = end;
+        this->threadNum = threadNum;
+        U32 num = end - start;
+        std::vector<std::vector<MemoryRange>> ranges(num);
+        std::vector<double> costs(num, 0);
+        for (U32 i = 0; i < num; i++) {
+            auto op = ops[start + i];
+            std::vector<Tensor> inputs = op->get_input_tensors();
+            std::vector<Tensor> outputs = op->get_output_tensors();
+            for (auto &tensor : inputs) {
+                costs[i] += this->add_range(&ranges[i], tensor, false);
+            }
+            for (auto &tensor : outputs) {
+                costs[i] += this->add_range(&ranges[i], tensor, true);
+            }
+        }
+
+        this->successors.assign(num, std::vector<U32>());
+        this->numDependencies.assign(num, 0);
+        std::vector<U32> levels(num, 0);
+        U32 numLevels = 1;
+        for (U32 i = 0; i < num; i++) {
+            for (U32 j = 0; j < i; j++) {
+                if (this->conflict(ranges[j], ranges[i])) {
+                    this->successors[j].push_back(i);
+                    this->numDependencies[i]++;
+                    levels[i] = UNI_MAX(levels[i], levels[j] + 1);
+                }
+            }
+            numLevels = UNI_MAX(numLevels, levels[i] + 1);
+        }
+
+        std::vector<double> levelCosts(numLevels, 0);
+        std::vector<U32> levelWidths(numLevels, 0);
+        U32 width = 1;
+        for (U32 i = 0; i < num; i++) {
+            levelCosts[levels[i]] += costs[i];
+            levelWidths[levels[i]]++;
+            width = UNI_MAX(width, levelWidths[levels[i]]);
+        }
+        this->numThreads.resize(num);
+        for (U32 i = 0; i < num; i++) {
+            int threads = threadNum;
+            if (levelCosts[levels[i]] > 0) {
+                threads = (int)(threadNum * costs[i] / levelCosts[levels[i]] + 0.5);
+            }
+            this->numThreads[i] = UNI_MAX(1, UNI_MIN(threads, threadNum));
+        }
+        this->numWorkers = UNI_MAX(1, UNI_MIN((int)width, threadNum));
+    }
+
+    U32 get_end()
+    {
+        return this->end;
+    }
+
+    int get_num_workers()
+    {
+        return this->numWorkers;
+    }
+
+    int get_num_threads()
+    {
+        return this->threadNum;
+    }
+
+    // tmpTensors must hold one tmp buffer for each worker
+    void run(std::vector<std::shared_ptr<Operator>> &ops,
+        std::vector<Tensor> &tmpTensors,
+        OperatorProfiler *profiler)
+    {
+        U32 num = this->end - this->start;
+        int workers = this->numWorkers;
+        if (workers == 1) {
+            for (U32 i = this->start; i < this->end; i++) {
+                ops[i]->set_tmp_memory(tmpTensors[0]);
+                ops[i]->set_num_threads(this->threadNum);
+                profiler->run(ops[i].get());
+            }
+            return;
+        }
+        std::vector<std::deque<U32>> queues(workers);
+        std::unique_ptr<std::atomic_flag[]> locks(new std::atomic_flag[workers]);
+        std::unique_ptr<std::atomic<U32>[]> pending(new std::atomic<U32>[num]);
+        std::atomic<U32> remaining(num);
+        // operators waiting in the queues, idle workers sleep on condition while it is 0
+        std::atomic<U32> queued(0);
+        std::mutex mutex;
+        std::condition_variable condition;
+        for (int w = 0; w < workers; w++) {
+            locks[w].clear();
+        }
+        for (U32 i = 0, w = 0; i < num; i++) {
+            pending[i] = this->numDependencies[i];
+            if (this->numDependencies[i] == 0) {
+                queues[w].push_back(i);
+                queued++;
+                w = (w + 1) % workers;
+            }
+        }
+#ifdef _USE_OPENMP
+        int maxActiveLevels = omp_get_max_active_levels();
+        omp_set_max_active_levels(2);
+#pragma omp parallel num_threads(workers)
+#endif
+        {
+#ifdef _USE_OPENMP
+            int worker = omp_get_thread_num();
+#else
+            int worker = 0;
+#endif
+            int spins = 0;
+            while (remaining > 0) {
+                U32 id;
+                if (!this->pop(queues, locks.get(), worker, &id)) {
+                    if (++spins < 64) {
+                        std::this_thread::yield();
+                    } else {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [&] { return queued > 0 || remaining == 0; });
+                        spins = 0;
+                    }
+                    continue;
+                }
+                spins = 0;
+                queued--;
+                auto op = ops[this->start + id];
+                op->set_tmp_memory(tmpTensors[worker]);
+                op->set_num_threads(this->numThreads[id]);
+                {
+                    ThreadContextGuard context(this->numThreads[id]);
+                    profiler->run(op.get());
+                }
+                bool wake = false;
+                for (U32 next : this->successors[id]) {
+                    if (--pending[next] == 0) {
+                        this->push(&queues[worker], &locks[worker], next);
+                        queued++;
+                        wake = true;
+                    }
+                }
+                if (--remaining == 0 || wake) {
+                    // taking the mutex orders the wake up after a sleeper's last check
+                    std::lock_guard<std::mutex> lock(mutex);
+                    condition.notify_all();
+                }
+            }
+        }
+#ifdef _USE_OPENMP
+        omp_set_max_active_levels(maxActiveLevels);
+#endif
+    }
+
+private:
+    struct MemoryRange {
+        uintptr_t begin;
+        uintptr_t end;
+        bool write;
+    };
+
+    double add_range(std::vector<MemoryRange> *ranges, Tensor &tensor, bool write)
+    {
+        U32 bytes = tensor.bytes();
+        if (tensor.get_mem_type() != CPUMem || bytes == 0) {
+            return 0;
+        }
+        uintptr_t ptr = (uintptr_t)((CpuMemory *)tensor.get_memory())->get_ptr();
+        if (ptr != 0) {
+            MemoryRange range = {ptr, ptr + bytes, write};
+            ranges->push_back(range);
+        }
+        return bytes;
+    }
+
+    bool conflict(std::vector<MemoryRange> &a, std::vector<MemoryRange> &b)
+    {
+        for (auto &x : a) {
+            for (auto &y : b) {
+                if ((x.write || y.write) && x.begin < y.end && y.begin < x.end) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void push(std::deque<U32> *queue, std::atomic_flag *lock, U32 id)
+    {
+        while (lock->test_and_set(std::memory_order_acquire)) {
+        }
+        queue->push_back(id);
+        lock->clear(std::memory_order_release);
+    }
+
+    // take the newest operator of our own queue, otherwise steal the oldest one of others
+    bool pop(std::vector<std::deque<U32>> &queues, std::atomic_flag *locks, int worker, U32 *id)
+    {
+        int workers = queues.size();
+        for (int i = 0; i < workers; i++) {
+            int w = (worker + i) % workers;
+            bool found = false;
+            while (locks[w].test_and_set(std::memory_order_acquire)) {
+            }
+            if (!queues[w].empty()) {
+                if (w == worker) {
+                    *id = queues[w].back();
+                    queues[w].pop_back();
+                } else {
+                    *id = queues[w].front();
+                    queues[w].pop_front();
+                }
+                found = true;
+            }
+            locks[w].clear(std::memory_order_release);
+            if (found) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    U32 start;
+    U32 end;
+    int numWorkers;
+    int threadNum;
+    std::vector<std::vector<U32>> successors;
+    std::vector<U32> numDependencies;
+    std::vector<int> numThreads;
+};
+#endif  // _OPERATOR_SCHEDULER_H
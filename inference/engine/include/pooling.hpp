@@ -29,6 +29,15 @@ public:
         return OT_Pooling;
     }
 
+    double get_flops() override
+    {
+        if (this->outputTensors.size() == 0) {
+            return 0;
+        }
+        double kernel = 1.0 * UNI_MAX(1, this->p.kernel_t) * this->p.kernel_h * this->p.kernel_w;
+        return kernel * tensorNumElements(this->outputTensors[0].get_desc());
+    }
+
     void set_kernelSize(U32 globalKernelSizeH, U32 globalKernelSizeW)
     {
         this->p.kernel_h = globalKernelSizeH;
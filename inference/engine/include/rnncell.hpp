@@ -30,6 +30,33 @@ public:
         return OT_RNN;
     }
 
+    // keep the final state of a run inside the operator and start the next run from it, so that
+    // a sequence can be fed chunk by chunk
+    virtual EE set_streaming(bool streaming)
+    {
+        UNUSED(streaming);
+        return NOT_SUPPORTED;
+    }
+
+    virtual void reset_state()
+    {}
+
+    // bytes of the state kept in streaming mode
+    virtual U32 get_state_bytes()
+    {
+        return 0;
+    }
+
+    virtual void save_state(U8 *state)
+    {
+        UNUSED(state);
+    }
+
+    virtual void load_state(const U8 *state)
+    {
+        UNUSED(state);
+    }
+
 public:
     RNNParamSpec p;
     U32 xDim;
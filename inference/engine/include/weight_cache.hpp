@@ -0,0 +1,306 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _WEIGHT_CACHE_H
+#define _WEIGHT_CACHE_H
+
+#include <cctype>
+#include <map>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "tensor.hpp"
+
+// Sidecar file of weights that are already transformed for the selected algorithms. A cache
+// belongs to one model content, arch and data type, and every entry additionally records the
+// algorithm and input shapes its weights were transformed for. A later load maps the file
+// privately and hands out tensors that point into the mapping, so neither the transform nor a
+// copy of the original weights is needed.
+class WeightCache {
+public:
+    WeightCache()
+    {
+        this->modelHash = 0;
+        this->arch = CPU_GENERAL;
+        this->dt = DT_F32;
+        this->dirty = false;
+    }
+
+    static U64 hash(const U8 *data, size_t bytes, U64 seed = 0xcbf29ce484222325ULL)
+    {
+        U64 h = seed ^ bytes;
+        size_t i = 0;
+        for (; i + sizeof(U64) <= bytes; i += sizeof(U64)) {
+            U64 v;
+            memcpy(&v, data + i, sizeof(U64));
+            h = (h ^ v) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+        }
+        for (; i < bytes; i++) {
+            h = (h ^ data[i]) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    bool enabled()
+    {
+        return this->path != "";
+    }
+
+    void init(std::string directory, std::string modelName, Arch arch, DataType dt, U64 modelHash)
+    {
+        for (U32 i = 0; i < modelName.size(); i++) {
+            if (!isalnum(modelName[i])) {
+                modelName[i] = '_';
+            }
+        }
+        if (directory != "" && directory[directory.length() - 1] != '/') {
+            directory += "/";
+        }
+        this->path = directory + "weightCache_" + modelName + "_" + std::to_string(arch) + "_" +
+            std::to_string(dt) + ".bin";
+        this->arch = arch;
+        this->dt = dt;
+        this->modelHash = modelHash;
+        this->entries.clear();
+        this->dirty = false;
+        this->load();
+    }
+
+    // get the transformed tensors of an operator, fail if they were transformed for another key
+    bool get(std::string name, std::string key, std::vector<Tensor> *tensors)
+    {
+        if (this->entries.find(name) == this->entries.end() || this->entries[name].key != key) {
+            this->dirty = true;
+            return false;
+        }
+        *tensors = this->entries[name].tensors;
+        return true;
+    }
+
+    void set(std::string name, std::string key, std::vector<Tensor> tensors)
+    {
+        Entry entry;
+        entry.key = key;
+        entry.tensors = tensors;
+        this->entries[name] = entry;
+    }
+
+    // rewrite the file when any operator missed the cache, the old mapping stays valid
+    EE save()
+    {
+        if (!this->enabled() || !this->dirty) {
+            return SUCCESS;
+        }
+        std::string tmpPath = this->path + ".tmp";
+        FILE *file = fopen(tmpPath.c_str(), "wb");
+        if (file == NULL) {
+            UNI_WARNING_LOG("can not write weight cache %s.\n", tmpPath.c_str());
+            return FILE_ERROR;
+        }
+        std::string table;
+        U64 offset = 0;
+        std::vector<std::pair<const U8 *, U64>> blobs;
+        for (auto &iter : this->entries) {
+            append_string(&table, iter.first);
+            append_string(&table, iter.second.key);
+            append(&table, (U32)iter.second.tensors.size());
+            for (auto tensor : iter.second.tensors) {
+                CpuMemory *mem = (CpuMemory *)tensor.get_memory();
+                U32 capacity = 0;
+                mem->capacity(&capacity);
+                U64 bytes = UNI_MAX(tensor.bytes(), capacity);
+                append(&table, tensor.get_desc());
+                append(&table, tensor.get_scale());
+                append(&table, offset);
+                append(&table, bytes);
+                blobs.push_back(std::make_pair((const U8 *)mem->get_ptr(), bytes));
+                offset += align(bytes);
+            }
+        }
+        Header header;
+        header.magic = magicNumber;
+        header.version = version;
+        header.modelHash = this->modelHash;
+        header.arch = this->arch;
+        header.dt = this->dt;
+        header.numEntries = this->entries.size();
+        header.tableBytes = table.size();
+        header.dataOffset = align(sizeof(Header) + table.size());
+        bool ok = fwrite(&header, sizeof(Header), 1, file) == 1 &&
+            fwrite(table.data(), 1, table.size(), file) == table.size();
+        U64 pos = sizeof(Header) + table.size();
+        std::vector<U8> padding((size_t)alignment, 0);
+        for (U32 i = 0; ok && i < blobs.size(); i++) {
+            U64 start = align(pos);
+            ok = fwrite(padding.data(), 1, start - pos, file) == start - pos &&
+                fwrite(blobs[i].first, 1, blobs[i].second, file) == blobs[i].second;
+            pos = start + blobs[i].second;
+        }
+        fclose(file);
+        if (!ok || rename(tmpPath.c_str(), this->path.c_str()) != 0) {
+            UNI_WARNING_LOG("can not write weight cache %s.\n", this->path.c_str());
+            remove(tmpPath.c_str());
+            return FILE_ERROR;
+        }
+        UNI_DEBUG_LOG("write %d operators to weight cache %s.\n", (int)this->entries.size(),
+            this->path.c_str());
+        this->dirty = false;
+        return SUCCESS;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        std::vector<Tensor> tensors;
+    };
+
+#pragma pack(8)
+    struct Header {
+        U32 magic;
+        U32 version;
+        U64 modelHash;
+        I32 arch;
+        I32 dt;
+        U32 numEntries;
+        U32 tableBytes;
+        U64 dataOffset;
+    };
+#pragma pack()
+
+    template <typename T>
+    static void append(std::string *table, T value)
+    {
+        table->append((const char *)&value, sizeof(T));
+    }
+
+    static void append_string(std::string *table, std::string value)
+    {
+        append(table, (U32)value.size());
+        table->append(value);
+    }
+
+    template <typename T>
+    static bool read(const U8 **ptr, const U8 *end, T *value)
+    {
+        if (*ptr + sizeof(T) > end) {
+            return false;
+        }
+        memcpy(value, *ptr, sizeof(T));
+        *ptr += sizeof(T);
+        return true;
+    }
+
+    static bool read_string(const U8 **ptr, const U8 *end, std::string *value)
+    {
+        U32 length;
+        if (!read(ptr, end, &length) || *ptr + length > end) {
+            return false;
+        }
+        *value = std::string((const char *)*ptr, length);
+        *ptr += length;
+        return true;
+    }
+
+    static U64 align(U64 bytes)
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    void load()
+    {
+        this->dirty = true;
+#ifndef _WIN32
+        int fd = open(this->path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            UNI_DEBUG_LOG("weight cache %s does not exist.\n", this->path.c_str());
+            return;
+        }
+        struct stat ss;
+        if (fstat(fd, &ss) == -1 || (size_t)ss.st_size < sizeof(Header)) {
+            close(fd);
+            return;
+        }
+        size_t fileLength = ss.st_size;
+        // private writable mapping, kernels that touch weights in place never reach the file
+        U8 *bytes = (U8 *)mmap(nullptr, fileLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (bytes == MAP_FAILED) {
+            UNI_WARNING_LOG("can not map weight cache %s.\n", this->path.c_str());
+            return;
+        }
+        std::shared_ptr<U8> file(bytes, [fileLength](U8 *ptr) { munmap(ptr, fileLength); });
+        Header header;
+        memcpy(&header, bytes, sizeof(Header));
+        if (header.magic != magicNumber || header.version != version ||
+            header.modelHash != this->modelHash || header.arch != this->arch ||
+            header.dt != this->dt || header.dataOffset > fileLength) {
+            UNI_DEBUG_LOG("weight cache %s is stale.\n", this->path.c_str());
+            return;
+        }
+        const U8 *ptr = bytes + sizeof(Header);
+        const U8 *end = bytes + UNI_MIN(sizeof(Header) + header.tableBytes, fileLength);
+        std::map<std::string, Entry> entries;
+        for (U32 i = 0; i < header.numEntries; i++) {
+            std::string name;
+            Entry entry;
+            U32 num;
+            if (!read_string(&ptr, end, &name) || !read_string(&ptr, end, &entry.key) ||
+                !read(&ptr, end, &num)) {
+                return;
+            }
+            for (U32 j = 0; j < num; j++) {
+                TensorDesc desc;
+                F32 scale;
+                U64 offset, size;
+                if (!read(&ptr, end, &desc) || !read(&ptr, end, &scale) ||
+                    !read(&ptr, end, &offset) || !read(&ptr, end, &size) ||
+                    header.dataOffset + offset + size > fileLength || tensorNumBytes(desc) > size) {
+                    return;
+                }
+                Tensor tensor;
+                tensor.resize(desc);
+                ((CpuMemory *)tensor.get_memory())
+                    ->set_shared_ptr(
+                        std::shared_ptr<U8>(file, bytes + header.dataOffset + offset));
+                tensor.set_scale(scale);
+                entry.tensors.push_back(tensor);
+            }
+            entries[name] = entry;
+        }
+        this->entries = entries;
+        this->dirty = false;
+        UNI_DEBUG_LOG(
+            "map %d operators from weight cache %s.\n", (int)entries.size(), this->path.c_str());
+#endif
+    }
+
+    static const U32 magicNumber = 0x62776331;
+    static const U32 version = 1;
+    static const U64 alignment = 64;
+
+    std::string path;
+    Arch arch;
+    DataType dt;
+    U64 modelHash;
+    std::map<std::string, Entry> entries;
+    bool dirty;
+};
+
+#endif  // _WEIGHT_CACHE_H
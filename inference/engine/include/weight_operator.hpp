@@ -31,6 +31,7 @@ public:
         this->ws.bytes_of_vec = 0;
         this->ws.vec = nullptr;
         this->wtmType = CPUMem;
+        this->modelFileLength = 0;
     }
 
     bool is_weight() override
@@ -108,6 +109,14 @@ public:
         return this->ws;
     }
 
+    // the mapped model file outlives the model spec, aligned weights inside it are used in place
+    // and only paged in when they are touched
+    void set_model_file(std::shared_ptr<U8> file, U64 length)
+    {
+        this->modelFile = file;
+        this->modelFileLength = length;
+    }
+
     virtual void set_hasBias(bool hasBiasOrNot)
     {
         this->hasBias = hasBiasOrNot;
@@ -136,30 +145,48 @@ public:
         }
 
         std::set<OperatorType> weightReuseSet = {OT_Conv, OT_FC, OT_Deconvolution, OT_RNN};
-        U32 weight_offset = 0;
+        U64 weight_offset = 0;
         for (auto weight_tensor : this->weightTensors) {
             TensorDesc desc = weight_tensor.get_desc();
             auto weight_mem_dst = weight_tensor.get_memory();
             weight_mem_src.resize(desc);
-            weight_mem_src.set_shared_ptr(
-                std::shared_ptr<U8>(weight_ptr, weight_ptr.get() + weight_offset));
-            if (weightReuseSet.count(this->get_type())) {
+            std::shared_ptr<U8> mapped;
+            if (modelPtr == nullptr && weight_mem_dst->get_mem_type() == CPUMem) {
+                mapped = this->get_model_file_memory(weight_ptr.get() + weight_offset);
+            }
+            if (mapped != nullptr) {
+                weight_mem_src.set_shared_ptr(mapped);
+                weight_mem_dst->reuse(&weight_mem_src);
+            } else if (weightReuseSet.count(this->get_type())) {
+                weight_mem_src.set_shared_ptr(
+                    std::shared_ptr<U8>(weight_ptr, weight_ptr.get() + weight_offset));
                 weight_mem_dst->reuse(&weight_mem_src);
             } else {
+                weight_mem_src.set_shared_ptr(
+                    std::shared_ptr<U8>(weight_ptr, weight_ptr.get() + weight_offset));
                 weight_mem_dst->copy_from(&weight_mem_src);
             }
             weight_offset += tensorNumBytes(desc);
         }
 
-        U32 bias_offset = (modelPtr != nullptr) ? weight_offset : 0;
+        U64 bias_offset = (modelPtr != nullptr) ? weight_offset : 0;
         if (this->hasBias) {
             for (auto bias_tensor : this->biasTensors) {
                 TensorDesc desc = bias_tensor.get_desc();
                 auto bias_mem_dst = bias_tensor.get_memory();
                 bias_mem_src.resize(desc);
-                bias_mem_src.set_shared_ptr(
-                    std::shared_ptr<U8>(bias_ptr, bias_ptr.get() + bias_offset));
-                bias_mem_dst->copy_from(&bias_mem_src);
+                std::shared_ptr<U8> mapped;
+                if (modelPtr == nullptr && bias_mem_dst->get_mem_type() == CPUMem) {
+                    mapped = this->get_model_file_memory(bias_ptr.get() + bias_offset);
+                }
+                if (mapped != nullptr) {
+                    bias_mem_src.set_shared_ptr(mapped);
+                    bias_mem_dst->reuse(&bias_mem_src);
+                } else {
+                    bias_mem_src.set_shared_ptr(
+                        std::shared_ptr<U8>(bias_ptr, bias_ptr.get() + bias_offset));
+                    bias_mem_dst->copy_from(&bias_mem_src);
+                }
                 bias_offset += tensorNumBytes(desc);
             }
         } else {
@@ -183,6 +210,58 @@ public:
     {
         return SUCCESS;
     }
+
+    // whether transform_filter() does real work, so that its result is worth a weight cache entry
+    virtual bool is_weight_cacheable()
+    {
+        return false;
+    }
+
+    // everything transform_filter() depends on besides the model weights
+    virtual std::string get_weight_cache_key()
+    {
+        std::string key = "dt:" + std::to_string(this->dt);
+        for (auto tensor : this->inputTensors) {
+            key += " input(" + tensorDesc2Str(tensor.get_desc()) + ")";
+        }
+        for (auto tensor : this->weightTensors) {
+            key += " weight(" + tensorDesc2Str(tensor.get_desc()) + ")";
+        }
+        return key;
+    }
+
+    double get_bytes() override
+    {
+        double bytes = Operator::get_bytes();
+        for (auto &tensor : this->weightTensors) {
+            bytes += tensor.bytes();
+        }
+        for (auto &tensor : this->biasTensors) {
+            bytes += tensor.bytes();
+        }
+        return bytes;
+    }
+
+    // tensors that completely describe the weights after transform_filter()
+    virtual std::vector<Tensor> get_transformed_weights()
+    {
+        std::vector<Tensor> tensors = this->weightTensors;
+        tensors.insert(tensors.end(), this->biasTensors.begin(), this->biasTensors.end());
+        return tensors;
+    }
+
+    // use the result of an earlier transform_filter() instead of running it, the number of bias
+    // tensors never changes during the transform
+    virtual EE set_transformed_weights(std::vector<Tensor> tensors)
+    {
+        if (tensors.size() < this->biasTensors.size()) {
+            return NOT_MATCH;
+        }
+        U32 num = tensors.size() - this->biasTensors.size();
+        this->weightTensors.assign(tensors.begin(), tensors.begin() + num);
+        this->biasTensors.assign(tensors.begin() + num, tensors.end());
+        return SUCCESS;
+    }
 #ifdef _USE_GPU
     virtual EE set_wtm_image(TensorDesc desc, std::shared_ptr<Tensor> *targetWtm = nullptr)
     {
@@ -206,6 +285,18 @@ public:
 #endif
 
 protected:
+    // memory at ptr if it lies in the mapped model file and kernels can use it in place
+    std::shared_ptr<U8> get_model_file_memory(U8 *ptr)
+    {
+        std::shared_ptr<U8> ret;
+        if (this->modelFile != nullptr && ptr >= this->modelFile.get() &&
+            ptr < this->modelFile.get() + this->modelFileLength &&
+            uintptr_t(ptr) % sg_weightAlignment == 0) {
+            ret = std::shared_ptr<U8>(this->modelFile, ptr);
+        }
+        return ret;
+    }
+
     std::vector<Tensor> weightTensors;
     std::vector<Tensor> biasTensors;
     bool hasBias;
@@ -214,6 +305,8 @@ protected:
     std::shared_ptr<Tensor> wtm;
     MemoryType wtmType;
     WeightSpec ws;
+    std::shared_ptr<U8> modelFile;
+    U64 modelFileLength;
 };
 
 #endif  // _WEIGHTOPERATOR_H
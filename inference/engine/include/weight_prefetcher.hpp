@@ -0,0 +1,115 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _WEIGHT_PREFETCHER_H
+#define _WEIGHT_PREFETCHER_H
+
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "weight_operator.hpp"
+
+// Asks the kernel to read the weights of the following operators while the current one runs, so
+// that weights mapped from a file are paged in ahead of execution instead of faulting page by
+// page. Every range is only requested once, resident weights cost nothing after that.
+class WeightPrefetcher {
+public:
+    WeightPrefetcher()
+    {
+        this->clear();
+    }
+
+    void clear()
+    {
+        this->ranges.clear();
+        this->issued = 0;
+        this->consumed = 0;
+        this->inFlight = 0;
+    }
+
+    // operators have to be added in the order of execution
+    void add(U32 opIndex, WeightOperator *op)
+    {
+        std::vector<Tensor> tensors = op->get_weight_tensors();
+        std::vector<Tensor> biasTensors = op->get_bias_tensors();
+        tensors.insert(tensors.end(), biasTensors.begin(), biasTensors.end());
+        for (auto tensor : tensors) {
+            auto mem = tensor.get_memory();
+            if (mem->get_mem_type() != CPUMem || tensor.bytes() < minBytes) {
+                continue;
+            }
+            Range range;
+            range.opIndex = opIndex;
+            range.ptr = (U8 *)((CpuMemory *)mem)->get_ptr();
+            range.bytes = tensor.bytes();
+            if (range.ptr != nullptr) {
+                this->ranges.push_back(range);
+            }
+        }
+    }
+
+    // called before operator opIndex runs, keeps up to window bytes of later weights requested
+    void prefetch(U32 opIndex)
+    {
+        if (this->issued >= this->ranges.size()) {
+            return;
+        }
+        while (this->consumed < this->ranges.size() &&
+            this->ranges[this->consumed].opIndex < opIndex) {
+            if (this->consumed < this->issued) {
+                this->inFlight -= this->ranges[this->consumed].bytes;
+            }
+            this->consumed++;
+        }
+        if (this->issued < this->consumed) {
+            this->issued = this->consumed;
+        }
+        while (this->issued < this->ranges.size() &&
+            (this->inFlight < window || this->ranges[this->issued].opIndex == opIndex)) {
+            advise(this->ranges[this->issued]);
+            this->inFlight += this->ranges[this->issued].bytes;
+            this->issued++;
+        }
+    }
+
+private:
+    typedef struct {
+        U32 opIndex;
+        U8 *ptr;
+        U64 bytes;
+    } Range;
+
+    static void advise(const Range &range)
+    {
+#ifndef _WIN32
+        uintptr_t page = sysconf(_SC_PAGESIZE);
+        uintptr_t start = uintptr_t(range.ptr) / page * page;
+        uintptr_t end = uintptr_t(range.ptr) + range.bytes;
+        // only a hint, a failure just leaves the pages to be faulted in on use
+        madvise((void *)start, end - start, MADV_WILLNEED);
+#endif
+    }
+
+    static const U64 minBytes = 64 * 1024;
+    static const U64 window = 64 * 1024 * 1024;
+
+    std::vector<Range> ranges;
+    U32 issued;
+    U32 consumed;
+    U64 inFlight;
+};
+
+#endif  // _WEIGHT_PREFETCHER_H
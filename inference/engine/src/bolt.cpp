@@ -11,18 +11,25 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include "inference.hpp"
 #include "../api/c/bolt.h"
 
 #define NAME_VALUE_PAIR(x) #x, x
 const int DataDescMaxDims = 8;
 
+struct AsyncWorker;
+
 struct ModelHandleInner {
     void *ms;
     void *cnn;
     DEVICE_TYPE deviceType;
     void *algoPath;
     bool useFileStream;
+    AsyncWorker *worker;
 };
 
 typedef struct DataDesc {
@@ -39,6 +46,29 @@ typedef struct {
     DEVICE_TYPE deviceType;
 } ResultHandleInner;
 
+struct RunHandleInner {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done = false;
+};
+
+struct AsyncRequest {
+    ResultHandle ir;
+    std::vector<std::string> names;
+    std::vector<void *> data;
+    int threads;
+    RunHandleInner *handle;
+};
+
+// one thread per model runs the asynchronous inferences in the order they are submitted
+struct AsyncWorker {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::queue<AsyncRequest> requests;
+    bool stop = false;
+};
+
 inline DataType DATA_TYPE2DataType(DATA_TYPE dt_user)
 {
     DataType ret = DT_F32;
@@ -232,6 +262,7 @@ inline DEVICE_TYPE Arch2DEVICE_TYPE(Arch arch)
             ret = CPU_SERIAL;
             break;
         case X86_AVX512:
+        case X86_AVX512_VNNI:
             ret = CPU_X86_AVX512;
             break;
         default: {
@@ -310,6 +341,7 @@ ModelHandle CloneModel(ModelHandle ih)
     assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
     ModelHandleInner *cloneHandle = new ModelHandleInner();
     *cloneHandle = *handle;
+    cloneHandle->worker = nullptr;
     CNN *cloneCnn = new CNN();
     *cloneCnn = cnn->clone();
     cloneHandle->cnn = cloneCnn;
@@ -665,6 +697,139 @@ void SetNumThreads(int threadNum)
     UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
 }
 
+void SetModelNumThreads(ModelHandle ih, int threadNum)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    cnn->set_num_threads(threadNum);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void SetParallelOperators(ModelHandle ih, int enable)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    cnn->set_parallel_operators(enable != 0);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void SetKVCache(ModelHandle ih, int capacity)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    if (capacity <= 0) {
+        UNI_ERROR_LOG("C API %s received capacity %d <= 0.\n", __FUNCTION__, capacity);
+        return;
+    }
+    cnn->set_kv_cache(capacity);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void ResetKVCache(ModelHandle ih)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    cnn->reset_kv_cache();
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void TruncateKVCache(ModelHandle ih, int length)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    if (length < 0) {
+        UNI_ERROR_LOG("C API %s received length %d < 0.\n", __FUNCTION__, length);
+        return;
+    }
+    cnn->truncate_kv_cache(length);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+int GetKVCacheLength(ModelHandle ih)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    int length = cnn->get_kv_cache_length();
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+    return length;
+}
+
+void SetStreaming(ModelHandle ih, int enable)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    cnn->set_streaming(enable != 0);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void ResetStreamingState(ModelHandle ih)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    cnn->reset_streaming_state();
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+int GetStreamingStateSize(ModelHandle ih)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    int bytes = cnn->get_streaming_state_bytes();
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+    return bytes;
+}
+
+void SaveStreamingState(ModelHandle ih, void *state)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    assert_not_nullptr(__FUNCTION__, "state", state);
+    cnn->save_streaming_state((U8 *)state);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+void LoadStreamingState(ModelHandle ih, const void *state)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    assert_not_nullptr(__FUNCTION__, "state", state);
+    cnn->load_streaming_state((const U8 *)state);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
 void RunModel(ModelHandle ih, ResultHandle ir, int num_inputs, const char **name, void **data)
 {
     UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
@@ -718,6 +883,117 @@ void RunModel(ModelHandle ih, ResultHandle ir, int num_inputs, const char **name
     UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
 }
 
+void BindModelInputOutput(ModelHandle ih,
+    int num_inputs,
+    const char **input_names,
+    void **input_data,
+    int num_outputs,
+    const char **output_names,
+    void **output_data)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ihInfo);
+    CNN *cnn = (CNN *)ihInfo->cnn;
+    assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
+    if (num_inputs > 0) {
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(input_names));
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(input_data));
+    }
+    if (num_outputs > 0) {
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(output_names));
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(output_data));
+    }
+    std::map<std::string, std::shared_ptr<U8>> input, output;
+    for (int index = 0; index < num_inputs; index++) {
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(input_data[index]));
+        input[input_names[index]] = std::shared_ptr<U8>((U8 *)input_data[index], [](U8 *ptr) {});
+    }
+    for (int index = 0; index < num_outputs; index++) {
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(output_data[index]));
+        output[output_names[index]] =
+            std::shared_ptr<U8>((U8 *)output_data[index], [](U8 *ptr) {});
+    }
+    cnn->bind_input_output(input, output);
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
+static void RunAsyncRequests(ModelHandle ih, AsyncWorker *worker)
+{
+    while (1) {
+        AsyncRequest request;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->cond.wait(lock, [worker] { return worker->stop || !worker->requests.empty(); });
+            if (worker->requests.empty()) {
+                break;
+            }
+            request = worker->requests.front();
+            worker->requests.pop();
+        }
+        {
+            ThreadContextGuard threadContext(request.threads);
+            std::vector<const char *> names;
+            for (auto &str : request.names) {
+                names.push_back(str.c_str());
+            }
+            RunModel(ih, request.ir, request.names.size(), names.data(), request.data.data());
+        }
+        RunHandleInner *handle = request.handle;
+        {
+            std::lock_guard<std::mutex> lock(handle->mutex);
+            handle->done = true;
+        }
+        handle->cond.notify_all();
+    }
+}
+
+RunHandle RunModelAsync(
+    ModelHandle ih, ResultHandle ir, int num_inputs, const char **name, void **data)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    assert_not_nullptr(__FUNCTION__, "ModelHandle", ih);
+    assert_not_nullptr(__FUNCTION__, "ResultHandle", ir);
+    if (num_inputs > 0) {
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(name));
+        assert_not_nullptr(__FUNCTION__, NAME_VALUE_PAIR(data));
+    }
+    ModelHandleInner *ihInfo = (ModelHandleInner *)ih;
+    AsyncRequest request;
+    request.ir = ir;
+    request.names = std::vector<std::string>(name, name + num_inputs);
+    request.data = std::vector<void *>(data, data + num_inputs);
+    // the worker keeps the parallel threads num of the calling thread
+    request.threads = OMP_NUM_THREADS;
+    request.handle = new RunHandleInner();
+    if (ihInfo->worker == nullptr) {
+        AsyncWorker *worker = new AsyncWorker();
+        worker->thread = std::thread(RunAsyncRequests, ih, worker);
+        ihInfo->worker = worker;
+    }
+    AsyncWorker *worker = ihInfo->worker;
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->requests.push(request);
+    }
+    worker->cond.notify_one();
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+    return (RunHandle)request.handle;
+}
+
+void WaitRunModel(RunHandle rh)
+{
+    UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
+    RunHandleInner *handle = (RunHandleInner *)rh;
+    assert_not_nullptr(__FUNCTION__, "RunHandle", handle);
+    {
+        std::unique_lock<std::mutex> lock(handle->mutex);
+        handle->cond.wait(lock, [handle] { return handle->done; });
+    }
+    delete handle;
+    UNI_DEBUG_LOG("C API %s end.\n", __FUNCTION__);
+}
+
 int GetNumOutputsFromResultHandle(ResultHandle ir)
 {
     UNI_DEBUG_LOG("C API %s...\n", __FUNCTION__);
@@ -838,6 +1114,19 @@ void DestroyModel(ModelHandle ih)
     CNN *cnn = (CNN *)ihInfo->cnn;
     assert_not_nullptr(__FUNCTION__, "ModelHandle.cnn", cnn);
 
+    // finish the queued asynchronous inferences
+    AsyncWorker *worker = ihInfo->worker;
+    if (worker != nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stop = true;
+        }
+        worker->cond.notify_one();
+        worker->thread.join();
+        delete worker;
+        ihInfo->worker = nullptr;
+    }
+
     if (nullptr != ihInfo->algoPath && !ihInfo->useFileStream) {
         const char *algoPath = (const char *)ihInfo->algoPath;
         UNI_THREAD_SAFE(cnn->saveAlgorithmMapToFile(algoPath));
@@ -14,11 +14,14 @@
 #include "cnn.h"
 #ifdef _USE_CPU
 #include "cpu/factory_cpu.hpp"
+#include "cpu/transform_format_cpu.hpp"
 #endif
 #ifdef _USE_GPU
 #include "ocl/factory_ocl.hpp"
 #endif
 #include "profiling.h"
+#include "concat.hpp"
+#include "rnncell.hpp"
 
 bool is_same_tensor(Tensor a, Tensor b)
 {
@@ -36,6 +39,11 @@ bool is_same_tensor(Tensor a, Tensor b)
 CNN CNN::clone()
 {
     CNN cnn = *this;
+    cnn.kvCache.clone_buffers();
+    // caller buffers belong to this model only
+    cnn.boundBuffers.clear();
+    cnn.boundBytes.clear();
+    cnn.ownBuffers.clear();
     for (U32 i = 0; i < cnn.ops.size(); i++) {
         cnn.ops[i] = cnn.ops[i]->clone();
         cnn.operatorMap[cnn.ops[i]->get_name()] = cnn.ops[i];
@@ -51,6 +59,7 @@ CNN CNN::clone()
     }
     cnn.infer_output_tensors_size(inputDescMap);
     cnn.assign_output_tensor();
+    cnn.workerTmpTensors.clear();
     cnn.tmpTensor = cnn.tmpTensor.clone();
     cnn.infer_tmp_memory_size();
     cnn.tmpTensor.alloc();
@@ -203,11 +212,25 @@ void CNN::initialize_ops(const ModelSpec *ms)
         this->set_op_tensors_positions(
             op, curOps.tensor_positions, inputTensorsName, outputTensorsName);
         op->set_schedule(this->deviceInfo.schedule);
+        op->set_num_threads(this->numThreads);
         op->init_feature_scale(curOps.num_quant_feature, curOps.feature_scale);
         op->set_algorithm_map(this->algorithmMap);
         this->ops.push_back(op);
     }
 
+    char *weightCacheDirectory = getenv("BOLT_WEIGHT_CACHE_DIRECTORY");
+    if (weightCacheDirectory != NULL && IS_CPU(this->deviceInfo.schedule)) {
+        this->set_weight_cache(weightCacheDirectory, ms);
+    }
+
+    // keep the model file after the model spec is destroyed, so that weights are used in place
+    // and paged in on demand rather than copied up front
+    U64 modelFileLength = 0;
+    if (IS_CPU(this->deviceInfo.schedule) && ms->mfd != nullptr) {
+        this->modelFile = mt_detach_model_file(ms->mfd);
+        modelFileLength = ms->mfd->fileLength;
+    }
+
     // setup WeightSpec ptr in WeightOperator
     for (int i = 0; i < ms->num_weight_specs; i++) {
         WeightSpec curOpWs = ms->ws[i];
@@ -219,6 +242,9 @@ void CNN::initialize_ops(const ModelSpec *ms)
         auto op = this->operatorMap[opName];
         auto weightOp = dynamic_cast<WeightOperator *>(op.get());
         weightOp->set_weightspec_ptr(curOpWs);
+        if (this->modelFile != nullptr) {
+            weightOp->set_model_file(this->modelFile, modelFileLength);
+        }
         if (curOpWs.bytes_of_vec != 0) {
             CHECK_REQUIREMENT(curOpWs.vec != nullptr);
             weightOp->set_hasBias(true);
@@ -227,9 +253,99 @@ void CNN::initialize_ops(const ModelSpec *ms)
     UNI_DEBUG_LOG("Initialize inference end.\n");
 }
 
+void CNN::set_weight_cache(std::string directory, const ModelSpec *ms)
+{
+    if (!IS_CPU(this->deviceInfo.schedule)) {
+        UNI_WARNING_LOG("weight cache is only supported on CPU.\n");
+        return;
+    }
+    U64 hash = 0;
+    bool hashed = false;
+#ifndef _WIN32
+    struct stat ss;
+    if (ms->mfd != nullptr && !ms->mfd->useFileStream && ms->mfd->fd != -1 &&
+        fstat(ms->mfd->fd, &ss) == 0) {
+        // identify a mapped model by its file, hashing the content would page in all weights
+        U64 id[4] = {(U64)ss.st_dev, (U64)ss.st_ino, (U64)ss.st_size, (U64)ss.st_mtime};
+        hash = WeightCache::hash((const U8 *)id, sizeof(id));
+        for (int i = 0; i < ms->num_weight_specs; i++) {
+            WeightSpec ws = ms->ws[i];
+            U64 bytes[2] = {ws.bytes_of_weight, ws.bytes_of_vec};
+            hash = WeightCache::hash((const U8 *)ws.op_name, NAME_LEN, hash);
+            hash = WeightCache::hash((const U8 *)bytes, sizeof(bytes), hash);
+        }
+        hashed = true;
+    }
+#endif
+    if (!hashed && ms->mfd != nullptr && ms->mfd->bytes != nullptr) {
+        hash = WeightCache::hash((const U8 *)ms->mfd->bytes, ms->mfd->fileLength);
+    } else if (!hashed) {
+        hash = WeightCache::hash((const U8 *)ms->model_name, NAME_LEN);
+        for (int i = 0; i < ms->num_weight_specs; i++) {
+            WeightSpec ws = ms->ws[i];
+            hash = WeightCache::hash((const U8 *)ws.op_name, NAME_LEN, hash);
+            hash = WeightCache::hash(ws.weight, ws.bytes_of_weight, hash);
+            hash = WeightCache::hash(ws.vec, ws.bytes_of_vec, hash);
+        }
+    }
+    this->weightCache.init(directory, ms->model_name, this->deviceInfo.schedule, this->dt, hash);
+}
+
+void CNN::transform_filter()
+{
+    // operators that have to transform, with their cache keys taken before the transform
+    std::vector<std::pair<U32, std::string>> pending;
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        auto op = this->ops[i];
+        if (!op->is_weight()) {
+            continue;
+        }
+        auto weightOpPtr = dynamic_cast<WeightOperator *>(op.get());
+        std::string key;
+        if (this->weightCache.enabled() && weightOpPtr->is_weight_cacheable()) {
+            key = weightOpPtr->get_weight_cache_key();
+            std::vector<Tensor> tensors;
+            if (this->weightCache.get(op->get_name(), key, &tensors) &&
+                weightOpPtr->set_transformed_weights(tensors) == SUCCESS) {
+                UNI_DEBUG_LOG("op: %s use cached filter\n", op->get_name().c_str());
+                continue;
+            }
+        }
+        pending.push_back(std::make_pair(i, key));
+    }
+    // only the weights of operators that really transform are read here
+    WeightPrefetcher prefetcher;
+    for (auto &iter : pending) {
+        prefetcher.add(iter.first, dynamic_cast<WeightOperator *>(this->ops[iter.first].get()));
+    }
+    for (auto &iter : pending) {
+        auto op = this->ops[iter.first];
+        auto weightOpPtr = dynamic_cast<WeightOperator *>(op.get());
+        prefetcher.prefetch(iter.first);
+        UNI_DEBUG_LOG("op: %s transform filter\n", op->get_name().c_str());
+        CHECK_STATUS(weightOpPtr->transform_filter());
+        if (iter.second != "") {
+            this->weightCache.set(
+                op->get_name(), iter.second, weightOpPtr->get_transformed_weights());
+        }
+    }
+    this->weightCache.save();
+}
+
+void CNN::build_weight_prefetcher()
+{
+    this->weightPrefetcher.clear();
+    for (U32 i = 0; i < this->ops.size(); i++) {
+        if (this->ops[i]->is_weight()) {
+            this->weightPrefetcher.add(i, dynamic_cast<WeightOperator *>(this->ops[i].get()));
+        }
+    }
+}
+
 void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
 {
     UNI_DEBUG_LOG("Inference ready...\n");
+    ThreadContextGuard threadContext(this->numThreads);
     UNI_PROFILE(
         {
             this->infer_output_tensors_size(inputDescMap);
@@ -247,17 +363,11 @@ void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
 
             this->infer_tmp_memory_size();
             this->assign_tmp_tensor();
-            // transform filter
-            for (auto &op : this->ops) {
-                if (op->is_weight()) {
-                    UNI_DEBUG_LOG("op: %s transform filter\n", op->get_name().c_str());
-                    auto weightOpPtr = dynamic_cast<WeightOperator *>(op.get());
-                    CHECK_STATUS(weightOpPtr->transform_filter());
-                }
-            }
+            this->transform_filter();
             this->infer_tmp_memory_size();
             this->tmpTensor.alloc();
             this->assign_output_tensor();
+            this->build_weight_prefetcher();
         },
         std::string("ready"), std::string("prepare"));
     UNI_DEBUG_LOG("Inference ready end.\n");
@@ -266,10 +376,13 @@ void CNN::ready(std::map<std::string, TensorDesc> inputDescMap)
 void CNN::reready(std::map<std::string, TensorDesc> inputDescMap)
 {
     UNI_DEBUG_LOG("Inference reready for dynamic input...\n");
+    ThreadContextGuard threadContext(this->numThreads);
     this->infer_output_tensors_size(inputDescMap);
     if (this->memoryTracker.getMemoryNeedAssign()) {
         this->assign_output_tensor();
     }
+    // memory ranges of tensors may grow inside their planned space
+    this->operatorSchedulers.clear();
     this->infer_tmp_memory_size();
     this->tmpTensor.alloc();
     UNI_DEBUG_LOG("Inference reready end.\n");
@@ -314,6 +427,10 @@ void CNN::set_input_by_copy(std::map<std::string, U8 *> modelTensorsInput)
         if (this->inputTensors.find(inputName) == this->inputTensors.end()) {
             CHECK_STATUS(NOT_MATCH);
         }
+        if (this->kvCache.get_buffer(inputName) != nullptr) {
+            UNI_DEBUG_LOG("    Skip input %s, it is kept in kv cache.\n", inputName.c_str());
+            continue;
+        }
         auto tensorPtr = this->inputTensors[inputName];
         Tensor input;
         input.resize(tensorPtr->get_desc());
@@ -325,6 +442,16 @@ void CNN::set_input_by_copy(std::map<std::string, U8 *> modelTensorsInput)
     UNI_DEBUG_LOG("Copy input end.\n");
 }
 
+static void reuse_cpu_buffer(Tensor *tensor, std::shared_ptr<U8> data)
+{
+    if (data != ((CpuMemory *)(tensor->get_memory()))->get_shared_ptr()) {
+        Tensor buffer;
+        buffer.resize(tensor->get_desc());
+        ((CpuMemory *)(buffer.get_memory()))->set_shared_ptr(data);
+        tensor->reuse(&buffer);
+    }
+}
+
 void CNN::set_input_by_assign(std::map<std::string, std::shared_ptr<U8>> modelTensorsInput)
 {
     UNI_DEBUG_LOG("Set input...\n");
@@ -334,18 +461,92 @@ void CNN::set_input_by_assign(std::map<std::string, std::shared_ptr<U8>> modelTe
         if (this->inputTensors.find(inputName) == this->inputTensors.end()) {
             CHECK_STATUS(NOT_MATCH);
         }
-        auto tensorPtr = this->inputTensors[inputName];
-        if (data != ((CpuMemory *)(tensorPtr->get_memory()))->get_shared_ptr()) {
-            Tensor input;
-            input.resize(tensorPtr->get_desc());
-            ((CpuMemory *)(input.get_memory()))->set_shared_ptr(data);
-            tensorPtr->reuse(&input);
+        if (this->kvCache.get_buffer(inputName) != nullptr) {
+            UNI_DEBUG_LOG("    Skip input %s, it is kept in kv cache.\n", inputName.c_str());
+            continue;
         }
+        auto tensorPtr = this->inputTensors[inputName];
+        reuse_cpu_buffer(tensorPtr.get(), data);
         UNI_DEBUG_LOG("    Set input: %s %s\n", inputName.c_str(), tensorPtr->string(8).c_str());
     }
     UNI_DEBUG_LOG("Set input end.\n");
 }
 
+void CNN::bind_input_output(std::map<std::string, std::shared_ptr<U8>> modelTensorsInput,
+    std::map<std::string, std::shared_ptr<U8>> modelTensorsOutput)
+{
+    // tensors bound before get their own memory back
+    for (auto &iter : this->ownBuffers) {
+        reuse_cpu_buffer(this->tensorMap[iter.first].get(), iter.second);
+    }
+    this->boundBuffers.clear();
+    this->boundBytes.clear();
+    this->ownBuffers.clear();
+    this->operatorSchedulers.clear();
+    if (IS_GPU(this->deviceInfo.schedule)) {
+        if (modelTensorsInput.size() + modelTensorsOutput.size() > 0) {
+            UNI_WARNING_LOG("binding caller buffers is only supported on CPU.\n");
+        }
+        return;
+    }
+    auto bind = [&](std::map<std::string, std::shared_ptr<U8>> &buffers,
+                    std::map<std::string, std::shared_ptr<Tensor>> &tensors, const char *kind) {
+        for (auto &iter : buffers) {
+            std::string name = iter.first;
+            if (tensors.find(name) == tensors.end()) {
+                UNI_ERROR_LOG("can not bind buffer to tensor(name: %s), it is not a model %s.\n",
+                    name.c_str(), kind);
+            }
+            if (this->kvCache.get_buffer(name) != nullptr) {
+                UNI_WARNING_LOG(
+                    "skip binding buffer to tensor(name: %s), it is kept in kv cache.\n",
+                    name.c_str());
+                continue;
+            }
+            // the caller buffer is sized for the tensor at binding time
+            this->boundBuffers[name] = iter.second;
+            this->boundBytes[name] = tensorNumBytes(tensors[name]->get_desc());
+        }
+    };
+    bind(modelTensorsInput, this->inputTensors, "input");
+    bind(modelTensorsOutput, this->outputTensors, "output");
+    this->apply_bound_buffers();
+}
+
+void CNN::apply_bound_buffers()
+{
+    if (this->boundBuffers.size() == 0) {
+        return;
+    }
+    for (auto iter = this->boundBuffers.begin(); iter != this->boundBuffers.end();) {
+        std::string name = iter->first;
+        Tensor *tensor = this->tensorMap[name].get();
+        std::shared_ptr<U8> own = ((CpuMemory *)(tensor->get_memory()))->get_shared_ptr();
+        U32 bytes = tensorNumBytes(tensor->get_desc());
+        if (bytes > this->boundBytes[name]) {
+            UNI_WARNING_LOG("unbind buffer from tensor(name: %s), tensor needs %u bytes but "
+                            "buffer is %u bytes.\n",
+                name.c_str(), bytes, this->boundBytes[name]);
+            if (own == iter->second) {
+                Tensor buffer;
+                buffer.resize(tensor->get_desc());
+                buffer.alloc();
+                tensor->reuse(&buffer);
+            }
+            this->ownBuffers.erase(name);
+            this->boundBytes.erase(name);
+            iter = this->boundBuffers.erase(iter);
+            continue;
+        }
+        if (own != iter->second) {
+            this->ownBuffers[name] = own;
+            reuse_cpu_buffer(tensor, iter->second);
+        }
+        iter++;
+    }
+    this->operatorSchedulers.clear();
+}
+
 std::map<std::string, std::shared_ptr<Tensor>> CNN::get_input()
 {
     std::map<std::string, std::shared_ptr<Tensor>> ret;
@@ -412,7 +613,16 @@ EE CNN::infer_output_tensors_size(std::map<std::string, TensorDesc> inputDescMap
         UNI_DEBUG_LOG(
             "model input: %s desc %s\n", iter.first.c_str(), tensorDesc2Str(iter.second).c_str());
     }
-    this->infer_layout_desc();
+    this->assign_data_formats();
+    U32 kvLength = 0;
+    for (auto &iter : this->kvCache.get_entries()) {
+        KVCache::Entry &entry = iter.second;
+        U32 length = this->tensorMap[entry.presentName]->get_desc().dims[entry.axis];
+        kvLength = UNI_MAX(kvLength, length);
+    }
+    if (kvLength > this->kvCache.get_capacity()) {
+        this->grow_kv_cache(kvLength);
+    }
     this->update_op_tensors();
     UNI_DEBUG_LOG("Infer tensor dimension end.\n");
     return SUCCESS;
@@ -421,10 +631,16 @@ EE CNN::infer_output_tensors_size(std::map<std::string, TensorDesc> inputDescMap
 void CNN::assign_output_tensor()
 {
     this->storageMemory.clear();
-    auto storageSize = this->memoryTracker.getStorageSize();
-    for (U32 size : storageSize) {
-        auto tensor = this->allocate_tensor(size);
-        this->storageMemory.push_back(tensor);
+    if (IS_GPU(this->deviceInfo.schedule)) {
+        auto storageSize = this->memoryTracker.getStorageSize();
+        for (U32 size : storageSize) {
+            auto tensor = this->allocate_tensor(size);
+            this->storageMemory.push_back(tensor);
+        }
+    } else {
+        // all slot-managed CPU tensors are placed inside one arena
+        this->storageMemory.push_back(
+            this->allocate_tensor(this->memoryTracker.getPlannedSize()));
     }
 #ifdef _USE_GPU
     this->storageImage.clear();
@@ -460,8 +676,16 @@ void CNN::assign_output_tensor()
                 }
                 if (needAssign) {
                     I32 slot = tensorPositions[tensorIter];
-                    if (slot >= 0) {
-                        tensor->reuse(get_reuse_memory(slot, tensor.get()));
+                    Tensor *cacheBuffer = this->kvCache.get_buffer(tensorName);
+                    if (cacheBuffer != nullptr) {
+                        tensor->reuse(cacheBuffer);
+                    } else if (slot >= 0) {
+                        if (IS_GPU(this->deviceInfo.schedule)) {
+                            tensor->reuse(get_reuse_memory(slot, tensor.get()));
+                        } else {
+                            Tensor arenaTensor = get_arena_memory(tensorName);
+                            tensor->reuse(&arenaTensor);
+                        }
                     } else if (slot == -1) {
                         tensor->alloc();
 #ifdef _USE_GPU
@@ -477,19 +701,30 @@ void CNN::assign_output_tensor()
         }
         op->set_input_output_tensors(tensors[0], tensors[1]);
     }
+    this->apply_bound_buffers();
     this->memoryTracker.setMemoryAssigned();
+    // operator dependencies are built from tensor addresses
+    this->operatorSchedulers.clear();
 }
 
 void CNN::run()
 {
+    ThreadContextGuard threadContext(this->numThreads);
+    if (this->kvCache.is_extended() || this->kvCache.is_changed()) {
+        this->extend_kv_cache();
+    }
     for (U32 opIndex = 0; opIndex < ops.size();) {
         std::shared_ptr<Operator> op = this->ops[opIndex];
+        this->weightPrefetcher.prefetch(opIndex);
         UNI_DEBUG_LOG(
             "Run op: %s type: %s\n", op->get_name().c_str(), OperatorTypeName()[op->get_type()]);
         if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
             opIndex = op->get_next_operator_index();
+        } else if (this->parallelOperators) {
+            opIndex = this->run_parallel_operators(opIndex);
+            continue;
         } else {
-            UNI_PROFILE(op->run(), op->get_name(),
+            UNI_PROFILE(this->operatorProfiler.run(op.get()), op->get_name(),
                 std::string(OperatorTypeName()[op->get_type()]) + std::string("::run"));
             opIndex++;
         }
@@ -503,6 +738,441 @@ void CNN::run()
         }
 #endif
     }
+    this->update_kv_cache();
+}
+
+void CNN::set_parallel_operators(bool parallel)
+{
+    if (parallel && IS_GPU(this->deviceInfo.schedule)) {
+        UNI_WARNING_LOG("parallel operators is only supported on CPU.\n");
+        parallel = false;
+    }
+    this->parallelOperators = parallel;
+    this->operatorSchedulers.clear();
+    this->workerTmpTensors.clear();
+    for (auto &op : this->ops) {
+        op->set_tmp_memory(this->tmpTensor);
+        op->set_num_threads(this->numThreads);
+    }
+}
+
+U32 CNN::run_parallel_operators(U32 start)
+{
+    auto iter = this->operatorSchedulers.find(start);
+    if (iter == this->operatorSchedulers.end() ||
+        iter->second.get_num_threads() != OMP_NUM_THREADS) {
+        U32 end = start;
+        while (end < this->ops.size() && this->ops[end]->get_type() != OT_Repeat &&
+            this->ops[end]->get_type() != OT_Jump) {
+            end++;
+        }
+        OperatorScheduler scheduler;
+        scheduler.build(this->ops, start, end, OMP_NUM_THREADS);
+        this->operatorSchedulers[start] = scheduler;
+        iter = this->operatorSchedulers.find(start);
+        UNI_DEBUG_LOG("parallel operators [%u, %u) use %d workers.\n", start, end,
+            scheduler.get_num_workers());
+        // each worker needs its own tmp buffer, schedulers are rebuilt whenever the tmp size
+        // may have grown (ready, reready, tensor reassignment), so buffers only grow here
+        U32 workers = scheduler.get_num_workers();
+        if (this->workerTmpTensors.size() < workers) {
+            this->workerTmpTensors.resize(workers);
+        }
+        this->workerTmpTensors[0] = this->tmpTensor;
+        for (U32 i = 1; i < this->workerTmpTensors.size(); i++) {
+            if (this->workerTmpTensors[i].bytes() < this->tmpTensor.bytes()) {
+                this->workerTmpTensors[i].resize(this->tmpTensor.get_desc());
+                this->workerTmpTensors[i].alloc();
+            }
+        }
+    }
+    OperatorScheduler &scheduler = iter->second;
+    scheduler.run(this->ops, this->workerTmpTensors, &this->operatorProfiler);
+    return scheduler.get_end();
+}
+
+void CNN::set_profiling(bool enable)
+{
+    this->operatorProfiler.set_enabled(enable);
+}
+
+void CNN::set_profiling_roofline(double peakGFlops, double peakGBs)
+{
+    this->operatorProfiler.set_roofline(peakGFlops, peakGBs);
+}
+
+EE CNN::save_profiling_trace(std::string path)
+{
+    return this->operatorProfiler.save_trace(path);
+}
+
+void CNN::print_profiling_statistics()
+{
+    this->operatorProfiler.print_statistics();
+}
+
+void CNN::set_kv_cache(U32 capacity)
+{
+    if (IS_GPU(this->deviceInfo.schedule)) {
+        UNI_WARNING_LOG("kv cache is only supported on CPU.\n");
+        return;
+    }
+    if (!this->kvCache.empty()) {
+        UNI_WARNING_LOG("kv cache has already been set.\n");
+        return;
+    }
+    this->kvCache.set_capacity(capacity);
+    for (std::string &opName : this->sortedOps) {
+        auto op = this->operatorMap[opName];
+        std::vector<std::string> &inputNames = this->operatorTensorMap[opName][0];
+        std::vector<std::string> &outputNames = this->operatorTensorMap[opName][1];
+        // past state is a model input, and the extended state is a model output
+        if (op->get_type() != OT_Concat || inputNames.size() < 2 ||
+            this->inputTensors.find(inputNames[0]) == this->inputTensors.end() ||
+            this->outputTensors.find(outputNames[0]) == this->outputTensors.end()) {
+            continue;
+        }
+        Concat *concat = dynamic_cast<Concat *>(op.get());
+        TensorDesc pastDesc = this->tensorMap[inputNames[0]]->get_desc();
+        TensorDesc presentDesc = this->tensorMap[outputNames[0]]->get_desc();
+        U32 axis;
+        if (!concat->get_append_axis(presentDesc, &axis) || pastDesc.dt != presentDesc.dt) {
+            UNI_WARNING_LOG("concat %s can not keep %s in kv cache.\n", opName.c_str(),
+                inputNames[0].c_str());
+            continue;
+        }
+        U32 step = presentDesc.dims[axis] - pastDesc.dims[axis];
+        if (step == 0 || step > capacity) {
+            UNI_WARNING_LOG("kv cache capacity %u can not hold %u steps of %s.\n", capacity,
+                step, inputNames[0].c_str());
+            continue;
+        }
+        U32 stepBytes = tensorNumBytes(presentDesc) / presentDesc.dims[axis];
+        this->kvCache.add(inputNames[0], outputNames[0], axis, stepBytes);
+        concat->set_append_in_place(true);
+        UNI_DEBUG_LOG("keep %s in kv cache of %u bytes.\n", inputNames[0].c_str(),
+            stepBytes * capacity);
+    }
+    if (this->kvCache.empty()) {
+        UNI_WARNING_LOG("can not find any model input that can be kept in kv cache.\n");
+        return;
+    }
+    this->find_kv_cache_ops();
+    this->set_kv_cache_row_strides();
+
+    // cached tensors live in their own buffers instead of the activation arena
+    for (std::string &opName : this->sortedOps) {
+        auto op = this->operatorMap[opName];
+        std::vector<I32> tensorPositions = op->get_tensor_positions();
+        U32 tensorIter = 0;
+        for (auto &tensorNames : this->operatorTensorMap[opName]) {
+            for (std::string &tensorName : tensorNames) {
+                if (tensorIter < tensorPositions.size() &&
+                    this->kvCache.get_buffer(tensorName) != nullptr) {
+                    tensorPositions[tensorIter] = -1;
+                }
+                tensorIter++;
+            }
+        }
+        op->set_tensor_positions(tensorPositions);
+    }
+
+    ThreadContextGuard threadContext(this->numThreads);
+    this->plan_kv_cache_memory();
+    this->reset_kv_cache();
+}
+
+// operators whose shapes follow the length of the states
+void CNN::find_kv_cache_ops()
+{
+    std::set<std::string> kvTensors;
+    for (auto &iter : this->kvCache.get_entries()) {
+        kvTensors.insert(iter.first);
+    }
+    this->kvCacheOps.clear();
+    for (std::string &opName : this->sortedOps) {
+        bool reads = false;
+        for (std::string &name : this->operatorTensorMap[opName][0]) {
+            reads = reads || (kvTensors.find(name) != kvTensors.end());
+        }
+        if (reads) {
+            this->kvCacheOps.push_back(opName);
+            for (std::string &name : this->operatorTensorMap[opName][1]) {
+                kvTensors.insert(name);
+            }
+        }
+    }
+}
+
+void CNN::set_kv_cache_row_strides()
+{
+    for (auto &iter : this->kvCache.get_entries()) {
+        KVCache::Entry &entry = iter.second;
+        TensorDesc desc = this->tensorMap[entry.presentName]->get_desc();
+        U32 stride = this->kvCache.get_capacity();
+        for (U32 i = 0; i < entry.axis; i++) {
+            stride *= desc.dims[i];
+        }
+        std::vector<std::pair<std::shared_ptr<Operator>, U32>> readers;
+        bool strided = true;
+        for (std::string &opName : this->sortedOps) {
+            std::vector<std::string> &inputNames = this->operatorTensorMap[opName][0];
+            for (U32 i = 0; i < inputNames.size(); i++) {
+                if (inputNames[i] == iter.first || inputNames[i] == entry.presentName) {
+                    auto op = this->operatorMap[opName];
+                    readers.push_back(std::make_pair(op, i));
+                    strided = op->set_input_row_stride(i, entry.axis, stride) && strided;
+                }
+            }
+        }
+        if (!strided) {
+            UNI_DEBUG_LOG("keep the rows of %s packed, not every operator reading them supports "
+                          "a row stride.\n",
+                iter.first.c_str());
+            for (auto &reader : readers) {
+                reader.first->set_input_row_stride(reader.second, entry.axis, 0);
+            }
+            stride = 0;
+        }
+        entry.rowBytes = stride * bytesOf(desc.dt);
+    }
+}
+
+void CNN::plan_kv_cache_memory()
+{
+    // plan memory with the longest history once, so that decoding steps do not reassign it
+    std::map<std::string, TensorDesc> pastDescs;
+    for (auto &iter : this->kvCache.get_entries()) {
+        U32 axis = iter.second.axis;
+        TensorDesc desc = this->tensorMap[iter.first]->get_desc();
+        U32 step = this->tensorMap[iter.second.presentName]->get_desc().dims[axis] -
+            desc.dims[axis];
+        pastDescs[iter.first] = desc;
+        U32 capacity = this->kvCache.get_capacity();
+        desc.dims[axis] = capacity - UNI_MIN(step, capacity);
+        this->tensorMap[iter.first]->resize(desc);
+    }
+    this->infer_output_tensors_size(this->get_input_desc());
+    this->assign_output_tensor();
+    this->infer_tmp_memory_size();
+    this->tmpTensor.alloc();
+    for (auto &iter : pastDescs) {
+        this->tensorMap[iter.first]->resize(iter.second);
+    }
+    this->kvCache.set_changed(true);
+}
+
+void CNN::extend_kv_cache()
+{
+    // the caller has written the inputs, keep them if tensors are reassigned
+    std::map<std::string, std::pair<std::shared_ptr<U8>, U32>> inputs;
+    for (auto &iter : this->inputTensors) {
+        inputs[iter.first] = std::make_pair(
+            ((CpuMemory *)(iter.second->get_memory()))->get_shared_ptr(), iter.second->bytes());
+    }
+    // a decoding step only updates the shapes it extends, tensors are reassigned by reready
+    // when they outgrow their planned memory
+    if (this->kvCache.is_extended() && !this->kvCache.is_changed()) {
+        this->update_kv_cache_shapes();
+    }
+    this->kvCache.set_extended(false);
+    if (this->kvCache.is_changed()) {
+        this->reready(this->get_input_desc());
+        this->kvCache.set_changed(false);
+    }
+    for (auto &iter : inputs) {
+        Tensor *tensor = this->inputTensors[iter.first].get();
+        U8 *data = (U8 *)((CpuMemory *)(tensor->get_memory()))->get_ptr();
+        if (data != iter.second.first.get()) {
+            UNI_MEMCPY(data, iter.second.first.get(), UNI_MIN(iter.second.second, tensor->bytes()));
+        }
+    }
+}
+
+void CNN::grow_kv_cache(U32 length)
+{
+    U32 capacity = UNI_MAX(length, this->kvCache.get_capacity() * 2);
+    UNI_WARNING_LOG("kv cache needs %u steps, grow its capacity from %u to %u.\n", length,
+        this->kvCache.get_capacity(), capacity);
+    this->kvCache.reserve(capacity);
+    for (auto &iter : this->kvCache.get_entries()) {
+        this->tensorMap[iter.first]->reuse(iter.second.buffer.get());
+        this->tensorMap[iter.second.presentName]->reuse(iter.second.buffer.get());
+    }
+    this->set_kv_cache_row_strides();
+}
+
+void CNN::reset_kv_cache()
+{
+    this->truncate_kv_cache(0);
+}
+
+void CNN::truncate_kv_cache(U32 length)
+{
+    for (auto &iter : this->kvCache.get_entries()) {
+        U32 axis = iter.second.axis;
+        TensorDesc desc = this->tensorMap[iter.first]->get_desc();
+        U32 past = desc.dims[axis];
+        if (past > length) {
+            // keep the first steps of every row, packed rows are moved towards the buffer start
+            U32 outer = 1;
+            for (U32 i = axis + 1; i < desc.nDims; i++) {
+                outer *= desc.dims[i];
+            }
+            U32 stepBytes = tensorNumBytes(desc) / outer / past;
+            U8 *data = (U8 *)((CpuMemory *)(iter.second.buffer->get_memory()))->get_ptr();
+            for (U32 o = 1; o < outer && length > 0 && iter.second.rowBytes == 0; o++) {
+                memmove(data + o * length * stepBytes, data + o * past * stepBytes,
+                    length * stepBytes);
+            }
+            desc.dims[axis] = length;
+            this->tensorMap[iter.first]->resize(desc);
+            this->kvCache.set_changed(true);
+        }
+    }
+}
+
+U32 CNN::get_kv_cache_length()
+{
+    U32 length = 0;
+    auto &entries = this->kvCache.get_entries();
+    if (!entries.empty()) {
+        auto iter = entries.begin();
+        length = this->tensorMap[iter->first]->get_desc().dims[iter->second.axis];
+    }
+    return length;
+}
+
+void CNN::set_format_assignment(bool enable)
+{
+    this->formatAssignment = enable;
+}
+
+void CNN::set_streaming(bool streaming)
+{
+    if (streaming && IS_GPU(this->deviceInfo.schedule)) {
+        UNI_WARNING_LOG("streaming is only supported on CPU.\n");
+        return;
+    }
+    bool found = false;
+    for (auto &op : this->ops) {
+        if (op->get_type() != OT_RNN) {
+            continue;
+        }
+        RNNCell *rnn = dynamic_cast<RNNCell *>(op.get());
+        if (rnn->set_streaming(streaming) == SUCCESS) {
+            found = true;
+        } else if (streaming) {
+            UNI_WARNING_LOG("RNN operator %s can not keep its state between runs.\n",
+                op->get_name().c_str());
+        }
+    }
+    if (streaming && !found) {
+        UNI_WARNING_LOG("can not find any RNN operator that can keep its state between runs.\n");
+    }
+}
+
+void CNN::reset_streaming_state()
+{
+    for (auto &op : this->ops) {
+        if (op->get_type() == OT_RNN) {
+            dynamic_cast<RNNCell *>(op.get())->reset_state();
+        }
+    }
+}
+
+U32 CNN::get_streaming_state_bytes()
+{
+    U32 bytes = 0;
+    for (auto &op : this->ops) {
+        if (op->get_type() == OT_RNN) {
+            bytes += dynamic_cast<RNNCell *>(op.get())->get_state_bytes();
+        }
+    }
+    return bytes;
+}
+
+void CNN::save_streaming_state(U8 *state)
+{
+    for (auto &op : this->ops) {
+        if (op->get_type() == OT_RNN) {
+            RNNCell *rnn = dynamic_cast<RNNCell *>(op.get());
+            rnn->save_state(state);
+            state += rnn->get_state_bytes();
+        }
+    }
+}
+
+void CNN::load_streaming_state(const U8 *state)
+{
+    for (auto &op : this->ops) {
+        if (op->get_type() == OT_RNN) {
+            RNNCell *rnn = dynamic_cast<RNNCell *>(op.get());
+            rnn->load_state(state);
+            state += rnn->get_state_bytes();
+        }
+    }
+}
+
+void CNN::update_kv_cache()
+{
+    // the present states extend the past states in place, next step continues from them
+    for (auto &iter : this->kvCache.get_entries()) {
+        this->tensorMap[iter.first]->resize(
+            this->tensorMap[iter.second.presentName]->get_desc());
+        this->kvCache.set_extended(true);
+    }
+}
+
+void CNN::update_kv_cache_shapes()
+{
+    U32 tmpBytes = this->tmpTensor.bytes();
+    for (std::string &opName : this->kvCacheOps) {
+        auto op = this->operatorMap[opName];
+        std::vector<Tensor *> inputTensors, outputTensors;
+        for (std::string &name : this->operatorTensorMap[opName][0]) {
+            inputTensors.push_back(this->tensorMap[name].get());
+        }
+        for (std::string &name : this->operatorTensorMap[opName][1]) {
+            outputTensors.push_back(this->tensorMap[name].get());
+        }
+        CHECK_STATUS(op->infer_output_tensors_size(inputTensors, outputTensors));
+        tmpBytes = UNI_MAX(tmpBytes, op->infer_tmp_memory_size());
+    }
+    U32 length = 0;
+    for (auto &iter : this->kvCache.get_entries()) {
+        KVCache::Entry &entry = iter.second;
+        length = UNI_MAX(length, this->tensorMap[entry.presentName]->get_desc().dims[entry.axis]);
+    }
+    bool fit = (length <= this->kvCache.get_capacity());
+    if (!fit) {
+        this->grow_kv_cache(length);
+    }
+    for (U32 i = 0; i < this->kvCacheOps.size() && fit; i++) {
+        for (std::string &name : this->operatorTensorMap[this->kvCacheOps[i]][1]) {
+            Tensor *tensor = this->tensorMap[name].get();
+            U32 bytes = tensorNumBytes(tensor->get_desc());
+            U32 offset, size;
+            if (this->memoryTracker.getTensorOffset(name, &offset, &size)) {
+                fit = fit && (bytes <= size);
+            } else if (this->boundBuffers.find(name) != this->boundBuffers.end()) {
+                fit = fit && (bytes <= this->boundBytes[name]);
+            } else if (this->kvCache.get_buffer(name) == nullptr) {
+                tensor->alloc();
+            }
+        }
+    }
+    if (!fit) {
+        // plan for the whole capacity instead of the current length, reready follows
+        this->plan_kv_cache_memory();
+        return;
+    }
+    if (tmpBytes > this->tmpTensor.bytes()) {
+        this->tmpTensor.resize(tensor1d(DT_U8, tmpBytes));
+        this->tmpTensor.alloc();
+    }
+    // memory ranges of tensors grow inside their planned space
+    this->operatorSchedulers.clear();
 }
 
 std::shared_ptr<Tensor> CNN::allocate_tensor(U32 size)
@@ -607,9 +1277,280 @@ void CNN::infer_layout_desc()
     }
 }
 
+// Readers that do not take a tensor in its data format natively transform it inside their
+// kernels on every run. The formats are assigned again at every shape inference: a producer
+// that can write the format all readers of its output want is asked to, so that the round trip
+// through its native format disappears, and several readers wanting the same other format share
+// one explicit transform.
+void CNN::assign_data_formats()
+{
+    std::string plan = this->formatPlan;
+    std::map<std::string, std::string> transforms = this->formatTransforms;
+    this->remove_format_transforms();
+    this->infer_layout_desc();
+    if (this->formatAssignment && this->push_output_formats()) {
+        this->infer_layout_desc();
+    }
+    if (this->formatAssignment && this->insert_format_transforms()) {
+        this->infer_layout_desc();
+    }
+    if (this->formatPlan == plan) {
+        return;
+    }
+    // readers moved between tensors, and operators moved between indexes
+    transforms.insert(this->formatTransforms.begin(), this->formatTransforms.end());
+    for (auto &iter : transforms) {
+        this->memoryTracker.eraseTensor(iter.first);
+        this->memoryTracker.eraseTensor(iter.second);
+    }
+    if (!this->kvCache.empty()) {
+        this->find_kv_cache_ops();
+    }
+    this->build_weight_prefetcher();
+    this->operatorSchedulers.clear();
+}
+
+void CNN::remove_format_transforms()
+{
+    for (std::string &name : this->formatProducers) {
+        this->operatorMap[name]->clear_output_format();
+    }
+    for (auto &iter : this->formatTransforms) {
+        const std::string &output = iter.first;
+        const std::string &input = iter.second;
+        U32 index = std::find(this->sortedOps.begin(), this->sortedOps.end(), output) -
+            this->sortedOps.begin();
+        this->ops.erase(this->ops.begin() + index);
+        this->sortedOps.erase(this->sortedOps.begin() + index);
+        this->operatorMap.erase(output);
+        this->operatorTensorMap.erase(output);
+        for (auto &opTensors : this->operatorTensorMap) {
+            for (std::string &name : opTensors.second[0]) {
+                if (name == output) {
+                    name = input;
+                }
+            }
+        }
+    }
+    this->formatTransforms.clear();
+    this->formatProducers.clear();
+    this->formatPlan = "";
+}
+
+// operators writing each tensor, and the (operator, input) pairs reading it
+bool CNN::get_format_users(std::map<std::string, std::set<U32>> *writers,
+    std::map<std::string, std::vector<std::pair<U32, U32>>> *readers)
+{
+    if (!IS_CPU(this->deviceInfo.schedule)) {
+        return false;
+    }
+    for (auto &op : this->ops) {
+        // loops jump to fixed operator indexes
+        if (op->get_type() == OT_Repeat || op->get_type() == OT_Jump) {
+            return false;
+        }
+    }
+    for (U32 i = 0; i < this->sortedOps.size(); i++) {
+        auto &names = this->operatorTensorMap[this->sortedOps[i]];
+        for (U32 j = 0; j < names[0].size(); j++) {
+            (*readers)[names[0][j]].push_back(std::make_pair(i, j));
+        }
+        for (auto &name : names[1]) {
+            (*writers)[name].insert(i);
+        }
+    }
+    return true;
+}
+
+bool CNN::is_format_candidate(std::string name,
+    std::map<std::string, std::set<U32>> &writers,
+    std::map<std::string, std::vector<std::pair<U32, U32>>> &readers)
+{
+    TensorDesc desc = this->tensorMap[name]->get_desc();
+    bool candidate = (desc.dt == DT_F32 || desc.dt == DT_F16) && desc.nDims >= 4 &&
+        (desc.df == DF_NCHW || desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) &&
+        writers[name].size() <= 1 &&
+        this->weightOpOutputNames.find(name) == this->weightOpOutputNames.end() &&
+        this->kvCache.get_buffer(name) == nullptr;
+    for (U32 i = 0; i < readers[name].size() && candidate; i++) {
+        // an operator updating the tensor in place reads the version it writes
+        candidate = (writers[name].count(readers[name][i].first) == 0);
+    }
+    return candidate;
+}
+
+std::vector<Tensor *> CNN::get_op_tensors(U32 opIndex, U32 kind)
+{
+    std::vector<Tensor *> tensors;
+    for (auto &name : this->operatorTensorMap[this->sortedOps[opIndex]][kind]) {
+        tensors.push_back(this->tensorMap[name].get());
+    }
+    return tensors;
+}
+
+bool CNN::push_output_formats()
+{
+    bool pushed = false;
+#ifdef _USE_CPU
+    std::map<std::string, std::set<U32>> writers;
+    std::map<std::string, std::vector<std::pair<U32, U32>>> readers;
+    if (!this->get_format_users(&writers, &readers)) {
+        return pushed;
+    }
+    // bytes an operator moves to transform its inputs when it writes its output in format df
+    auto get_input_cost = [&](U32 opIndex, DataFormat df) {
+        std::vector<Tensor *> inputs = this->get_op_tensors(opIndex, 0);
+        std::vector<Tensor *> outputs = this->get_op_tensors(opIndex, 1);
+        Tensor output;
+        TensorDesc desc = outputs[0]->get_desc();
+        desc.df = df;
+        output.resize(desc);
+        auto op = this->ops[opIndex];
+        U32 bytes = 0;
+        for (U32 i = 0; i < inputs.size(); i++) {
+            TensorDesc inputDesc = inputs[i]->get_desc();
+            if (op->get_input_format(i, inputs, {&output}) != inputDesc.df) {
+                bytes += 2 * tensorNumBytes(inputDesc);
+            }
+        }
+        return bytes;
+    };
+    for (auto &iter : readers) {
+        const std::string &name = iter.first;
+        if (!this->is_format_candidate(name, writers, readers) || writers[name].size() == 0 ||
+            this->outputTensors.find(name) != this->outputTensors.end()) {
+            continue;
+        }
+        U32 producer = *(writers[name].begin());
+        auto op = this->ops[producer];
+        Tensor *tensor = this->tensorMap[name].get();
+        TensorDesc desc = tensor->get_desc();
+        TensorDesc wantedDesc = desc;
+        Tensor wantedTensor;
+        // every reader transforms the tensor to the same other format, and reads that natively
+        bool same = (this->operatorTensorMap[this->sortedOps[producer]][1].size() == 1);
+        for (U32 i = 0; i < iter.second.size() && same; i++) {
+            U32 opIndex = iter.second[i].first;
+            U32 inputIndex = iter.second[i].second;
+            std::vector<Tensor *> inputs = this->get_op_tensors(opIndex, 0);
+            std::vector<Tensor *> outputs = this->get_op_tensors(opIndex, 1);
+            DataFormat df = this->ops[opIndex]->get_input_format(inputIndex, inputs, outputs);
+            if (i == 0) {
+                wantedDesc.df = df;
+                wantedTensor.resize(wantedDesc);
+            }
+            inputs[inputIndex] = &wantedTensor;
+            same = (df != desc.df && df == wantedDesc.df &&
+                this->ops[opIndex]->get_input_format(inputIndex, inputs, outputs) == df);
+        }
+        if (!same ||
+            !op->support_output_format(wantedDesc.df, this->get_op_tensors(producer, 0),
+                this->get_op_tensors(producer, 1))) {
+            continue;
+        }
+        // the readers move the tensor at least once, the producer may move its inputs instead
+        U32 readerCost = 2 * tensorNumBytes(desc);
+        U32 producerCost = get_input_cost(producer, wantedDesc.df);
+        U32 nativeCost = get_input_cost(producer, desc.df);
+        if (producerCost >= nativeCost + readerCost) {
+            continue;
+        }
+        op->set_output_format(wantedDesc.df);
+        this->formatProducers.push_back(this->sortedOps[producer]);
+        this->formatPlan += this->sortedOps[producer] + ":" + DataFormatName()[wantedDesc.df] + ";";
+        UNI_DEBUG_LOG("operator %s writes %s in %s for %d readers\n",
+            this->sortedOps[producer].c_str(), name.c_str(), DataFormatName()[wantedDesc.df],
+            (int)iter.second.size());
+        pushed = true;
+    }
+#endif
+    return pushed;
+}
+
+bool CNN::insert_format_transforms()
+{
+    bool inserted = false;
+#ifdef _USE_CPU
+    std::map<std::string, std::set<U32>> writers;
+    std::map<std::string, std::vector<std::pair<U32, U32>>> readers;
+    if (!this->get_format_users(&writers, &readers)) {
+        return inserted;
+    }
+    struct Transform {
+        std::string input;
+        DataFormat df;
+        std::vector<std::pair<U32, U32>> readers;
+    };
+    std::vector<Transform> transforms;
+    for (auto &iter : readers) {
+        const std::string &name = iter.first;
+        if (!this->is_format_candidate(name, writers, readers)) {
+            continue;
+        }
+        TensorDesc desc = this->tensorMap[name]->get_desc();
+        std::map<DataFormat, std::vector<std::pair<U32, U32>>> wanted;
+        for (auto &reader : iter.second) {
+            DataFormat df = this->ops[reader.first]->get_input_format(reader.second,
+                this->get_op_tensors(reader.first, 0), this->get_op_tensors(reader.first, 1));
+            if (df != desc.df) {
+                wanted[df].push_back(reader);
+            }
+        }
+        for (auto &format : wanted) {
+            // k readers move the tensor k times, a shared transform moves it once
+            if (format.second.size() > 1) {
+                transforms.push_back({name, format.first, format.second});
+            }
+        }
+    }
+    std::vector<I32> slots;
+    for (auto &transform : transforms) {
+        auto &first = transform.readers[0];
+        slots.push_back(this->ops[first.first]->get_tensor_positions()[first.second]);
+        std::string output = transform.input + "_" + DataFormatName()[transform.df];
+        this->formatPlan += output + ":";
+        for (auto &reader : transform.readers) {
+            this->operatorTensorMap[this->sortedOps[reader.first]][0][reader.second] = output;
+            this->formatPlan += this->sortedOps[reader.first] + ",";
+        }
+        this->formatPlan += ";";
+    }
+    // insert from the back, so that the positions of the transforms still to insert stay valid
+    std::vector<U32> order(transforms.size());
+    for (U32 i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](U32 a, U32 b) {
+        return transforms[a].readers[0].first > transforms[b].readers[0].first;
+    });
+    for (U32 i : order) {
+        Transform &transform = transforms[i];
+        std::string output = transform.input + "_" + DataFormatName()[transform.df];
+        U32 position = transform.readers[0].first;
+        std::shared_ptr<Operator> op(new TransformFormatCPU(this->dt, transform.df));
+        op->set_name(output);
+        std::vector<std::string> inputNames = {transform.input};
+        std::vector<std::string> outputNames = {output};
+        this->add(op, inputNames, outputNames);
+        op->set_tensor_positions({slots[i], slots[i]});
+        op->set_schedule(this->deviceInfo.schedule);
+        op->set_num_threads(this->numThreads);
+        op->set_algorithm_map(this->algorithmMap);
+        this->ops.insert(this->ops.begin() + position, op);
+        this->sortedOps.insert(this->sortedOps.begin() + position, output);
+        this->formatTransforms[output] = transform.input;
+        UNI_DEBUG_LOG("insert %s transform of tensor %s for %d readers\n",
+            DataFormatName()[transform.df], transform.input.c_str(), (int)transform.readers.size());
+        inserted = true;
+    }
+#endif
+    return inserted;
+}
+
 void CNN::update_op_tensors()
 {
-    for (auto &opName : this->sortedOps) {
+    for (U32 opIndex = 0; opIndex < this->sortedOps.size(); opIndex++) {
+        std::string &opName = this->sortedOps[opIndex];
         auto op = this->operatorMap[opName];
         std::vector<std::string> curOpInputTensorName = this->operatorTensorMap[opName][0];
         std::vector<std::string> curOpOutputTensorName = this->operatorTensorMap[opName][1];
@@ -627,7 +1568,17 @@ void CNN::update_op_tensors()
 
         curOpInputTensorName.insert(
             curOpInputTensorName.end(), curOpOutputTensorName.begin(), curOpOutputTensorName.end());
-        memoryTracker.trackOpTensorSizes(op, curOpInputTensorName);
+        memoryTracker.trackOpTensorSizes(op, curOpInputTensorName, opIndex);
+    }
+    U32 opNum = this->sortedOps.size();
+    for (auto &iter : this->inputTensors) {
+        this->memoryTracker.extendTensorLifetime(iter.first, 0, 0);
+    }
+    for (auto &iter : this->outputTensors) {
+        this->memoryTracker.extendTensorLifetime(iter.first, opNum, opNum);
+    }
+    if (this->memoryTracker.getMemoryNeedAssign() && !IS_GPU(this->deviceInfo.schedule)) {
+        this->memoryTracker.planTensorOffsets();
     }
     check_memory_reuse_ratio();
 }
@@ -639,6 +1590,10 @@ void CNN::set_input_desc(std::map<std::string, TensorDesc> inputDescMap)
             UNI_WARNING_LOG("Unused model input node: %s\n", iter.first.c_str());
             continue;
         }
+        // the shape of a cached input is decided by the cache length
+        if (this->kvCache.get_buffer(iter.first) != nullptr) {
+            continue;
+        }
         TensorDesc desc = iter.second;
         (this->tensorMap[iter.first].get())->resize(desc);
     }
@@ -680,6 +1635,21 @@ void CNN::assign_tmp_tensor()
     }
 }
 
+Tensor CNN::get_arena_memory(std::string tensorName)
+{
+    U32 offset, size;
+    if (!this->memoryTracker.getTensorOffset(tensorName, &offset, &size)) {
+        UNI_ERROR_LOG("can not find planned memory for tensor %s.\n", tensorName.c_str());
+        CHECK_STATUS(NOT_MATCH);
+    }
+    auto arena = ((CpuMemory *)(this->storageMemory[0]->get_memory()))->get_shared_ptr();
+    Tensor tensor;
+    tensor.resize(tensor1d(DT_U8, size));
+    ((CpuMemory *)(tensor.get_memory()))
+        ->set_shared_ptr(std::shared_ptr<U8>(arena, arena.get() + offset));
+    return tensor;
+}
+
 Tensor *CNN::get_reuse_memory(U32 slot, Tensor *tensor)
 {
     auto mem = tensor->get_memory();
@@ -716,4 +1686,11 @@ void CNN::check_memory_reuse_ratio()
                   "for standalone tensors (e.g. loop topology). reuse rate: %f\n",
         this->memoryTracker.getNumSlots(), this->memoryTracker.getSizeSum(), standaloneSize,
         (F32)originalSize / (this->memoryTracker.getSizeSum() + standaloneSize));
+    if (!IS_GPU(this->deviceInfo.schedule)) {
+        UNI_DEBUG_LOG("tensor memory: offset planner places slot tensors in a %u bytes arena, "
+                      "%f of the sum of slot sizes.\n",
+            this->memoryTracker.getPlannedSize(),
+            (F32)this->memoryTracker.getPlannedSize() /
+                UNI_MAX(this->memoryTracker.getSizeSum(), 1));
+    }
 }
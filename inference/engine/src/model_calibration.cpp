@@ -13,6 +13,8 @@
 
 #ifdef _USE_INT8
 
+#include <algorithm>
+#include <pthread.h>
 #include "inference.hpp"
 #include "data_loader.hpp"
 #include "result_format.hpp"
@@ -76,12 +78,164 @@ void update_histogram(
     }
 }
 
+// adds one sample of a tensor to its histogram, the histogram is compressed when the sample
+// extends the range
+void observe_tensor(const F32 *data, U32 len, std::vector<F32> &histogram, F32 &maxAbs)
+{
+    F32 minmax[2] = {1, -1};
+    CHECK_STATUS(minmax_value_func<F32>(data, len, 3, minmax));
+    F32 sampleMaxAbs = UNI_MAX(UNI_ABS(minmax[0]), UNI_ABS(minmax[1]));
+    if (histogram.size() == 0) {
+        histogram.resize(BINS, 0);
+    }
+    if (sampleMaxAbs > maxAbs) {
+        if (maxAbs > 0) {
+            compress_histogram(histogram, sampleMaxAbs / maxAbs, BINS);
+        }
+        maxAbs = sampleMaxAbs;
+    }
+    if (maxAbs > 0) {
+        update_histogram(std::vector<U32>(1, len), data, BINS, maxAbs / BINS, histogram.data());
+    } else {
+        histogram[0] += len;
+    }
+}
+
+void merge_histogram(
+    std::vector<F32> &histogram, F32 &maxAbs, std::vector<F32> other, F32 otherMaxAbs)
+{
+    if (other.size() == 0) {
+        return;
+    }
+    if (histogram.size() == 0) {
+        histogram.resize(BINS, 0);
+    }
+    F32 range = UNI_MAX(maxAbs, otherMaxAbs);
+    if (maxAbs > 0 && maxAbs < range) {
+        compress_histogram(histogram, range / maxAbs, BINS);
+    }
+    if (otherMaxAbs > 0 && otherMaxAbs < range) {
+        compress_histogram(other, range / otherMaxAbs, BINS);
+    }
+    for (int i = 0; i < BINS; i++) {
+        histogram[i] += other[i];
+    }
+    maxAbs = range;
+}
+
+std::vector<F32> compute_scale(std::vector<F32> &histogram, F32 maxAbs, bool useMinMax)
+{
+    if (useMinMax) {
+        return std::vector<F32>(1, 127.0 / maxAbs);
+    }
+    return compute_scale_with_KL(histogram, maxAbs / BINS);
+}
+
+void store_feature_scale(std::shared_ptr<Operator> op,
+    U32 opIdx,
+    std::vector<std::vector<F32>> scales,
+    ModelSpec *int8Ms,
+    ModelSpec *resultMs)
+{
+    if (int8Ms->ops[opIdx].num_quant_feature == 1 &&
+        -2 == int8Ms->ops[opIdx].feature_scale[0].scale[0]) {
+        std::vector<F32> outputScale;
+        outputScale.push_back(-2);
+        scales.back() = outputScale;
+    }
+
+    op->set_feature_scale(scales);
+
+    // Store scales into result model
+    // Could be labelled with -2
+    if (nullptr != resultMs->ops[opIdx].feature_scale) {
+        for (U32 i = 0; i < resultMs->ops[opIdx].num_quant_feature; i++) {
+            if (nullptr != resultMs->ops[opIdx].feature_scale[i].scale) {
+                delete[] resultMs->ops[opIdx].feature_scale[i].scale;
+            }
+        }
+        delete[] resultMs->ops[opIdx].feature_scale;
+    }
+
+    resultMs->ops[opIdx].num_quant_feature = scales.size();
+    resultMs->ops[opIdx].feature_scale =
+        (QuantSpec *)mt_new_storage(scales.size() * sizeof(QuantSpec));
+
+    for (U32 i = 0; i < scales.size(); i++) {
+        resultMs->ops[opIdx].feature_scale[i].num_scale = scales[i].size();
+        U32 scaleBytes = scales[i].size() * sizeof(F32);
+        resultMs->ops[opIdx].feature_scale[i].scale = (F32 *)mt_new_storage(scaleBytes);
+        memcpy(resultMs->ops[opIdx].feature_scale[i].scale, scales[i].data(), scaleBytes);
+    }
+}
+
+// a tensor recorded in single pass mode, id indexes the histograms
+struct ObservedTensor {
+    U32 id;
+    bool isOutput;
+    U32 position;
+};
+
+// an op whose scales wait for the histograms, slots are filled with the scales of the tensors
+struct PendingOp {
+    U32 opIdx;
+    std::vector<std::vector<F32>> scales;
+    std::vector<std::pair<U32, std::string>> slots;
+};
+
+struct CalibrationWorker {
+    CNN cnn;
+    std::map<std::string, TensorDesc> inputDescMap;
+    std::vector<std::vector<Tensor>> *inputs;
+    const std::map<U32, std::vector<ObservedTensor>> *observers;
+    U32 start;
+    U32 step;
+    std::vector<std::vector<F32>> histograms;
+    std::vector<F32> maxAbs;
+};
+
+// runs the samples start, start + step, ... and records the observed tensors after their ops
+void *calibration_worker(void *_worker)
+{
+    CalibrationWorker *worker = (CalibrationWorker *)_worker;
+    std::map<std::string, std::shared_ptr<U8>> modelInputs;
+    for (U32 j = worker->start; j < worker->inputs->size(); j += worker->step) {
+        U32 index = 0;
+        for (auto &iter : worker->inputDescMap) {
+            Tensor &input = (*worker->inputs)[j][index];
+            modelInputs[iter.first] = ((CpuMemory *)input.get_memory())->get_shared_ptr();
+            iter.second = input.get_desc();
+            index++;
+        }
+        worker->cnn.reready(worker->inputDescMap);
+        worker->cnn.set_input_by_assign(modelInputs);
+        worker->cnn.run_with_observer([&](U32 opIdx) {
+            auto observer = worker->observers->find(opIdx);
+            if (observer == worker->observers->end()) {
+                return;
+            }
+            auto op = worker->cnn.get_operator_by_index(opIdx);
+            for (auto &target : observer->second) {
+                std::vector<Tensor> tensors =
+                    target.isOutput ? op->get_output_tensors() : op->get_input_tensors();
+                Tensor tensor = tensors[target.position];
+                observe_tensor((F32 *)((CpuMemory *)tensor.get_memory())->get_ptr(),
+                    tensorNumElements(tensor.get_desc()), worker->histograms[target.id],
+                    worker->maxAbs[target.id]);
+            }
+        });
+    }
+    return NULL;
+}
+
 void calibrate_model_with_dataset(std::string dataPath,
     ImageFormat imageFormat,
     DataType inferType,
     F32 scaleValue,
     std::string modelPath,
-    ModelSpec *resultMs)
+    ModelSpec *resultMs,
+    U32 threadNum,
+    bool useMinMax)
 {
     DataType fType;
     if (DT_F16_8Q == inferType) {
@@ -138,6 +292,10 @@ void calibrate_model_with_dataset(std::string dataPath,
 
     std::vector<U32> calibratedOpIdx;
     std::map<std::string, std::vector<F32>> tensorScale;
+    // single pass mode only collects what to record here, and computes the scales at the end
+    std::vector<std::string> observedNames;
+    std::map<U32, std::vector<ObservedTensor>> observers;
+    std::vector<PendingOp> pendingOps;
     //TODO: add more ops to quantize
     U32 opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, 0);
 
@@ -161,6 +319,7 @@ void calibrate_model_with_dataset(std::string dataPath,
         std::vector<Tensor> calibrateTensors;
         std::vector<U32> calibrateIdxs;
         std::vector<std::pair<bool, U32>> tensorPosition;
+        PendingOp pendingOp;
 
         for (U32 i = 0; i < int8Ms.ops[opIdx].num_inputs; i++) {
             // already set clipping value
@@ -176,6 +335,10 @@ void calibrate_model_with_dataset(std::string dataPath,
             auto it = tensorScale.find(tensorName);
             if (it != tensorScale.end()) {
                 scales[i] = tensorScale[tensorName];
+                if (std::find(observedNames.begin(), observedNames.end(), tensorName) !=
+                    observedNames.end()) {
+                    pendingOp.slots.push_back(std::make_pair(i, tensorName));
+                }
                 continue;
             }
 
@@ -254,7 +417,23 @@ void calibrate_model_with_dataset(std::string dataPath,
             continue;
         }
 
-        for (U32 i = 0; i < calibrateTensors.size(); ++i) {
+        for (U32 i = 0; threadNum > 0 && i < calibrateTensors.size(); ++i) {
+            ObservedTensor target = {
+                (U32)observedNames.size(), tensorPosition[i].first, tensorPosition[i].second};
+            observers[opIdx].push_back(target);
+            observedNames.push_back(calibrateTensorName[i]);
+            pendingOp.slots.push_back(std::make_pair(calibrateIdxs[i], calibrateTensorName[i]));
+            // positive placeholder until the histograms are ready
+            scales[calibrateIdxs[i]] = std::vector<F32>(1, 1);
+            tensorScale[calibrateTensorName[i]] = scales[calibrateIdxs[i]];
+        }
+        if (pendingOp.slots.size() > 0) {
+            pendingOp.opIdx = opIdx;
+            pendingOp.scales = scales;
+            pendingOps.push_back(pendingOp);
+        }
+
+        for (U32 i = 0; threadNum == 0 && i < calibrateTensors.size(); ++i) {
             std::string tensorName = calibrateTensorName[i];
             Tensor tensor = calibrateTensors[i];
             auto floatDesc = tensor.get_desc();
@@ -320,44 +499,57 @@ void calibrate_model_with_dataset(std::string dataPath,
                 }
             }
             free(dBuf);
-            std::vector<F32> scale = compute_scale_with_KL(histogram, interval);
+            std::vector<F32> scale = useMinMax ? std::vector<F32>(1, 127.0 / maxAbs)
+                                               : compute_scale_with_KL(histogram, interval);
             scales[calibrateIdxs[i]] = scale;
             tensorScale[tensorName] = scale;
         }
 
-        if (int8Ms.ops[opIdx].num_quant_feature == 1 &&
-            -2 == int8Ms.ops[opIdx].feature_scale[0].scale[0]) {
-            std::vector<F32> outputScale;
-            outputScale.push_back(-2);
-            scales.back() = outputScale;
-        }
+        store_feature_scale(op, opIdx, scales, &int8Ms, resultMs);
 
-        op->set_feature_scale(scales);
+        calibratedOpIdx.push_back(opIdx);
+        opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, opIdx);
+    }
 
-        // Store scales into result model
-        // Could be labelled with -2
-        if (nullptr != resultMs->ops[opIdx].feature_scale) {
-            for (U32 i = 0; i < resultMs->ops[opIdx].num_quant_feature; i++) {
-                if (nullptr != resultMs->ops[opIdx].feature_scale[i].scale) {
-                    delete[] resultMs->ops[opIdx].feature_scale[i].scale;
-                }
+    if (observedNames.size() > 0) {
+        U32 num = UNI_MIN(threadNum, (U32)inputs.size());
+        std::vector<CalibrationWorker> workers(num);
+        std::vector<pthread_t> threads(num);
+        for (U32 i = 0; i < num; i++) {
+            workers[i].cnn = floatCNN->clone();
+            if (num > 1) {
+                workers[i].cnn.set_num_threads(1);
+            }
+            workers[i].inputDescMap = originInputDescMap;
+            workers[i].inputs = &inputs;
+            workers[i].observers = &observers;
+            workers[i].start = i;
+            workers[i].step = num;
+            workers[i].histograms.resize(observedNames.size());
+            workers[i].maxAbs.resize(observedNames.size(), 0);
+            if (pthread_create(&threads[i], NULL, calibration_worker, &workers[i]) != 0) {
+                UNI_ERROR_LOG("model calibration create thread fail\n");
             }
-            delete[] resultMs->ops[opIdx].feature_scale;
         }
-
-        resultMs->ops[opIdx].num_quant_feature = scales.size();
-        resultMs->ops[opIdx].feature_scale =
-            (QuantSpec *)mt_new_storage(scales.size() * sizeof(QuantSpec));
-
-        for (U32 i = 0; i < scales.size(); i++) {
-            resultMs->ops[opIdx].feature_scale[i].num_scale = scales[i].size();
-            U32 scaleBytes = scales[i].size() * sizeof(F32);
-            resultMs->ops[opIdx].feature_scale[i].scale = (F32 *)mt_new_storage(scaleBytes);
-            memcpy(resultMs->ops[opIdx].feature_scale[i].scale, scales[i].data(), scaleBytes);
+        for (U32 i = 0; i < num; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        for (U32 id = 0; id < observedNames.size(); id++) {
+            std::vector<F32> histogram;
+            F32 maxAbs = 0;
+            for (U32 i = 0; i < num; i++) {
+                merge_histogram(
+                    histogram, maxAbs, workers[i].histograms[id], workers[i].maxAbs[id]);
+            }
+            tensorScale[observedNames[id]] = compute_scale(histogram, maxAbs, useMinMax);
+        }
+        for (auto &pendingOp : pendingOps) {
+            for (auto &slot : pendingOp.slots) {
+                pendingOp.scales[slot.first] = tensorScale[slot.second];
+            }
+            store_feature_scale(int8CNN->get_operator_by_index(pendingOp.opIdx),
+                pendingOp.opIdx, pendingOp.scales, &int8Ms, resultMs);
         }
-
-        calibratedOpIdx.push_back(opIdx);
-        opIdx = int8CNN->find_next_dynamic_scale_op(calibratedOpIdx, opIdx);
     }
 
     CHECK_STATUS(mt_destroy_model(&int8Ms));
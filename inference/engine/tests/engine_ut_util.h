@@ -0,0 +1,112 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef _H_ENGINE_UT_UTIL
+#define _H_ENGINE_UT_UTIL
+
+#include <string.h>
+#include <vector>
+#include "inference.hpp"
+#include "model_common.h"
+#include "ut_util.h"
+
+// small fp32 models built in memory for the engine tests
+
+inline OperatorSpec ut_create_operator(const char *name,
+    OperatorType type,
+    std::vector<const char *> inputs,
+    std::vector<const char *> outputs)
+{
+    OperatorSpec spec = mt_create_operator(name, type, inputs.size(), outputs.size());
+    for (U32 i = 0; i < inputs.size(); i++) {
+        str_copy(spec.input_tensors_name[i], inputs[i], strlen(inputs[i]));
+    }
+    for (U32 i = 0; i < outputs.size(); i++) {
+        str_copy(spec.output_tensors_name[i], outputs[i], strlen(outputs[i]));
+    }
+    // -1 as the converters write, no tensor shares memory with another
+    spec.tensor_positions = (I32 *)mt_new_storage(sizeof(I32) * (inputs.size() + outputs.size()));
+    for (U32 i = 0; i < inputs.size() + outputs.size(); i++) {
+        spec.tensor_positions[i] = -1;
+    }
+    memset(&spec.ps, 0, sizeof(spec.ps));
+    return spec;
+}
+
+inline WeightSpec ut_create_weight(const char *name, U32 weightNum, U32 vecNum)
+{
+    WeightSpec ws;
+    str_copy(ws.op_name, name, strlen(name));
+    ws.mdt = DT_F32;
+    ws.bytes_of_weight = weightNum * bytesOf(DT_F32);
+    ws.weight = (U8 *)mt_new_storage(ws.bytes_of_weight);
+    ut_init_v(ws.weight, weightNum, DT_F32, UT_INIT_RANDOM);
+    ws.bytes_of_vec = vecNum * bytesOf(DT_F32);
+    ws.vec = (U8 *)mt_new_storage(ws.bytes_of_vec);
+    ut_init_v(ws.vec, vecNum, DT_F32, UT_INIT_RANDOM);
+    ws.num_quant_scale = 0;
+    ws.weight_scale = nullptr;
+    return ws;
+}
+
+// destroy the model with mt_destroy_model
+inline void ut_create_model(const char *name,
+    std::vector<std::pair<const char *, TensorDesc>> inputs,
+    std::vector<const char *> outputs,
+    std::vector<OperatorSpec> ops,
+    std::vector<WeightSpec> ws,
+    ModelSpec *ms)
+{
+    CHECK_STATUS(mt_create_model(ms));
+    str_copy(ms->model_name, name, strlen(name));
+    ms->dt = DT_F32;
+    ms->num_inputs = inputs.size();
+    ms->input_names = (I8 **)mt_new_storage(sizeof(I8 *) * inputs.size());
+    ms->input_dims = (TensorDesc *)mt_new_storage(sizeof(TensorDesc) * inputs.size());
+    for (U32 i = 0; i < inputs.size(); i++) {
+        ms->input_names[i] = (I8 *)mt_new_storage(NAME_LEN);
+        str_copy(ms->input_names[i], inputs[i].first, strlen(inputs[i].first));
+        ms->input_dims[i] = inputs[i].second;
+    }
+    ms->num_outputs = outputs.size();
+    ms->output_names = (I8 **)mt_new_storage(sizeof(I8 *) * outputs.size());
+    for (U32 i = 0; i < outputs.size(); i++) {
+        ms->output_names[i] = (I8 *)mt_new_storage(NAME_LEN);
+        str_copy(ms->output_names[i], outputs[i], strlen(outputs[i]));
+    }
+    ms->num_operator_specs = ops.size();
+    ms->ops = (OperatorSpec *)mt_new_storage(sizeof(OperatorSpec) * ops.size());
+    UNI_MEMCPY(ms->ops, ops.data(), sizeof(OperatorSpec) * ops.size());
+    ms->num_weight_specs = ws.size();
+    ms->ws = (WeightSpec *)mt_new_storage(sizeof(WeightSpec) * ws.size());
+    UNI_MEMCPY(ms->ws, ws.data(), sizeof(WeightSpec) * ws.size());
+}
+
+// output of a model in plain layout
+inline std::vector<F32> ut_get_output(std::shared_ptr<CNN> cnn, std::string name)
+{
+    Tensor output = *(cnn->get_output()[name]);
+    TensorDesc desc = output.get_desc();
+    std::vector<F32> data(tensorNumElements(desc));
+    if (desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) {
+        TensorDesc plainDesc = desc;
+        plainDesc.df = DF_NCHW;
+        CHECK_STATUS(transformToNCHW(
+            desc, get_ptr_from_tensor(output, CPU_GENERAL), plainDesc, data.data()));
+    } else {
+        UNI_MEMCPY(data.data(), get_ptr_from_tensor(output, CPU_GENERAL), output.bytes());
+    }
+    return data;
+}
+
+#endif
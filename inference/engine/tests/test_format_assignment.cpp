@@ -0,0 +1,99 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "engine_ut_util.h"
+
+// run a model whose tensors are read in other data formats than they are written in, with the
+// data format assignment on and off, and compare the outputs at two shapes
+
+static std::map<std::string, TensorDesc> get_input_descs(U32 h, U32 w)
+{
+    std::map<std::string, TensorDesc> descs;
+    descs["a"] = tensor4df(DT_F32, DF_NCHWC8, 1, 16, h, w);
+    descs["b"] = tensor4df(DT_F32, DF_NCHW, 1, 8, h, w);
+    descs["rois"] = tensor2df(DT_F32, DF_NORMAL, 2, 4);
+    return descs;
+}
+
+static void run(std::shared_ptr<CNN> cnn, std::map<std::string, std::vector<F32>> &inputs)
+{
+    std::map<std::string, U8 *> data;
+    for (auto &iter : inputs) {
+        data[iter.first] = (U8 *)iter.second.data();
+    }
+    cnn->set_input_by_copy(data);
+    cnn->run();
+}
+
+int main()
+{
+    // a blocked input concatenated with a plain one and read by a channel softmax, so that the
+    // concat writes NCHW, and read by two RoIAligns, so that they share one NCHW transform
+    OperatorSpec concat = ut_create_operator("concat", OT_Concat, {"b", "a"}, {"ab"});
+    concat.ps.concat_spec.axis = 1;
+    OperatorSpec softmax = ut_create_operator("softmax", OT_Softmax, {"ab"}, {"softmax"});
+    softmax.ps.softmax_spec.axis = 1;
+    std::vector<OperatorSpec> ops = {concat, softmax};
+    const char *names[2] = {"roialign1", "roialign2"};
+    for (U32 i = 0; i < 2; i++) {
+        OperatorSpec roialign =
+            ut_create_operator(names[i], OT_RoIAlign, {"a", "rois"}, {names[i]});
+        RoIAlignParamSpec &p = roialign.ps.roialign_spec;
+        p.output_h = 2 + i;
+        p.output_w = 3;
+        p.sampling_ratio = 2;
+        p.spatial_scale = 0.5 * (i + 1);
+        ops.push_back(roialign);
+    }
+    std::vector<const char *> outputs = {"softmax", "roialign1", "roialign2"};
+    std::map<std::string, TensorDesc> descs = get_input_descs(6, 5);
+    ModelSpec ms;
+    ut_create_model("format_assignment",
+        {{"a", descs["a"]}, {"b", descs["b"]}, {"rois", descs["rois"]}}, outputs, ops, {}, &ms);
+    auto on = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    auto off = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    CHECK_STATUS(mt_destroy_model(&ms));
+    off->set_format_assignment(false);
+    off->reready(descs);
+
+    U32 shapes[2][2] = {{6, 5}, {10, 7}};
+    for (U32 i = 0; i < 2; i++) {
+        descs = get_input_descs(shapes[i][0], shapes[i][1]);
+        if (i > 0) {
+            on->reready(descs);
+            off->reready(descs);
+        }
+        std::map<std::string, std::vector<F32>> inputs;
+        for (auto &iter : descs) {
+            inputs[iter.first] = std::vector<F32>(tensorNumElements(iter.second));
+            ut_init_v((U8 *)inputs[iter.first].data(), inputs[iter.first].size(), DT_F32,
+                UT_INIT_RANDOM);
+        }
+        // boxes inside the feature maps
+        for (U32 j = 0; j < 8; j++) {
+            inputs["rois"][j] = (j % 4 < 2) ? j % 4 : shapes[i][1 - j % 2] - 1;
+        }
+        run(on, inputs);
+        run(off, inputs);
+        for (auto &name : outputs) {
+            std::vector<F32> expect = ut_get_output(off, name);
+            std::vector<F32> actual = ut_get_output(on, name);
+            CHECK_REQUIREMENT(actual.size() == expect.size());
+            ut_check_v(actual.data(), expect.data(), actual.size(), DT_F32, 0.0001, __FILE__,
+                __LINE__);
+            UNI_INFO_LOG("%s of shape %u x %u matches the model without format assignment.\n",
+                name, shapes[i][0], shapes[i][1]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "engine_ut_util.h"
+
+// decode an attention layer step by step with keys and values kept in kv cache, and compare the
+// outputs with a model that is given the whole history on every step
+
+static const U32 heads = 2, dim = 8, chunk = 2;
+
+// keys and values of the steps so far, [heads, length, dim]
+struct History {
+    std::vector<F32> key[heads];
+    std::vector<F32> value[heads];
+
+    U32 length()
+    {
+        return key[0].size() / dim;
+    }
+
+    void truncate(U32 length)
+    {
+        for (U32 h = 0; h < heads; h++) {
+            key[h].resize(length * dim);
+            value[h].resize(length * dim);
+        }
+    }
+};
+
+// the packed model also exports the keys through a Power, which can not read a row stride
+static void create_model(bool packed, ModelSpec *ms)
+{
+    std::vector<OperatorSpec> ops;
+    OperatorSpec catKey =
+        ut_create_operator("cat_key", OT_Concat, {"past_key", "key"}, {"present_key"});
+    catKey.ps.concat_spec.axis = 2;
+    ops.push_back(catKey);
+    OperatorSpec catValue =
+        ut_create_operator("cat_value", OT_Concat, {"past_value", "value"}, {"present_value"});
+    catValue.ps.concat_spec.axis = 2;
+    ops.push_back(catValue);
+    OperatorSpec qk = ut_create_operator("qk", OT_MatMul, {"query", "present_key"}, {"score"});
+    qk.ps.matmul_spec.transpose_b = true;
+    ops.push_back(qk);
+    OperatorSpec softmax = ut_create_operator("softmax", OT_Softmax, {"score"}, {"prob"});
+    softmax.ps.softmax_spec.axis = -1;
+    ops.push_back(softmax);
+    ops.push_back(ut_create_operator("pv", OT_MatMul, {"prob", "present_value"}, {"context"}));
+    OperatorSpec sdpa = ut_create_operator("sdpa", OT_ScaledDotProductAttention,
+        {"query", "present_key", "present_value"}, {"attention"});
+    sdpa.ps.sdpa_spec.transpose_key = true;
+    sdpa.ps.sdpa_spec.scale = 1;
+    sdpa.ps.sdpa_spec.mask_mode = SDPA_MASK_NONE;
+    ops.push_back(sdpa);
+    std::vector<const char *> outputs = {"present_key", "present_value", "context", "attention"};
+    if (packed) {
+        OperatorSpec power = ut_create_operator("power", OT_Power, {"present_key"}, {"key_copy"});
+        power.ps.power_spec.scale = 1;
+        power.ps.power_spec.shift = 0;
+        power.ps.power_spec.power = 1;
+        ops.push_back(power);
+        outputs.push_back("key_copy");
+    }
+    TensorDesc pastDesc = tensor4df(DT_F32, DF_NCHW, 1, heads, 0, dim);
+    TensorDesc stepDesc = tensor4df(DT_F32, DF_NCHW, 1, heads, chunk, dim);
+    ut_create_model(packed ? "kv_cache_packed" : "kv_cache",
+        {{"past_key", pastDesc}, {"past_value", pastDesc}, {"key", stepDesc},
+            {"value", stepDesc}, {"query", stepDesc}},
+        outputs, ops, {}, ms);
+}
+
+static std::vector<F32> random_step()
+{
+    std::vector<F32> data(heads * chunk * dim);
+    ut_init_v((U8 *)data.data(), data.size(), DT_F32, UT_INIT_RANDOM);
+    return data;
+}
+
+// run one step on the model with kv cache and on the reference, which is given history, and
+// append the step to history
+static void check_step(
+    std::shared_ptr<CNN> cached, std::shared_ptr<CNN> reference, History *history)
+{
+    std::vector<F32> key = random_step(), value = random_step(), query = random_step();
+    std::map<std::string, TensorDesc> descs = reference->get_input_desc();
+    U32 length = history->length();
+    descs["past_key"].dims[1] = length;
+    descs["past_value"].dims[1] = length;
+    reference->reready(descs);
+    std::vector<F32> pastKey, pastValue;
+    for (U32 h = 0; h < heads; h++) {
+        pastKey.insert(pastKey.end(), history->key[h].begin(), history->key[h].end());
+        pastValue.insert(pastValue.end(), history->value[h].begin(), history->value[h].end());
+        U32 offset = h * chunk * dim;
+        history->key[h].insert(
+            history->key[h].end(), key.begin() + offset, key.begin() + offset + chunk * dim);
+        history->value[h].insert(history->value[h].end(), value.begin() + offset,
+            value.begin() + offset + chunk * dim);
+    }
+    std::map<std::string, U8 *> inputs = {
+        {"key", (U8 *)key.data()}, {"value", (U8 *)value.data()}, {"query", (U8 *)query.data()}};
+    cached->set_input_by_copy(inputs);
+    cached->run();
+    inputs["past_key"] = (U8 *)pastKey.data();
+    inputs["past_value"] = (U8 *)pastValue.data();
+    reference->set_input_by_copy(inputs);
+    reference->run();
+
+    CHECK_REQUIREMENT(cached->get_kv_cache_length() == history->length());
+    for (std::string name : {"context", "attention"}) {
+        std::vector<F32> actual = ut_get_output(cached, name);
+        std::vector<F32> expect = ut_get_output(reference, name);
+        CHECK_REQUIREMENT(actual.size() == expect.size());
+        ut_check_v(actual.data(), expect.data(), actual.size(), DT_F32, 0.0001, __FILE__, __LINE__);
+    }
+}
+
+static void test_kv_cache(bool packed)
+{
+    ModelSpec ms;
+    create_model(packed, &ms);
+    auto reference = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    auto cached = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    CHECK_STATUS(mt_destroy_model(&ms));
+    const char *mode = packed ? "packed rows" : "row stride";
+
+    // the capacity of 2 steps grows twice
+    cached->set_kv_cache(2 * chunk);
+    History history;
+    for (U32 i = 0; i < 5; i++) {
+        check_step(cached, reference, &history);
+    }
+    UNI_INFO_LOG("%s: decoding matches the whole history.\n", mode);
+
+    // a fork continues from the same history independently
+    std::shared_ptr<CNN> fork = std::shared_ptr<CNN>(new CNN(cached->clone()));
+    History forkHistory = history;
+    for (U32 i = 0; i < 2; i++) {
+        check_step(fork, reference, &forkHistory);
+        check_step(cached, reference, &history);
+    }
+    UNI_INFO_LOG("%s: a forked sequence matches its own history.\n", mode);
+
+    cached->truncate_kv_cache(3);
+    history.truncate(3);
+    check_step(cached, reference, &history);
+    check_step(cached, reference, &history);
+    UNI_INFO_LOG("%s: decoding after truncation matches the kept history.\n", mode);
+
+    cached->reset_kv_cache();
+    CHECK_REQUIREMENT(cached->get_kv_cache_length() == 0);
+    history.truncate(0);
+    check_step(cached, reference, &history);
+    check_step(fork, reference, &forkHistory);
+    UNI_INFO_LOG("%s: decoding after reset matches a new sequence.\n", mode);
+}
+
+int main()
+{
+    test_kv_cache(false);
+    test_kv_cache(true);
+    return 0;
+}
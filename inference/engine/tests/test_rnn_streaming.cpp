@@ -0,0 +1,86 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "engine_ut_util.h"
+
+// feed a sequence to a two layer LSTM chunk by chunk in streaming mode, and compare the outputs
+// with one run over the whole sequence
+
+static std::vector<F32> run_chunk(std::shared_ptr<CNN> cnn, F32 *input)
+{
+    std::map<std::string, U8 *> inputs = {{"data", (U8 *)input}};
+    cnn->set_input_by_copy(inputs);
+    cnn->run();
+    return ut_get_output(cnn, "h2");
+}
+
+static void check_chunk(std::vector<F32> actual, const F32 *expect, const char *step)
+{
+    ut_check_v(actual.data(), (void *)expect, actual.size(), DT_F32, 0.0001, __FILE__, __LINE__);
+    UNI_INFO_LOG("%s matches the whole sequence.\n", step);
+}
+
+int main()
+{
+    U32 x = 6, h = 8, chunk = 4, chunks = 3, steps = chunk * chunks;
+    std::vector<OperatorSpec> ops;
+    std::vector<WeightSpec> ws;
+    const char *names[2][3] = {{"lstm1", "data", "h1"}, {"lstm2", "h1", "h2"}};
+    for (U32 i = 0, xDim = x; i < 2; i++, xDim = h) {
+        OperatorSpec lstm = ut_create_operator(names[i][0], OT_RNN, {names[i][1]}, {names[i][2]});
+        RNNParamSpec &p = lstm.ps.rnn_spec;
+        p.mode = RNN_LSTM;
+        p.numOutput = h;
+        p.steps = 0;
+        p.numProjection = 0;
+        p.biDirection = false;
+        p.activationMode = ACTIVATION_TANH;
+        ops.push_back(lstm);
+        ws.push_back(ut_create_weight(names[i][0], 4 * h * (xDim + h), 4 * h));
+    }
+    ModelSpec ms;
+    TensorDesc wholeDesc = tensor3df(DT_F32, DF_MTK, 1, steps, x);
+    ut_create_model("rnn_streaming", {{"data", wholeDesc}}, {"h2"}, ops, ws, &ms);
+    auto whole = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    ms.input_dims[0] = tensor3df(DT_F32, DF_MTK, 1, chunk, x);
+    auto stream = createPipelinefromMs("CPU_AFFINITY_HIGH_PERFORMANCE", &ms, "");
+    CHECK_STATUS(mt_destroy_model(&ms));
+
+    std::vector<F32> input(steps * x);
+    ut_init_v((U8 *)input.data(), input.size(), DT_F32, UT_INIT_RANDOM);
+    std::vector<F32> expect = run_chunk(whole, input.data());
+
+    stream->set_streaming(true);
+    std::vector<U8> state(stream->get_streaming_state_bytes());
+    CHECK_REQUIREMENT(state.size() > 0);
+    for (U32 i = 0; i < chunks; i++) {
+        if (i == chunks - 1) {
+            stream->save_streaming_state(state.data());
+        }
+        check_chunk(run_chunk(stream, input.data() + i * chunk * x), expect.data() + i * chunk * h,
+            "streaming chunk");
+    }
+
+    // a saved state continues the stream, also after another stream has run
+    stream->reset_streaming_state();
+    check_chunk(run_chunk(stream, input.data()), expect.data(), "chunk after reset");
+    stream->load_streaming_state(state.data());
+    U32 last = chunks - 1;
+    check_chunk(run_chunk(stream, input.data() + last * chunk * x), expect.data() + last * chunk * h,
+        "chunk after loading the saved state");
+
+    // streaming off starts each run from zero states
+    stream->set_streaming(false);
+    check_chunk(run_chunk(stream, input.data()), expect.data(), "chunk without streaming");
+    return 0;
+}
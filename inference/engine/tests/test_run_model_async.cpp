@@ -0,0 +1,102 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "engine_ut_util.h"
+#include "../api/c/bolt.h"
+
+// asynchronous runs of a model through the C API give the results of synchronous runs, also when
+// several runs are queued on one handle and when the outputs are bound to caller buffers
+
+static std::vector<F32> get_result(ResultHandle result, U32 size)
+{
+    void *data[1];
+    GetOutputDataFromResultHandle(result, 1, data);
+    return std::vector<F32>((F32 *)data[0], (F32 *)data[0] + size);
+}
+
+static void check_result(std::vector<F32> actual, std::vector<F32> expect, const char *step)
+{
+    ut_check_v(actual.data(), expect.data(), actual.size(), DT_F32, 0.0001, __FILE__, __LINE__);
+    UNI_INFO_LOG("%s matches the synchronous run.\n", step);
+}
+
+int main()
+{
+    U32 k = 32, n = 16, runs = 4;
+    OperatorSpec fc = ut_create_operator("fc", OT_FC, {"data"}, {"fc"});
+    fc.ps.fc_spec.num_outputs = n;
+    fc.ps.fc_spec.num_slices = 1;
+    fc.ps.fc_spec.slice_point[0] = n;
+    OperatorSpec relu = ut_create_operator("relu", OT_Relu, {"fc"}, {"output"});
+    ModelSpec ms;
+    ut_create_model("run_model_async", {{"data", tensor2df(DT_F32, DF_NORMAL, 1, k)}}, {"output"},
+        {fc, relu}, {ut_create_weight("fc", n * k, n)}, &ms);
+    const char *path = "./test_run_model_async.bolt";
+    CHECK_STATUS(serialize_model_to_file(&ms, path));
+    CHECK_STATUS(mt_destroy_model(&ms));
+
+    ModelHandle model = CreateModel(path, CPU_HIGH_PERFORMANCE, NULL);
+    remove(path);
+    char inputName[NAME_LEN] = "data";
+    char *inputNames[1] = {inputName};
+    int in = 1, ic = k, ih = 1, iw = 1;
+    DATA_TYPE idt = FP_32;
+    DATA_FORMAT idf = NORMAL;
+    PrepareModel(model, 1, (const char **)inputNames, &in, &ic, &ih, &iw, &idt, &idf);
+    ResultHandle result = AllocAllResultHandle(model);
+
+    std::vector<std::vector<F32>> inputs(runs, std::vector<F32>(k)), expects;
+    for (U32 i = 0; i < runs; i++) {
+        ut_init_v((U8 *)inputs[i].data(), k, DT_F32, UT_INIT_RANDOM);
+        void *data[1] = {inputs[i].data()};
+        RunModel(model, result, 1, (const char **)inputNames, data);
+        expects.push_back(get_result(result, n));
+    }
+
+    for (U32 i = 0; i < runs; i++) {
+        void *data[1] = {inputs[i].data()};
+        RunHandle run = RunModelAsync(model, result, 1, (const char **)inputNames, data);
+        WaitRunModel(run);
+        check_result(get_result(result, n), expects[i], "asynchronous run");
+    }
+
+    // queued runs execute one by one in order, so the last one writes the result
+    std::vector<RunHandle> queued;
+    for (U32 i = 0; i < runs; i++) {
+        void *data[1] = {inputs[i].data()};
+        queued.push_back(RunModelAsync(model, result, 1, (const char **)inputNames, data));
+    }
+    for (U32 i = 0; i < runs; i++) {
+        WaitRunModel(queued[i]);
+    }
+    check_result(get_result(result, n), expects[runs - 1], "last of the queued runs");
+
+    std::vector<F32> input = inputs[0], output(n, -1);
+    void *inputData[1] = {input.data()};
+    void *outputData[1] = {output.data()};
+    char outputName[NAME_LEN] = "output";
+    char *outputNames[1] = {outputName};
+    BindModelInputOutput(model, 1, (const char **)inputNames, inputData, 1,
+        (const char **)outputNames, outputData);
+    WaitRunModel(RunModelAsync(model, result, 0, NULL, NULL));
+    check_result(output, expects[0], "bound output of an asynchronous run");
+
+    // a queued run is finished before the model is destroyed
+    input = inputs[1];
+    RunHandle last = RunModelAsync(model, result, 0, NULL, NULL);
+    DestroyModel(model);
+    WaitRunModel(last);
+    FreeResultHandle(result);
+    check_result(output, expects[1], "run queued before DestroyModel");
+    return 0;
+}
@@ -30,6 +30,7 @@ int convolutionCPUFloatAlgorithmSearch(Arch arch, DataType dt, std::string path)
     U32 in = 1;
     ArchInfo archInfo;
     archInfo.arch = UT_ARCH;
+    archInfo.numThreads = 0;
     U32 ic_step, ihw_step, fn_step, ic_max, ihw_max, fn_max;
     std::set<U32> fwh;
     std::set<U32> stride;
@@ -56,6 +56,7 @@ void load_cifar10(U8 *dataset, U32 batchIdx, TensorDesc inDesc, float *pixels, T
     F32 factor = 1.0 / 255;
     ArchInfo archInfo;
     archInfo.arch = CPU_GENERAL;
+    archInfo.numThreads = 0;
 
     if (training) {
         memset(labels, 0, BATCH_SIZE * 10 * sizeof(float));
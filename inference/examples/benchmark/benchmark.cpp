@@ -12,7 +12,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <iostream>
+#include <fstream>
 #include <getopt.h>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <algorithm>
 #include "inference.hpp"
 #include "data_loader.hpp"
 #include "profiling.h"
@@ -26,12 +31,31 @@ char *algorithmMapPath = (char *)"";
 int loopTime = 1;
 int warmUp = 10;
 int threadsNum = OMP_MAX_NUM_THREADS;
+int instancesNum = 1;
+double arrivalRate = 0;
+std::string arrivalProcess = "FIXED";
+std::vector<int> threadsSweep;
+std::string jsonPath = "";
+std::string tracePath = "";
+double peakGFlops = 0;
+double peakGBs = 0;
+
+struct BenchmarkResult {
+    int threads;
+    int instances;
+    double arrivalRate;
+    // wall time of all the measured loops
+    double totalTime;
+    // latency of each loop, including the queueing time in open loop mode
+    std::vector<double> latencies;
+};
 
 void print_benchmark_usage()
 {
     printf("benchmark usage: (<> must be filled in with exact value; [] is optional)\n"
            "./benchmark -m <boltModelPath> -i [inputDataPath] -a [affinityPolicyName] -p "
-           "[algorithmMapPath] -l [loopTime]\n"
+           "[algorithmMapPath] -l [loopTime] -c [instancesNum] -r [arrivalRate] -d "
+           "[arrivalProcess] -s [threadsSweep] -j [jsonPath] -o [tracePath] -e [roofline]\n"
            "\nParameter description:\n"
            "1. -m <boltModelPath>: The path where .bolt is stored.\n"
            "2. -i [inputDataPath]: The input data absolute path. If not input the option, "
@@ -43,8 +67,22 @@ void print_benchmark_usage()
            "5. -l [loopTime]: The running loopTimes. The default value is %d.\n"
            "6. -w [warmUp]: WarmUp times. The default value is %d.\n"
            "7. -t [threadsNum]: Parallel threads num. The default value is %d.\n"
+           "8. -c [instancesNum]: The number of model clones that run concurrently, the loops are "
+           "shared among them. The default value is %d.\n"
+           "9. -r [arrivalRate]: The number of inferences per second that arrive regardless of "
+           "completion (open loop), latency includes the queueing time. 0 keeps every instance "
+           "busy (closed loop). The default value is %.0f.\n"
+           "10. -d [arrivalProcess]: The arrival intervals of open loop mode. You can only choose "
+           "one of {FIXED, POISSON}. The default value is %s.\n"
+           "11. -s [threadsSweep]: Comma separated parallel threads nums to measure one by one, "
+           "for example 1,2,4. It overrides -t.\n"
+           "12. -j [jsonPath]: Also write the statistics to a JSON file.\n"
+           "13. -o [tracePath]: Profile every operator of the measured loops, write a Chrome "
+           "trace and print GFLOP/s and GB/s of each operator type.\n"
+           "14. -e [roofline]: Peak GFLOP/s and GB/s of the machine separated by a comma, for "
+           "example 100,20. The operator statistics also show the roofline efficiency.\n"
            "Example: ./benchmark -m /local/models/resnet50_f16.bolt\n",
-        loopTime, warmUp, threadsNum);
+        loopTime, warmUp, threadsNum, instancesNum, arrivalRate, arrivalProcess.c_str());
 }
 
 void parse_options(int argc, char *argv[])
@@ -60,7 +98,7 @@ void parse_options(int argc, char *argv[])
     }
 
     int option;
-    const char *optionstring = "m:i:a:p:l:w:t:";
+    const char *optionstring = "m:i:a:p:l:w:t:c:r:d:s:j:o:e:";
     while ((option = getopt(argc, argv, optionstring)) != -1) {
         switch (option) {
             case 'm':
@@ -91,6 +129,51 @@ void parse_options(int argc, char *argv[])
                 std::cout << "option is -t [threadsNum], value is: " << optarg << std::endl;
                 threadsNum = atoi(optarg);
                 break;
+            case 'c':
+                std::cout << "option is -c [instancesNum], value is: " << optarg << std::endl;
+                instancesNum = UNI_MAX(1, atoi(optarg));
+                break;
+            case 'r':
+                std::cout << "option is -r [arrivalRate], value is: " << optarg << std::endl;
+                arrivalRate = atof(optarg);
+                break;
+            case 'd':
+                std::cout << "option is -d [arrivalProcess], value is: " << optarg << std::endl;
+                arrivalProcess = std::string(optarg);
+                if (arrivalProcess != "FIXED" && arrivalProcess != "POISSON") {
+                    std::cout << "Unknown arrival process " << arrivalProcess << std::endl;
+                    print_benchmark_usage();
+                    exit(-1);
+                }
+                break;
+            case 's': {
+                std::cout << "option is -s [threadsSweep], value is: " << optarg << std::endl;
+                std::string sweep = std::string(optarg);
+                for (size_t begin = 0, end = 0; begin < sweep.size(); begin = end + 1) {
+                    end = sweep.find(',', begin);
+                    if (end == std::string::npos) {
+                        end = sweep.size();
+                    }
+                    threadsSweep.push_back(atoi(sweep.substr(begin, end - begin).c_str()));
+                }
+                break;
+            }
+            case 'j':
+                std::cout << "option is -j [jsonPath], value is: " << optarg << std::endl;
+                jsonPath = std::string(optarg);
+                break;
+            case 'o':
+                std::cout << "option is -o [tracePath], value is: " << optarg << std::endl;
+                tracePath = std::string(optarg);
+                break;
+            case 'e':
+                std::cout << "option is -e [roofline], value is: " << optarg << std::endl;
+                if (sscanf(optarg, "%lf,%lf", &peakGFlops, &peakGBs) != 2) {
+                    std::cout << "roofline should be peakGFlops,peakGBs" << std::endl;
+                    print_benchmark_usage();
+                    exit(-1);
+                }
+                break;
             default:
                 std::cout << "Input option gets error, please check the params meticulously.\n";
                 print_benchmark_usage();
@@ -155,6 +238,128 @@ std::map<std::string, std::shared_ptr<Tensor>> get_output(
     return outMap;
 }
 
+// the loops are taken in order by the instances, in open loop mode loop i arrives at its
+// scheduled time and waits until an instance is free
+BenchmarkResult run_benchmark(std::vector<std::shared_ptr<CNN>> &pipelines,
+    int threads,
+    std::map<std::string, std::shared_ptr<U8>> &model_tensors_input,
+    std::map<std::string, std::shared_ptr<Tensor>> &outMap)
+{
+    BenchmarkResult result = {threads, (int)pipelines.size(), arrivalRate, 0,
+        std::vector<double>(UNI_MAX(0, loopTime), 0)};
+    for (auto pipeline : pipelines) {
+        pipeline->set_num_threads(threads);
+        for (int i = 0; i < warmUp; i++) {
+            pipeline->set_input_by_assign(model_tensors_input);
+            pipeline->run();
+            outMap = get_output(pipeline, affinityPolicyName);
+        }
+    }
+#ifdef _USE_GPU
+    if (strcmp(affinityPolicyName, "GPU") == 0) {
+        gcl_finish(OCLContext::getInstance().handle.get());
+    }
+#endif
+    // the first instance is profiled after warming up
+    if (tracePath != "") {
+        pipelines[0]->set_profiling(true);
+    }
+
+    std::vector<double> arrivals(result.latencies.size(), 0);
+    if (arrivalRate > 0) {
+        std::mt19937 generator(0);
+        std::exponential_distribution<double> interval(arrivalRate / 1000);
+        for (U32 i = 1; i < arrivals.size(); i++) {
+            arrivals[i] = (arrivalProcess == "POISSON") ? arrivals[i - 1] + interval(generator)
+                                                        : i * 1000 / arrivalRate;
+        }
+    }
+    std::atomic<int> next(0);
+    double start = ut_time_ms();
+    auto work = [&](int id) {
+        std::map<std::string, std::shared_ptr<Tensor>> outputs;
+        for (int i = next++; i < loopTime; i = next++) {
+            double timeBegin = ut_time_ms();
+            if (arrivalRate > 0) {
+                double arrival = start + arrivals[i];
+                if (arrival > timeBegin) {
+                    std::this_thread::sleep_for(
+                        std::chrono::microseconds((long long)((arrival - timeBegin) * 1000)));
+                }
+                timeBegin = arrival;
+            }
+            pipelines[id]->set_input_by_assign(model_tensors_input);
+            pipelines[id]->run();
+            outputs = get_output(pipelines[id], affinityPolicyName);
+            result.latencies[i] = ut_time_ms() - timeBegin;
+        }
+        if (id == 0) {
+            outMap = outputs;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (U32 id = 1; id < pipelines.size(); id++) {
+        workers.push_back(std::thread(work, id));
+    }
+    work(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    result.totalTime = ut_time_ms() - start;
+    return result;
+}
+
+// nearest-rank percentile of sorted latencies
+double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.size() == 0) {
+        return 0;
+    }
+    int rank = (int)ceil(p / 100 * sorted.size());
+    return sorted[UNI_MIN(UNI_MAX(rank, 1), (int)sorted.size()) - 1];
+}
+
+void print_statistics(BenchmarkResult result, std::ofstream &json, bool first)
+{
+    std::vector<double> sorted = result.latencies;
+    std::sort(sorted.begin(), sorted.end());
+    double totalTime = 0;
+    for (double time : sorted) {
+        totalTime += time;
+    }
+    int loops = sorted.size();
+    double minTime = (loops > 0) ? sorted.front() : 0;
+    double maxTime = (loops > 0) ? sorted.back() : 0;
+    double throughput = loops * 1000.0 / UNI_MAX(result.totalTime, DBL_EPSILON);
+    std::vector<std::pair<std::string, double>> percentiles = {{"p50", percentile(sorted, 50)},
+        {"p90", percentile(sorted, 90)}, {"p99", percentile(sorted, 99)},
+        {"p99.9", percentile(sorted, 99.9)}};
+
+    UNI_CI_LOG("threads:%d instances:%d arrival_rate:%f/s\n", result.threads, result.instances,
+        result.arrivalRate);
+    UNI_CI_LOG("total_time:%fms(loops=%d)\n", 1.0 * totalTime, loops);
+    UNI_CI_LOG("avg_time:%fms/data\n", 1.0 * totalTime / UNI_MAX(1, loops));
+    UNI_CI_LOG("min_time:%fms/data\n", 1.0 * minTime);
+    UNI_CI_LOG("max_time:%fms/data\n", 1.0 * maxTime);
+    for (auto iter : percentiles) {
+        UNI_CI_LOG("%s_time:%fms/data\n", iter.first.c_str(), iter.second);
+    }
+    UNI_CI_LOG("throughput:%fdata/s\n", throughput);
+
+    if (!json.is_open()) {
+        return;
+    }
+    json << (first ? "" : ",\n") << "    {\"threads\": " << result.threads
+         << ", \"instances\": " << result.instances << ", \"arrival_rate\": " << result.arrivalRate
+         << ", \"loops\": " << loops << ", \"wall_time_ms\": " << result.totalTime
+         << ", \"avg_ms\": " << totalTime / UNI_MAX(1, loops) << ", \"min_ms\": " << minTime
+         << ", \"max_ms\": " << maxTime;
+    for (auto iter : percentiles) {
+        json << ", \"" << iter.first << "_ms\": " << iter.second;
+    }
+    json << ", \"throughput\": " << throughput << "}";
+}
+
 int main(int argc, char *argv[])
 {
     UNI_TIME_INIT
@@ -164,6 +369,14 @@ int main(int argc, char *argv[])
 
     // 1: set up the pipeline
     auto pipeline = createPipeline(affinityPolicyName, modelPath, algorithmMapPath);
+    std::vector<std::shared_ptr<CNN>> pipelines(1, pipeline);
+    if (instancesNum > 1 && strcmp(affinityPolicyName, "GPU") == 0) {
+        UNI_WARNING_LOG("benchmark only runs one instance on GPU\n");
+        instancesNum = 1;
+    }
+    for (int i = 1; i < instancesNum; i++) {
+        pipelines.push_back(std::shared_ptr<CNN>(new CNN(pipeline->clone())));
+    }
 
     // 2: create input data and feed the pipeline with it
     auto model_tensors_input = create_tensors_from_path(inputData, pipeline);
@@ -171,40 +384,39 @@ int main(int argc, char *argv[])
     std::map<std::string, std::shared_ptr<Tensor>> outMap;
 
     // 3: warm up and run
-    for (int i = 0; i < warmUp; i++) {
-        pipeline->set_input_by_assign(model_tensors_input);
-        pipeline->run();
-        outMap = get_output(pipeline, affinityPolicyName);
+    if (threadsSweep.size() == 0) {
+        threadsSweep.push_back(threadsNum);
     }
-#ifdef _USE_GPU
-    if (strcmp(affinityPolicyName, "GPU") == 0) {
-        gcl_finish(OCLContext::getInstance().handle.get());
-    }
-#endif
-
-    double minTime = DBL_MAX;
-    double maxTime = 0;
-    double totalTime = 0;
-    for (int i = 0; i < loopTime; i++) {
-        double timeBegin = ut_time_ms();
-        pipeline->set_input_by_assign(model_tensors_input);
-        pipeline->run();
-        outMap = get_output(pipeline, affinityPolicyName);
-        double timeEnd = ut_time_ms();
-        double time = timeEnd - timeBegin;
-        minTime = (minTime < time) ? minTime : time;
-        maxTime = (maxTime > time) ? maxTime : time;
-        totalTime += time;
+    std::vector<BenchmarkResult> results;
+    for (int threads : threadsSweep) {
+        results.push_back(run_benchmark(pipelines, threads, model_tensors_input, outMap));
     }
 
     // 4: process result
     print_result(outMap);
 
     UNI_TIME_STATISTICS
-    UNI_CI_LOG("total_time:%fms(loops=%d)\n", 1.0 * totalTime, loopTime);
-    UNI_CI_LOG("avg_time:%fms/data\n", 1.0 * totalTime / UNI_MAX(1, loopTime));
-    UNI_CI_LOG("min_time:%fms/data\n", 1.0 * minTime);
-    UNI_CI_LOG("max_time:%fms/data\n", 1.0 * maxTime);
+    std::ofstream json;
+    if (jsonPath != "") {
+        json.open(jsonPath.c_str());
+        if (!json.is_open()) {
+            UNI_WARNING_LOG("can not write benchmark result to %s\n", jsonPath.c_str());
+        }
+        json << "{\n  \"model\": \"" << modelPath << "\",\n  \"affinity\": \""
+             << affinityPolicyName << "\",\n  \"arrival_process\": \"" << arrivalProcess
+             << "\",\n  \"results\": [\n";
+    }
+    for (U32 i = 0; i < results.size(); i++) {
+        print_statistics(results[i], json, i == 0);
+    }
+    if (json.is_open()) {
+        json << "\n  ]\n}\n";
+    }
+    if (tracePath != "") {
+        pipeline->set_profiling_roofline(peakGFlops, peakGBs);
+        pipeline->print_profiling_statistics();
+        pipeline->save_profiling_trace(tracePath);
+    }
     pipeline->saveAlgorithmMapToFile(algorithmMapPath);
     return 0;
 }
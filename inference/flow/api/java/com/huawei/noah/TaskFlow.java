@@ -93,6 +93,17 @@ public final class TaskFlow {
         this.tasksAddr.add(new Long(task_addr));
     }
 
+    /** callback of an enqueued task, invoked on a flow worker thread */
+    public interface TaskCallback {
+        void onTaskEnd(long task_addr);
+    }
+
+    public void enqueue(long task_addr, TaskCallback callback)
+    {
+        taskEnqueueCallback(this.flowAddr, task_addr, callback);
+        this.tasksAddr.add(new Long(task_addr));
+    }
+
     public long[] dequeue(boolean block)
     {
         long[] finished_tasks_addr = tasksDequeue(this.flowAddr, block);
@@ -105,6 +116,18 @@ public final class TaskFlow {
         return finished_tasks_addr;
     }
 
+    public long[] dequeueAny(int num)
+    {
+        long[] finished_tasks_addr = tasksDequeueAny(this.flowAddr, num);
+        for (int i = 0; i < finished_tasks_addr.length; i++) {
+            int index = this.tasksAddr.indexOf((new Long(finished_tasks_addr[i])));
+            if (index != -1) {
+                this.tasksAddr.remove(index);
+            }
+        }
+        return finished_tasks_addr;
+    }
+
     public BoltResult getOutput(long task_addr, int outputNumber, String[] outputNames)
     {
         return getTaskResult(
@@ -151,8 +174,13 @@ public final class TaskFlow {
 
     private native void taskEnqueue(long flow_addr, long task_addr);
 
+    private native void taskEnqueueCallback(
+        long flow_addr, long task_addr, TaskCallback callback);
+
     private native long[] tasksDequeue(long flow_addr, boolean block);
 
+    private native long[] tasksDequeueAny(long flow_addr, int num);
+
     private native BoltResult getTaskResult(
         long task_addr, int outputNumber, String[] outputNames, String boltResultClassPath);
 
@@ -27,6 +27,14 @@ extern "C" {
  */
 JNIEXPORT void JNICALL BOLT_JNI_PREFIX(TaskFlow_taskEnqueue)(JNIEnv *, jobject, jlong, jlong);
 
+/*
+ * Class:     TaskFlow
+ * Method:    taskEnqueueCallback
+ * Signature: (JJLcom/huawei/noah/TaskFlow$TaskCallback;)V
+ */
+JNIEXPORT void JNICALL BOLT_JNI_PREFIX(TaskFlow_taskEnqueueCallback)(
+    JNIEnv *, jobject, jlong, jlong, jobject);
+
 /*
  * Class:     TaskFlow
  * Method:    tasksDequeue
@@ -35,6 +43,14 @@ JNIEXPORT void JNICALL BOLT_JNI_PREFIX(TaskFlow_taskEnqueue)(JNIEnv *, jobject,
 JNIEXPORT jlongArray JNICALL BOLT_JNI_PREFIX(TaskFlow_tasksDequeue)(
     JNIEnv *, jobject, jlong, jboolean);
 
+/*
+ * Class:     TaskFlow
+ * Method:    tasksDequeueAny
+ * Signature: (JI)[J
+ */
+JNIEXPORT jlongArray JNICALL BOLT_JNI_PREFIX(TaskFlow_tasksDequeueAny)(
+    JNIEnv *, jobject, jlong, jint);
+
 /*
  * Class:     TaskFlow
  * Method:    getTaskResult
@@ -25,7 +25,7 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <queue>
+#include <deque>
 #include "flow.pb.h"
 
 #include "node.h"
@@ -63,6 +63,40 @@ public:
      */
     void enqueue(Task task);
 
+    /**
+     * @brief run queued tasks of the same graph as one batched inference, call it before init.
+     *        Tasks are stacked along the outermost dimension, init turns batching off for a graph
+     *        whose inputs or outputs do not have an outermost dimension of 1.
+     * @param  graphPath      predefined flow graph file path
+     * @param  maxBatch       the maximum number of tasks in a batch(1 disables batching)
+     * @param  maxWaitUs      the maximum time in microseconds to wait for a batch to fill(default
+     *                        is 0, only batch tasks that are already queued)
+     *
+     * @return
+     */
+    void setBatchPolicy(std::string graphPath, int maxBatch, int maxWaitUs = 0);
+
+    /**
+     * @brief run each node of the graph on its own threads, tasks are passed from node to node
+     *        through bounded queues so that the nodes work on different tasks at the same time,
+     *        call it before init
+     * @param  graphPath      predefined flow graph file path
+     * @param  queueDepth     the maximum number of tasks waiting in front of each node(default
+     *                        is 4), enqueue blocks when the first node's queue is full
+     * @param  stageThreads   the number of threads running each node(default is 1)
+     *
+     * @return
+     */
+    void setPipeline(std::string graphPath, int queueDepth = 4, int stageThreads = 1);
+
+    /**
+     * @brief get the per node queue depth and latency statistics of a pipelined graph
+     * @param  graphPath      predefined flow graph file path
+     *
+     * @return statistics: array of node statistics in running order
+     */
+    std::vector<StageStatistics> getStageStatistics(std::string graphPath);
+
     /** get already finished tasks
      * @brief
      * @param  block          set to blocked until all tasks has finished(default is false)
@@ -71,6 +105,14 @@ public:
      */
     std::vector<Task> dequeue(bool block = false);
 
+    /** get finished tasks in any order
+     * @brief
+     * @param  num            block until at least num tasks have finished
+     *
+     * @return finishedTasks: array of all finished tasks
+     */
+    std::vector<Task> dequeueAny(unsigned int num = 1);
+
     /**
      * @brief get the current number of unfinished tasks
      *
@@ -80,6 +122,6 @@ public:
 
 private:
     Schedule<flow::GraphParameter, Node, Tensor> schedule;
-    std::queue<std::shared_ptr<Task>> tasks;
+    std::deque<std::shared_ptr<Task>> tasks;
 };
 #endif  // FLOW_INCLUDE_FLOW_H_
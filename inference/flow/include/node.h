@@ -38,7 +38,7 @@ public:
 
     void setPrecision(DataType precision);
 
-    void initInference(AffinityPolicy affinityPolicy);
+    void initInference(AffinityPolicy affinityPolicy, int maxBatch = 1);
 
     unsigned int getTmpBufferSize();
 
@@ -117,22 +117,69 @@ JNIEXPORT void JNICALL BOLT_JNI_PREFIX(TaskFlow_taskEnqueue)(
     flow->enqueue(*task);
 }
 
-JNIEXPORT jlongArray JNICALL BOLT_JNI_PREFIX(TaskFlow_tasksDequeue)(
-    JNIEnv *env, jobject, jlong flow_addr, jboolean block)
+JNIEXPORT void JNICALL BOLT_JNI_PREFIX(TaskFlow_taskEnqueueCallback)(
+    JNIEnv *env, jobject, jlong flow_addr, jlong task_addr, jobject callback)
 {
     Flow *flow = (Flow *)flow_addr;
-    std::vector<Task> results = flow->dequeue(block);
+    Task *task = (Task *)task_addr;
+    JavaVM *vm = nullptr;
+    env->GetJavaVM(&vm);
+    jobject callbackRef = env->NewGlobalRef(callback);
+    // worker threads are not java threads, attach them for the duration of the call
+    task->callback = [vm, callbackRef, task_addr](Task *) {
+        JNIEnv *workerEnv = nullptr;
+        bool attached = false;
+        if (vm->GetEnv((void **)&workerEnv, JNI_VERSION_1_6) != JNI_OK) {
+#ifdef __ANDROID__
+            vm->AttachCurrentThread(&workerEnv, nullptr);
+#else
+            vm->AttachCurrentThread((void **)&workerEnv, nullptr);
+#endif
+            attached = true;
+        }
+        jclass callbackClass = workerEnv->GetObjectClass(callbackRef);
+        jmethodID onTaskEnd = workerEnv->GetMethodID(callbackClass, "onTaskEnd", "(J)V");
+        workerEnv->CallVoidMethod(callbackRef, onTaskEnd, task_addr);
+        workerEnv->DeleteLocalRef(callbackClass);
+        workerEnv->DeleteGlobalRef(callbackRef);
+        if (attached) {
+            vm->DetachCurrentThread();
+        }
+    };
+    flow->enqueue(*task);
+    task->callback = nullptr;
+}
+
+jlongArray tasks2LongArray(JNIEnv *env, std::vector<Task> &results)
+{
     int length = results.size();
     std::vector<jlong> tasks_addr(length);
     jlongArray newArr = env->NewLongArray(length);
     for (int i = 0; i < length; i++) {
         Task *task = new Task(&results[i]);
+        task->callback = nullptr;
         tasks_addr[i] = (jlong)task;
     }
     env->SetLongArrayRegion(newArr, 0, length, tasks_addr.data());
     return newArr;
 }
 
+JNIEXPORT jlongArray JNICALL BOLT_JNI_PREFIX(TaskFlow_tasksDequeue)(
+    JNIEnv *env, jobject, jlong flow_addr, jboolean block)
+{
+    Flow *flow = (Flow *)flow_addr;
+    std::vector<Task> results = flow->dequeue(block);
+    return tasks2LongArray(env, results);
+}
+
+JNIEXPORT jlongArray JNICALL BOLT_JNI_PREFIX(TaskFlow_tasksDequeueAny)(
+    JNIEnv *env, jobject, jlong flow_addr, jint num)
+{
+    Flow *flow = (Flow *)flow_addr;
+    std::vector<Task> results = flow->dequeueAny(num);
+    return tasks2LongArray(env, results);
+}
+
 JNIEXPORT jobject JNICALL BOLT_JNI_PREFIX(TaskFlow_getTaskResult)(JNIEnv *env,
     jobject,
     jlong task_addr,
@@ -40,31 +40,65 @@ void Flow::enqueue(Task task)
         UNI_ERROR_LOG("task is not ready to add queue\n");
     }
     std::shared_ptr<Task> taskPtr = std::shared_ptr<Task>(new Task(&task));
-    this->tasks.emplace(taskPtr);
+    this->tasks.push_back(taskPtr);
     this->schedule.enqueue(taskPtr.get());
     UNI_DEBUG_LOG("user enqueues task: end\n");
 }
 
+void Flow::setBatchPolicy(std::string graphPath, int maxBatch, int maxWaitUs)
+{
+    if (this->schedule.setBatchPolicy(graphPath, maxBatch, maxWaitUs) != 0) {
+        UNI_ERROR_LOG("flow set batch policy of %s failed\n", graphPath.c_str());
+    }
+}
+
+void Flow::setPipeline(std::string graphPath, int queueDepth, int stageThreads)
+{
+    if (this->schedule.setPipeline(graphPath, queueDepth, stageThreads) != 0) {
+        UNI_ERROR_LOG("flow set pipeline of %s failed\n", graphPath.c_str());
+    }
+}
+
+std::vector<StageStatistics> Flow::getStageStatistics(std::string graphPath)
+{
+    return this->schedule.getStageStatistics(graphPath);
+}
+
 std::vector<Task> Flow::dequeue(bool block)
 {
+    std::vector<Task *> tasks;
+    for (auto task : this->tasks) {
+        tasks.push_back(task.get());
+    }
+    std::vector<bool> finished = this->schedule.wait(tasks, block ? tasks.size() : 0);
     std::vector<Task> outputs;
-    if (this->tasks.size() == 0) {
-        return outputs;
+    for (unsigned int i = 0; i < finished.size() && finished[i]; i++) {
+        outputs.push_back(*this->tasks.front());
+        this->tasks.pop_front();
     }
-    for (;;) {
-        if (this->tasks.size() == 0) {
-            break;
-        }
-        auto task = this->tasks.front();
-        if (task->status == TASK_END) {
-            outputs.push_back(*task.get());
-            this->tasks.pop();
+    if (outputs.size() > 0) {
+        UNI_DEBUG_LOG("user get result (num=%d) end\n", (int)outputs.size());
+    }
+    return outputs;
+}
+
+std::vector<Task> Flow::dequeueAny(unsigned int num)
+{
+    std::vector<Task *> tasks;
+    for (auto task : this->tasks) {
+        tasks.push_back(task.get());
+    }
+    std::vector<bool> finished = this->schedule.wait(tasks, UNI_MIN(num, tasks.size()));
+    std::vector<Task> outputs;
+    std::deque<std::shared_ptr<Task>> unfinished;
+    for (unsigned int i = 0; i < finished.size(); i++) {
+        if (finished[i]) {
+            outputs.push_back(*this->tasks[i]);
         } else {
-            if (!block) {
-                break;
-            }
+            unfinished.push_back(this->tasks[i]);
         }
     }
+    this->tasks = unfinished;
     if (outputs.size() > 0) {
         UNI_DEBUG_LOG("user get result (num=%d) end\n", (int)outputs.size());
     }
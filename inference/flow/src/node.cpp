@@ -93,7 +93,7 @@ void Node::setTmpBuffer(std::shared_ptr<Tensor> tmpTensor)
     this->tmpTensor = tmpTensor;
 }
 
-void Node::initInference(AffinityPolicy affinityPolicy)
+void Node::initInference(AffinityPolicy affinityPolicy, int maxBatch)
 {
     if (this->inferenceParameter.size() == 0) {
         UNI_DEBUG_LOG("node %s has no inference\n", this->nodeParameter.name().c_str());
@@ -114,6 +114,22 @@ void Node::initInference(AffinityPolicy affinityPolicy)
     cnn.initialize_ops(&ms);
     cnn.loadAlgorithmMap(algorithmMapPath);
     std::map<std::string, TensorDesc> inputDescMap = extractInputDims(&ms);
+    // prepare weights and memory for the largest batch, later runs reready to the real one. Tasks
+    // are stacked along the outermost dimension, which has to hold one task in every input.
+    for (auto &iter : inputDescMap) {
+        if (maxBatch > 1 && (iter.second.nDims < 2 || iter.second.dims[iter.second.nDims - 1] != 1)) {
+            UNI_WARNING_LOG("node %s is prepared for one task because input %s(%s) has no batch "
+                            "outer dimension\n",
+                this->nodeParameter.name().c_str(), iter.first.c_str(),
+                tensorDesc2Str(iter.second).c_str());
+            maxBatch = 1;
+        }
+    }
+    for (auto &iter : inputDescMap) {
+        if (maxBatch > 1) {
+            iter.second.dims[iter.second.nDims - 1] *= maxBatch;
+        }
+    }
     cnn.ready(inputDescMap);
     CHECK_STATUS(cnn.mark_input_output());
     if (algorithmMapPath != nullptr)
@@ -218,6 +234,7 @@ EE Node::run()
             if (postprocessInputs.find(name) != postprocessInputs.end()) {
                 TensorDesc desc = inferenceResult[name]->get_desc();
                 postprocessInputs[name]->resize(desc);
+                postprocessInputs[name]->alloc();
                 void *src = ((CpuMemory *)inferenceResult[name]->get_memory())->get_ptr();
                 void *dst = ((CpuMemory *)postprocessInputs[name]->get_memory())->get_ptr();
                 if (src != dst) {
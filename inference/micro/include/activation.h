@@ -0,0 +1,96 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_ACTIVATION_H
+#define _MICRO_ACTIVATION_H
+
+#include "operator.h"
+
+class Activation : public Operator {
+public:
+    Activation(OperatorSpec spec, Arch arch) : Operator(spec, arch)
+    {
+        switch (spec.type) {
+            case OT_Relu: {
+                this->activationDesc.mode = ACTIVATION_RELU;
+                this->activationDesc.value[0] = spec.ps.relu_spec.neg_slope;
+                break;
+            }
+            case OT_Relu6: {
+                this->activationDesc.mode = ACTIVATION_RELU6;
+                break;
+            }
+            case OT_HSwish: {
+                this->activationDesc.mode = ACTIVATION_H_SWISH;
+                break;
+            }
+            case OT_HSwishNoDiv: {
+                this->activationDesc.mode = ACTIVATION_H_SWISH_NODIV;
+                break;
+            }
+            case OT_Sigmoid: {
+                this->activationDesc.mode = ACTIVATION_SIGMOID;
+                break;
+            }
+            case OT_HSigmoid: {
+                this->activationDesc.mode = ACTIVATION_H_SIGMOID;
+                break;
+            }
+            case OT_Gelu: {
+                this->activationDesc.mode = ACTIVATION_GELU;
+                break;
+            }
+            case OT_TanH: {
+                this->activationDesc.mode = ACTIVATION_TANH;
+                break;
+            }
+            case OT_Mish: {
+                this->activationDesc.mode = ACTIVATION_MISH;
+                break;
+            }
+            default:
+                UNI_ERROR_LOG("micro compiler not support activation %s.\n",
+                    OperatorTypeName()[spec.type]);
+        }
+    }
+
+    EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) override
+    {
+        Tensor inputTensor = create_tensor(inputDescs[0]);
+        Tensor outputTensor;
+        CHECK_STATUS(activation_infer_output_size(&inputTensor, &outputTensor, &this->archInfo));
+        this->inputDescs = inputDescs;
+        this->outputDescs = {outputTensor.get_desc()};
+        *outputDescs = this->outputDescs;
+        return SUCCESS;
+    }
+
+    std::string generate_declaration() override
+    {
+        return Util::structToCode("ActivationParamSpec", this->id + "_p", this->activationDesc);
+    }
+
+    std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) override
+    {
+        return call("activation_cpu",
+            {Util::tensorDescToCode(this->inputDescs[0]), inputs[0], this->id + "_p",
+                Util::tensorDescToCode(this->outputDescs[0]), outputs[0], arch_to_code()});
+    }
+
+private:
+    ActivationParamSpec activationDesc;
+};
+#endif  // _MICRO_ACTIVATION_H
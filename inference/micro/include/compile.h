@@ -1,9 +1,95 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_COMPILE_H
+#define _MICRO_COMPILE_H
+
+#include <string>
 #include <vector>
+#include "util.h"
 
+// generate a shell script that builds the generated sources against the bolt kernel libraries
 class Compile {
 public:
-    Compile(std::vector<std::string> sourceFileList, std::string compileFilePath);
+    Compile(std::vector<std::string> sourceFileList,
+        std::string compileFilePath,
+        std::string executable,
+        std::string boltRoot,
+        std::string libraryPath)
+    {
+        this->sourceFileList = sourceFileList;
+        this->compileFilePath = compileFilePath;
+        this->executable = executable;
+        this->boltRoot = boltRoot;
+        this->libraryPath = libraryPath;
+    }
+
+    EE generate()
+    {
+        return Util::writeToFile(this->generateCompileScript(), this->compileFilePath);
+    }
 
 private:
-    std::string generateCompileScript();
+    // the generated code reuses parameter structures of the generator, so it must be compiled
+    // with the same feature macros
+    std::string generateFlags()
+    {
+        std::string flags = "-O3 -std=c++11 -fPIC";
+#ifdef _USE_GENERAL
+        flags += " -D_USE_GENERAL";
+#endif
+#ifdef _USE_X86
+        flags += " -D_USE_X86 -mavx2 -mfma";
+#endif
+#ifdef _USE_FP32
+        flags += " -D_USE_FP32";
+#endif
+#ifdef _USE_INT8
+        flags += " -D_USE_INT8";
+#endif
+#ifdef _USE_OPENMP
+        flags += " -D_USE_OPENMP -fopenmp";
+#endif
+        return flags;
+    }
+
+    std::string generateCompileScript()
+    {
+        std::string sources;
+        for (auto file : this->sourceFileList) {
+            sources += " " + file;
+        }
+        std::string includes;
+        std::vector<std::string> directories = {"common/uni/include", "common/memory/include",
+            "compute/blas_enhance/include", "compute/tensor/include", "compute/tensor/src"};
+        for (auto directory : directories) {
+            includes += " -I${BOLT_ROOT}/" + directory;
+        }
+        std::string code = "#!/bin/bash\n\n"
+                           "# Generated by micro_compiler, do not edit.\n\n";
+        code += "BOLT_ROOT=${BOLT_ROOT:-" + this->boltRoot + "}\n";
+        code += "BOLT_LIBRARY_PATH=${BOLT_LIBRARY_PATH:-" + this->libraryPath + "}\n";
+        code += "CXX=${CXX:-c++}\n\n";
+        code += "${CXX} " + this->generateFlags() + includes + sources + " -o " + this->executable +
+            " -L${BOLT_LIBRARY_PATH} -ltensor -lblas_enhance -luni -lpthread || exit 1\n";
+        return code;
+    }
+
+    std::vector<std::string> sourceFileList;
+    std::string compileFilePath;
+    std::string executable;
+    std::string boltRoot;
+    std::string libraryPath;
 };
+#endif  // _MICRO_COMPILE_H
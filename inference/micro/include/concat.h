@@ -0,0 +1,70 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_CONCAT_H
+#define _MICRO_CONCAT_H
+
+#include "operator.h"
+
+class Concat : public Operator {
+public:
+    Concat(OperatorSpec spec, Arch arch) : Operator(spec, arch)
+    {
+        this->p = spec.ps.concat_spec;
+    }
+
+    EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) override
+    {
+        std::vector<Tensor> inputTensors;
+        for (auto desc : inputDescs) {
+            inputTensors.push_back(create_tensor(desc));
+        }
+        std::vector<Tensor *> inputTensorPtrs;
+        for (U32 i = 0; i < inputTensors.size(); i++) {
+            inputTensorPtrs.push_back(&inputTensors[i]);
+        }
+        Tensor outputTensor;
+        CHECK_STATUS(
+            concat_infer_output_size(inputTensorPtrs, this->p, &outputTensor, &this->archInfo));
+        CHECK_STATUS(
+            concat_infer_forward_tmp_bytes(inputTensors, &this->tmpBytes, &this->archInfo));
+        this->inputDescs = inputDescs;
+        this->outputDescs = {outputTensor.get_desc()};
+        *outputDescs = this->outputDescs;
+        return SUCCESS;
+    }
+
+    std::string generate_declaration() override
+    {
+        return Util::structToCode("ConcatParamSpec", this->id + "_p", this->p);
+    }
+
+    std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) override
+    {
+        std::string descs, ptrs;
+        for (U32 i = 0; i < inputs.size(); i++) {
+            descs += (i > 0 ? ", " : "") + Util::tensorDescToCode(this->inputDescs[i]);
+            ptrs += (i > 0 ? ", " : "") + inputs[i];
+        }
+        return call("concat_cpu",
+            {"{" + descs + "}", "{" + ptrs + "}", "nullptr", this->id + "_p", tmp,
+                Util::tensorDescToCode(this->outputDescs[0]), outputs[0], "nullptr"});
+    }
+
+private:
+    ConcatParamSpec p;
+};
+#endif  // _MICRO_CONCAT_H
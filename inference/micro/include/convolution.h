@@ -1,27 +1,277 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_CONVOLUTION_H
+#define _MICRO_CONVOLUTION_H
+
 #include "operator.h"
 
-class Convolution ::Operator {
+class Convolution : public Operator {
 public:
-    // use tensor_computing interface or rewrite
-    std::vector<TensorDesc> inferOutputSize(
-        std::vector<TensorDesc> inputDescs, void *paramaters) override
-    {}
-
-    std::string generateImplementation(
-        Arch arch, std::vector<TensorDesc> inputDescs, void *parameters) override
-    {}
-
-    pair<std::string, std::vector<std::string>> generateParameter(void *parameter) override
-    {}
-
-    std::string generateOutputTensorDesc(std::vector<std::string> outputNames,
-        Map<std::string, std::string> &tensorDescNameMap) override
-    {}
-    // output = "convolution(inputDesc, input, params, outputDesc, output);"
-    std::string generateCall(std::vector<std::string> inputDescstd::strings,
-        std::vector<std::string> inputstd::strings,
-        std::vector<std::string> parameterstd::strings,
-        std::vector<std::string> outputDescstd::strings,
-        std::vector<std::string> outputstd::strings) override
-    {}
+    Convolution(OperatorSpec spec, Arch arch) : Operator(spec, arch)
+    {
+        this->p = spec.ps.conv_spec;
+        this->dwActivationParamSpec.mode = this->p.dw_activation_type;
+        this->pwActivationParamSpec.mode = this->p.pw_activation_type;
+        this->pwAlg = CONVOLUTION_ALGORITHM_NULL;
+        this->dwAlg = DEPTHWISE_CONVOLUTION_ALGORITHM_NULL;
+        this->eltwiseFused = false;
+    }
+
+    EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) override
+    {
+        CHECK_STATUS(this->check_weight_type());
+        TensorDesc inputDesc = transformDescTo4d(inputDescs[0]);
+        if (!tensorIs4d(inputDesc) || inputDesc.dt != DT_F32) {
+            UNI_ERROR_LOG("micro compiler only supports 4d float32 convolution, operator %s input "
+                          "is %s.\n",
+                this->spec.name, tensorDesc2Str(inputDescs[0]).c_str());
+            return NOT_SUPPORTED;
+        }
+        U32 ic = inputDesc.dims[2];
+        std::vector<TensorDesc> filterDescs, biasDescs;
+        switch (this->p.convolution_type) {
+            case Convolution_Pointwise:
+            case Convolution_Dilation: {
+                filterDescs.push_back(tensor4d(DT_F32, this->p.num_outputs, ic / this->p.group,
+                    this->p.kernel_h, this->p.kernel_w));
+                biasDescs.push_back(tensor1d(DT_F32, this->p.num_outputs));
+                break;
+            }
+            case Convolution_Depthwise: {
+                filterDescs.push_back(tensor4d(DT_F32, 1, ic, this->p.kernel_h, this->p.kernel_w));
+                biasDescs.push_back(tensor1d(DT_F32, this->p.num_outputs));
+                break;
+            }
+            case Convolution_Depthwise_Pointwise: {
+                filterDescs.push_back(tensor4d(DT_F32, 1, ic, this->p.kernel_h, this->p.kernel_w));
+                filterDescs.push_back(tensor4d(DT_F32, this->p.num_outputs, ic, 1, 1));
+                biasDescs.push_back(tensor1d(DT_F32, ic));
+                biasDescs.push_back(tensor1d(DT_F32, this->p.num_outputs));
+                break;
+            }
+            default:
+                UNI_ERROR_LOG("micro compiler not support convolution type %d.\n",
+                    this->p.convolution_type);
+                return NOT_SUPPORTED;
+        }
+        CHECK_STATUS(this->load_weight(filterDescs, biasDescs));
+
+        Tensor inputTensor = create_tensor(inputDesc);
+        Tensor outputTensor;
+        ConvolutionPolicy policy = CONVOLUTION_FASTEST;
+        char *tuningSetting = getenv("BOLT_CPU_ALGORITHM_TUNING");
+        if (tuningSetting != NULL && std::string(tuningSetting) == std::string("ON")) {
+            policy = CONVOLUTION_TUNNING;
+        }
+        std::vector<U32> ftmBytes(this->filters.size(), 0);
+        std::vector<Tensor> ftms(this->filters.size());
+        Tensor tmpTensor;
+        switch (this->p.convolution_type) {
+            case Convolution_Pointwise:
+            case Convolution_Dilation: {
+                CHECK_STATUS(convolution_infer_output_size(&inputTensor, this->filters[0], this->p,
+                    &outputTensor, DT_F32, &this->archInfo));
+                CHECK_STATUS(convolution_infer_forward_algorithm(inputTensor, this->filters[0],
+                    outputTensor, this->p, policy, &this->pwAlg, DT_F32,
+                    this->pwActivationParamSpec, &this->archInfo));
+                CHECK_STATUS(convolution_transform_filter_bytes(
+                    this->filters[0], this->p, this->pwAlg, ftmBytes.data(), &this->archInfo));
+                ftms[0] = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, ftmBytes[0]));
+                CHECK_STATUS(convolution_transform_filter(
+                    this->filters[0], this->p, this->pwAlg, tmpTensor, &ftms[0], &this->archInfo));
+                CHECK_STATUS(convolution_infer_forward_tmp_bytes(inputTensor, ftms[0],
+                    outputTensor, this->p, this->pwAlg, &this->tmpBytes, &this->archInfo));
+                break;
+            }
+            case Convolution_Depthwise: {
+                CHECK_STATUS(depthwise_convolution_infer_output_size(&inputTensor, this->filters[0],
+                    this->p, &outputTensor, DT_F32, &this->archInfo));
+                CHECK_STATUS(depthwise_convolution_infer_forward_algorithm(inputTensor,
+                    this->filters[0], outputTensor, this->p, policy, &this->dwAlg, DT_F32,
+                    this->dwActivationParamSpec, &this->archInfo));
+                CHECK_STATUS(depthwise_convolution_transform_filter_bytes(
+                    this->filters[0], this->p, this->dwAlg, ftmBytes.data(), &this->archInfo));
+                ftms[0] = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, ftmBytes[0]));
+                CHECK_STATUS(depthwise_convolution_transform_filter(
+                    this->filters[0], this->p, this->dwAlg, &ftms[0], &this->archInfo));
+                CHECK_STATUS(depthwise_convolution_infer_forward_tmp_bytes(inputTensor, ftms[0],
+                    outputTensor, this->p, this->dwAlg, &this->tmpBytes, &this->archInfo));
+                break;
+            }
+            default: {
+                CHECK_STATUS(depthwise_pointwise_convolution_infer_output_size(&inputTensor,
+                    this->filters[0], this->filters[1], this->p, &outputTensor, DT_F32,
+                    &this->archInfo));
+                CHECK_STATUS(depthwise_pointwise_convolution_infer_forward_algorithm(inputTensor,
+                    this->filters[0], this->filters[1], outputTensor, this->p, policy,
+                    &this->dwAlg, DT_F32, this->dwActivationParamSpec,
+                    this->pwActivationParamSpec, &this->archInfo));
+                CHECK_STATUS(depthwise_pointwise_convolution_transform_filter_bytes(
+                    this->filters[0], this->filters[1], this->p, this->dwAlg, &ftmBytes[0],
+                    &ftmBytes[1], &this->archInfo));
+                for (U32 i = 0; i < ftms.size(); i++) {
+                    ftms[i] = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, ftmBytes[i]));
+                }
+                CHECK_STATUS(depthwise_pointwise_convolution_transform_filter(this->filters[0],
+                    this->filters[1], this->p, this->dwAlg, &ftms[0], &ftms[1], &this->archInfo));
+                CHECK_STATUS(depthwise_pointwise_convolution_infer_forward_tmp_bytes(inputTensor,
+                    ftms[0], ftms[1], outputTensor, this->p, this->dwAlg, &this->tmpBytes,
+                    &this->archInfo));
+                break;
+            }
+        }
+        this->filters = ftms;
+        this->filterBytes = ftmBytes;
+
+        TensorDesc outputDesc = outputTensor.get_desc();
+        if (inputDescs.size() > 1) {
+            // residual add fused by the model converter, same rule as convolution()
+            TensorDesc eltwiseDesc = inputDescs[1];
+            if (this->p.convolution_type != Convolution_Pointwise &&
+                this->p.convolution_type != Convolution_Dilation) {
+                UNI_ERROR_LOG("micro compiler only supports fused add on convolution.\n");
+                return NOT_SUPPORTED;
+            }
+            this->eltwiseFused = (this->pwAlg != CONVOLUTION_ALGORITHM_GEMM_ICNCHW &&
+                tensorNumElements(eltwiseDesc) == tensorNumElements(outputDesc) &&
+                eltwiseDesc.df == outputDesc.df);
+        }
+        this->inputDescs = inputDescs;
+        this->outputDescs = {outputDesc};
+        *outputDescs = this->outputDescs;
+        return SUCCESS;
+    }
+
+    std::string generate_declaration() override
+    {
+        std::string code = Util::structToCode("ConvolutionParamSpec", this->id + "_p", this->p);
+        code += Util::structToCode(
+            "ActivationParamSpec", this->id + "_dw_act", this->dwActivationParamSpec);
+        code += Util::structToCode(
+            "ActivationParamSpec", this->id + "_pw_act", this->pwActivationParamSpec);
+        for (U32 i = 0; i < this->filters.size(); i++) {
+            code += Util::arrayToCode(this->id + "_filter" + std::to_string(i),
+                get_ptr_from_tensor(this->filters[i], CPU_GENERAL), this->filterBytes[i]);
+            code += Util::arrayToCode(this->id + "_bias" + std::to_string(i),
+                get_ptr_from_tensor(this->biases[i], CPU_GENERAL), this->biases[i].bytes());
+        }
+        return code;
+    }
+
+    std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) override
+    {
+        std::string inputDesc = Util::tensorDescToCode(transformDescTo4d(this->inputDescs[0]));
+        std::string outputDesc = Util::tensorDescToCode(this->outputDescs[0]);
+        std::string filter0 = this->id + "_filter0";
+        std::string filterDesc0 = Util::tensorDescToCode(this->filters[0].get_desc());
+        std::string bias0 = this->id + "_bias0";
+        std::string biasDesc0 = Util::tensorDescToCode(this->biases[0].get_desc());
+        std::string tmpBytes = std::to_string(this->tmpBytes);
+        std::string code;
+        switch (this->p.convolution_type) {
+            case Convolution_Pointwise:
+            case Convolution_Dilation: {
+                std::string eltwise = "nullptr";
+                std::string activation = this->id + "_pw_act";
+                if (inputs.size() > 1 && this->eltwiseFused) {
+                    eltwise = inputs[1];
+                } else if (inputs.size() > 1) {
+                    activation = "micro_activation_null";
+                }
+                code += call("convolution_x86",
+                    {inputDesc, inputs[0], eltwise, filterDesc0, filter0, this->id + "_p",
+                        "(ConvolutionForwardAlgorithm)" + std::to_string(this->pwAlg),
+                        filterDesc0, "nullptr", biasDesc0, bias0, tmpBytes, tmp, outputDesc,
+                        outputs[0], activation, arch_to_code()});
+                if (inputs.size() > 1 && !this->eltwiseFused) {
+                    EltwiseParamSpec eltwiseDesc;
+                    eltwiseDesc.elt_mode = ELTWISE_SUM;
+                    eltwiseDesc.activation_type = this->pwActivationParamSpec.mode;
+                    eltwiseDesc.activation_spec = this->p.activation_spec;
+                    code = Util::structToCode("EltwiseParamSpec", "p", eltwiseDesc) + code;
+                    code += call("eltwise_cpu",
+                        {"{" + outputDesc + ", " + Util::tensorDescToCode(this->inputDescs[1]) +
+                                "}",
+                            "{" + outputs[0] + ", " + inputs[1] + "}", "p", tmpBytes, tmp,
+                            outputDesc, outputs[0], arch_to_code()});
+                }
+                break;
+            }
+            case Convolution_Depthwise: {
+                code += call("depthwise_convolution_x86",
+                    {inputDesc, inputs[0], filterDesc0, filter0, this->id + "_p",
+                        "(DepthwiseConvolutionForwardAlgorithm)" + std::to_string(this->dwAlg),
+                        biasDesc0, bias0, tmpBytes, tmp, outputDesc, outputs[0],
+                        this->id + "_dw_act", arch_to_code()});
+                break;
+            }
+            default: {
+                code += call("depthwise_pointwise_convolution_x86",
+                    {inputDesc, inputs[0], "nullptr", filterDesc0, filter0,
+                        Util::tensorDescToCode(this->filters[1].get_desc()), this->id + "_filter1",
+                        this->id + "_p",
+                        "(DepthwiseConvolutionForwardAlgorithm)" + std::to_string(this->dwAlg),
+                        biasDesc0, bias0, Util::tensorDescToCode(this->biases[1].get_desc()),
+                        this->id + "_bias1", tmpBytes, tmp, outputDesc, outputs[0],
+                        this->id + "_dw_act", this->id + "_pw_act", arch_to_code()});
+                break;
+            }
+        }
+        return code;
+    }
+
+private:
+    EE load_weight(std::vector<TensorDesc> filterDescs, std::vector<TensorDesc> biasDescs)
+    {
+        U32 weightBytes = 0, biasBytes = 0;
+        for (U32 i = 0; i < filterDescs.size(); i++) {
+            weightBytes += tensorNumBytes(filterDescs[i]);
+            biasBytes += tensorNumBytes(biasDescs[i]);
+        }
+        if (this->ws.bytes_of_weight != weightBytes ||
+            (this->ws.bytes_of_vec != 0 && this->ws.bytes_of_vec != biasBytes)) {
+            UNI_ERROR_LOG("weight size of convolution %s is not match.\n", this->spec.name);
+            return NOT_MATCH;
+        }
+        U32 weightOffset = 0, biasOffset = 0;
+        for (U32 i = 0; i < filterDescs.size(); i++) {
+            this->filters.push_back(create_tensor(filterDescs[i], this->ws.weight + weightOffset));
+            weightOffset += tensorNumBytes(filterDescs[i]);
+            Tensor bias = Tensor::alloc_sized<CPUMem>(biasDescs[i]);
+            if (this->ws.bytes_of_vec > 0) {
+                UNI_MEMCPY(get_ptr_from_tensor(bias, CPU_GENERAL), this->ws.vec + biasOffset,
+                    bias.bytes());
+            } else {
+                memset(get_ptr_from_tensor(bias, CPU_GENERAL), 0, bias.bytes());
+            }
+            biasOffset += tensorNumBytes(biasDescs[i]);
+            this->biases.push_back(bias);
+        }
+        return SUCCESS;
+    }
+
+    ConvolutionParamSpec p;
+    ActivationParamSpec dwActivationParamSpec;
+    ActivationParamSpec pwActivationParamSpec;
+    ConvolutionForwardAlgorithm pwAlg;
+    DepthwiseConvolutionForwardAlgorithm dwAlg;
+    bool eltwiseFused;
+    std::vector<Tensor> filters;
+    std::vector<U32> filterBytes;
+    std::vector<Tensor> biases;
 };
+#endif  // _MICRO_CONVOLUTION_H
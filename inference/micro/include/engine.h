@@ -1,81 +1,411 @@
-#include "util.h"
-#include "model.h"
-#include "operator.h"
-#include "test.h"
-#include "compile.h"
-#include "convolution.h"
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
 
-#include <set>
-#include <vector>
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_ENGINE_H
+#define _MICRO_ENGINE_H
+
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "thread_affinity.h"
+#include "model.h"
+#include "convolution.h"
+#include "fully_connected.h"
+#include "pooling.h"
+#include "activation.h"
+#include "eltwise.h"
+#include "softmax.h"
+#include "reshape.h"
+#include "concat.h"
 
+// Ahead-of-time compiler, turns a fixed shape bolt model into one C++ source file. All shapes,
+// algorithms, weight layouts and activation offsets are decided here, the generated code only
+// contains static weight arrays, one static memory block and direct kernel calls.
 class Engine {
 public:
-    Engine(std::string engineFilePath);
+    // arch is the deployment target, the generated code runs the kernels and weight layouts of
+    // that instruction set whatever the machine running the generator supports
+    Engine(std::string boltModelFilePath,
+        std::string outputDirectory,
+        std::string prefix = "",
+        Arch arch = X86_AVX2)
+        : model(boltModelFilePath)
+    {
+        this->arch = arch;
+        this->outputDirectory = outputDirectory;
+        this->prefix = Util::toIdentifier(prefix.empty() ? this->model.get_name() : prefix);
+        this->memorySize = 0;
+        this->tmpOffset = 0;
+        this->tmpSize = 0;
+    }
 
-    void generateOperators()
+    EE generate()
     {
-        std::set<OperatorType> operatorList;
-        for (auto op : ops) {
-            operatorList.insert(op.type);
+        if (!IS_X86(this->arch)) {
+            UNI_ERROR_LOG("micro compiler only generates code for x86 AVX2/AVX512.\n");
+            return NOT_SUPPORTED;
         }
-        for (auto op : operatorList) {
-            Operator *op = new Convolution();
-            this->tensorDescMap[op_output] = op->infer_output_size(op_input_descs, parameter);
-            std::string convolutionCodePath = op->generateOperatorImplementation(arch);
-            this->sourcesFiles.append(convolutionCodePath);
+        // weights are transformed for the target here, with the target's kernels
+        DeviceInfo deviceInfo = get_cpu_info(AFFINITY_CPU_HIGH_PERFORMANCE);
+        if (!IS_X86(deviceInfo.archs[0]) || deviceInfo.archs[0] < this->arch) {
+            UNI_ERROR_LOG("micro compiler can not generate %s code on %s machine.\n",
+                ArchName()[this->arch], ArchName()[deviceInfo.archs[0]]);
+            return NOT_SUPPORTED;
         }
+        UNI_INFO_LOG("generate %s for model %s.\n", this->get_source_path().c_str(),
+            this->model.get_name().c_str());
+        CHECK_STATUS(this->generateOperators());
+        this->generateMemorySegment();
+        std::string code = this->generateEngineHeader();
+        code += this->generateEngineWeight();
+        code += this->generateEngineInterface();
+        code += this->generateEngineLogic();
+        return Util::writeToFile(code, this->get_source_path());
     }
 
-    std::string generateEngineHeader();
+    std::string get_prefix()
+    {
+        return this->prefix;
+    }
 
-    void generateMemorySegment()
+    std::string get_source_path()
+    {
+        return this->outputDirectory + "/" + this->prefix + ".cpp";
+    }
+
+    std::vector<std::string> get_input_names()
+    {
+        return this->inputNames;
+    }
+
+    std::vector<std::string> get_output_names()
+    {
+        return this->outputNames;
+    }
+
+    TensorDesc get_tensor_desc(std::string name)
+    {
+        return this->tensorDescMap[name];
+    }
+
+private:
+    std::shared_ptr<Operator> createOperator(OperatorSpec spec)
     {
-        // input: this->tensorDescMap�����е�desc��map
+        std::shared_ptr<Operator> op;
+        switch (spec.type) {
+            case OT_Conv:
+                op = std::shared_ptr<Operator>(new Convolution(spec, this->arch));
+                break;
+            case OT_FC:
+                op = std::shared_ptr<Operator>(new FullyConnected(spec, this->arch));
+                break;
+            case OT_Pooling:
+                op = std::shared_ptr<Operator>(new Pooling(spec, this->arch));
+                break;
+            case OT_Relu:
+            case OT_Relu6:
+            case OT_HSwish:
+            case OT_HSwishNoDiv:
+            case OT_Sigmoid:
+            case OT_HSigmoid:
+            case OT_Gelu:
+            case OT_TanH:
+            case OT_Mish:
+                op = std::shared_ptr<Operator>(new Activation(spec, this->arch));
+                break;
+            case OT_Eltwise:
+                op = std::shared_ptr<Operator>(new Eltwise(spec, this->arch));
+                break;
+            case OT_Softmax:
+                op = std::shared_ptr<Operator>(new Softmax(spec, this->arch));
+                break;
+            case OT_Reshape:
+                op = std::shared_ptr<Operator>(new Reshape(spec, this->arch));
+                break;
+            case OT_Concat:
+                op = std::shared_ptr<Operator>(new Concat(spec, this->arch));
+                break;
+            default:
+                UNI_ERROR_LOG("micro compiler not support operator %s(%s).\n", spec.name,
+                    OperatorTypeName()[spec.type]);
+                break;
+        }
+        return op;
     }
 
-    std::string generateEngineInterface();
+    // create operators and infer every tensor shape in model order
+    EE generateOperators()
+    {
+        const ModelSpec &spec = this->model.get_spec();
+        if (spec.dt != DT_F32) {
+            UNI_ERROR_LOG("micro compiler only supports float32 model, %s is %s.\n",
+                spec.model_name, DataTypeName()[spec.dt]);
+            return NOT_SUPPORTED;
+        }
+        for (int i = 0; i < spec.num_inputs; i++) {
+            std::string name = spec.input_names[i];
+            this->inputNames.push_back(name);
+            this->tensorDescMap[name] = spec.input_dims[i];
+            this->tensorLifetime[name] = std::make_pair(0, 0);
+        }
+        for (int i = 0; i < spec.num_operator_specs; i++) {
+            std::shared_ptr<Operator> op = this->createOperator(spec.ops[i]);
+            if (op == nullptr) {
+                return NOT_SUPPORTED;
+            }
+            WeightSpec ws;
+            if (this->model.get_weight_spec(op->get_name(), &ws)) {
+                op->set_weight_spec(ws);
+            }
+            U32 index = this->ops.size();
+            std::vector<TensorDesc> inputDescs, outputDescs;
+            for (auto name : op->get_input_names()) {
+                if (this->tensorDescMap.find(name) == this->tensorDescMap.end()) {
+                    UNI_ERROR_LOG("can not find input %s of operator %s.\n", name.c_str(),
+                        op->get_name().c_str());
+                    return NOT_MATCH;
+                }
+                inputDescs.push_back(this->tensorDescMap[name]);
+                this->tensorLifetime[name].second = index;
+            }
+            CHECK_STATUS(op->infer_output_size(inputDescs, &outputDescs));
+            std::vector<std::string> outputNames = op->get_output_names();
+            for (U32 j = 0; j < outputNames.size(); j++) {
+                this->tensorDescMap[outputNames[j]] = outputDescs[j];
+                // an in place operator rewrites a tensor that is already alive
+                if (this->tensorLifetime.find(outputNames[j]) == this->tensorLifetime.end()) {
+                    this->tensorLifetime[outputNames[j]] = std::make_pair(index, index);
+                } else {
+                    this->tensorLifetime[outputNames[j]].second = index;
+                }
+                UNI_DEBUG_LOG("operator %s output %s desc %s.\n", op->get_name().c_str(),
+                    outputNames[j].c_str(), tensorDesc2Str(outputDescs[j]).c_str());
+            }
+            this->tmpSize = UNI_MAX(this->tmpSize, op->get_tmp_bytes());
+            this->ops.push_back(op);
+        }
+        // model inputs are filled once by the caller and must survive repeated runs, model
+        // outputs are always handed out in plain layout
+        U32 end = this->ops.size();
+        for (auto name : this->inputNames) {
+            this->tensorLifetime[name].second = end;
+        }
+        for (int i = 0; i < spec.num_outputs; i++) {
+            std::string name = spec.output_names[i];
+            if (this->tensorDescMap.find(name) == this->tensorDescMap.end()) {
+                UNI_ERROR_LOG("can not find model output %s.\n", name.c_str());
+                return NOT_MATCH;
+            }
+            TensorDesc desc = this->tensorDescMap[name];
+            if (desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) {
+                std::string outputName = name + "_nchw";
+                desc.df = DF_NCHW;
+                this->tensorDescMap[outputName] = desc;
+                this->tensorLifetime[outputName] = std::make_pair(end, end);
+                this->tensorLifetime[name].second = end;
+                this->outputTransforms[name] = outputName;
+                name = outputName;
+            }
+            this->tensorLifetime[name].second = end;
+            this->outputNames.push_back(name);
+        }
+        return SUCCESS;
+    }
 
-    std::string generateEngineLogic(std::string engineFilePath)
+    // plan every activation tensor as an offset inside one static block, tensors whose
+    // lifetimes do not overlap share memory
+    void generateMemorySegment()
     {
-        std::string code = "";
-        Operator *op;
-        for (auto op : ops) {
-            switch (op.type) {
-                case OT_Conv: {
-                    op = new Convolution();
+        std::vector<std::string> names;
+        for (auto iter : this->tensorLifetime) {
+            names.push_back(iter.first);
+        }
+        std::map<std::string, TensorDesc> &descs = this->tensorDescMap;
+        std::stable_sort(names.begin(), names.end(), [&](const std::string &a, const std::string &b) {
+            return tensorNumBytes(descs[a]) > tensorNumBytes(descs[b]);
+        });
+        std::vector<std::string> placed;
+        for (auto name : names) {
+            U32 bytes = Util::alignSize(tensorNumBytes(this->tensorDescMap[name]));
+            std::pair<U32, U32> life = this->tensorLifetime[name];
+            std::vector<std::pair<U32, U32>> used;
+            for (auto other : placed) {
+                std::pair<U32, U32> otherLife = this->tensorLifetime[other];
+                if (otherLife.first <= life.second && life.first <= otherLife.second) {
+                    U32 offset = this->tensorOffset[other];
+                    U32 otherBytes = Util::alignSize(tensorNumBytes(this->tensorDescMap[other]));
+                    used.push_back(std::make_pair(offset, offset + otherBytes));
+                }
+            }
+            std::sort(used.begin(), used.end());
+            U32 offset = 0;
+            for (auto range : used) {
+                if (offset + bytes <= range.first) {
                     break;
                 }
+                offset = UNI_MAX(offset, range.second);
             }
-            code += op->generate();
+            this->tensorOffset[name] = offset;
+            this->memorySize = UNI_MAX(this->memorySize, offset + bytes);
+            placed.push_back(name);
         }
-        return code;
+        this->tmpOffset = this->memorySize;
+        this->memorySize += Util::alignSize(this->tmpSize);
+        U32 sum = 0;
+        for (auto name : names) {
+            sum += Util::alignSize(tensorNumBytes(this->tensorDescMap[name]));
+        }
+        UNI_INFO_LOG("plan %d tensors(%u bytes) into %u bytes, temporary memory %u bytes.\n",
+            (int)names.size(), sum, this->tmpOffset, this->tmpSize);
     }
 
-    void generateEngine()
+    std::string buffer(std::string name)
     {
-        std::string code = "";
-        code += generateMemorySegment;
-        code += generateEngineInterface;
-        code += "\n{" code += generateEngineLogic;
-        code += "}";
-        writeEngineToFile;
+        return "(micro_memory + " + std::to_string(this->tensorOffset[name]) + ")";
     }
 
-    void generate(Arch arch)
+    std::string generateEngineHeader()
     {
-        generateLog;
+        std::string code = "// Generated by micro_compiler from bolt model " +
+            this->model.get_name() + ", do not edit.\n//\n";
+        for (auto name : this->inputNames) {
+            code += "// input  " + name + ": " + tensorDesc2Str(this->tensorDescMap[name]) + "\n";
+        }
+        for (auto name : this->outputNames) {
+            code += "// output " + name + ": " + tensorDesc2Str(this->tensorDescMap[name]) + "\n";
+        }
+        code += "\n#include \"cpu/tensor_computing_cpu.h\"\n"
+                "#include \"cpu/x86/tensor_computing_x86.h\"\n"
+                "#include \"blas_enhance.h\"\n\n"
+                "#define MICRO_CHECK(status)   \\\n"
+                "    {                         \\\n"
+                "        EE ret = status;      \\\n"
+                "        if (ret != SUCCESS) { \\\n"
+                "            return ret;       \\\n"
+                "        }                     \\\n"
+                "    }\n\n"
+                "static inline TensorDesc micro_tensor_desc(DataType dt, DataFormat df, U32 nDims, "
+                "U32 d0, U32 d1, U32 d2, U32 d3, U32 d4, U32 d5)\n"
+                "{\n"
+                "    TensorDesc desc;\n"
+                "    desc.dt = dt;\n"
+                "    desc.df = df;\n"
+                "    desc.nDims = nDims;\n"
+                "    desc.dims[0] = d0;\n"
+                "    desc.dims[1] = d1;\n"
+                "    desc.dims[2] = d2;\n"
+                "    desc.dims[3] = d3;\n"
+                "    desc.dims[4] = d4;\n"
+                "    desc.dims[5] = d5;\n"
+                "    return desc;\n"
+                "}\n\n";
+        ActivationParamSpec activationNull;
+        activationNull.mode = ACTIVATION_NULL;
+        code += Util::structToCode("ActivationParamSpec", "micro_activation_null", activationNull);
+        return code;
+    }
 
-        parseBoltModel;
-        generateModelWeightToArray;
+    std::string generateEngineWeight()
+    {
+        std::string code;
+        for (auto op : this->ops) {
+            code += "\n// " + op->get_name() + "\n" + op->generate_declaration();
+        }
+        code += "\n// " + std::to_string(this->tmpOffset) + " bytes activation, " +
+            std::to_string(this->tmpSize) + " bytes temporary memory\n";
+        code += "alignas(" + std::to_string(MICRO_ALIGNMENT) + ") static U8 micro_memory[" +
+            std::to_string(UNI_MAX(this->memorySize, 1)) + "];\n";
+        return code;
+    }
 
-        generateOperators(arch);
+    std::string generateEngineInterface()
+    {
+        std::string code = "\nextern \"C\" {\n";
+        std::vector<std::pair<std::string, std::vector<std::string>>> groups = {
+            {"input", this->inputNames}, {"output", this->outputNames}};
+        for (auto group : groups) {
+            std::string names, offsets, bytes;
+            for (auto name : group.second) {
+                names += "\"" + name + "\", ";
+                offsets += std::to_string(this->tensorOffset[name]) + ", ";
+                bytes += std::to_string(tensorNumBytes(this->tensorDescMap[name])) + ", ";
+            }
+            std::string function = this->prefix + "_" + group.first;
+            std::string num = std::to_string(group.second.size());
+            code += "static const char *const " + function + "_names[] = {" + names + "};\n" +
+                "static const U32 " + function + "_offsets[] = {" + offsets + "};\n" +
+                "static const U32 " + function + "_sizes[] = {" + bytes + "};\n\n" +
+                "unsigned int " + this->prefix + "_num_" + group.first + "s()\n{\n" +
+                "    return " + num + ";\n}\n\n" +
+                "const char *" + function + "_name(unsigned int i)\n{\n" +
+                "    return i < " + num + " ? " + function + "_names[i] : nullptr;\n}\n\n" +
+                "void *" + function + "(unsigned int i)\n{\n" + "    return i < " + num +
+                " ? micro_memory + " + function + "_offsets[i] : nullptr;\n}\n\n" +
+                "unsigned int " + function + "_bytes(unsigned int i)\n{\n" + "    return i < " +
+                num + " ? " + function + "_sizes[i] : 0;\n}\n\n";
+        }
+        return code;
+    }
 
-        generateEngine;
+    std::string generateEngineLogic()
+    {
+        std::string tmp = "(micro_memory + " + std::to_string(this->tmpOffset) + ")";
+        std::string code = "int " + this->prefix + "_run()\n{\n";
+        for (auto op : this->ops) {
+            std::vector<std::string> inputs, outputs;
+            for (auto name : op->get_input_names()) {
+                inputs.push_back(this->buffer(name));
+            }
+            for (auto name : op->get_output_names()) {
+                outputs.push_back(this->buffer(name));
+            }
+            code += "    // " + op->get_name() + "\n    {\n";
+            std::string body = op->generate_call(inputs, outputs, tmp);
+            for (U32 start = 0; start < body.size();) {
+                U32 end = body.find('\n', start);
+                code += "    " + body.substr(start, end + 1 - start);
+                start = end + 1;
+            }
+            code += "    }\n";
+        }
+        for (auto iter : this->outputTransforms) {
+            code += "    MICRO_CHECK(transformToNCHW(" +
+                Util::tensorDescToCode(this->tensorDescMap[iter.first]) + ", " +
+                this->buffer(iter.first) + ", " +
+                Util::tensorDescToCode(this->tensorDescMap[iter.second]) + ", " +
+                this->buffer(iter.second) + "));\n";
+        }
+        code += "    return SUCCESS;\n}\n}\n";
+        return code;
     }
 
-private:
-    Map<std::string, TensorDesc> tensorDescMap;
-    Map<std::string, std::string> tensorDescNameMap;
-    Map<std::string, std::string> tensorNameMap;
+    Model model;
+    Arch arch;
+    std::string outputDirectory;
+    std::string prefix;
+    std::vector<std::shared_ptr<Operator>> ops;
+    std::vector<std::string> inputNames;
+    std::vector<std::string> outputNames;
+    std::map<std::string, TensorDesc> tensorDescMap;
+    // first and last operator index that touches the tensor
+    std::map<std::string, std::pair<U32, U32>> tensorLifetime;
+    std::map<std::string, U32> tensorOffset;
+    std::map<std::string, std::string> outputTransforms;
+    U32 memorySize;
+    U32 tmpOffset;
+    U32 tmpSize;
 };
+#endif  // _MICRO_ENGINE_H
@@ -0,0 +1,148 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_FULLY_CONNECTED_H
+#define _MICRO_FULLY_CONNECTED_H
+
+#include "operator.h"
+#include "blas_enhance.h"
+
+class FullyConnected : public Operator {
+public:
+    FullyConnected(OperatorSpec spec, Arch arch) : Operator(spec, arch)
+    {
+        this->p = spec.ps.fc_spec;
+    }
+
+    EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) override
+    {
+        CHECK_STATUS(this->check_weight_type());
+        TensorDesc inputDesc = inputDescs[0];
+        if (inputDesc.dt != DT_F32 || this->p.num_slices != 1 || this->ws.bytes_of_weight == 0) {
+            UNI_ERROR_LOG("micro compiler only supports float32 fully connected with weight.\n");
+            return NOT_SUPPORTED;
+        }
+        U32 N = this->p.num_outputs;
+        U32 K = this->ws.bytes_of_weight / N / bytesOf(DT_F32);
+        TensorDesc filterDesc = tensor2df(DT_F32, DF_TRANSPOSE, N, K);
+        Tensor inputTensor = create_tensor(inputDesc);
+        Tensor filterTensor = create_tensor(filterDesc, this->ws.weight);
+        Tensor outputTensor;
+        CHECK_STATUS(fully_connected_infer_output_size(
+            &inputTensor, filterTensor, &outputTensor, &this->archInfo));
+        this->M = tensorNumElements(inputDesc) / K;
+
+        // same layout handling as fully_connected(), NCHWC8 feature map is reordered at first
+        U32 hw = 1;
+        for (int i = 0; i < (int)inputDesc.nDims - 2; i++) {
+            hw *= inputDesc.dims[i];
+        }
+        this->transformInput = (inputDesc.df == DF_NCHWC8 && hw > 1);
+
+        U32 bytes = 0;
+        CHECK_STATUS(fully_connected_transform_filter_bytes(filterTensor, &bytes, &this->archInfo));
+        this->filter = Tensor::alloc_sized<CPUMem>(tensor1d(DT_U8, bytes));
+        this->filterBytes = bytes;
+        void *filterData = get_ptr_from_tensor(filterTensor, CPU_GENERAL);
+        void *ftmData = get_ptr_from_tensor(this->filter, CPU_GENERAL);
+        TensorDesc ftmDesc;
+        if (this->M == 1) {
+            filterDesc.df = DF_NORMAL;
+            CHECK_STATUS(matrix_vector_multiply_transform_weight(
+                filterDesc, filterData, &ftmDesc, ftmData, this->archInfo.arch));
+            CHECK_STATUS(matrix_vector_multiply_tmp_bytes(
+                ftmDesc, tensor1d(DT_F32, K), &this->tmpBytes, this->archInfo.arch));
+        } else {
+            CHECK_STATUS(matrix_matrix_multiply_transform_rhs(
+                filterDesc, filterData, &ftmDesc, ftmData, this->archInfo.arch));
+            CHECK_STATUS(matrix_matrix_multiply_tmp_bytes(tensor2df(DT_F32, DF_NORMAL, this->M, K),
+                ftmDesc, &this->tmpBytes, this->archInfo.arch));
+        }
+        this->filter.resize(ftmDesc);
+        if (this->transformInput) {
+            this->tmpBytes += tensorNumBytes(inputDesc);
+        }
+
+        this->bias = Tensor::alloc_sized<CPUMem>(tensor1d(DT_F32, N));
+        if (this->ws.bytes_of_vec > 0) {
+            UNI_MEMCPY(
+                get_ptr_from_tensor(this->bias, CPU_GENERAL), this->ws.vec, this->bias.bytes());
+        } else {
+            memset(get_ptr_from_tensor(this->bias, CPU_GENERAL), 0, this->bias.bytes());
+        }
+        this->K = K;
+        this->inputDescs = inputDescs;
+        this->outputDescs = {outputTensor.get_desc()};
+        *outputDescs = this->outputDescs;
+        return SUCCESS;
+    }
+
+    std::string generate_declaration() override
+    {
+        std::string code = Util::arrayToCode(this->id + "_filter",
+            get_ptr_from_tensor(this->filter, CPU_GENERAL), this->filterBytes);
+        code += Util::arrayToCode(this->id + "_bias",
+            get_ptr_from_tensor(this->bias, CPU_GENERAL), this->bias.bytes());
+        return code;
+    }
+
+    std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) override
+    {
+        std::string code;
+        std::string input = inputs[0];
+        U32 tmpBytes = this->tmpBytes;
+        if (this->transformInput) {
+            TensorDesc desc = this->inputDescs[0];
+            TensorDesc nchwDesc = desc;
+            nchwDesc.df = DF_NCHW;
+            code += call("transformToNCHW",
+                {Util::tensorDescToCode(desc), input, Util::tensorDescToCode(nchwDesc), tmp});
+            input = tmp;
+            tmp = "(" + tmp + " + " + std::to_string(tensorNumBytes(desc)) + ")";
+            tmpBytes -= tensorNumBytes(desc);
+        }
+        U32 N = this->p.num_outputs;
+        code += "    for (U32 i = 0; i < " + std::to_string(this->M) + "; i++) {\n" +
+            "        UNI_MEMCPY((U8 *)" + outputs[0] + " + i * " + std::to_string(N * 4) + ", " +
+            this->id + "_bias, " + std::to_string(N * 4) + ");\n    }\n";
+        std::string filterDesc = Util::tensorDescToCode(this->filter.get_desc());
+        if (this->M == 1) {
+            code += call("matrix_vector_multiply",
+                {filterDesc, this->id + "_filter",
+                    Util::tensorDescToCode(tensor1d(DT_F32, this->K)), input,
+                    std::to_string(tmpBytes), tmp,
+                    Util::tensorDescToCode(tensor1d(DT_F32, N)), outputs[0], "nullptr",
+                    arch_to_code()});
+        } else {
+            code += call("matrix_matrix_multiply",
+                {Util::tensorDescToCode(tensor2df(DT_F32, DF_NORMAL, this->M, this->K)), input,
+                    filterDesc, this->id + "_filter", std::to_string(tmpBytes), tmp,
+                    Util::tensorDescToCode(tensor2df(DT_F32, DF_NORMAL, this->M, N)), outputs[0],
+                    "nullptr", arch_to_code()});
+        }
+        return code;
+    }
+
+private:
+    FullyConnectedParamSpec p;
+    Tensor filter;
+    U32 filterBytes;
+    Tensor bias;
+    U32 M;
+    U32 K;
+    bool transformInput;
+};
+#endif  // _MICRO_FULLY_CONNECTED_H
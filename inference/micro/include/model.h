@@ -1,32 +1,67 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_MODEL_H
+#define _MICRO_MODEL_H
+
+#include <map>
+#include <string>
+#include "model_spec.h"
+
 class Model {
 public:
-    Model(String boltModelFilePath, String modelHeaderFilePath)
+    Model(std::string boltModelFilePath)
     {
-        parseBoltModel(boltModelFilePath);
+        this->parseBoltModel(boltModelFilePath);
     }
 
     ~Model()
     {
-        // destroy model;
-        // TODO
+        CHECK_STATUS(mt_destroy_model(&this->spec));
     }
 
-    // load an bolt model file into memory
-    void parseBoltModel(String modelPath)
+    // load a bolt model file into memory with the model_spec deserializer
+    void parseBoltModel(std::string modelPath)
     {
-        // use model_tools deserialize function
-        // TODO
+        CHECK_STATUS(deserialize_model_from_file(modelPath.c_str(), &this->spec));
+        for (int i = 0; i < this->spec.num_weight_specs; i++) {
+            this->weightIndex[this->spec.ws[i].op_name] = i;
+        }
     }
 
-    // write bolt model weight into model.h/model.c in the array format
-    // model.h
-    // char *weight0 = [0, 1, 2, 3];
-    // output = {
-    //   op_name: weight0
-    // }
-    pair<OperatorParameter *, std::map<String, String>> generate()
-    {}
+    std::string get_name()
+    {
+        return this->spec.model_name;
+    }
+
+    const ModelSpec &get_spec()
+    {
+        return this->spec;
+    }
+
+    bool get_weight_spec(std::string opName, WeightSpec *ws)
+    {
+        auto iter = this->weightIndex.find(opName);
+        if (iter == this->weightIndex.end()) {
+            return false;
+        }
+        *ws = this->spec.ws[iter->second];
+        return true;
+    }
 
 private:
-    ModelSpec modelSpec;
+    ModelSpec spec;
+    std::map<std::string, int> weightIndex;
 };
+#endif  // _MICRO_MODEL_H
@@ -1,33 +1,143 @@
-#include <std::vector>
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
 
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_OPERATOR_H
+#define _MICRO_OPERATOR_H
+
+#include <string>
+#include <vector>
+#include "tensor_computing.h"
+#include "model_spec.h"
+#include "util.h"
+
+// An operator of the ahead-of-time compiler. Shapes, algorithms and weight layouts are resolved
+// with tensor_computing at generation time, only the final kernel call is emitted.
 class Operator {
 public:
-    Operator();
+    Operator(OperatorSpec spec, Arch arch)
+    {
+        this->spec = spec;
+        this->archInfo.arch = arch;
+        this->archInfo.archPara = nullptr;
+        this->archInfo.numThreads = 0;
+        this->id = "op_" + Util::toIdentifier(spec.name);
+        this->ws.bytes_of_weight = 0;
+        this->ws.bytes_of_vec = 0;
+        this->ws.weight = nullptr;
+        this->ws.vec = nullptr;
+        this->tmpBytes = 0;
+    }
+
+    virtual ~Operator() = default;
+
+    std::string get_name()
+    {
+        return this->spec.name;
+    }
+
+    OperatorType get_type()
+    {
+        return this->spec.type;
+    }
+
+    std::vector<std::string> get_input_names()
+    {
+        std::vector<std::string> names;
+        for (U32 i = 0; i < this->spec.num_inputs; i++) {
+            names.push_back(this->spec.input_tensors_name[i]);
+        }
+        return names;
+    }
+
+    std::vector<std::string> get_output_names()
+    {
+        std::vector<std::string> names;
+        for (U32 i = 0; i < this->spec.num_outputs; i++) {
+            names.push_back(this->spec.output_tensors_name[i]);
+        }
+        return names;
+    }
+
+    void set_weight_spec(WeightSpec ws)
+    {
+        this->ws = ws;
+    }
+
+    U32 get_tmp_bytes()
+    {
+        return this->tmpBytes;
+    }
+
+    // resolve output shapes, forward algorithm, transformed weights and temporary memory
+    virtual EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) = 0;
+
+    // file scope definitions used by the call, weights and parameters
+    virtual std::string generate_declaration()
+    {
+        return "";
+    }
 
-    virtual std::vector<TensorDesc> inferOutputSize(
-        std::vector<TensorDesc> inputDescs, void *paramaters) = 0;
+    // statements that run the operator, inputs, outputs and tmp are buffer expressions
+    virtual std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) = 0;
 
-    virtual std::string generateImplementation(
-        Arch arch, std::vector<TensorDesc> inputDescs, void *parameters) = 0;
+protected:
+    static Tensor create_tensor(TensorDesc desc)
+    {
+        Tensor tensor;
+        tensor.resize(desc);
+        return tensor;
+    }
 
-    virtual pair<std::string, std::vector<std::string>> generateParameter(void *parameter) = 0;
+    static Tensor create_tensor(TensorDesc desc, const void *data)
+    {
+        Tensor tensor = Tensor::alloc_sized<CPUMem>(desc);
+        UNI_MEMCPY(get_ptr_from_tensor(tensor, CPU_GENERAL), data, tensor.bytes());
+        return tensor;
+    }
 
-    virtual std::string generateOutputTensorDesc(
-        std::vector<std::string> outputNames, Map<std::string, std::string> &tensorDescNameMap) = 0;
+    static std::string call(std::string function, std::vector<std::string> args)
+    {
+        std::string code = "    MICRO_CHECK(" + function + "(";
+        for (U32 i = 0; i < args.size(); i++) {
+            code += (i > 0 ? ", " : "") + args[i];
+        }
+        return code + "));\n";
+    }
 
-    virtual std::string generateCall(std::vector<std::string> inputDescstd::strings,
-        std::vector<std::string> inputstd::strings,
-        std::vector<std::string> parameterstd::strings,
-        std::vector<std::string> outputDescstd::strings,
-        std::vector<std::string> outputstd::strings) = 0;
+    std::string arch_to_code()
+    {
+        return std::string("(Arch)") + std::to_string(this->archInfo.arch);
+    }
 
-    std::string generate()
+    EE check_weight_type()
     {
-        std::string code = "";
-        code += op->genrerateParameter(parameter);
-        code += op->genrerateOutputTensorDesc(outputNames, tensorDescNameMap);
-        code += op->generateCall(inputTensorDescNames, inputTensorNames, parameters,
-            outputTensorDescNames, outputTensorName);
-        return code;
+        if (this->ws.bytes_of_weight > 0 && this->ws.mdt != DT_F32) {
+            UNI_ERROR_LOG("micro compiler only supports float32 weight, operator %s is %s.\n",
+                this->spec.name, DataTypeName()[this->ws.mdt]);
+            return NOT_SUPPORTED;
+        }
+        return SUCCESS;
     }
+
+    OperatorSpec spec;
+    WeightSpec ws;
+    ArchInfo archInfo;
+    std::string id;
+    std::vector<TensorDesc> inputDescs;
+    std::vector<TensorDesc> outputDescs;
+    U32 tmpBytes;
 };
+#endif  // _MICRO_OPERATOR_H
@@ -0,0 +1,97 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_POOLING_H
+#define _MICRO_POOLING_H
+
+#include "operator.h"
+
+class Pooling : public Operator {
+public:
+    Pooling(OperatorSpec spec, Arch arch) : Operator(spec, arch)
+    {
+        this->p = spec.ps.pooling_spec;
+    }
+
+    EE infer_output_size(
+        std::vector<TensorDesc> inputDescs, std::vector<TensorDesc> *outputDescs) override
+    {
+        Tensor inputTensor = create_tensor(inputDescs[0]);
+        Tensor outputTensor;
+        CHECK_STATUS(
+            pooling_infer_output_size(&inputTensor, this->p, &outputTensor, &this->archInfo));
+        CHECK_STATUS(pooling_infer_forward_tmp_bytes(
+            inputTensor, outputTensor, &this->tmpBytes, &this->archInfo));
+        TensorDesc inputDesc = transformDescTo4d(inputDescs[0]);
+        if (0 == this->p.kernel_w) {
+            this->p.kernel_w = inputDesc.dims[0];
+        }
+        if (0 == this->p.kernel_h) {
+            this->p.kernel_h = inputDesc.dims[1];
+        }
+        if (0 == this->p.kernel_t) {
+            this->p.kernel_t = inputDesc.dims[2];
+        }
+        this->inputDescs = inputDescs;
+        this->outputDescs = {outputTensor.get_desc()};
+        *outputDescs = this->outputDescs;
+        return SUCCESS;
+    }
+
+    std::string generate_declaration() override
+    {
+        return Util::structToCode("PoolingParamSpec", this->id + "_p", this->p);
+    }
+
+    std::string generate_call(
+        std::vector<std::string> inputs, std::vector<std::string> outputs, std::string tmp) override
+    {
+        TensorDesc inputDesc = transformDescTo4d(this->inputDescs[0]);
+        TensorDesc outputDesc = transformDescTo4d(this->outputDescs[0]);
+        std::string code = "    F32 scale[2] = {-1, -1};\n";
+        if (inputDesc.df == DF_NCHWC8 || inputDesc.df == DF_NCHWC16) {
+            code += call("pooling_x86",
+                {Util::tensorDescToCode(inputDesc), inputs[0], this->id + "_p", "scale",
+                    Util::tensorDescToCode(outputDesc), outputs[0]});
+            return code;
+        }
+        // same channel padding as pooling(), the x86 kernel only takes NCHWC8
+        TensorDesc inputC8Desc = inputDesc;
+        TensorDesc outputC8Desc = outputDesc;
+        int channelAxis = inputDesc.nDims - 2;
+        U32 paddedC = (inputDesc.dims[channelAxis] + 7) / 8 * 8;
+        inputC8Desc.dims[channelAxis] = paddedC;
+        inputC8Desc.df = DF_NCHWC8;
+        outputC8Desc.dims[channelAxis] = paddedC;
+        outputC8Desc.df = DF_NCHWC8;
+        std::string outputC8 =
+            "(" + tmp + " + " + std::to_string(tensorNumBytes(inputC8Desc)) + ")";
+        code += call("transformNCHWToNCHWC8",
+            {Util::tensorDescToCode(inputDesc), inputs[0], Util::tensorDescToCode(inputC8Desc),
+                tmp});
+        code += call("pooling_x86",
+            {Util::tensorDescToCode(inputC8Desc), tmp, this->id + "_p", "scale",
+                Util::tensorDescToCode(outputC8Desc), outputC8});
+        if (outputDesc.df != DF_NCHWC8) {
+            code += call("transformToNCHW",
+                {Util::tensorDescToCode(outputC8Desc), outputC8, Util::tensorDescToCode(outputDesc),
+                    outputs[0]});
+        }
+        return code;
+    }
+
+private:
+    PoolingParamSpec p;
+};
+#endif  // _MICRO_POOLING_H
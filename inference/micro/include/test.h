@@ -1,21 +1,112 @@
-#include <string>
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
 
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_TEST_H
+#define _MICRO_TEST_H
+
+#include "engine.h"
+
+// generate a standalone program that feeds the generated model with synthetic data, reports
+// the average latency and prints a checksum of every output
 class Test {
 public:
-    Test(std::string testFilePath);
+    Test(Engine *engine, std::string outputDirectory)
+    {
+        this->engine = engine;
+        this->testFilePath = outputDirectory + "/" + engine->get_prefix() + "_test.cpp";
+    }
+
+    EE generate()
+    {
+        std::string code = this->generateTestHeader();
+        code += this->generateTest();
+        return Util::writeToFile(this->replacePrefix(code), this->testFilePath);
+    }
 
-    void generate()
+    std::string get_source_path()
     {
-        std::string code = "";
-        code += generateTestHeader();
-        code += generateTest();
-        writeTestToFile(code, testFilePath);
+        return this->testFilePath;
     }
 
 private:
-    std::string generateTestHeader();
+    std::string replacePrefix(std::string code)
+    {
+        std::string pattern = "MICRO_PREFIX";
+        for (size_t pos = code.find(pattern); pos != std::string::npos;
+             pos = code.find(pattern, pos)) {
+            code.replace(pos, pattern.size(), this->engine->get_prefix());
+        }
+        return code;
+    }
 
-    std::string generateTest();
+    std::string generateTestHeader()
+    {
+        return "// Generated by micro_compiler, do not edit.\n\n"
+               "#include <stdio.h>\n"
+               "#include <stdlib.h>\n"
+               "#include <chrono>\n\n"
+               "extern \"C\" {\n"
+               "unsigned int MICRO_PREFIX_num_inputs();\n"
+               "void *MICRO_PREFIX_input(unsigned int i);\n"
+               "unsigned int MICRO_PREFIX_input_bytes(unsigned int i);\n"
+               "unsigned int MICRO_PREFIX_num_outputs();\n"
+               "const char *MICRO_PREFIX_output_name(unsigned int i);\n"
+               "void *MICRO_PREFIX_output(unsigned int i);\n"
+               "unsigned int MICRO_PREFIX_output_bytes(unsigned int i);\n"
+               "int MICRO_PREFIX_run();\n"
+               "}\n\n";
+    }
+
+    std::string generateTest()
+    {
+        return "int main(int argc, char **argv)\n"
+               "{\n"
+               "    int loops = (argc > 1) ? atoi(argv[1]) : 10;\n"
+               "    for (unsigned int i = 0; i < MICRO_PREFIX_num_inputs(); i++) {\n"
+               "        float *data = (float *)MICRO_PREFIX_input(i);\n"
+               "        unsigned int length = MICRO_PREFIX_input_bytes(i) / sizeof(float);\n"
+               "        for (unsigned int j = 0; j < length; j++) {\n"
+               "            data[j] = ((int)(j % 17) - 8) / 8.0f;\n"
+               "        }\n"
+               "    }\n"
+               "    if (MICRO_PREFIX_run() != 0) {\n"
+               "        printf(\"[ERROR] run model failed.\\n\");\n"
+               "        return 1;\n"
+               "    }\n"
+               "    auto start = std::chrono::high_resolution_clock::now();\n"
+               "    for (int i = 0; i < loops; i++) {\n"
+               "        MICRO_PREFIX_run();\n"
+               "    }\n"
+               "    auto end = std::chrono::high_resolution_clock::now();\n"
+               "    double time = std::chrono::duration<double, std::milli>(end - start).count();\n"
+               "    for (unsigned int i = 0; i < MICRO_PREFIX_num_outputs(); i++) {\n"
+               "        const float *data = (const float *)MICRO_PREFIX_output(i);\n"
+               "        unsigned int length = MICRO_PREFIX_output_bytes(i) / sizeof(float);\n"
+               "        double sum = 0;\n"
+               "        for (unsigned int j = 0; j < length; j++) {\n"
+               "            sum += data[j];\n"
+               "        }\n"
+               "        printf(\"output %s: %u elements, sum %f\\n\", MICRO_PREFIX_output_name(i), "
+               "length, sum);\n"
+               "    }\n"
+               "    double avg = (loops > 0) ? time / loops : 0;\n"
+               "    printf(\"avg_time: %f ms/loop over %d loops\\n\", avg, loops);\n"
+               "    return 0;\n"
+               "}\n";
+    }
 
+    Engine *engine;
     std::string testFilePath;
 };
+#endif  // _MICRO_TEST_H
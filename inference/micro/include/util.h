@@ -1,28 +1,99 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _MICRO_UTIL_H
+#define _MICRO_UTIL_H
+
 #include <string>
+#include <stdio.h>
+#include "tensor_desc.h"
+
+#define MICRO_ALIGNMENT 64
 
 class Util {
 public:
-    Util(std::string utilHeaderFilePath)
-    {}
-
-    void generate()
+    // turn an arbitrary tensor or operator name into a valid C identifier
+    static std::string toIdentifier(std::string name)
     {
-        std::string code = "";
-        code += generateUtilFileHeader;
-        code += generateStruct;
+        std::string ret = name;
+        for (U32 i = 0; i < ret.size(); i++) {
+            char c = ret[i];
+            if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+                ret[i] = '_';
+            }
+        }
+        if (ret.size() == 0 || (ret[0] >= '0' && ret[0] <= '9')) {
+            ret = "_" + ret;
+        }
+        return ret;
+    }
 
-        code += generateLogFunction;
-        writeUtilToFile(code, this->utilHeaderFilePath);
+    static U32 alignSize(U32 size)
+    {
+        return (size + MICRO_ALIGNMENT - 1) / MICRO_ALIGNMENT * MICRO_ALIGNMENT;
     }
 
-private:
-    void generateUtilHeader(std::string utilHeaderFilePath);
+    // expression that rebuilds desc in the generated code, resolved at compile time
+    static std::string tensorDescToCode(TensorDesc desc)
+    {
+        std::string code = std::string("micro_tensor_desc(") + DataTypeName()[desc.dt] + ", " +
+            DataFormatName()[desc.df] + ", " + std::to_string(desc.nDims);
+        for (U32 i = 0; i < sizeof(desc.dims) / sizeof(desc.dims[0]); i++) {
+            code += ", " + std::to_string(desc.dims[i]);
+        }
+        return code + ")";
+    }
 
-    // generate iot code log function
-    std::string generateLogFunction();
+    // static read-only byte array, used for weights and parameter structures
+    static std::string arrayToCode(std::string name, const void *data, U32 bytes)
+    {
+        std::string code = "alignas(" + std::to_string(MICRO_ALIGNMENT) + ") static const U8 " +
+            name + "[" + std::to_string(UNI_MAX(bytes, 1)) + "] = {";
+        const U8 *ptr = (const U8 *)data;
+        char buffer[8];
+        for (U32 i = 0; i < bytes; i++) {
+            if (i % 16 == 0) {
+                code += "\n    ";
+            }
+            snprintf(buffer, sizeof(buffer), "0x%02x,", ptr[i]);
+            code += buffer;
+        }
+        return code + "};\n";
+    }
 
-    // generate iot code struct
-    std::string generateStruct();
+    // parameter structures are emitted as their binary image, the generated code is compiled
+    // against the same parameter_spec.h as the generator
+    template <typename T>
+    static std::string structToCode(std::string type, std::string name, const T &value)
+    {
+        std::string code = arrayToCode(name + "_data", &value, sizeof(T));
+        code += "static const " + type + " &" + name + " = *(const " + type + " *)" + name +
+            "_data;\n";
+        return code;
+    }
 
-    std::string utilHeaderFilePath;
+    static EE writeToFile(std::string code, std::string path)
+    {
+        FILE *file = fopen(path.c_str(), "w");
+        if (file == NULL) {
+            UNI_ERROR_LOG("can not write generated code to %s.\n", path.c_str());
+            return FILE_ERROR;
+        }
+        fwrite(code.c_str(), 1, code.size(), file);
+        fclose(file);
+        UNI_INFO_LOG("write generated code to %s.\n", path.c_str());
+        return SUCCESS;
+    }
 };
+#endif  // _MICRO_UTIL_H
@@ -0,0 +1,248 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <libgen.h>
+#include <string.h>
+#include <stdlib.h>
+#include "inference.hpp"
+#include "model_common.h"
+#include "ut_util.h"
+
+// generate code for a small model with micro_compiler, build and run it, and compare its outputs
+// with the engine. The compiler runs in its own process, its classes share names with the
+// engine's.
+
+static OperatorSpec create_operator(
+    const char *name, OperatorType type, std::vector<const char *> inputs, const char *output)
+{
+    OperatorSpec spec = mt_create_operator(name, type, inputs.size(), 1);
+    for (U32 i = 0; i < inputs.size(); i++) {
+        str_copy(spec.input_tensors_name[i], inputs[i], strlen(inputs[i]));
+    }
+    str_copy(spec.output_tensors_name[0], output, strlen(output));
+    memset(&spec.ps, 0, sizeof(spec.ps));
+    return spec;
+}
+
+static WeightSpec create_weight(const char *name, U32 weightNum, U32 vecNum)
+{
+    WeightSpec ws;
+    str_copy(ws.op_name, name, strlen(name));
+    ws.mdt = DT_F32;
+    ws.bytes_of_weight = weightNum * bytesOf(DT_F32);
+    ws.weight = (U8 *)mt_new_storage(ws.bytes_of_weight);
+    ut_init_v(ws.weight, weightNum, DT_F32, UT_INIT_RANDOM);
+    ws.bytes_of_vec = vecNum * bytesOf(DT_F32);
+    ws.vec = (U8 *)mt_new_storage(ws.bytes_of_vec);
+    ut_init_v(ws.vec, vecNum, DT_F32, UT_INIT_RANDOM);
+    ws.num_quant_scale = 0;
+    ws.weight_scale = nullptr;
+    return ws;
+}
+
+// sigmoid -> conv -> in place relu -> depthwise conv -> eltwise -> pooling -> fc -> softmax,
+// the relu rewrites the convolution output, whose memory must not overlap the sigmoid output
+static void create_model(const char *path)
+{
+    U32 ic = 3, oc = 16, h = 8, w = 8, fn = 10;
+    ModelSpec ms;
+    CHECK_STATUS(mt_create_model(&ms));
+    str_copy(ms.model_name, "micro_test", strlen("micro_test"));
+    ms.dt = DT_F32;
+    ms.num_inputs = 1;
+    ms.input_names = (I8 **)mt_new_storage(sizeof(I8 *));
+    ms.input_names[0] = (I8 *)mt_new_storage(NAME_LEN);
+    str_copy(ms.input_names[0], "data", strlen("data"));
+    ms.input_dims = (TensorDesc *)mt_new_storage(sizeof(TensorDesc));
+    ms.input_dims[0] = tensor4df(DT_F32, DF_NCHW, 1, ic, h, w);
+    std::vector<const char *> outputs = {"prob", "e1"};
+    ms.num_outputs = outputs.size();
+    ms.output_names = (I8 **)mt_new_storage(sizeof(I8 *) * outputs.size());
+    for (U32 i = 0; i < outputs.size(); i++) {
+        ms.output_names[i] = (I8 *)mt_new_storage(NAME_LEN);
+        str_copy(ms.output_names[i], outputs[i], strlen(outputs[i]));
+    }
+
+    std::vector<OperatorSpec> ops;
+    ops.push_back(create_operator("sigmoid0", OT_Sigmoid, {"data"}, "s0"));
+    OperatorSpec conv = create_operator("conv1", OT_Conv, {"s0"}, "c1");
+    ConvolutionParamSpec &p = conv.ps.conv_spec;
+    p.num_outputs = oc;
+    p.num_outputs_origin = oc;
+    p.kernel_t = 1;
+    p.kernel_h = p.kernel_w = 3;
+    p.stride_t = p.stride_h = p.stride_w = 1;
+    p.padding_top = p.padding_bottom = p.padding_left = p.padding_right = 1;
+    p.group = 1;
+    p.dilatedRate_t = p.dilatedRate_h = p.dilatedRate_w = 1;
+    p.convolution_type = Convolution_Pointwise;
+    p.dw_activation_type = ACTIVATION_NULL;
+    p.pw_activation_type = ACTIVATION_NULL;
+    ops.push_back(conv);
+    ops.push_back(create_operator("relu1", OT_Relu, {"c1"}, "c1"));
+    OperatorSpec depthwise = create_operator("dw1", OT_Conv, {"c1"}, "d1");
+    depthwise.ps.conv_spec = p;
+    depthwise.ps.conv_spec.group = oc;
+    depthwise.ps.conv_spec.convolution_type = Convolution_Depthwise;
+    depthwise.ps.conv_spec.dw_activation_type = ACTIVATION_RELU;
+    ops.push_back(depthwise);
+    OperatorSpec eltwise = create_operator("add1", OT_Eltwise, {"d1", "c1"}, "e1");
+    eltwise.ps.eltwise_spec.elt_mode = ELTWISE_SUM;
+    eltwise.ps.eltwise_spec.activation_type = ACTIVATION_NULL;
+    ops.push_back(eltwise);
+    OperatorSpec pooling = create_operator("pool1", OT_Pooling, {"e1"}, "p1");
+    PoolingParamSpec &pp = pooling.ps.pooling_spec;
+    pp.kernel_t = pp.stride_t = 1;
+    pp.kernel_h = pp.kernel_w = pp.stride_h = pp.stride_w = 2;
+    pp.rm = CEIL;
+    pp.mode = POOLING_MAX;
+    ops.push_back(pooling);
+    OperatorSpec fc = create_operator("fc1", OT_FC, {"p1"}, "f1");
+    fc.ps.fc_spec.num_outputs = fn;
+    fc.ps.fc_spec.num_slices = 1;
+    ops.push_back(fc);
+    OperatorSpec softmax = create_operator("softmax1", OT_Softmax, {"f1"}, "prob");
+    softmax.ps.softmax_spec.axis = -1;
+    ops.push_back(softmax);
+    ms.num_operator_specs = ops.size();
+    ms.ops = (OperatorSpec *)mt_new_storage(sizeof(OperatorSpec) * ops.size());
+    UNI_MEMCPY(ms.ops, ops.data(), sizeof(OperatorSpec) * ops.size());
+
+    std::vector<WeightSpec> ws = {create_weight("conv1", oc * ic * 9, oc),
+        create_weight("dw1", oc * 9, oc), create_weight("fc1", fn * oc * h / 2 * w / 2, fn)};
+    ms.num_weight_specs = ws.size();
+    ms.ws = (WeightSpec *)mt_new_storage(sizeof(WeightSpec) * ws.size());
+    UNI_MEMCPY(ms.ws, ws.data(), sizeof(WeightSpec) * ws.size());
+    ms.num_op_tensor_entries = 0;
+    ms.op_relationship_entries = nullptr;
+    CHECK_STATUS(serialize_model_to_file(&ms, path));
+    CHECK_STATUS(mt_destroy_model(&ms));
+}
+
+// replaces the sample program of the generated code, reads the inputs from <directory>/input.bin,
+// runs the generated model once and writes the outputs to <directory>/output.bin
+static void create_runner(std::string path, std::string directory, std::string prefix)
+{
+    std::string code = "#include <stdio.h>\n\n"
+                       "extern \"C\" {\n"
+                       "unsigned int MICRO_PREFIX_num_inputs();\n"
+                       "void *MICRO_PREFIX_input(unsigned int i);\n"
+                       "unsigned int MICRO_PREFIX_input_bytes(unsigned int i);\n"
+                       "unsigned int MICRO_PREFIX_num_outputs();\n"
+                       "void *MICRO_PREFIX_output(unsigned int i);\n"
+                       "unsigned int MICRO_PREFIX_output_bytes(unsigned int i);\n"
+                       "int MICRO_PREFIX_run();\n"
+                       "}\n\n"
+                       "int main()\n"
+                       "{\n"
+                       "    FILE *file = fopen(\"MICRO_DIRECTORY/input.bin\", \"rb\");\n"
+                       "    for (unsigned int i = 0; file && i < MICRO_PREFIX_num_inputs(); i++) {\n"
+                       "        if (fread(MICRO_PREFIX_input(i), 1, MICRO_PREFIX_input_bytes(i), "
+                       "file) != MICRO_PREFIX_input_bytes(i)) {\n"
+                       "            return 1;\n"
+                       "        }\n"
+                       "    }\n"
+                       "    if (file == NULL || MICRO_PREFIX_run() != 0) {\n"
+                       "        return 1;\n"
+                       "    }\n"
+                       "    fclose(file);\n"
+                       "    file = fopen(\"MICRO_DIRECTORY/output.bin\", \"wb\");\n"
+                       "    for (unsigned int i = 0; file && i < MICRO_PREFIX_num_outputs(); i++) "
+                       "{\n"
+                       "        fwrite(MICRO_PREFIX_output(i), 1, MICRO_PREFIX_output_bytes(i), "
+                       "file);\n"
+                       "    }\n"
+                       "    return (file == NULL || fclose(file) != 0) ? 1 : 0;\n"
+                       "}\n";
+    std::vector<std::pair<std::string, std::string>> patterns = {
+        {"MICRO_PREFIX", prefix}, {"MICRO_DIRECTORY", directory}};
+    for (auto pattern : patterns) {
+        for (size_t pos = code.find(pattern.first); pos != std::string::npos;
+             pos = code.find(pattern.first, pos)) {
+            code.replace(pos, pattern.first.size(), pattern.second);
+        }
+    }
+    FILE *file = fopen(path.c_str(), "w");
+    CHECK_REQUIREMENT(file != NULL);
+    fwrite(code.c_str(), 1, code.size(), file);
+    fclose(file);
+}
+
+static void run_command(std::string command)
+{
+    if (system(command.c_str()) != 0) {
+        UNI_ERROR_LOG("run %s failed.\n", command.c_str());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string toolPath = argv[0];
+    std::string installPath = std::string(dirname(&toolPath[0])) + "/..";
+    std::string compilerPath = (argc > 1) ? argv[1] : installPath + "/tools/micro_compiler";
+    std::string libraryPath = (argc > 2) ? argv[2] : installPath + "/lib";
+    char directoryTemplate[] = "/tmp/micro_test_XXXXXX";
+    if (mkdtemp(directoryTemplate) == NULL) {
+        UNI_ERROR_LOG("can not create temporary directory.\n");
+    }
+    std::string directory = directoryTemplate;
+    std::string modelPath = directory + "/micro_test_f32.bolt";
+    std::string prefix = directory + "/micro_test";
+    create_model(modelPath.c_str());
+    run_command(compilerPath + " -m " + modelPath + " -o " + directory + " -n micro_test -l " +
+        libraryPath + " -a AVX2");
+    create_runner(prefix + "_test.cpp", directory, "micro_test");
+    run_command("bash " + prefix + "_compile.sh");
+
+    auto cnn = createPipeline("CPU_AFFINITY_HIGH_PERFORMANCE", modelPath.c_str());
+    std::map<std::string, std::shared_ptr<U8>> inputs;
+    std::map<std::string, U8 *> inputPtrs;
+    FILE *file = fopen((directory + "/input.bin").c_str(), "wb");
+    for (auto iter : cnn->get_input_desc()) {
+        U32 length = tensorNumElements(iter.second);
+        inputs[iter.first] = std::shared_ptr<U8>(ut_input_v(length, DT_F32, UT_INIT_RANDOM), free);
+        inputPtrs[iter.first] = inputs[iter.first].get();
+        fwrite(inputPtrs[iter.first], 1, tensorNumBytes(iter.second), file);
+    }
+    fclose(file);
+    run_command(prefix + "_test");
+    cnn->set_input_by_copy(inputPtrs);
+    cnn->run();
+
+    // generated outputs follow the model output order and are always in plain layout
+    ModelSpec ms;
+    CHECK_STATUS(deserialize_model_from_file(modelPath.c_str(), &ms));
+    std::map<std::string, std::shared_ptr<Tensor>> outputs = cnn->get_output();
+    file = fopen((directory + "/output.bin").c_str(), "rb");
+    for (int i = 0; i < ms.num_outputs; i++) {
+        Tensor output = *(outputs[ms.output_names[i]]);
+        TensorDesc desc = output.get_desc();
+        U32 length = tensorNumElements(desc);
+        std::vector<F32> actual(length), expect(length);
+        CHECK_REQUIREMENT(
+            fread(actual.data(), 1, tensorNumBytes(desc), file) == tensorNumBytes(desc));
+        if (desc.df == DF_NCHWC8 || desc.df == DF_NCHWC16) {
+            desc.df = DF_NCHW;
+            CHECK_STATUS(transformToNCHW(output.get_desc(),
+                get_ptr_from_tensor(output, CPU_GENERAL), desc, expect.data()));
+        } else {
+            UNI_MEMCPY(expect.data(), get_ptr_from_tensor(output, CPU_GENERAL), output.bytes());
+        }
+        ut_check_v(actual.data(), expect.data(), length, DT_F32, 0.0001, __FILE__, __LINE__);
+        UNI_INFO_LOG("output %s of %u elements matches.\n", ms.output_names[i], length);
+    }
+    fclose(file);
+    CHECK_STATUS(mt_destroy_model(&ms));
+    run_command("rm -rf " + directory);
+    return 0;
+}
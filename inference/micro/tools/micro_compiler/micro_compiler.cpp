@@ -0,0 +1,102 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <getopt.h>
+#include <libgen.h>
+#include <iostream>
+#include "engine.h"
+#include "test.h"
+#include "compile.h"
+
+void print_micro_compiler_usage()
+{
+    std::cout << "micro_compiler usage: (<> must be filled in with exact value; [] is optional.)\n"
+                 "./micro_compiler -m <boltModelPath> -o [outputDirectory] -n [name] "
+                 "-l [libraryPath] -a [arch]\n"
+                 "Parameter description:\n"
+                 "1. -m <boltModelPath>: The path of float32 bolt model, input shapes of the "
+                 "model are fixed in the generated code.\n"
+                 "2. -o [outputDirectory]: The directory to write generated files. The default "
+                 "value is current directory.\n"
+                 "3. -n [name]: The prefix of generated files and interfaces. The default value "
+                 "is the model name.\n"
+                 "4. -l [libraryPath]: The directory of bolt tensor libraries used by the "
+                 "generated compile script. The default value is <micro_compiler "
+                 "directory>/../lib.\n"
+                 "5. -a [arch]: The instruction set of the machine that runs the generated code, "
+                 "AVX2, AVX512 or AVX512_VNNI. The default value is AVX2.\n"
+                 "Example: ./micro_compiler -m /local/models/resnet50_f32.bolt -o /local/micro\n"
+                 "You can find resnet50.cpp, resnet50_test.cpp and resnet50_compile.sh in "
+                 "/local/micro.\n"
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string modelPath;
+    std::string outputDirectory = ".";
+    std::string name;
+    std::string toolPath = argv[0];
+    std::string libraryPath = std::string(dirname(&toolPath[0])) + "/../lib";
+    const char *boltRoot = getenv("BOLT_ROOT");
+    Arch arch = X86_AVX2;
+
+    int option;
+    const char *optionstring = "m:o:n:l:a:h";
+    while ((option = getopt(argc, argv, optionstring)) != -1) {
+        switch (option) {
+            case 'm':
+                modelPath = optarg;
+                break;
+            case 'o':
+                outputDirectory = optarg;
+                break;
+            case 'n':
+                name = optarg;
+                break;
+            case 'l':
+                libraryPath = optarg;
+                break;
+            case 'a':
+                if (std::string(optarg) == "AVX2") {
+                    arch = X86_AVX2;
+                } else if (std::string(optarg) == "AVX512") {
+                    arch = X86_AVX512;
+                } else if (std::string(optarg) == "AVX512_VNNI") {
+                    arch = X86_AVX512_VNNI;
+                } else {
+                    print_micro_compiler_usage();
+                    return 1;
+                }
+                break;
+            default:
+                print_micro_compiler_usage();
+                return 1;
+        }
+    }
+    if (modelPath.empty()) {
+        print_micro_compiler_usage();
+        return 1;
+    }
+
+    Engine engine(modelPath, outputDirectory, name, arch);
+    CHECK_STATUS(engine.generate());
+    Test test(&engine, outputDirectory);
+    CHECK_STATUS(test.generate());
+    std::string prefix = outputDirectory + "/" + engine.get_prefix();
+    Compile compile({engine.get_source_path(), test.get_source_path()}, prefix + "_compile.sh",
+        prefix + "_test", (boltRoot == NULL) ? "." : boltRoot, libraryPath);
+    CHECK_STATUS(compile.generate());
+    return 0;
+}
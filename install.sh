@@ -190,9 +190,6 @@ elif [[ ${target} =~ avx ]]; then
         if [[ "${use_int8}" == "ON" || "${use_int8}" == "on" ]]; then
             cmake_options="${cmake_options} -DUSE_INT8=ON"
         fi
-        if [[ ${target} =~ vnni ]]; then
-            cmake_options="${cmake_options} -DUSE_AVX512_VNNI=ON"
-        fi
     fi
 else
     if [[ "${use_int8}" == "ON" || "${use_int8}" == "on" ]]; then
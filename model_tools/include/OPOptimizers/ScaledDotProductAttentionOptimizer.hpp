@@ -0,0 +1,197 @@
+// Copyright (C) 2019. Huawei Technologies Co., Ltd. All rights reserved.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef _H_SCALEDDOTPRODUCTATTENTIONOPTIMIZER
+#define _H_SCALEDDOTPRODUCTATTENTIONOPTIMIZER
+
+#include <vector>
+#include "OPOptimizer.hpp"
+
+// MatMul(Q, K) -> [Power] -> [Eltwise(+mask)] -> [Power] -> Softmax -> MatMul(V)
+class ScaledDotProductAttentionOptimizer : public OPOptimizer {
+    bool optimize(ModelSpec *spec) override
+    {
+        bool hasOptimized = false;
+        int sdpa_layer = 0;
+        for (int i = 0; i < spec->num_operator_specs; i++) {
+            if (spec->ops[i].type != OT_Softmax ||
+                (spec->ops[i].ps.softmax_spec.axis != -1 &&
+                    spec->ops[i].ps.softmax_spec.axis != 3)) {
+                continue;
+            }
+            int softmaxIndex = i;
+            int nextIndex = consumer(spec, softmaxIndex);
+            if (nextIndex < 0 || spec->ops[nextIndex].type != OT_MatMul ||
+                std::string(spec->ops[nextIndex].input_tensors_name[0]) !=
+                    spec->ops[softmaxIndex].output_tensors_name[0] ||
+                spec->ops[nextIndex].ps.matmul_spec.transpose_a ||
+                spec->ops[nextIndex].ps.matmul_spec.transpose_b ||
+                searchWeightIndex(spec, spec->ops[nextIndex].name) >= 0) {
+                continue;
+            }
+
+            ScaledDotProductAttentionParamSpec p;
+            p.transpose_key = false;
+            p.scale = 1;
+            p.mask_scale = 1;
+            p.mask_mode = SDPA_MASK_NONE;
+            std::string mask;
+            std::vector<int> chain;
+            int k = producer(spec, softmaxIndex, 0);
+            while (k >= 0 && consumer(spec, k) >= 0 && !isModelOutput(spec, k)) {
+                OperatorSpec &op = spec->ops[k];
+                if (isScale(spec, k)) {
+                    p.scale *= op.ps.power_spec.scale;
+                    // only a scale applied after the mask add also scales the mask
+                    if (p.mask_mode == SDPA_MASK_NONE) {
+                        p.mask_scale *= op.ps.power_spec.scale;
+                    }
+                    chain.push_back(k);
+                    k = producer(spec, k, 0);
+                } else if (op.type == OT_Eltwise && p.mask_mode == SDPA_MASK_NONE &&
+                    op.num_inputs == 2 && op.ps.eltwise_spec.elt_mode == ELTWISE_SUM &&
+                    op.ps.eltwise_spec.elt_sum_spec.coeff_size == 0 &&
+                    op.ps.eltwise_spec.activation_type == ACTIVATION_NULL) {
+                    // the score is the operand that comes from Q*K, the other one is the mask
+                    bool a = isScore(spec, producer(spec, k, 0));
+                    bool b = isScore(spec, producer(spec, k, 1));
+                    if (a == b) {
+                        break;
+                    }
+                    int scoreId = a ? 0 : 1;
+                    mask = op.input_tensors_name[1 - scoreId];
+                    p.mask_mode = SDPA_MASK_ADD;
+                    chain.push_back(k);
+                    k = producer(spec, k, scoreId);
+                } else {
+                    break;
+                }
+            }
+            if (!isQueryKey(spec, k)) {
+                continue;
+            }
+            int matmulIndex = k;
+            p.transpose_key = spec->ops[matmulIndex].ps.matmul_spec.transpose_b;
+
+            int attentionIndex = -1;
+            if (p.mask_mode == SDPA_MASK_ADD) {
+                std::vector<std::pair<int, int>> maskProducers =
+                    searchOperatorIndexByOutput(spec, mask, 0, matmulIndex);
+                if (maskProducers.size() > 0 &&
+                    spec->ops[maskProducers[0].first].type == OT_Attention) {
+                    attentionIndex = maskProducers[0].first;
+                    mask = spec->ops[attentionIndex].input_tensors_name[0];
+                    p.mask_mode = SDPA_MASK_ATTENTION;
+                }
+            }
+
+            OperatorSpec &op = spec->ops[nextIndex];
+            std::string value = op.input_tensors_name[1];
+            std::vector<std::string> inputs = {spec->ops[matmulIndex].input_tensors_name[0],
+                spec->ops[matmulIndex].input_tensors_name[1], value};
+            if (p.mask_mode != SDPA_MASK_NONE) {
+                inputs.push_back(mask);
+            }
+            for (U32 j = 0; j < op.num_inputs; j++) {
+                delete op.input_tensors_name[j];
+            }
+            delete op.input_tensors_name;
+            op.num_inputs = inputs.size();
+            op.input_tensors_name = (I8 **)mt_new_storage(op.num_inputs * sizeof(I8 *));
+            for (U32 j = 0; j < op.num_inputs; j++) {
+                op.input_tensors_name[j] = (I8 *)mt_new_storage(NAME_LEN * sizeof(I8));
+                str_copy(op.input_tensors_name[j], inputs[j].c_str(), inputs[j].size());
+            }
+            std::string opName = "sdpa" + std::to_string(sdpa_layer++);
+            memset(op.name, 0, NAME_LEN);
+            str_copy(op.name, opName.c_str(), opName.size());
+            op.type = OT_ScaledDotProductAttention;
+            memset(&op.ps, 0, sizeof(op.ps));
+            op.ps.sdpa_spec = p;
+
+            setOperatorInvalid(spec, matmulIndex, false);
+            for (U32 j = 0; j < chain.size(); j++) {
+                setOperatorInvalid(spec, chain[j], false);
+            }
+            setOperatorInvalid(spec, softmaxIndex, false);
+            if (attentionIndex >= 0 && !isModelOutput(spec, attentionIndex) &&
+                searchOperatorIndexByInput(spec,
+                    spec->ops[attentionIndex].output_tensors_name[0], attentionIndex + 1,
+                    spec->num_operator_specs, false)
+                        .size() == 0) {
+                setOperatorInvalid(spec, attentionIndex, false);
+            }
+            hasOptimized = true;
+        }
+        return hasOptimized;
+    }
+
+private:
+    // index of the only operator reading the output of op, -1 if there are several
+    int consumer(ModelSpec *spec, int op)
+    {
+        if (spec->ops[op].num_outputs != 1) {
+            return -1;
+        }
+        std::vector<std::pair<int, int>> result = searchOperatorIndexByInput(
+            spec, spec->ops[op].output_tensors_name[0], op + 1, spec->num_operator_specs, false);
+        if (result.size() != 1) {
+            return -1;
+        }
+        return result[0].first;
+    }
+
+    // index of the operator writing input id of op
+    int producer(ModelSpec *spec, int op, U32 id)
+    {
+        if (id >= spec->ops[op].num_inputs) {
+            return -1;
+        }
+        std::vector<std::pair<int, int>> result =
+            searchOperatorIndexByOutput(spec, spec->ops[op].input_tensors_name[id], 0, op);
+        if (result.size() == 0) {
+            return -1;
+        }
+        return result[0].first;
+    }
+
+    // op only scales its input
+    bool isScale(ModelSpec *spec, int op)
+    {
+        return spec->ops[op].type == OT_Power &&
+            UNI_ABS(spec->ops[op].ps.power_spec.power - 1) < eps &&
+            UNI_ABS(spec->ops[op].ps.power_spec.shift) < eps;
+    }
+
+    // op is a MatMul of query and key that can be fused
+    bool isQueryKey(ModelSpec *spec, int op)
+    {
+        return op >= 0 && spec->ops[op].type == OT_MatMul && consumer(spec, op) >= 0 &&
+            !isModelOutput(spec, op) && !spec->ops[op].ps.matmul_spec.transpose_a &&
+            searchWeightIndex(spec, spec->ops[op].name) < 0;
+    }
+
+    // op is the query and key MatMul, or scales its output
+    bool isScore(ModelSpec *spec, int op)
+    {
+        while (op >= 0 && isScale(spec, op) && consumer(spec, op) >= 0 &&
+            !isModelOutput(spec, op)) {
+            op = producer(spec, op, 0);
+        }
+        return isQueryKey(spec, op);
+    }
+
+    float eps = 0.0001;
+};
+#endif
@@ -63,6 +63,7 @@
 #include "OPOptimizers/RsqrtOptimizer.hpp"
 #include "OPOptimizers/MergeSharedWeightOptimizer.hpp"
 #include "OPOptimizers/GATOptimizer.hpp"
+#include "OPOptimizers/ScaledDotProductAttentionOptimizer.hpp"
 #include "OPOptimizers/ConvConvOptimizer.hpp"
 
 class ModelSpecOptimizer {
@@ -81,7 +82,7 @@ public:
         return optimizeOrNot;
     }
 
-    void suggest(bool isPTQ)
+    void suggest(bool isPTQ, bool isFP32 = false)
     {
         // strict order
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new ResizeFuseOptimizer()));
@@ -105,6 +106,11 @@ public:
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new TransposeMatMulToFCOptimizer()));
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new InnerProductOptimizer()));
         // this->opos.push_back(std::shared_ptr<OPOptimizer>(new MultiHeadAttentionOptimizer()));
+        if (isFP32) {
+            // only the x86 fp32 path has a fused kernel, keep MatMul + Softmax elsewhere
+            this->opos.push_back(
+                std::shared_ptr<OPOptimizer>(new ScaledDotProductAttentionOptimizer()));
+        }
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new InvariantSliceOptimizer()));
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new InPlaceOptimizer()));
         this->opos.push_back(std::shared_ptr<OPOptimizer>(new PowerOptimizer()));
@@ -83,7 +83,8 @@ void *OnlineModelConversion(const char *storagePath,
 
     UNI_DEBUG_LOG("Start to optimize graph...\n");
     ModelSpecOptimizer msOptimizer;
-    msOptimizer.suggest(inferPrecision == std::string("PTQ"));
+    msOptimizer.suggest(
+        inferPrecision == std::string("PTQ"), inferPrecision == std::string("FP32"));
     msOptimizer.optimize(originalMs);
 
     CHECK_STATUS(ms_datatype_converter(originalMs, targetMs, converterMode, "NOQUANT"));
@@ -19,6 +19,7 @@
 #include "model_data_type_converter.h"
 #include "model_optimizer.hpp"
 #include "model_print.h"
+#include "thread_affinity.h"
 #include <algorithm>
 
 void print_quantization_usage()
@@ -44,12 +45,17 @@ void print_quantization_usage()
                  "value according to the file.\n"
                  "7. -o [offlineCalibration]: Whether to use offline calibration. Not compatible "
                  "with "
-                 "option 6. Only when -o is set to true, option 8-10 will take effect.\n"
+                 "option 6. Only when -o is set to true, option 8-12 will take effect.\n"
                  "8. -d [datasetPath]: Path to the calibration dataset (e.g. directory of "
                  "images).\n"
                  "9. -f [formatOfInput]: Specify the preprocessing style of the model.\n"
                  "10. -m [mulScale]: The multiplying scale for input preprocessing.\n"
-                 "11. -V : Verbose mode.\n"
+                 "11. -t [calibrationThreads]: The number of threads that share the dataset. "
+                 "All tensors are recorded in one forward pass per sample. Default is the number "
+                 "of CPU cores. 0 calibrates the operators one by one.\n"
+                 "12. -a [calibrationAlgorithm]: How to choose the clipping value. You can choose "
+                 "one of {KL, MINMAX}. Default is KL.\n"
+                 "13. -V : Verbose mode.\n"
               << std::endl;
 }
 
@@ -74,11 +80,13 @@ int main(int argc, char *argv[])
     char *dataPath = nullptr;
     ImageFormat imageFormat = RGB;
     F32 mulScale = 1.0;
+    int calThreads = get_cpus_num();
+    bool useMinMax = false;
     bool verbose = false;
     bool hasScale = false;
 
     int option;
-    const char *optionstring = "p:i:b:q:c:s:o:d:f:m:V";
+    const char *optionstring = "p:i:b:q:c:s:o:d:f:m:t:a:V";
     while ((option = getopt(argc, argv, optionstring)) != -1) {
         switch (option) {
             case 'p':
@@ -136,6 +144,15 @@ int main(int argc, char *argv[])
                 std::cout << "option is -m [mulScale], value is: " << optarg << std::endl;
                 mulScale = atof(optarg);
                 break;
+            case 't':
+                std::cout << "option is -t [calibrationThreads], value is: " << optarg << std::endl;
+                calThreads = atoi(optarg);
+                break;
+            case 'a':
+                std::cout << "option is -a [calibrationAlgorithm], value is: " << optarg
+                          << std::endl;
+                useMinMax = (std::string(optarg).compare("MINMAX") == 0) ? true : false;
+                break;
 #endif
             case 'V':
                 verbose = true;
@@ -237,8 +254,8 @@ int main(int argc, char *argv[])
         if ("INT8" == std::string(inferPrecision)) {
             calibrateType = DT_F16_8Q;
         }
-        calibrate_model_with_dataset(
-            dataPath, imageFormat, calibrateType, mulScale, storePath, &calMs);
+        calibrate_model_with_dataset(dataPath, imageFormat, calibrateType, mulScale, storePath,
+            &calMs, UNI_MAX(calThreads, 0), useMinMax);
         relationNum = calMs.num_op_tensor_entries;
         relationPtr = calMs.op_relationship_entries;
         calMs.num_op_tensor_entries = 0;